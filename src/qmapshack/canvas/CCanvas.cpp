@@ -49,6 +49,7 @@
 #include "mouse/CMouseWptBubble.h"
 #include "plot/CPlotProfile.h"
 #include "poi/CPoiDraw.h"
+#include "print/CTiledImageWriter.h"
 #include "realtime/CRtDraw.h"
 #include "units/IUnit.h"
 #include "widgets/CColorLegend.h"
@@ -65,6 +66,8 @@ qreal CCanvas::gisLayerOpacity = 1.0;
 #define HEIGHT_PROFILE_LARGE  120
 #define WIDTH_PROFILE_SMALL   200
 #define HEIGHT_PROFILE_SMALL  80
+#define PAN_MOTION_TIMEOUT    500 // ms
+#define PAN_MOTION_HALFLIFE   100 // ms
 
 inline QSize getTrackProfileSize(int height)
 {
@@ -611,6 +614,12 @@ void CCanvas::paintEvent(QPaintEvent*)
     // move coordinate system to center of the screen
     p.translate(width() >> 1, height() >> 1);
 
+    // the map is not panned anymore, stop prefetching in the last direction
+    if(timeLastMove.isValid() && (timeLastMove.elapsed() >= PAN_MOTION_TIMEOUT))
+    {
+        resetMotion();
+    }
+
     map->draw(p, needsRedraw, posFocus);
     poi->draw(p, needsRedraw, posFocus);
     dem->draw(p, needsRedraw, posFocus);
@@ -1067,16 +1076,38 @@ void CCanvas::moveMap(const QPointF& delta)
     posFocus -= delta;
     map->convertPx2Rad(posFocus);
 
+    // smooth the pan motion and pass it to the map to prefetch tiles ahead of the viewport.
+    // The older the last motion the less it counts.
+    if(timeLastMove.isValid() && (timeLastMove.elapsed() < PAN_MOTION_TIMEOUT))
+    {
+        const qreal keep = 0.7 * qPow(0.5, timeLastMove.elapsed() / qreal(PAN_MOTION_HALFLIFE));
+        panMotion = panMotion * keep - delta * (1.0 - keep);
+    }
+    else
+    {
+        panMotion = -delta;
+    }
+    timeLastMove.start();
+    map->setMotion(panMotion);
+
     emit sigMove();
     emit sigMoveAndZoom(map->zoom(), posFocus);
 
     slotTriggerCompleteUpdate(eRedrawAll);
 }
 
-void CCanvas::zoomTo(const QRectF& rect)
+void CCanvas::resetMotion()
+{
+    panMotion = QPointF();
+    timeLastMove = QTime();
+    map->setMotion(panMotion);
+}
+
+void CCanvas::zoomTo(const QRectF& rect, const QSize& size)
 {
     posFocus = rect.center();
-    map->zoom(rect);
+    resetMotion();
+    map->zoom(rect, size);
     const QList<IDrawContext*>& allContext = allDrawContext.mid(1);
     for(IDrawContext* context : allContext)
     {
@@ -1220,6 +1251,7 @@ void CCanvas::getElevationAt(SGisLine& line) const
 
 void CCanvas::setZoom(bool in, redraw_e& needsRedraw)
 {
+    resetMotion();
     map->zoom(in, needsRedraw);
     const QList<IDrawContext*>& allContext = allDrawContext.mid(1);
     for(IDrawContext* context : allContext)
@@ -1238,6 +1270,7 @@ void CCanvas::zoom(int index)
         return;
     }
 
+    resetMotion();
     map->zoom(index);
     const QList<IDrawContext*>& allContext = allDrawContext.mid(1);
     for(IDrawContext* context : allContext)
@@ -1340,51 +1373,159 @@ bool CCanvas::setDrawContextSize(const QSize& s)
     return done;
 }
 
-void CCanvas::print(QPainter& p, const QRectF& area, const QPointF& focus, bool printScale)
+void CCanvas::print(const QSize& size, const QPointF& focus, const CTileRenderer::fWriteTile& write, bool printScale, qint32 tileSize)
 {
-    const QSize oldSize = size();
-    const QSize newSize(area.size().toSize());
-
-    setDrawContextSize(newSize);
+    const QSize oldSize = this->size();
 
-    // ----- start to draw thread based content -----
-    // move coordinate system to center of the screen
-    p.translate(newSize.width() >> 1, newSize.height() >> 1);
+    CTileRenderer renderer(size, tileSize);
+    const QList<CTileRenderer::tile_t>& tiles = renderer.getTiles();
+    const QSize& sizeTile = renderer.getTileSize();
 
-    redraw_e redraw = eRedrawAll;
+    // Derive the focus of each tile before the draw contexts change their focus.
+    // The area's focus is in the area's center as without tiles.
+    QPointF pxFocus = focus;
+    convertRad2Px(pxFocus);
+    const QPoint pxCenter(size.width() >> 1, size.height() >> 1);
 
-    for(IDrawContext* context : qAsConst(allDrawContext))
+    QList<QPointF> foci;
+    for(const CTileRenderer::tile_t& tile : tiles)
     {
-        context->draw(p, redraw, focus);
+        QPointF pt = pxFocus + tile.rectTile.topLeft() + QPoint(sizeTile.width() >> 1, sizeTile.height() >> 1) - pxCenter;
+        convertPx2Rad(pt);
+        foci << pt;
     }
 
-    for(IDrawContext* context : qAsConst(allDrawContext))
+    setDrawContextSize(sizeTile);
+
+    // the buffers of the previous tile are drawn on this one when triggering a redraw
+    QImage dummy(1, 1, QImage::Format_ARGB32);
+    QPainter pDummy(&dummy);
+
+    // Labels are placed to not overlap with items in the viewport. To get the same
+    // placement on all tiles the GIS items are recorded once for the whole area. The
+    // thread is run once to have no redraw pending that would abort the recording.
+    gis->draw(pDummy, eRedrawAll, focus);
+    gis->wait();
+
+    QPointF pxOrigin = focus;
+    gis->convertRad2Px(pxOrigin);
+    pxOrigin -= pxCenter;
+
+    QPolygonF viewport;
+    viewport << pxOrigin
+             << pxOrigin + QPointF(size.width(), 0)
+             << pxOrigin + QPointF(size.width(), size.height())
+             << pxOrigin + QPointF(0, size.height());
+    for(QPointF& pt : viewport)
     {
-        context->wait();
+        gis->convertPx2Rad(pt);
     }
 
-    for(IDrawContext* context : qAsConst(allDrawContext))
+    QPicture pictureGis;
     {
-        context->draw(p, redraw, focus);
+        QPainter p(&pictureGis);
+        USE_ANTI_ALIASING(p, true);
+        gis->drawViewport(p, viewport);
+        gis->draw(p, QRectF(pxOrigin, size).toAlignedRect());
     }
 
-    // restore coordinate system to default
-    p.resetTransform();
-    // ----- start to draw fast content -----
+    // restore the draw contexts even if writing a tile fails
+    try
+    {
+        renderer.render([&](QPainter& p, qint32 n)
+        {
+            const QPointF& focusTile = foci[n];
+            USE_ANTI_ALIASING(p, true);
 
-    QRect r(QPoint(0, 0), area.size().toSize());
+            // ----- start to draw thread based content -----
+            for(IDrawContext* context : qAsConst(allDrawContext))
+            {
+                if(context != gis)
+                {
+                    context->draw(pDummy, eRedrawAll, focusTile);
+                }
+            }
+
+            for(IDrawContext* context : qAsConst(allDrawContext))
+            {
+                context->wait();
+            }
 
-    grid->draw(p, r);
-    gis->draw(p, r);
-    rt->draw(p, r);
-    if(printScale)
+            // move coordinate system to center of the tile
+            p.translate(sizeTile.width() >> 1, sizeTile.height() >> 1);
+            for(IDrawContext* context : qAsConst(allDrawContext))
+            {
+                if(context != gis)
+                {
+                    context->draw(p, eRedrawNone, focusTile);
+                    continue;
+                }
+
+                // the recording is in the pixels of the GIS context, move the tile's part of it to the origin
+                p.save();
+                p.resetTransform();
+                p.translate(-pxOrigin - tiles[n].rectTile.topLeft());
+                p.drawPicture(0, 0, pictureGis);
+                p.restore();
+            }
+
+            // restore coordinate system to default
+            p.resetTransform();
+            // ----- start to draw fast content -----
+
+            QRect r(QPoint(0, 0), sizeTile);
+            // the area in the tile's coordinates
+            QRect rectArea(-tiles[n].rectTile.topLeft(), size);
+
+            // the grid's labels are placed at the border of the area, not the tile
+            grid->draw(p, rectArea);
+            rt->draw(p, r);
+            if(printScale)
+            {
+                drawScale(p, rectArea);
+            }
+        }, write);
+    }
+    catch(const QString& msg)
     {
-        drawScale(p, r);
+        setDrawContextSize(oldSize);
+        throw msg;
     }
 
     setDrawContextSize(oldSize);
 }
 
+void CCanvas::print(QPainter& p, const QRectF& area, const QPointF& focus, bool printScale)
+{
+    print(area.size().toSize(), focus, [&p](const QImage& img, const QPoint& pos)
+    {
+        p.drawImage(pos, img);
+    }, printScale);
+}
+
+void CCanvas::print(CTiledImageWriter& writer, const QRectF& area, const QPointF& focus)
+{
+    const QSize& size = area.size().toSize();
+
+    // the area's top left and bottom right corner in units of the projection
+    QPointF pt1 = focus;
+    convertRad2Px(pt1);
+    pt1 -= QPoint(size.width() >> 1, size.height() >> 1);
+    QPointF pt2 = pt1 + QPoint(size.width(), size.height());
+    convertPx2Rad(pt1);
+    convertPx2Rad(pt2);
+    map->convertRad2M(pt1);
+    map->convertRad2M(pt2);
+
+    const QPointF pxSize((pt2.x() - pt1.x()) / size.width(), (pt2.y() - pt1.y()) / size.height());
+    writer.setGeoReference(map->getProjection(), pt1, pxSize);
+
+    print(size, focus, [&writer](const QImage& img, const QPoint& pos)
+    {
+        writer.write(img, pos);
+    }, false);
+}
+
 bool CCanvas::event(QEvent* event)
 {
     if (event->type() == QEvent::Gesture)
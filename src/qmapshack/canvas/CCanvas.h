@@ -21,10 +21,12 @@
 #define CCANVAS_H
 
 #include "gis/IGisItem.h"
+#include "print/CTileRenderer.h"
 
 #include <QMap>
 #include <QPainter>
 #include <QPointer>
+#include <QTime>
 #include <QWidget>
 
 class IDrawContext;
@@ -52,6 +54,7 @@ class IPlot;
 struct SGisLine;
 struct poi_t;
 class CTableTrkInfo;
+class CTiledImageWriter;
 
 class CCanvas : public QWidget
 {
@@ -97,7 +100,7 @@ public:
 
     void moveTo(const QPointF& newFocus);
     void moveMap(const QPointF& delta);
-    void zoomTo(const QRectF& rect);
+    void zoomTo(const QRectF& rect, const QSize& size = QSize());
     void zoom(int index);
     void displayInfo(const QPoint& px);
     ///The POIs can be clustered together, so the icon is not necessarily displayed where the POI is.
@@ -170,7 +173,34 @@ public:
      */
     bool findPolylineCloseBy(const QPointF& pt1, const QPointF& pt2, qint32 threshold, QPolygonF& polyline);
 
+    /**
+       @brief Render an area of the map tile by tile
+
+       The draw contexts are resized to the size of a tile instead of the size of the
+       area. Thus memory consumption does not depend on the area's size. Each tile is
+       rendered with the map, DEM, GIS, grid and realtime layers. The GIS items and their
+       labels are placed once for the whole area and replayed on each tile. Thus labels
+       crossing the border of a tile are neither cut nor placed twice.
+
+       @param size          the size of the area in [px]
+       @param focus         the coordinate in [rad] of the area's center
+       @param write         called with each rendered tile
+       @param printScale    set true to draw the scale into the area's bottom right corner
+       @param tileSize      the size of a tile's core in [px]
+     */
+    void print(const QSize& size, const QPointF& focus, const CTileRenderer::fWriteTile& write, bool printScale, qint32 tileSize = 1024);
+    /**
+       @brief Render an area of the map to a painter, e.g. a printer's page
+
+       The area is drawn with it's top left corner at the painter's origin.
+     */
     void print(QPainter& p, const QRectF& area, const QPointF& focus, bool printScale = true);
+    /**
+       @brief Render an area of the map to an image file
+
+       The image is georeferenced with the canvas' projection.
+     */
+    void print(CTiledImageWriter& writer, const QRectF& area, const QPointF& focus);
 
     /**
        @brief Set a single map file to be shown on the canvas
@@ -233,6 +263,8 @@ private:
         drawScale(p, rect());
     }
     void setZoom(bool in, redraw_e& needsRedraw);
+    /// forget the pan motion and stop prefetching map tiles in its direction
+    void resetMotion();
     void setSizeTrackProfile();
     /**
        @brief Resize all registered drwa context objects
@@ -289,6 +321,11 @@ private:
 
     QPointer<CColorLegend> colorLegend;
 
+    /// the smoothed pan motion [px] passed to the map for tile prefetching
+    QPointF panMotion;
+    /// time of the last call to moveMap()
+    QTime timeLastMove;
+
     /// current accumulated angleDelta, used/required for zooming on trackpads
     int zoomAngleDelta = 0;
 
@@ -23,6 +23,9 @@
 
 #define BUFFER_BORDER 50
 
+/// more invalidated areas than that will trigger a complete redraw
+#define MAX_DIRTY_AREAS 50
+
 
 #define N_DEFAULT_ZOOM_LEVELS 31
 const qreal IDrawContext::scalesDefault[N_DEFAULT_ZOOM_LEVELS] =
@@ -111,6 +114,8 @@ bool IDrawContext::resize(const QSize& size)
     buffer[1].image = QImage(bufWidth, bufHeight, QImage::Format_ARGB32);
     buffer[1].image.fill(Qt::transparent);
 
+    intNeedsFullRedraw = true;
+
     return true;
 }
 
@@ -154,7 +159,7 @@ bool IDrawContext::needsRedraw() const
     return res;
 }
 
-void IDrawContext::zoom(const QRectF& rect)
+void IDrawContext::zoom(const QRectF& rect, const QSize& size)
 {
     if(!proj.isValid())
     {
@@ -168,6 +173,8 @@ void IDrawContext::zoom(const QRectF& rect)
         return;
     }
 
+    const QSize& viewport = size.isValid() ? size : QSize(bufWidth - 2 * BUFFER_BORDER, bufHeight - 2 * BUFFER_BORDER);
+
     // zoom out from closest zoom level until a match is found
     for(int i = 0; i < zoomLevels; i++)
     {
@@ -179,7 +186,7 @@ void IDrawContext::zoom(const QRectF& rect)
         convertRad2Px(pt2);
 
         QPointF pt = pt2 - pt1;
-        if(qAbs(pt.x()) < (bufWidth - 2 * BUFFER_BORDER) && (qAbs(pt.y()) < (bufHeight - 2 * BUFFER_BORDER)))
+        if(qAbs(pt.x()) < viewport.width() && qAbs(pt.y()) < viewport.height())
         {
             break;
         }
@@ -365,6 +372,64 @@ void IDrawContext::convertRad2Px(QPolygonF& poly) const
 }
 
 
+QRectF IDrawContext::getViewport() const
+{
+    QPointF pt1(0, 0);
+    QPointF pt2(viewWidth, viewHeight);
+    convertPx2Rad(pt1);
+    convertPx2Rad(pt2);
+    return QRectF(pt1, pt2);
+}
+
+void IDrawContext::setMotion(const QPointF& m)
+{
+    QMutexLocker lock(&mutex);
+    motion = m;
+}
+
+void IDrawContext::invalidate(const QRectF& area)
+{
+    if(!proj.isValid())
+    {
+        return;
+    }
+
+    mutex.lock(); // --------- start serialize with thread
+    if(dirtyAreas.size() < MAX_DIRTY_AREAS)
+    {
+        dirtyAreas << area;
+    }
+    else
+    {
+        intNeedsFullRedraw = true;
+    }
+    intNeedsRedraw = true;
+    mutex.unlock(); // --------- stop serialize with thread
+
+    // start the thread once all changes of the current event are reported
+    QTimer::singleShot(0, this, [this]()
+    {
+        // an earlier call might have started the thread already. Starting
+        // it without anything to draw would switch to an outdated buffer.
+        mutex.lock();
+        const bool needsRedraw = intNeedsRedraw;
+        mutex.unlock();
+
+        if(needsRedraw && !isRunning())
+        {
+            emit sigStartThread();
+            start();
+        }
+    });
+}
+
+bool IDrawContext::hasDirtyAreas() const
+{
+    QMutexLocker lock(&mutex);
+    return !dirtyAreas.isEmpty();
+}
+
+
 void IDrawContext::draw(QPainter& p, CCanvas::redraw_e needsRedraw, const QPointF& f)
 {
     if(!proj.isValid())
@@ -441,6 +506,7 @@ void IDrawContext::draw(QPainter& p, CCanvas::redraw_e needsRedraw, const QPoint
     if(needsRedraw & maskRedraw)
     {
         intNeedsRedraw = true;
+        intNeedsFullRedraw = true;
     }
     mutex.unlock(); // --------- stop serialize with thread
 
@@ -451,6 +517,12 @@ void IDrawContext::draw(QPainter& p, CCanvas::redraw_e needsRedraw, const QPoint
     }
 }
 
+void IDrawContext::drawtPartial(buffer_t& currentBuffer, const QList<QRectF>& /*areas*/)
+{
+    currentBuffer.image.fill(Qt::transparent);
+    drawt(currentBuffer);
+}
+
 void IDrawContext::run()
 {
     mutex.lock();
@@ -459,26 +531,59 @@ void IDrawContext::run()
 //    qDebug() << "start thread" << objectName();
 
     IDrawContext::buffer_t& currentBuffer = buffer[!bufIndex];
+    const IDrawContext::buffer_t& lastBuffer = buffer[bufIndex];
+
+    /*
+        Invalidated areas are redrawn on top of a copy of the last buffer. If the
+        loop runs more than once, the previous pass might have been aborted. Thus
+        all areas of this run are collected and drawn on a fresh copy again. Once
+        a complete redraw is necessary all following passes are complete redraws, too.
+     */
+    QList<QRectF> areas;
+    bool partial = true;
     while(intNeedsRedraw)
     {
-        // copy all projection information need by the
-        // map render objects to buffer structure
-        currentBuffer.zoomFactor = zoomFactor;
-        currentBuffer.scale = scale;
-        currentBuffer.ref1 = ref1;
-        currentBuffer.ref2 = ref2;
-        currentBuffer.ref3 = ref3;
-        currentBuffer.ref4 = ref4;
-        currentBuffer.focus = focus;
+        partial = partial && !intNeedsFullRedraw && !dirtyAreas.isEmpty()
+                  && (lastBuffer.zoomFactor == zoomFactor)
+                  && (lastBuffer.scale == scale)
+                  && (lastBuffer.image.size() == QSize(bufWidth, bufHeight));
+
+        if(partial)
+        {
+            areas += dirtyAreas;
+            currentBuffer = lastBuffer;
+        }
+        else
+        {
+            // copy all projection information need by the
+            // map render objects to buffer structure
+            currentBuffer.zoomFactor = zoomFactor;
+            currentBuffer.scale = scale;
+            currentBuffer.ref1 = ref1;
+            currentBuffer.ref2 = ref2;
+            currentBuffer.ref3 = ref3;
+            currentBuffer.ref4 = ref4;
+            currentBuffer.focus = focus;
+            currentBuffer.motion = motion;
+        }
+        dirtyAreas.clear();
+        intNeedsFullRedraw = false;
         intNeedsRedraw = false;
 
         mutex.unlock();
 
 //        qDebug() << "bufferScale" << (currentBuffer.scale * currentBuffer.zoomFactor);
-        // ----- reset buffer -----
-        currentBuffer.image.fill(Qt::transparent);
+        if(partial)
+        {
+            drawtPartial(currentBuffer, areas);
+        }
+        else
+        {
+            // ----- reset buffer -----
+            currentBuffer.image.fill(Qt::transparent);
 
-        drawt(currentBuffer);
+            drawt(currentBuffer);
+        }
 
         mutex.lock();
     }
@@ -53,6 +53,7 @@ public:
         QPointF ref3;  //< bottom right corner
         QPointF ref4;  //< bottom left corner
         QPointF focus; //< point of focus
+        QPointF motion; //< recent pan motion of the viewport in [px] (screen orientation), null if not moving
     };
 
     /**
@@ -68,7 +69,12 @@ public:
      */
     void zoom(bool in, CCanvas::redraw_e& needsRedraw);
     void zoom(int idx);
-    void zoom(const QRectF& rect);
+    /**
+       @brief Select the closest zoom level that fits the rectangle into the viewport
+       @param rect          the rectangle in [rad]
+       @param size          the size of the viewport in [px], if invalid the size of the current viewport is used
+     */
+    void zoom(const QRectF& rect, const QSize& size = QSize());
     int  zoom() const
     {
         return zoomIndex;
@@ -98,6 +104,12 @@ public:
     void convertRad2Px(QPointF& p) const;
     void convertRad2Px(QPolygonF& poly) const;
 
+    /**
+       @brief Get the area currently visible in the viewport
+       @return A rectangle with the top left and bottom right corner in [rad]
+     */
+    QRectF getViewport() const;
+
     /**
        @brief Check if the internal needs redraw flag is set
        @return intNeedsRedraw is returned
@@ -143,6 +155,33 @@ public:
 
     virtual void setScales(const CCanvas::scales_type_e type);
 
+    /**
+       @brief Set the recent pan motion of the viewport
+
+       The motion is passed to the map render objects with the next buffer. Online maps use it
+       to prefetch tiles in the direction the user is panning to.
+
+       @param m     the smoothed pan motion in [px], with the direction the viewport is moving to
+     */
+    void setMotion(const QPointF& m);
+
+    /**
+       @brief Redraw a part of the buffer only
+
+       The area is redrawn on top of the buffer currently displayed, as long as the
+       buffer's zoom factor and size are still valid. Otherwise the complete buffer
+       is redrawn. Many areas in a row will end in a complete redraw, too.
+
+       @param area  the area in [rad]
+     */
+    void invalidate(const QRectF& area);
+
+    /**
+       @brief Check for invalidated areas not drawn yet
+       @return True if invalidate() has been called since the last redraw started.
+     */
+    bool hasDirtyAreas() const;
+
 
 signals:
     void sigCanvasUpdate(CCanvas::redraw_e flags);
@@ -164,6 +203,16 @@ protected:
      */
     virtual void drawt(buffer_t& currentBuffer) = 0;
 
+    /**
+       @brief Redraw invalidated areas. Called from the thread.
+
+       The default implementation clears the buffer and calls drawt().
+
+       @param currentBuffer a copy of the last buffer to draw on
+       @param areas         all areas passed to invalidate() in [rad]
+     */
+    virtual void drawtPartial(buffer_t& currentBuffer, const QList<QRectF>& areas);
+
     /**
        @brief The global list of available scale factors
      */
@@ -175,6 +224,10 @@ protected:
 
     /// internal needs redraw flag
     bool intNeedsRedraw;
+    /// set true if the next redraw must not be a partial one
+    bool intNeedsFullRedraw = true;
+    /// the areas passed to invalidate() since the last redraw in [rad]
+    QList<QRectF> dirtyAreas;
 
     /// the canvas this map object is attached to
     CCanvas* canvas;
@@ -217,6 +270,7 @@ private:
     QPointF zoomFactor;
 
     QPointF focus; //< the next point of focus that will be displayed right in the middle of the viewport
+    QPointF motion; //< the recent pan motion passed on to the next buffer
 
     QPointF ref1; //< top left corner of next buffer
     QPointF ref2; //< top right corner of next buffer
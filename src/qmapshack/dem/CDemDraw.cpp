@@ -24,15 +24,19 @@
 #include "dem/CDemPathSetup.h"
 #include "dem/IDem.h"
 #include "gis/IGisLine.h"
+#include "helpers/CFileScanner.h"
 #include "helpers/CSettings.h"
 #include "units/IUnit.h"
 
 #include <QtWidgets>
 
+/// the number of bytes used to calculate a DEM file's key
+#define DEM_KEY_SIZE 1024
 
 QList<CDemDraw*> CDemDraw::dems;
 QStringList CDemDraw::demPaths;
 QStringList CDemDraw::supportedFormats = QString("*.vrt|*.wcs").split('|');
+CFileScanner* CDemDraw::scanner = nullptr;
 
 
 CDemDraw::CDemDraw(CCanvas* canvas)
@@ -43,6 +47,13 @@ CDemDraw::CDemDraw(CCanvas* canvas)
     connect(canvas, &CCanvas::destroyed, demList, &CDemList::deleteLater);
     connect(demList, &CDemList::sigChanged, this, &CDemDraw::emitSigCanvasUpdate);
 
+    if(scanner == nullptr)
+    {
+        scanner = new CFileScanner(DEM_KEY_SIZE, &CMainWindow::self());
+        scanner->scan(demPaths, supportedFormats);
+    }
+    connect(scanner, &CFileScanner::sigFilesFound, this, &CDemDraw::slotFilesFound);
+
     buildMapList();
 
     dems << this;
@@ -94,6 +105,11 @@ void CDemDraw::setupDemPath(const QStringList& paths)
 {
     demPaths = paths;
 
+    if(scanner != nullptr)
+    {
+        scanner->scan(demPaths, supportedFormats);
+    }
+
     for(CDemDraw* dem : qAsConst(dems))
     {
         QStringList keys;
@@ -145,40 +161,89 @@ void CDemDraw::loadConfig(QSettings& cfg)
 
 void CDemDraw::buildMapList()
 {
-    QCryptographicHash md5(QCryptographicHash::Md5);
-
     QMutexLocker lock(&CDemItem::mutexActiveDems);
     demList->clear();
+    keysPending.clear();
+    scanDone = false;
+    cntScanned = 0;
 
-    for(const QString& path : qAsConst(demPaths))
+    // take all files the scanner has found so far
+    slotFilesFound();
+}
+
+void CDemDraw::slotFilesFound()
+{
+    if(scanDone)
     {
-        QDir dir(path);
-        // find available maps
-        const QStringList& filenames = dir.entryList(supportedFormats, QDir::Files | QDir::Readable, QDir::Name);
-        for(const QString& filename : filenames)
-        {
-            QFileInfo fi(filename);
+        return;
+    }
 
-            CDemItem* item = new CDemItem(*demList, this);
+    QMutexLocker lock(&CDemItem::mutexActiveDems);
 
-            item->setText(0, fi.completeBaseName().replace("_", " "));
-            item->filename = dir.absoluteFilePath(filename);
-            item->updateIcon();
+    // query the state first, to be sure to get all files if complete
+    const bool complete = scanner->isComplete();
+    const QList<CFileScanner::file_t>& files = scanner->getFiles(cntScanned);
+    cntScanned += files.size();
 
-            // calculate MD5 hash from the file's first 1024 bytes
-            QFile f(dir.absoluteFilePath(filename));
-            f.open(QIODevice::ReadOnly);
-            md5.reset();
-            md5.addData(f.read(1024));
-            item->key = md5.result().toHex();
-            f.close();
-        }
+    for(const CFileScanner::file_t& file : files)
+    {
+        QFileInfo fi(file.filename);
+
+        CDemItem* item = new CDemItem(*demList, this);
+
+        item->setText(0, fi.completeBaseName().replace("_", " "));
+        item->filename = file.filename;
+        item->key = file.key;
+        item->updateIcon();
     }
 
-    demList->sort();
+    if(!files.isEmpty())
+    {
+        demList->sort();
+    }
+
+    scanDone = complete;
+    restorePendingMaps();
+
     demList->updateHelpText();
 }
 
+void CDemDraw::restorePendingMaps()
+{
+    QMutexLocker lock(&CDemItem::mutexActiveDems);
+
+    while(!keysPending.isEmpty())
+    {
+        CDemItem* item = nullptr;
+        for(int i = 0; i < demList->count(); i++)
+        {
+            CDemItem* dem = demList->item(i);
+            if(dem && dem->key == keysPending.first())
+            {
+                item = dem;
+                break;
+            }
+        }
+
+        // keep the order of active files
+        if((item == nullptr) && !scanDone)
+        {
+            break;
+        }
+
+        keysPending.removeFirst();
+
+        if(item != nullptr)
+        {
+            /**
+                @Note   the item will load it's configuration upon successful activation
+                        by calling loadConfigForDemItem().
+             */
+            item->activate();
+        }
+    }
+}
+
 
 void CDemDraw::saveActiveMapsList(QStringList& keys)
 {
@@ -203,6 +268,9 @@ void CDemDraw::saveActiveMapsList(QStringList& keys, QSettings& cfg)
             keys << item->key;
         }
     }
+
+    // files not found yet by the scan are still part of the configuration
+    keys += keysPending;
 }
 
 void CDemDraw::loadConfigForDemItem(CDemItem* item)
@@ -224,23 +292,8 @@ void CDemDraw::restoreActiveMapsList(const QStringList& keys)
 {
     QMutexLocker lock(&CDemItem::mutexActiveDems);
 
-    for(const QString& key : keys)
-    {
-        for(int i = 0; i < demList->count(); i++)
-        {
-            CDemItem* item = demList->item(i);
-
-            if(item && item->key == key)
-            {
-                /**
-                    @Note   the item will load it's configuration upon successful activation
-                            by calling loadConfigForDemItem().
-                 */
-                item->activate();
-                break;
-            }
-        }
-    }
+    keysPending += keys;
+    restorePendingMaps();
 
     demList->updateHelpText();
 }
@@ -249,6 +302,12 @@ void CDemDraw::restoreActiveMapsList(const QStringList& keys, QSettings& cfg)
 {
     QMutexLocker lock(&CDemItem::mutexActiveDems);
 
+    if(!scanDone)
+    {
+        scanner->waitForComplete();
+        slotFilesFound();
+    }
+
     for(const QString& key : keys)
     {
         for(int i = 0; i < demList->count(); i++)
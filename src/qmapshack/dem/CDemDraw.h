@@ -23,6 +23,7 @@
 
 class QPainter;
 class CDemList;
+class CFileScanner;
 class CCanvas;
 class QSettings;
 class CDemItem;
@@ -76,10 +77,21 @@ protected:
 
 private:
     /**
-       @brief Search in paths found in mapPaths for files with supported extensions and add them to mapList.
+       @brief Fill demList with the files found in demPaths
 
+       The paths are scanned in the background by the scanner shared by all
+       CDemDraw objects. The list will be populated incrementally by
+       slotFilesFound().
      */
     void buildMapList();
+    /**
+       @brief Add the files found by the scanner since the last call to demList.
+     */
+    void slotFilesFound();
+    /**
+       @brief Activate pending DEM files in the order they have been requested
+     */
+    void restorePendingMaps();
 
     /**
        @brief Save list of active maps to configuration file
@@ -88,6 +100,10 @@ private:
     void saveActiveMapsList(QStringList& keys);
     /**
        @brief Restore list of active maps from configuration file
+
+       DEM files not found yet by a running scan are restored as soon as they show up.
+       As the configuration object passed is only valid during the call, the second
+       version will wait for a running scan to complete.
      */
     void restoreActiveMapsList(const QStringList& keys);
     void restoreActiveMapsList(const QStringList& keys, QSettings& cfg);
@@ -103,6 +119,16 @@ private:
 
     /// a list of supported map formats
     static QStringList supportedFormats;
+
+    /// search demPaths for DEM files in the background
+    static CFileScanner* scanner;
+
+    /// the number of files already taken from the scanner
+    qint32 cntScanned = 0;
+    /// true if all files of the scanner have been taken
+    bool scanDone = false;
+    /// keys of DEM files to activate once they are found
+    QStringList keysPending;
 };
 
 #endif //CDEMDRAW_H
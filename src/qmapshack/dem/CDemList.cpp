@@ -95,10 +95,22 @@ void CDemList::clear()
 
 void CDemList::sort()
 {
+    // active items stay on top in their order
+    int first = 0;
+    while(first < treeWidget->topLevelItemCount())
+    {
+        CDemItem* item = dynamic_cast<CDemItem*>(treeWidget->topLevelItem(first));
+        if(item == nullptr || !item->isActivated())
+        {
+            break;
+        }
+        first++;
+    }
+
     QList<CDemItem*> items1;
-    while(treeWidget->topLevelItemCount())
+    while(treeWidget->topLevelItemCount() > first)
     {
-        CDemItem* item = dynamic_cast<CDemItem*>(treeWidget->takeTopLevelItem(0));
+        CDemItem* item = dynamic_cast<CDemItem*>(treeWidget->takeTopLevelItem(treeWidget->topLevelItemCount() - 1));
         if(item != nullptr)
         {
             items1 << item;
@@ -113,6 +125,12 @@ void CDemList::sort()
         items2 << item;
     }
     treeWidget->addTopLevelItems(items2);
+
+    // items added while a filter is set have to be filtered, too
+    if(!lineFilter->text().isEmpty())
+    {
+        slotFilter(lineFilter->text());
+    }
 }
 
 int CDemList::count()
@@ -60,6 +60,7 @@ public:
 
     void updateHelpText();
 
+    /// sort all inactive DEM files by name, active ones stay on top
     void sort();
 
 signals:
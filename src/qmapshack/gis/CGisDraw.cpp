@@ -22,10 +22,21 @@
 
 #include <QtWidgets>
 
+/// the margin around an item's area to cover it's symbol and label [px]
+#define DIRTY_MARGIN 150
+
 CGisDraw::CGisDraw(CCanvas* parent)
     : IDrawContext("gis", CCanvas::eRedrawGis, parent)
 {
-    connect(&CGisWorkspace::self(), &CGisWorkspace::sigChanged, this, &CGisDraw::emitSigCanvasUpdate);
+    connect(&CGisWorkspace::self(), &CGisWorkspace::sigChanged, this, &CGisDraw::slotChanged);
+    connect(&CGisWorkspace::self(), &CGisWorkspace::sigChangedArea, this, &CGisDraw::invalidate);
+}
+
+void CGisDraw::slotChanged()
+{
+    // A plain change (e.g. project visibility or filter) can affect any item.
+    // Thus it needs a complete redraw even if a partial one is pending.
+    emitSigCanvasUpdate();
 }
 
 
@@ -34,6 +45,11 @@ void CGisDraw::draw(QPainter& p, const QRect& rect)
     CGisWorkspace::self().fastDraw(p, rect, this);
 }
 
+void CGisDraw::drawViewport(QPainter& p, const QPolygonF& viewport)
+{
+    CGisWorkspace::self().draw(p, viewport, this);
+}
+
 void CGisDraw::drawt(buffer_t& currentBuffer)
 {
     QPointF pt1 = currentBuffer.ref1;
@@ -53,3 +69,70 @@ void CGisDraw::drawt(buffer_t& currentBuffer)
 
     CGisWorkspace::self().draw(p, viewport, this);
 }
+
+void CGisDraw::drawtPartial(buffer_t& currentBuffer, const QList<QRectF>& areas)
+{
+    QPointF pp = currentBuffer.ref1;
+    convertRad2Px(pp);
+
+    // the dirty area in buffer coordinates
+    QRectF dirty;
+    for(const QRectF& area : areas)
+    {
+        QPolygonF poly;
+        poly << area.topLeft() << area.topRight() << area.bottomRight() << area.bottomLeft();
+        convertRad2Px(poly);
+        dirty |= poly.boundingRect().adjusted(-DIRTY_MARGIN, -DIRTY_MARGIN, DIRTY_MARGIN, DIRTY_MARGIN);
+    }
+    dirty.translate(-pp);
+
+    const QRect& rectBuffer = currentBuffer.image.rect();
+    const QRect& rectDirty = dirty.toAlignedRect() & rectBuffer;
+    if(rectDirty.isEmpty())
+    {
+        return;
+    }
+
+    // a partial redraw of most of the buffer does not pay off
+    if(rectDirty.width() * rectDirty.height() > rectBuffer.width() * rectBuffer.height() / 2)
+    {
+        IDrawContext::drawtPartial(currentBuffer, areas);
+        return;
+    }
+
+    QPainter p(&currentBuffer.image);
+    p.setCompositionMode(QPainter::CompositionMode_Source);
+    p.fillRect(rectDirty, Qt::transparent);
+    p.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    p.setClipRect(rectDirty);
+    USE_ANTI_ALIASING(p, true);
+    p.translate(-pp);
+
+    /*
+        Items are drawn with the viewport of the complete buffer. Track lines
+        are split and decorated with arrows depending on the viewport. With
+        the dirty area as viewport the result would not match the pixels
+        around it. The dirty area is used as clip region only.
+     */
+    QPolygonF viewport;
+    viewport << currentBuffer.ref1 << currentBuffer.ref2 << currentBuffer.ref3 << currentBuffer.ref4;
+
+    /*
+        Items close to the dirty area are drawn, too. Their symbols and labels
+        might reach into it. And they have to block the same areas for labels
+        as with a complete redraw.
+     */
+    QPointF pt1 = QPointF(rectDirty.topLeft() - QPoint(DIRTY_MARGIN, DIRTY_MARGIN)) + pp;
+    QPointF pt2 = QPointF(rectDirty.topRight() + QPoint(DIRTY_MARGIN, -DIRTY_MARGIN)) + pp;
+    QPointF pt3 = QPointF(rectDirty.bottomRight() + QPoint(DIRTY_MARGIN, DIRTY_MARGIN)) + pp;
+    QPointF pt4 = QPointF(rectDirty.bottomLeft() + QPoint(-DIRTY_MARGIN, DIRTY_MARGIN)) + pp;
+    convertPx2Rad(pt1);
+    convertPx2Rad(pt2);
+    convertPx2Rad(pt3);
+    convertPx2Rad(pt4);
+
+    QPolygonF area;
+    area << pt1 << pt2 << pt3 << pt4;
+
+    CGisWorkspace::self().drawPartial(p, viewport, area, this);
+}
@@ -32,8 +32,22 @@ public:
     using IDrawContext::draw;
     void draw(QPainter& p, const QRect& rect);
 
+    /**
+       @brief Draw the GIS items and their labels of a viewport without the thread's buffer
+
+       The viewport can be larger than the draw context, e.g. a complete print area.
+
+       @param p         the painter using the draw context's coordinate system in [px]
+       @param viewport  the viewport in [rad]
+     */
+    void drawViewport(QPainter& p, const QPolygonF& viewport);
+
 protected:
     void drawt(buffer_t& currentBuffer) override;
+    void drawtPartial(buffer_t& currentBuffer, const QList<QRectF>& areas) override;
+
+private:
+    void slotChanged();
 };
 
 #endif //CGISDRAW_H
@@ -292,7 +292,15 @@ bool CGisListDB::event(QEvent* e)
             if(evt->updateLostFound)
             {
                 folder->updateLostFound();
-                folder->announceChange();
+
+                QList<IDBFolderSql::change_t> changes;
+                changes << IDBFolderSql::change_t {IDBFolderSql::eChangeFolder, evt->id};
+                for(quint64 idItem : qAsConst(evt->idItemsChanged))
+                {
+                    changes << IDBFolderSql::change_t {IDBFolderSql::eChangeItem, idItem};
+                }
+                changes << IDBFolderSql::change_t {IDBFolderSql::eChangeLostFound, 0};
+                folder->announceChange(changes);
             }
         }
         e->accept();
@@ -329,7 +337,7 @@ bool CGisListDB::event(QEvent* e)
                 CGisWorkspace::self().postEventForWks(evt1);
             }
 
-            db->announceChange();
+            db->announceChange({{IDBFolderSql::eChangeFolder, evt->idParent}});
         }
         e->accept();
         return true;
@@ -504,7 +512,7 @@ void CGisListDB::slotAddFolder()
     IDBFolderSql* dbfolder = folder->getDBFolder();
     if(dbfolder)
     {
-        dbfolder->announceChange();
+        dbfolder->announceChange({{IDBFolderSql::eChangeFolder, folder->getId()}});
     }
 }
 
@@ -529,6 +537,7 @@ void CGisListDB::slotDelFolder()
         return;
     }
 
+    QList<IDBFolderSql::change_t> changes;
     QList<QTreeWidgetItem*> itemsToDelete;
     const QList<QTreeWidgetItem*>& items = selectedItems();
     for(QTreeWidgetItem* item : items)
@@ -540,6 +549,11 @@ void CGisListDB::slotDelFolder()
             continue;
         }
 
+        IDBFolder* parent = dynamic_cast<IDBFolder*>(folder->parent());
+        if(parent != nullptr)
+        {
+            changes << IDBFolderSql::change_t {IDBFolderSql::eChangeFolder, parent->getId()};
+        }
 
         folder->remove();
         // Because some items can be parent of other selected items
@@ -561,7 +575,9 @@ void CGisListDB::slotDelFolder()
     }
 
     dbfolder->updateLostFound();
-    dbfolder->announceChange();
+
+    changes << IDBFolderSql::change_t {IDBFolderSql::eChangeLostFound, 0};
+    dbfolder->announceChange(changes);
 }
 
 void CGisListDB::slotCopyFolder()
@@ -629,7 +645,7 @@ void CGisListDB::slotCopyFolder()
     }
 
     // tell other clients to show changes
-    dbfolder->announceChange();
+    dbfolder->announceChange({{IDBFolderSql::eChangeFolder, idTarget}});
 }
 
 void CGisListDB::slotMoveFolder()
@@ -668,6 +684,7 @@ void CGisListDB::slotMoveFolder()
     // --- at this point we should have all data to perform the copy without interruption ---
 
     // now iterate over all selected items
+    QList<IDBFolderSql::change_t> changes;
     QList<IDBFolder*> foldersToDelete;
     const QList<QTreeWidgetItem*>& items = selectedItems();
     for(QTreeWidgetItem* item : items)
@@ -695,6 +712,7 @@ void CGisListDB::slotMoveFolder()
 
         // copy to new location
         dbfolder->copyFolder(folder->getId(), idTarget);
+        changes << IDBFolderSql::change_t {IDBFolderSql::eChangeFolder, parent->getId()};
         // Because some items can be parent of other selected items
         // it's a bad idea to delete them asap. Better collect them first.
         foldersToDelete << folder;
@@ -721,7 +739,8 @@ void CGisListDB::slotMoveFolder()
         target->update();
     }
     // tell other clients to show changes
-    dbfolder->announceChange();
+    changes << IDBFolderSql::change_t {IDBFolderSql::eChangeFolder, idTarget};
+    dbfolder->announceChange(changes);
 }
 
 void CGisListDB::slotRenameFolder()
@@ -741,6 +760,7 @@ void CGisListDB::slotRenameFolder()
         return;
     }
 
+    QList<IDBFolderSql::change_t> changes;
     const QList<QTreeWidgetItem*>& items = selectedItems();
     for(QTreeWidgetItem* item : items)
     {
@@ -757,11 +777,15 @@ void CGisListDB::slotRenameFolder()
         if(!name2.isEmpty() && (name1 != name2))
         {
             folder->setName(name2);
+            changes << IDBFolderSql::change_t {IDBFolderSql::eChangeFolder, folder->getId()};
         }
     }
 
     // tell other clients to show changes
-    dbfolder->announceChange();
+    if(!changes.isEmpty())
+    {
+        dbfolder->announceChange(changes);
+    }
 }
 
 void CGisListDB::slotDelLostFound()
@@ -785,7 +809,7 @@ void CGisListDB::slotDelLostFound()
     IDBFolderSql* dbfolder = folder->getDBFolder();
     if(dbfolder)
     {
-        dbfolder->announceChange();
+        dbfolder->announceChange({{IDBFolderSql::eChangeLostFound, 0}});
     }
 }
 
@@ -832,7 +856,7 @@ void CGisListDB::slotDelLostFoundItem()
         IDBFolderSql* dbfolder = folder->getDBFolder();
         if(dbfolder)
         {
-            dbfolder->announceChange();
+            dbfolder->announceChange({{IDBFolderSql::eChangeLostFound, 0}});
         }
     }
 }
@@ -860,6 +884,7 @@ void CGisListDB::slotDelItem()
     QSet<IDBFolder*>        folders;
     QList<QTreeWidgetItem*> dbItems;
     QSet<IDBFolderSql*>     dbFolders;
+    QHash<IDBFolderSql*, QList<IDBFolderSql::change_t> > changes;
 
 
     const QList<QTreeWidgetItem*>& items = selectedItems();
@@ -896,13 +921,17 @@ void CGisListDB::slotDelItem()
         folders << folder;
         dbItems << dbItem;
         dbFolders << folder->getDBFolder();
+        changes[folder->getDBFolder()] << IDBFolderSql::change_t {IDBFolderSql::eChangeFolder, folder->getId()};
     }
 
     qDeleteAll(dbItems);
     for(IDBFolderSql* dbFolder : qAsConst(dbFolders))
     {
         dbFolder->updateLostFound();
-        dbFolder->announceChange();
+
+        QList<IDBFolderSql::change_t>& changesDb = changes[dbFolder];
+        changesDb << IDBFolderSql::change_t {IDBFolderSql::eChangeLostFound, 0};
+        dbFolder->announceChange(changesDb);
     }
 
     // tell all folders to update their statistics and waypoint/track correlations
@@ -1035,10 +1064,26 @@ void CGisListDB::slotReadyRead()
         IDBFolderSql* folder = getDataBase(dbName, dbHost);
         if(folder)
         {
-            folder->update();
+            const QList<IDBFolderSql::change_t>& changes = IDBFolderSql::readChanges(stream);
+            if(changes.isEmpty())
+            {
+                // no details, update everything
+                folder->update();
 
-            CEvtD2WReload* evt = new CEvtD2WReload(folder->getDBName());
-            CGisWorkspace::self().postEventForWks(evt);
+                CEvtD2WReload* evt = new CEvtD2WReload(folder->getDBName());
+                CGisWorkspace::self().postEventForWks(evt);
+            }
+            else
+            {
+                // update the affected folders and projects only
+                QSet<quint64> idFolders;
+                folder->applyChanges(changes, idFolders);
+                if(!idFolders.isEmpty())
+                {
+                    CEvtD2WReload* evt = new CEvtD2WReload(folder->getDBName(), idFolders);
+                    CGisWorkspace::self().postEventForWks(evt);
+                }
+            }
         }
     }
 }
@@ -1092,7 +1137,7 @@ void CGisListDB::slotImport()
     if(dbfolder)
     {
         dbfolder->update();
-        dbfolder->announceChange();
+        dbfolder->announceChange({{IDBFolderSql::eChangeFolder, folder->getId()}});
     }
 
     path = QFileInfo(filenames.first()).absolutePath();
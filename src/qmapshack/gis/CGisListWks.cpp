@@ -189,6 +189,12 @@ CGisListWks::CGisListWks(QWidget* parent)
     connect(this, &CGisListWks::itemDoubleClicked, this, &CGisListWks::slotItemDoubleClicked);
     connect(this, &CGisListWks::itemChanged, this, &CGisListWks::slotItemChanged);
 
+    // Any change to a project's subtree makes it subject to the next workspace save.
+    // This catches changes not passing IGisProject::updateDecoration(), too.
+    connect(model(), &QAbstractItemModel::dataChanged, this, [this](const QModelIndex& topLeft){markWksChanged(topLeft);});
+    connect(model(), &QAbstractItemModel::rowsInserted, this, [this](const QModelIndex& parent){markWksChanged(parent);});
+    connect(model(), &QAbstractItemModel::rowsRemoved, this, [this](const QModelIndex& parent){markWksChanged(parent);});
+
     SETTINGS;
     saveOnExit = cfg.value("Database/saveOnExit", saveOnExit).toBool();
     saveEvery = cfg.value("Database/saveEvery", saveEvery).toInt();
@@ -777,6 +783,27 @@ CDBProject* CGisListWks::getProjectById(quint64 id, const QString& db)
     return nullptr;
 }
 
+void CGisListWks::markWksChanged(const QModelIndex& index)
+{
+    if(!index.isValid())
+    {
+        // top level items are handled by their key
+        return;
+    }
+
+    QModelIndex top = index;
+    while(top.parent().isValid())
+    {
+        top = top.parent();
+    }
+
+    IGisProject* project = dynamic_cast<IGisProject*>(itemFromIndex(top));
+    if(nullptr != project)
+    {
+        revisionsInDb.remove(project->getKey());
+    }
+}
+
 void CGisListWks::slotSaveWorkspace()
 {
     CGisListWksEditLock lock(true, IGisItem::mutexItems);
@@ -786,47 +813,103 @@ void CGisListWks::slotSaveWorkspace()
         return;
     }
 
-    QSqlQuery query(db);
-    QUERY_RUN("DELETE FROM workspace", return )
-
     qDebug() << "slotSaveWorkspace()";
 
-    const int total = topLevelItemCount();
-    PROGRESS_SETUP(tr("Saving workspace. Please wait."), 0, total, this);
-
-    for(int i = 0; i < total; i++)
+    // collect all projects changed since the last save
+    QSet<QString> keys;
+    QList<IGisProject*> projects;
+    const int N = topLevelItemCount();
+    for(int i = 0; i < N; i++)
     {
-        PROGRESS(i, return );
-
         IGisProject* project = dynamic_cast<IGisProject*>(topLevelItem(i));
         if(nullptr == project)
         {
             continue;
         }
 
-        QByteArray data;
-        QDataStream stream(&data, QIODevice::WriteOnly);
-        stream.setVersion(QDataStream::Qt_5_2);
-        stream.setByteOrder(QDataStream::LittleEndian);
-
-        project->IGisProject::operator>>(stream);
+        const QString& key = project->getKey();
+        keys << key;
+        if(!revisionsInDb.contains(key) || (revisionsInDb[key] != project->getRevision()))
+        {
+            projects << project;
+        }
+    }
 
-        query.prepare("INSERT INTO workspace (type, keyqms, name, changed, visible, data) VALUES (:type, :keyqms, :name, :changed, :visible, :data)");
-        query.bindValue(":type", project->getType());
-        query.bindValue(":keyqms", project->getKey());
-        query.bindValue(":name", project->getName());
-        query.bindValue(":changed", project->isChanged());
+    QSqlQuery query(db);
+    QUERY_RUN("BEGIN TRANSACTION;", return )
 
-        bool visible = (project->checkState(CGisListDB::eColumnCheckbox) == Qt::Checked);
-        query.bindValue(":visible", visible);
-        query.bindValue(":data", data);
+    // remove closed projects
+    for(const QString& key : keysInDb - keys)
+    {
+        query.prepare("DELETE FROM workspace WHERE keyqms=:keyqms");
+        query.bindValue(":keyqms", key);
         QUERY_EXEC(continue);
+        keysInDb.remove(key);
+        revisionsInDb.remove(key);
     }
 
+    {   // open context for progress dialog
+        const int total = projects.size();
+        PROGRESS_SETUP(tr("Saving workspace. Please wait."), 0, total, this);
+
+        for(int i = 0; i < total; i++)
+        {
+            // already written projects are kept on cancel
+            PROGRESS(i, break);
+
+            IGisProject* project = projects[i];
+            const QString& key = project->getKey();
+
+            QByteArray data;
+            QDataStream stream(&data, QIODevice::WriteOnly);
+            stream.setVersion(QDataStream::Qt_5_2);
+            stream.setByteOrder(QDataStream::LittleEndian);
+
+            project->IGisProject::operator>>(stream);
+
+            if(keysInDb.contains(key))
+            {
+                query.prepare("UPDATE workspace SET type=:type, name=:name, changed=:changed, visible=:visible, data=:data WHERE keyqms=:keyqms");
+            }
+            else
+            {
+                query.prepare("INSERT INTO workspace (type, keyqms, name, changed, visible, data) VALUES (:type, :keyqms, :name, :changed, :visible, :data)");
+            }
+            query.bindValue(":type", project->getType());
+            query.bindValue(":keyqms", key);
+            query.bindValue(":name", project->getName());
+            query.bindValue(":changed", project->isChanged());
+
+            bool visible = (project->checkState(CGisListDB::eColumnCheckbox) == Qt::Checked);
+            query.bindValue(":visible", visible);
+            query.bindValue(":data", data);
+            QUERY_EXEC(continue);
+
+            keysInDb << key;
+            revisionsInDb[key] = project->getRevision();
+        }
+    }   // close context for progress dialog
+
     query.prepare( "UPDATE userfocus set focus=:focus");
     query.bindValue(":focus", IGisProject::getUserFocus());
     QUERY_EXEC();
 
+    if(!query.exec("COMMIT;"))
+    {
+        qWarning() << "Execution of SQL-Statement `" << query.lastQuery() << "` failed:";
+        qWarning() << query.lastError();
+        query.exec("ROLLBACK;");
+
+        // the state of the database is unknown, write everything next time
+        QUERY_RUN("SELECT keyqms FROM workspace", NO_CMD)
+        keysInDb.clear();
+        revisionsInDb.clear();
+        while(query.next())
+        {
+            keysInDb << query.value(0).toString();
+        }
+    }
+
     if(saveEvery)
     {
         QTimer::singleShot(saveEvery * 60000, this, &CGisListWks::slotSaveWorkspace);
@@ -839,8 +922,9 @@ void CGisListWks::slotLoadWorkspace()
 
     QSqlQuery query(db);
 
-    QUERY_RUN("SELECT type, keyqms, name, changed, visible, data FROM workspace", return )
+    QUERY_RUN("SELECT type, keyqms, name, changed, visible, data FROM workspace ORDER BY id", return )
 
+    QList<IGisProject*> projects;
     { // open context for progress dialog
         const int total = query.size();
         PROGRESS_SETUP(tr("Loading workspace. Please wait."), 0, total, this);
@@ -850,6 +934,8 @@ void CGisListWks::slotLoadWorkspace()
         {
             PROGRESS(progCnt++, return );
 
+            keysInDb << query.value(1).toString();
+
             int type = query.value(0).toInt();
             QString name = query.value(2).toString();
             bool changed = query.value(3).toBool();
@@ -965,10 +1051,18 @@ void CGisListWks::slotLoadWorkspace()
                 {
                     project->setChanged();
                 }
+                projects << project;
             }
         }
     } // close context for progress dialog
 
+    // The projects are in the same state as in the database. There is
+    // no need to write them on the next save unless they change.
+    for(const IGisProject* project : qAsConst(projects))
+    {
+        revisionsInDb[project->getKey()] = project->getRevision();
+    }
+
     slotGeoSearch(static_cast<QAction*>(CMainWindow::self().findChild<QAction*>("actionGeoSearch"))->isChecked());
 
     for(const QString& filename : qlOpts->arguments)
@@ -2307,7 +2401,7 @@ bool CGisListWks::event(QEvent* e)
             {
                 CDBProject* project = dynamic_cast<CDBProject*>(topLevelItem(i));
 
-                if(project && (project->getDBName() == evt->db))
+                if(project && (project->getDBName() == evt->db) && (evt->ids.isEmpty() || evt->ids.contains(project->getId())))
                 {
                     project->update();
                     projects << project;
@@ -23,7 +23,9 @@
 #include "gis/prj/IGisProject.h"
 #include "gis/trk/CTrackData.h"
 
+#include <QHash>
 #include <QPointer>
+#include <QSet>
 #include <QSqlDatabase>
 #include <QTreeWidget>
 
@@ -142,6 +144,7 @@ private:
     void migrateDB2to3();
     void migrateDB3to4();
     void setVisibilityOnMap(bool visible);
+    void markWksChanged(const QModelIndex& index);
     QAction* addSortAction(QObject* parent, QActionGroup* actionGroup, const QString& icon, const QString& text, IGisProject::sorting_folder_e mode);
 
     template<typename Func>
@@ -242,6 +245,11 @@ private:
     bool saveOnExit = true;
     qint32 saveEvery = 5;
 
+    /// the keys of all projects stored in the workspace database
+    QSet<QString> keysInDb;
+    /// the project revision last written to the workspace database, by project key
+    QHash<QString, quint32> revisionsInDb;
+
     IDeviceWatcher* deviceWatcher = nullptr;
 
     bool blockSorting = false;
@@ -40,6 +40,9 @@
 #include "gis/search/CGeoSearchWeb.h"
 #include "gis/search/CSearch.h"
 #include "gis/search/CSearchExplanationDialog.h"
+#include "gis/slf/CSlfProject.h"
+#include "gis/slf/CSlfReader.h"
+#include "gis/tcx/CTcxProject.h"
 #include "gis/trk/CCombineTrk.h"
 #include "gis/trk/CGisItemTrk.h"
 #include "gis/wpt/CGisItemWpt.h"
@@ -104,7 +107,11 @@ CGisWorkspace::~CGisWorkspace()
         CGisWorkspace upon destruction to signal the database their destruction.
 
      */
+    isClosing = true;
     delete treeWks;
+
+    // items destroyed later must not report to a deleted workspace
+    pSelf = nullptr;
 }
 
 void CGisWorkspace::slotLateInit()
@@ -154,6 +161,82 @@ void CGisWorkspace::loadGisProject(const QString& filename)
     emit sigChanged();
 }
 
+IGisProject* CGisWorkspace::loadGisProjectQuiet(const QString& filename)
+{
+    const QFileInfo fi(filename);
+    if(!fi.isFile())
+    {
+        throw tr("File '%1' does not exist.").arg(filename);
+    }
+
+    // the projects are created empty by a name without file suffix and
+    // filled by the static loaders that throw instead of showing a message box
+    const QString& name = fi.completeBaseName();
+    const QString& suffix = fi.suffix().toLower();
+
+    QMutexLocker lock(&IGisItem::mutexItems);
+
+    QScopedPointer<IGisProject> project;
+    if(suffix == "gpx")
+    {
+        CGpxProject* gpx = new CGpxProject(name, (CGisListWks*)nullptr);
+        project.reset(gpx);
+        gpx->blockUpdateItems(true);
+        CGpxProject::loadGpx(filename, gpx);
+        gpx->blockUpdateItems(false);
+    }
+    else if(suffix == "tcx")
+    {
+        CTcxProject* tcx = new CTcxProject(name, (CGisListWks*)nullptr);
+        project.reset(tcx);
+        tcx->blockUpdateItems(true);
+        CTcxProject::loadTcx(filename, tcx);
+        tcx->blockUpdateItems(false);
+    }
+    else if(suffix == "slf")
+    {
+        CSlfProject* slf = new CSlfProject(filename, false);
+        project.reset(slf);
+        CSlfReader::readFile(filename, slf);
+    }
+    else if(suffix == "qms")
+    {
+        // the only error CQmsProject reports by message box
+        QFile file(filename);
+        if(!file.open(QIODevice::ReadOnly))
+        {
+            throw tr("Failed to open %1").arg(filename);
+        }
+        file.close();
+        project.reset(new CQmsProject(filename, (CGisListWks*)nullptr));
+    }
+    else
+    {
+        throw tr("File '%1' has an unsupported format.").arg(filename);
+    }
+
+    if(!project->isValid())
+    {
+        throw tr("Failed to load file %1...").arg(filename);
+    }
+
+    if(treeWks->hasProject(project.data()))
+    {
+        throw tr("The project \"%1\" is already in the workspace.").arg(project->getName());
+    }
+
+    treeWks->blockSignals(true);
+    treeWks->addProject(project.data());
+    treeWks->blockSignals(false);
+
+    IGisProject* item = project.take();
+    item->setWorkspaceFilter(currentSearch);
+    lock.unlock();
+
+    emit sigChanged();
+    return item;
+}
+
 
 void CGisWorkspace::slotSetGisLayerOpacity(int val)
 {
@@ -1386,6 +1469,111 @@ void CGisWorkspace::draw(QPainter& p, const QPolygonF& viewport, CGisDraw* gis)
     }
 }
 
+static void collectItems(QTreeWidgetItem* parent, QList<IGisItem*>& items)
+{
+    IGisProject* project = dynamic_cast<IGisProject*>(parent);
+    if(project != nullptr)
+    {
+        if(!project->isVisible())
+        {
+            return;
+        }
+
+        const int N = project->childCount();
+        for(int n = 0; n < N; n++)
+        {
+            IGisItem* item = dynamic_cast<IGisItem*>(project->child(n));
+            if(item != nullptr && !item->isHidden())
+            {
+                items << item;
+            }
+        }
+        return;
+    }
+
+    IDevice* device = dynamic_cast<IDevice*>(parent);
+    if(device != nullptr)
+    {
+        const int N = device->childCount();
+        for(int n = 0; n < N; n++)
+        {
+            collectItems(device->child(n), items);
+        }
+    }
+}
+
+void CGisWorkspace::drawPartial(QPainter& p, const QPolygonF& viewport, const QPolygonF& area, CGisDraw* gis)
+{
+    QFontMetricsF fm(CMainWindow::self().getMapFont());
+    QList<QRectF> blockedAreas;
+
+    QPolygonF tmp = area;
+    gis->convertRad2Px(tmp);
+    const QRectF& rectArea = tmp.boundingRect();
+
+    QMutexLocker lock(&IGisItem::mutexItems);
+
+    /*
+        Collect items in the same order as draw() does. This keeps the
+        stacking of items and the label placement as with a full redraw.
+        Items outside the area are skipped. The painter is clipped to the
+        area anyway.
+     */
+    QList<IGisItem*> items;
+    for(int i = 0; i < treeWks->topLevelItemCount(); i++)
+    {
+        collectItems(treeWks->topLevelItem(i), items);
+    }
+
+    QList<IGisItem*> visibleItems;
+    for(IGisItem* item : qAsConst(items))
+    {
+        const QRectF& rect = item->getBoundingRect();
+
+        QPolygonF poly;
+        poly << rect.topLeft() << rect.topRight() << rect.bottomRight() << rect.bottomLeft();
+        gis->convertRad2Px(poly);
+        const QRectF& rectItem = poly.boundingRect();
+
+        // inclusive test as waypoints have a bounding rectangle of zero size
+        if(rectItem.left() <= rectArea.right() && rectItem.right() >= rectArea.left()
+           && rectItem.top() <= rectArea.bottom() && rectItem.bottom() >= rectArea.top())
+        {
+            visibleItems << item;
+        }
+    }
+
+    // draw mandatory stuff first
+    for(IGisItem* item : qAsConst(visibleItems))
+    {
+        if(gis->needsRedraw())
+        {
+            return;
+        }
+        item->drawItem(p, viewport, blockedAreas, gis);
+    }
+
+    // draw optional labels second
+    for(IGisItem* item : qAsConst(visibleItems))
+    {
+        if(gis->needsRedraw())
+        {
+            return;
+        }
+        item->drawLabel(p, viewport, blockedAreas, fm, gis);
+    }
+}
+
+void CGisWorkspace::changedArea(const QRectF& area)
+{
+    if(pSelf == nullptr || pSelf->isClosing || area == QRectF())
+    {
+        return;
+    }
+
+    emit pSelf->sigChangedArea(area);
+}
+
 void CGisWorkspace::fastDraw(QPainter& p, const QRectF& viewport, CGisDraw* gis)
 {
     /*
@@ -150,6 +150,8 @@ public:
     QString db;
     QString host;
     QSet<QString> keysChildren;
+    /// IDs of items written to the database
+    QSet<quint64> idItemsChanged;
 };
 
 class CEvtD2WUpdateLnF : public QEvent
@@ -202,7 +204,13 @@ public:
     {
     }
 
+    CEvtD2WReload(const QString& db, const QSet<quint64>& ids) : QEvent(QEvent::Type(eEvtD2WReload)), db(db), ids(ids)
+    {
+    }
+
     QString db;
+    /// the IDs of the projects to reload. All projects of the database if empty.
+    QSet<quint64> ids;
 };
 
 
@@ -248,6 +256,19 @@ public:
     virtual ~CGisWorkspace();
 
     void loadGisProject(const QString& filename);
+    /**
+       @brief Load a GIS file without any user interaction
+
+       Unlike loadGisProject() no message box is shown. Only the formats with a loader
+       reporting errors by exception are supported: GPX, TCX, QMS and SLF.
+
+       Throws a QString with an error message if the file can't be loaded or if the
+       project is already in the workspace.
+
+       @param filename  the GIS file
+       @return The project added to the workspace.
+     */
+    IGisProject* loadGisProjectQuiet(const QString& filename);
     /**
        @brief Draw all loaded data in the workspace that is visible
 
@@ -279,6 +300,34 @@ public:
      */
     void fastDraw(QPainter& p, const QRectF& viewport, CGisDraw* gis);
 
+    /**
+       @brief Draw all items close to a part of the viewport
+
+       Like draw() but only items with a bounding rectangle intersecting the area
+       are drawn. This is used to redraw invalidated areas of the GIS buffer. The
+       items are drawn with the complete viewport to get the same result as with
+       draw(). The painter is expected to be clipped to the area.
+
+       This method is called from the CGisDraw thread.
+
+       @param p         the painter to be used
+       @param viewport  the viewport in units of rad
+       @param area      the area to redraw in units of rad
+       @param gis       the draw context to be used
+     */
+    void drawPartial(QPainter& p, const QPolygonF& viewport, const QPolygonF& area, CGisDraw* gis);
+
+    /**
+       @brief Report an area on the map that has to be redrawn
+
+       Items report their area when they change or are removed. It's safe to
+       call this before the workspace exists, while it is destroyed or after it
+       is gone. Areas reported while the workspace is destroyed are dropped.
+
+       @param area      the area in units of rad
+     */
+    static void changedArea(const QRectF& area);
+
     /**
        @brief Get items close to the given point
 
@@ -461,6 +510,7 @@ public:
 
 signals:
     void sigChanged();
+    void sigChangedArea(const QRectF& area);
 
 public slots:
     void slotLateInit();
@@ -481,6 +531,9 @@ private:
 
     static CGisWorkspace* pSelf;
 
+    /// set true while the workspace and it's items are destroyed
+    bool isClosing = false;
+
     /**
         The item key of last item pressed in the workspace list.
         The key will be reset by getItemsByPos() which is used by
@@ -145,6 +145,7 @@ IGisItem::IGisItem(IGisProject* parent, type_e typ, int idx)
 
 IGisItem::~IGisItem()
 {
+    CGisWorkspace::changedArea(areaOnMap);
 }
 
 
@@ -331,6 +332,11 @@ QString IGisItem::getNameEx() const
 
 void IGisItem::updateDecoration(quint32 enable, quint32 disable)
 {
+    // the old and the new area of the item have to be redrawn
+    CGisWorkspace::changedArea(areaOnMap);
+    areaOnMap = getBoundingRect();
+    CGisWorkspace::changedArea(areaOnMap);
+
     // update text and icon
     setToolTip(CGisListWks::eColumnName, getInfo(IGisItem::eFeatureShowName));
     setText(CGisListWks::eColumnName, getName());
@@ -649,6 +649,8 @@ protected:
     QPixmap displayIcon;
     /// the dimensions of the item
     QRectF boundingRect;
+    /// the dimensions last reported to the workspace for a redraw
+    QRectF areaOnMap;
     /// that's where the real data is. An item is completely defined by it's history
     history_t history;
     /// the hash in the database when the item was loaded/saved
@@ -215,10 +215,11 @@ void CDBProject::setupName(const QString& defaultName)
 }
 
 
-void CDBProject::postStatus(bool updateLostFound)
+void CDBProject::postStatus(bool updateLostFound, const QSet<quint64>& idItemsChanged)
 {
     // collect the keys of all child items and post them to the database view
     CEvtW2DAckInfo* info = new CEvtW2DAckInfo(getId(), getDBName(), getDBHost());
+    info->idItemsChanged = idItemsChanged;
 
     bool changedItems = false;
     const int N = childCount();
@@ -560,6 +561,7 @@ bool CDBProject::save(CSelectSaveAction::result_e action1ForAll, action_e action
     QSqlQuery query(db);
     bool stop = false;
     bool success = true;
+    QSet<quint64> idItemsChanged;
 
     // check if project is still part of the database
     query.prepare("SELECT keyqms FROM folders WHERE id=:id");
@@ -633,6 +635,11 @@ bool CDBProject::save(CSelectSaveAction::result_e action1ForAll, action_e action
                 QUERY_EXEC(throw eReasonQueryFail);
             }
             item->updateDecoration(IGisItem::eMarkNone, IGisItem::eMarkChanged | IGisItem::eMarkNotPart | IGisItem::eMarkNotInDB);
+
+            if(idItem != 0)
+            {
+                idItemsChanged << idItem;
+            }
         }
         catch(reasons_e reason)
         {
@@ -673,7 +680,7 @@ bool CDBProject::save(CSelectSaveAction::result_e action1ForAll, action_e action
     query.bindValue(":id", getId());
     QUERY_EXEC(return false);
 
-    postStatus(true);
+    postStatus(true, idItemsChanged);
     // update change flag
     updateDecoration();
     return success;
@@ -99,8 +99,11 @@ public:
 
     /**
        @brief Send a CEvtW2DAckInfo event to the database view
+
+       @param updateLostFound   set true if the database content has been changed
+       @param idItemsChanged    the IDs of items written to the database
      */
-    void postStatus(bool updateLostFound);
+    void postStatus(bool updateLostFound, const QSet<quint64>& idItemsChanged = QSet<quint64>());
 
     /**
        @brief Load items from the database into the project
@@ -265,6 +265,16 @@ void IDBFolder::update(CEvtW2DAckInfo* info)
 }
 
 bool IDBFolder::update()
+{
+    return updateFolder(true);
+}
+
+bool IDBFolder::updateShallow()
+{
+    return updateFolder(false);
+}
+
+bool IDBFolder::updateFolder(bool recursive)
 {
     QSqlQuery query(db);
 
@@ -338,8 +348,9 @@ bool IDBFolder::update()
         IDBFolder* dbFolder = dynamic_cast<IDBFolder*>(item);
         if(dbFolder != nullptr)
         {
-            dbFoldersAdd.removeAll(dbFolder->getId());
-            if(dbFolder->update() == false)
+            // without recursion it is sufficient to know if the folder is still attached
+            const bool isAttached = dbFoldersAdd.removeAll(dbFolder->getId()) != 0;
+            if(recursive ? (dbFolder->update() == false) : !isAttached)
             {
                 dbFoldersDel << dbFolder;
             }
@@ -110,6 +110,14 @@ public:
      */
     virtual bool update();
 
+    /**
+     * @brief Update this folder only from database
+     *
+     * Like update() but expanded sub-folders are not updated. They are just
+     * removed if they are no longer attached to this folder.
+     */
+    bool updateShallow();
+
     /**
      * @brief Toggle check state of project and post event to workspace.
      */
@@ -175,6 +183,14 @@ public:
     void exportToGpx();
 
 protected:
+    /**
+       @brief Update from database
+
+       @param recursive if true all expanded sub-folders are updated, too
+       @return False if the folder is no longer in the database or on errors
+     */
+    virtual bool updateFolder(bool recursive);
+
     /**
        @brief Setup all item properties
 
@@ -26,6 +26,9 @@
 #include <QtNetwork>
 #include <QtSql>
 
+/// the maximum number of changes sent with an announcement
+static constexpr int maxChanges = 1000;
+
 IDBFolderSql::IDBFolderSql(QSqlDatabase& db, QTreeWidget* parent)
     : IDBFolder(false, db, eTypeDatabase, 1, parent)
 {
@@ -52,6 +55,11 @@ void IDBFolderSql::updateLostFound()
 }
 
 bool IDBFolderSql::update()
+{
+    return updateFolder(true);
+}
+
+bool IDBFolderSql::updateFolder(bool recursive)
 {
     QSqlQuery query(db);
     QList<IDBFolder*> dbFoldersDel;
@@ -86,8 +94,8 @@ bool IDBFolderSql::update()
         IDBFolder* folder = dynamic_cast<IDBFolder*>(child(i));
         if(folder)
         {
-            dbFoldersAdd.removeAll(folder->getId());
-            if(!folder->update())
+            const bool isAttached = dbFoldersAdd.removeAll(folder->getId()) != 0;
+            if(recursive ? !folder->update() : !isAttached)
             {
                 dbFoldersDel << folder;
             }
@@ -118,7 +126,7 @@ bool IDBFolderSql::update()
     return true;
 }
 
-void IDBFolderSql::announceChange() const
+void IDBFolderSql::announceChange(const QList<change_t>& changes) const
 {
     SETTINGS;
     bool enabled = cfg.value("Database/listenUpdate", false).toBool();
@@ -143,6 +151,18 @@ void IDBFolderSql::announceChange() const
     stream << getDBName();
     stream << getDBHost();
 
+    // Append the changes. Older versions will ignore them and
+    // update everything. Too many changes will do the same as
+    // the message has to fit into a single datagram.
+    if(changes.size() <= maxChanges)
+    {
+        stream << quint32(changes.size());
+        for(const change_t& change : changes)
+        {
+            stream << quint8(change.kind) << change.id;
+        }
+    }
+
     const QList<QNetworkInterface>& netdevices = QNetworkInterface::allInterfaces();
     for(const QNetworkInterface& netdevice : netdevices)
     {
@@ -155,3 +175,87 @@ void IDBFolderSql::announceChange() const
         }
     }
 }
+
+QList<IDBFolderSql::change_t> IDBFolderSql::readChanges(QDataStream& stream)
+{
+    QList<change_t> changes;
+    if(stream.atEnd())
+    {
+        return changes;
+    }
+
+    quint32 N;
+    stream >> N;
+    for(quint32 n = 0; (n < N) && (stream.status() == QDataStream::Ok); n++)
+    {
+        quint8 kind;
+        quint64 id;
+        stream >> kind >> id;
+        changes << change_t {change_e(kind), id};
+    }
+
+    if(stream.status() != QDataStream::Ok)
+    {
+        // a broken message, better update everything
+        changes.clear();
+    }
+
+    return changes;
+}
+
+void IDBFolderSql::applyChanges(const QList<change_t>& changes, QSet<quint64>& idFolders)
+{
+    QSqlQuery query(db);
+
+    bool updateLF = false;
+    for(const change_t& change : changes)
+    {
+        switch(change.kind)
+        {
+        case eChangeFolder:
+            idFolders << change.id;
+            break;
+
+        case eChangeItem:
+            // all folders the item is attached to are affected
+            query.prepare("SELECT parent FROM folder2item WHERE child=:child");
+            query.bindValue(":child", change.id);
+            QUERY_EXEC(continue);
+            while(query.next())
+            {
+                idFolders << query.value(0).toULongLong();
+            }
+            break;
+
+        case eChangeLostFound:
+            updateLF = true;
+            break;
+        }
+    }
+
+    for(quint64 idFolder : qAsConst(idFolders))
+    {
+        // folders not shown in the tree have nothing to update
+        IDBFolder* folder = getFolder(idFolder);
+        if((folder == nullptr) || (folder == folderLostFound))
+        {
+            continue;
+        }
+
+        if(folder == this)
+        {
+            updateFolder(false);
+            continue;
+        }
+
+        if(!folder->updateShallow())
+        {
+            delete folder;
+        }
+    }
+
+    if(updateLF)
+    {
+        updateLostFound();
+    }
+}
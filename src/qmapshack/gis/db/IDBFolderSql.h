@@ -40,11 +40,46 @@ public:
     }
     bool update() override;
 
-    void announceChange() const;
+    enum change_e
+    {
+        eChangeFolder = 1       ///< properties, sub-folders or items of a folder changed
+        , eChangeItem = 2       ///< the data of an item changed
+        , eChangeLostFound = 3  ///< the content of lost & found changed
+    };
+
+    struct change_t
+    {
+        change_e kind;
+        quint64 id;     ///< the folder or item ID, not used for eChangeLostFound
+    };
+
+    /**
+       @brief Tell other instances working on the same database about changes
+
+       An empty list of changes will make the receivers update all folders
+       and all projects loaded from the database. This is also done by instances
+       not knowing about the list of changes.
+
+       @param changes   the list of changes
+     */
+    void announceChange(const QList<change_t>& changes) const;
+
+    /**
+       @brief Update the folders affected by changes announced by another instance
+
+       @param changes       the list of changes
+       @param idFolders     the IDs of all folders affected by the changes
+     */
+    void applyChanges(const QList<change_t>& changes, QSet<quint64>& idFolders);
+
+    /// read the changes appended to an announcement. An empty list means "all changed".
+    static QList<change_t> readChanges(QDataStream& stream);
 
     virtual void copyFolder(quint64 child, quint64 parent) = 0;
 
 protected:
+    bool updateFolder(bool recursive) override;
+
     CDBFolderLostFound* folderLostFound = nullptr;
 
     QUdpSocket* socket;
@@ -1090,6 +1090,9 @@ void IGisProject::updateDecoration()
 
 void IGisProject::updateDecoration(bool saved)
 {
+    // all changes and saves end up here
+    ++revision;
+
     QString str = autoSave ? "A" : saved ? "" : "*";
     if(autoSyncToDev)
     {
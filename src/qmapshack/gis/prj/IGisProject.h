@@ -455,6 +455,18 @@ public:
      */
     bool isChanged() const;
 
+    /**
+       @brief Get a counter increased with each change of the project's state
+
+       The workspace uses it to tell projects changed since the last autosave.
+
+       @return The current revision.
+     */
+    quint32 getRevision() const
+    {
+        return revision;
+    }
+
     void drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>& blockedAreas, CGisDraw* gis);
     void drawLabel(QPainter& p, const QPolygonF& viewport, QList<QRectF>& blockedAreas, const QFontMetricsF& fm, CGisDraw* gis);
     void drawItem(QPainter& p, const QRectF& viewport, CGisDraw* gis);
@@ -618,6 +630,7 @@ protected:
     bool invalidDataOk = false;          ///< if set invalid data in GIS items will not raise any dialog
     bool autoSyncToDev = false;          ///< if set true sync the project with every device connected
     bool autoSyncToDevPending = false;   ///< flag to show that a sync to device is already pending
+    quint32 revision = 0;                ///< increased by updateDecoration() with each change
 
     metadata_t metadata;
     QString nameSuffix;
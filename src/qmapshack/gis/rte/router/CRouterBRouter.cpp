@@ -369,90 +369,161 @@ int CRouterBRouter::synchronousRequest(const QVector<QPointF>& points, const QLi
         //Processing userinputevents in local eventloop would cause a SEGV when clicking 'abort' of calling LineOp
         eventLoop.exec(QEventLoop::ExcludeUserInputEvents);
 
-        const QNetworkReply::NetworkError& netErr = reply->error();
-        if (netErr == QNetworkReply::RemoteHostClosedError && nogos.size() > 1 && !isMinimumVersion(1, 4, 10))
-        {
-            throw tr("this version of BRouter does not support more then 1 nogo-area");
-        }
-        else if(netErr != QNetworkReply::NoError)
+        readRoute(reply, nogos.size(), coords, costs);
+    }
+    catch(const QString& msg)
+    {
+        coords.clear();
+        if(!msg.isEmpty())
         {
-            throw reply->errorString();
+            reply->deleteLater();
+            mutex.unlock();
+            throw tr("Bad response from server: %1").arg(msg);
         }
-        slotClearError();
+    }
 
-        const QByteArray& res = reply->readAll();
+    reply->deleteLater();
+    slotCloseStatusMsg();
+    mutex.unlock();
+    return coords.size();
+}
 
-        if(res.isEmpty())
-        {
-            throw tr("response is empty");
-        }
+void CRouterBRouter::readRoute(QNetworkReply* reply, int nogos, QPolygonF& coords, qreal* costs)
+{
+    const QNetworkReply::NetworkError& netErr = reply->error();
+    if (netErr == QNetworkReply::RemoteHostClosedError && nogos > 1 && !isMinimumVersion(1, 4, 10))
+    {
+        throw tr("this version of BRouter does not support more then 1 nogo-area");
+    }
+    else if(netErr != QNetworkReply::NoError)
+    {
+        throw reply->errorString();
+    }
+    slotClearError();
 
-        QDomDocument xml;
-        xml.setContent(res);
-        const QDomElement& xmlGpx = xml.documentElement();
+    const QByteArray& res = reply->readAll();
 
-        if(xmlGpx.isNull() || xmlGpx.tagName() != "gpx")
-        {
-            throw QString(res);
-        }
-        setup->parseBRouterVersion(xmlGpx.attribute("creator"));
+    if(res.isEmpty())
+    {
+        throw tr("response is empty");
+    }
 
-        // read the shape
-        const QDomNodeList& xmlLatLng = xmlGpx.firstChildElement("trk")
-                                        .firstChildElement("trkseg")
-                                        .elementsByTagName("trkpt");
-        for(int n = 0; n < xmlLatLng.size(); n++)
-        {
-            const QDomElement& elem = xmlLatLng.item(n).toElement();
-            coords << QPointF();
-            QPointF& point = coords.last();
-            point.setX(elem.attribute("lon").toFloat() * DEG_TO_RAD);
-            point.setY(elem.attribute("lat").toFloat() * DEG_TO_RAD);
-        }
+    QDomDocument xml;
+    xml.setContent(res);
+    const QDomElement& xmlGpx = xml.documentElement();
+
+    if(xmlGpx.isNull() || xmlGpx.tagName() != "gpx")
+    {
+        throw QString(res);
+    }
+    setup->parseBRouterVersion(xmlGpx.attribute("creator"));
 
-        //find costs of route (copied and adapted from CGisItemRte::setResultFromBrouter)
-        if(costs != nullptr)
+    // read the shape
+    const QDomNodeList& xmlLatLng = xmlGpx.firstChildElement("trk")
+                                    .firstChildElement("trkseg")
+                                    .elementsByTagName("trkpt");
+    for(int n = 0; n < xmlLatLng.size(); n++)
+    {
+        const QDomElement& elem = xmlLatLng.item(n).toElement();
+        coords << QPointF();
+        QPointF& point = coords.last();
+        point.setX(elem.attribute("lon").toFloat() * DEG_TO_RAD);
+        point.setY(elem.attribute("lat").toFloat() * DEG_TO_RAD);
+    }
+
+    //find costs of route (copied and adapted from CGisItemRte::setResultFromBrouter)
+    if(costs != nullptr)
+    {
+        const QDomNodeList& nodes = xml.childNodes();
+        for (int i = 0; i < nodes.count(); i++)
         {
-            const QDomNodeList& nodes = xml.childNodes();
-            for (int i = 0; i < nodes.count(); i++)
+            const QDomNode& node = nodes.at(i);
+            if (!node.isComment())
             {
-                const QDomNode& node = nodes.at(i);
-                if (!node.isComment())
-                {
-                    continue;
-                }
-                const QString& commentTxt = node.toComment().data();
-                // ' track-length = 180864 filtered ascend = 428 plain-ascend = -172 cost=270249 '
-                const QRegExp rxAscDes("(\\s*track-length\\s*=\\s*)(-?\\d+)(\\s*)(filtered ascend\\s*=\\s*-?\\d+)(\\s*)(plain-ascend\\s*=\\s*-?\\d+)(\\s*)(cost\\s*=\\s*)(-?\\d+)(\\s*)");
-                int pos = rxAscDes.indexIn(commentTxt);
-                if (pos > -1)
+                continue;
+            }
+            const QString& commentTxt = node.toComment().data();
+            // ' track-length = 180864 filtered ascend = 428 plain-ascend = -172 cost=270249 '
+            const QRegExp rxAscDes("(\\s*track-length\\s*=\\s*)(-?\\d+)(\\s*)(filtered ascend\\s*=\\s*-?\\d+)(\\s*)(plain-ascend\\s*=\\s*-?\\d+)(\\s*)(cost\\s*=\\s*)(-?\\d+)(\\s*)");
+            int pos = rxAscDes.indexIn(commentTxt);
+            if (pos > -1)
+            {
+                bool ok;
+                *costs = rxAscDes.cap(9).toDouble(&ok);
+                if(!ok)
                 {
-                    bool ok;
-                    *costs = rxAscDes.cap(9).toDouble(&ok);
-                    if(!ok)
-                    {
-                        *costs = -1;
-                    }
+                    *costs = -1;
                 }
-                break;
             }
+            break;
         }
     }
+}
+
+bool CRouterBRouter::calcRouteAsync(quint64 id, const QPointF& p1, const QPointF& p2)
+{
+    if(!hasFastRouting())
+    {
+        return false;
+    }
+
+    if (localBRouter->isBRouterNotRunning())
+    {
+        localBRouter->startBRouter();
+    }
+
+    const QVector<QPointF> points = {p1* RAD_TO_DEG, p2 * RAD_TO_DEG};
+
+    QList<IGisItem*> nogos;
+    CGisWorkspace::self().getNogoAreas(nogos);
+
+    // the requests are independent of each other, no need to lock the mutex
+    QNetworkReply* reply = networkAccessManager->get(getRequest(points, nogos));
+    reply->setProperty("async.id", id);
+    reply->setProperty("nogos", nogos.size());
+    repliesAsync[id] = reply;
+
+    return true;
+}
+
+void CRouterBRouter::cancelRouteAsync(quint64 id)
+{
+    QNetworkReply* reply = repliesAsync.take(id);
+    if(reply != nullptr)
+    {
+        reply->abort();
+    }
+}
+
+void CRouterBRouter::asyncRequestFinished(QNetworkReply* reply)
+{
+    reply->deleteLater();
+
+    const quint64 id = reply->property("async.id").toULongLong();
+    if(repliesAsync.remove(id) == 0)
+    {
+        // canceled
+        return;
+    }
+
+    QPolygonF coords;
+    QString error;
+    qreal costs = -1;
+    try
+    {
+        readRoute(reply, reply->property("nogos").toInt(), coords, &costs);
+    }
     catch(const QString& msg)
     {
         coords.clear();
+        costs = -1;
         if(!msg.isEmpty())
         {
-            reply->deleteLater();
-            mutex.unlock();
-            throw tr("Bad response from server: %1").arg(msg);
+            error = tr("Bad response from server: %1").arg(msg);
         }
     }
 
-    reply->deleteLater();
-    slotCloseStatusMsg();
-    mutex.unlock();
-    return coords.size();
+    emit sigRouteFinished(id, coords, error, costs);
 }
 
 void CRouterBRouter::calcRoute(const IGisItem::key_t& key)
@@ -506,6 +577,12 @@ void CRouterBRouter::calcRoute(const IGisItem::key_t& key)
 
 void CRouterBRouter::slotRequestFinished(QNetworkReply* reply)
 {
+    if(reply->property("async.id").isValid())
+    {
+        asyncRequestFinished(reply);
+        return;
+    }
+
     if (synchronous)
     {
         return;
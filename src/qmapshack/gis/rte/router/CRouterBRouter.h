@@ -23,6 +23,7 @@
 #include "gis/rte/router/IRouter.h"
 #include "ui_IRouterBRouter.h"
 
+#include <QHash>
 #include <QNetworkAccessManager>
 #include <QProcess>
 #include <QTimer>
@@ -48,6 +49,8 @@ public:
 
     void calcRoute(const IGisItem::key_t& key) override;
     int calcRoute(const QPointF& p1, const QPointF& p2, QPolygonF& coords, qreal* costs = nullptr) override;
+    bool calcRouteAsync(quint64 id, const QPointF& p1, const QPointF& p2) override;
+    void cancelRouteAsync(quint64 id) override;
     bool hasFastRouting() override;
     QString getOptions() override;
     void routerSelected() override;
@@ -75,6 +78,18 @@ private:
     bool isMinimumVersion(int major, int minor, int patch) const;
     void updateBRouterStatus() const;
     int synchronousRequest(const QVector<QPointF>& points, const QList<IGisItem*>& nogos, QPolygonF& coords, qreal* costs);
+    /**
+       @brief Read the route from a finished request
+
+       Throws a QString on errors.
+
+       @param reply     the finished request
+       @param nogos     the number of nogo areas sent with the request
+       @param coords    the route [rad]
+       @param costs     if not nullptr it will receive the costs of the route
+     */
+    void readRoute(QNetworkReply* reply, int nogos, QPolygonF& coords, qreal* costs);
+    void asyncRequestFinished(QNetworkReply* reply);
     QNetworkRequest getRequest(const QVector<QPointF>& routePoints, const QList<IGisItem*>& nogos) const;
     QUrl getServiceUrl() const;
 
@@ -83,6 +98,8 @@ private:
     QNetworkAccessManager* networkAccessManager;
     QTimer* timerCloseStatusMsg;
     bool synchronous = false;
+    /// the pending requests of calcRouteAsync()
+    QHash<quint64, QNetworkReply*> repliesAsync;
     QMutex mutex {QMutex::NonRecursive};
     CRouterBRouterSetup* setup;
     CRouterSetup* routerSetup;
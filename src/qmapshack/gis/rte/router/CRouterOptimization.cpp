@@ -17,10 +17,24 @@
 **********************************************************************************************/
 
 #include "CRouterOptimization.h"
-#include "gis/GeoMath.h"
 #include "gis/rte/router/CRouterSetup.h"
 #include "helpers/CProgressDialog.h"
 
+#include <QtCore>
+#include <numeric>
+
+/// the costs of a leg that can't be routed
+constexpr qreal costsNoRoute = 1e12;
+
+uint qHash(const CRouterOptimization::leg_t& leg, uint seed)
+{
+    seed = qHash(leg.from.x(), seed);
+    seed = qHash(leg.from.y(), seed);
+    seed = qHash(leg.to.x(), seed);
+    seed = qHash(leg.to.y(), seed);
+    return seed;
+}
+
 CRouterOptimization::CRouterOptimization()
 {
     routerOptions = CRouterSetup::self().getOptions();
@@ -38,66 +52,68 @@ int CRouterOptimization::optimize(SGisLine& line)
         return 0; //There is nothing to optimize
     }
 
-    CProgressDialog progress(tr("Optimizing route"), 0, line.length() + 2, nullptr);
+    QVector<QPointF> points;
+    points.reserve(line.length());
+    for(const IGisLine::point_t& pt : qAsConst(line))
+    {
+        points << pt.coord;
+    }
 
-    //Optimize using air distance and known distances, since this is much faster than routing, especially brouter
-    SGisLine newAirdistanceOrder;
-    SGisLine oldAirdistanceOrder = line;
-    qreal gain = createNextBestOrder(oldAirdistanceOrder, newAirdistanceOrder);
-    while(gain < 0)
+    // Route all legs first. The search itself is fast enough to work on exact costs.
+    costs_t costs;
+    if(!getCostMatrix(points, costs))
     {
-        oldAirdistanceOrder = newAirdistanceOrder;
-        gain = createNextBestOrder(oldAirdistanceOrder, newAirdistanceOrder);
+        return -1;
     }
-    //Do routing and calculate cost for order found
-    qreal airdistanceOrderCosts = getRealRouteCosts(oldAirdistanceOrder);
 
-    progress.setValue(1);
+    const QVector<qint32>& order = optimizeOrder(costs);
 
-    //Do routing and calculate costs of the order the user supplied
-    //cancel the route calculation when the cost of the airdistance order is reached
-    qreal givenOrderCosts = getRealRouteCosts(line, airdistanceOrderCosts);
-    if(givenOrderCosts < 0 && airdistanceOrderCosts < 0)
+    SGisLine newOrder;
+    for(qint32 idx : order)
     {
-        return -1;
+        newOrder << line[idx];
     }
+    line = newOrder;
 
-    //determine starting order for optimization
-    qreal bestCosts = NOINT;
-    if(givenOrderCosts > 0 && givenOrderCosts < airdistanceOrderCosts)
+    return fillSubPts(line);
+}
+
+QVector<qint32> CRouterOptimization::optimizeOrder(const costs_t& costs)
+{
+    const qint32 N = costs.size();
+
+    QVector<qint32> givenOrder(N);
+    std::iota(givenOrder.begin(), givenOrder.end(), 0);
+    if(N < 4)
     {
-        bestCosts = givenOrderCosts;
+        return givenOrder; //There is nothing to optimize
     }
-    else
+
+    // Insert points at their best position until there is no gain anymore
+    QVector<qint32> newOrder;
+    QVector<qint32> oldOrder = givenOrder;
+    while(createNextBestOrder(costs, oldOrder, newOrder) < 0)
     {
-        bestCosts = airdistanceOrderCosts;
-        //the old order is the "optimal" one, since the new one didn't have a gain<0
-        line = oldAirdistanceOrder;
-        fillSubPts(line);
+        oldOrder = newOrder;
     }
-    progress.setValue(2);
 
-    SGisLine lastWorkingOrder = line;
+    QVector<qint32> bestOrder = oldOrder;
+    qreal bestCosts = getCosts(costs, bestOrder);
+
+    QVector<qint32> lastWorkingOrder = bestOrder;
     qreal lastWorkingOrderCosts = bestCosts;
     int numOfRestarts = 0;
     // The number of needed starting permutations is somewhat arbitrary,
     // but you'd likely need more to find the global optimum if there are more possibilities
-    while(numOfRestarts < line.length())
+    while(numOfRestarts < N)
     {
-        progress.setValue(numOfRestarts + 2);
-        if(progress.wasCanceled())
-        {
-            return -1;
-        }
-
-        SGisLine newWorkingOrder;
-        qreal bestInsertionGain = createNextBestOrder(lastWorkingOrder, newWorkingOrder);
+        QVector<qint32> newWorkingOrder;
+        qreal bestInsertionGain = createNextBestOrder(costs, lastWorkingOrder, newWorkingOrder);
 
         if(bestInsertionGain < 0)
         {
-            qreal newWorkingOrderCosts = getRealRouteCosts(newWorkingOrder, lastWorkingOrderCosts);
-
-            if(newWorkingOrderCosts > 0 && newWorkingOrderCosts < lastWorkingOrderCosts)
+            qreal newWorkingOrderCosts = getCosts(costs, newWorkingOrder);
+            if(newWorkingOrderCosts < lastWorkingOrderCosts)
             {
                 lastWorkingOrder = newWorkingOrder;
                 lastWorkingOrderCosts = newWorkingOrderCosts;
@@ -105,11 +121,7 @@ int CRouterOptimization::optimize(SGisLine& line)
                 if(newWorkingOrderCosts < bestCosts)
                 {
                     bestCosts = newWorkingOrderCosts;
-                    line = newWorkingOrder;
-
-                    // Do this every time, since changes to the line are displayed and the data is available anyways.
-                    // Gives a nice animation on screen if the subpoints are displayed aswell.
-                    fillSubPts(line);
+                    bestOrder = newWorkingOrder;
                 }
             }
         }
@@ -117,24 +129,54 @@ int CRouterOptimization::optimize(SGisLine& line)
         {
             numOfRestarts += 1;
             //We accept any order that is produced, as we want to escape from the local optimum
-            twoOptStep(lastWorkingOrder, newWorkingOrder);
+            twoOptStep(costs, lastWorkingOrder, newWorkingOrder);
             lastWorkingOrder = newWorkingOrder;
-            lastWorkingOrderCosts = getRealRouteCosts(lastWorkingOrder);
+            lastWorkingOrderCosts = getCosts(costs, lastWorkingOrder);
         }
     }
 
-    //Do this a last time, since it happens that the route is already optimal.
-    //Return the return value as this is the last point the code may fail for some odd reason
-    return fillSubPts(line);
+    // Polish the result with 2-opt and or-opt. As only improving moves are
+    // applied the result can't get worse than the one of the insertion search.
+    improveLocal(costs, bestOrder);
+    bestCosts = getCosts(costs, bestOrder);
+
+    // Iterated local search: kick the best order out of its local optimum and
+    // descend again. A fixed seed keeps the result reproducible.
+    quint32 seed = 1;
+    for(int i = 0; i < N; i++)
+    {
+        QVector<qint32> order = bestOrder;
+        perturb(order, seed);
+        improveLocal(costs, order);
+
+        const qreal orderCosts = getCosts(costs, order);
+        if(orderCosts < bestCosts)
+        {
+            bestCosts = orderCosts;
+            bestOrder = order;
+        }
+    }
+
+    return bestOrder;
+}
+
+qreal CRouterOptimization::getCosts(const costs_t& costs, const QVector<qint32>& order)
+{
+    qreal sum = 0;
+    for(int i = 0; i < order.size() - 1; i++)
+    {
+        sum += costs[order[i]][order[i + 1]];
+    }
+    return sum;
 }
 
-qreal CRouterOptimization::createNextBestOrder(const SGisLine& oldOrder, SGisLine& newOrder)
+qreal CRouterOptimization::createNextBestOrder(const costs_t& costs, const QVector<qint32>& oldOrder, QVector<qint32>& newOrder)
 {
     qreal bestInsertionGain = 0;
     int bestBaseIndex = -1;
     int bestInsertedItemIndex = -1;
 
-    // lastWorkingOrder.length()-2, since we can't use the last two items as base
+    // oldOrder.length()-2, since we can't use the last two items as base
     for(int baseIndex = 0; baseIndex < oldOrder.length() - 2; baseIndex++)
     {
         // Keep start and end fixed
@@ -145,12 +187,18 @@ qreal CRouterOptimization::createNextBestOrder(const SGisLine& oldOrder, SGisLin
                 continue;
             }
 
-            qreal insertionGain = bestKnownDistance(oldOrder[baseIndex], oldOrder[insertedItemIndex])
-                                  + bestKnownDistance(oldOrder[insertedItemIndex], oldOrder[baseIndex + 1])
-                                  - bestKnownDistance(oldOrder[baseIndex], oldOrder[baseIndex + 1])
-                                  + bestKnownDistance(oldOrder[insertedItemIndex - 1], oldOrder[insertedItemIndex + 1])
-                                  - bestKnownDistance(oldOrder[insertedItemIndex - 1], oldOrder[insertedItemIndex])
-                                  - bestKnownDistance(oldOrder[insertedItemIndex], oldOrder[insertedItemIndex + 1]);
+            const qint32 base = oldOrder[baseIndex];
+            const qint32 baseNext = oldOrder[baseIndex + 1];
+            const qint32 inserted = oldOrder[insertedItemIndex];
+            const qint32 insertedPrev = oldOrder[insertedItemIndex - 1];
+            const qint32 insertedNext = oldOrder[insertedItemIndex + 1];
+
+            qreal insertionGain = costs[base][inserted]
+                                  + costs[inserted][baseNext]
+                                  - costs[base][baseNext]
+                                  + costs[insertedPrev][insertedNext]
+                                  - costs[insertedPrev][inserted]
+                                  - costs[inserted][insertedNext];
 
             if(insertionGain < bestInsertionGain)
             {
@@ -161,7 +209,7 @@ qreal CRouterOptimization::createNextBestOrder(const SGisLine& oldOrder, SGisLin
         }
     }
 
-    newOrder = SGisLine(oldOrder);
+    newOrder = oldOrder;
     if(bestBaseIndex >= 0 && bestInsertedItemIndex >= 0)
     {
         // If the index of the inserted item was smaller than that of the base item,
@@ -178,7 +226,7 @@ qreal CRouterOptimization::createNextBestOrder(const SGisLine& oldOrder, SGisLin
     return bestInsertionGain;
 }
 
-qreal CRouterOptimization::twoOptStep(const SGisLine& oldOrder, SGisLine& newOrder)
+qreal CRouterOptimization::twoOptStep(const costs_t& costs, const QVector<qint32>& oldOrder, QVector<qint32>& newOrder)
 {
     //NOINT and not 0, since we also want to take orders that don't seem to be improving the situation
     qreal bestTwoOptGain = NOINT;
@@ -186,20 +234,20 @@ qreal CRouterOptimization::twoOptStep(const SGisLine& oldOrder, SGisLine& newOrd
     int bestBeginIndex = -1;
     int bestEndIndex = -1;
 
-    // lastWorkingOrder.length()-2, since the end of the inverted section can't be the end of the line
+    // oldOrder.length()-2, since the end of the inverted section can't be the end of the line
     for(int beginIndex = 1; beginIndex < oldOrder.length() - 2; beginIndex++)
     {
         for(int endIndex = beginIndex + 1; endIndex < oldOrder.length() - 1; endIndex++)
         {
-            qreal oldRangeCosts = bestKnownDistance(oldOrder[beginIndex - 1], oldOrder[beginIndex])
-                                  + bestKnownDistance(oldOrder[endIndex], oldOrder[endIndex + 1]);
+            qreal oldRangeCosts = costs[oldOrder[beginIndex - 1]][oldOrder[beginIndex]]
+                                  + costs[oldOrder[endIndex]][oldOrder[endIndex + 1]];
 
-            qreal newRangeCosts = bestKnownDistance(oldOrder[beginIndex - 1], oldOrder[endIndex])
-                                  + bestKnownDistance(oldOrder[beginIndex], oldOrder[endIndex + 1]);
+            qreal newRangeCosts = costs[oldOrder[beginIndex - 1]][oldOrder[endIndex]]
+                                  + costs[oldOrder[beginIndex]][oldOrder[endIndex + 1]];
             for(int i = beginIndex; i < endIndex; i++)
             {
-                oldRangeCosts += bestKnownDistance(oldOrder[i], oldOrder[i + 1]);
-                newRangeCosts += bestKnownDistance(oldOrder[i + 1], oldOrder[i]);
+                oldRangeCosts += costs[oldOrder[i]][oldOrder[i + 1]];
+                newRangeCosts += costs[oldOrder[i + 1]][oldOrder[i]];
             }
 
             if(newRangeCosts - oldRangeCosts < bestTwoOptGain)
@@ -211,7 +259,7 @@ qreal CRouterOptimization::twoOptStep(const SGisLine& oldOrder, SGisLine& newOrd
         }
     }
 
-    newOrder = SGisLine(oldOrder);
+    newOrder = oldOrder;
     if(bestEndIndex >= 0 && bestBeginIndex >= 0)
     {
         std::reverse(newOrder.begin() + bestBeginIndex, newOrder.begin() + bestEndIndex);
@@ -219,88 +267,273 @@ qreal CRouterOptimization::twoOptStep(const SGisLine& oldOrder, SGisLine& newOrd
     return bestTwoOptGain;
 }
 
-qreal CRouterOptimization::getRealRouteCosts(const SGisLine& line, qreal costCutoff)
+bool CRouterOptimization::improveTwoOpt(const costs_t& costs, QVector<qint32>& order, qreal epsilon)
 {
-    qreal costs = 0;
-    for(int i = 0; i < line.length() - 1; i++)
+    const qint32 N = order.size();
+
+    // the accumulated costs along the order and against it
+    QVector<qreal> forward(N, 0);
+    QVector<qreal> backward(N, 0);
+    for(int i = 1; i < N; i++)
     {
-        const routing_cache_item_t* route = getRoute(line[i].coord, line[i + 1].coord);
-        if(route == nullptr)
+        forward[i] = forward[i - 1] + costs[order[i - 1]][order[i]];
+        backward[i] = backward[i - 1] + costs[order[i]][order[i - 1]];
+    }
+
+    qreal bestGain = -epsilon;
+    int bestBeginIndex = -1;
+    int bestEndIndex = -1;
+
+    // reverse order[beginIndex..endIndex], start and end are fixed
+    for(int beginIndex = 1; beginIndex < N - 2; beginIndex++)
+    {
+        const qint32 prev = order[beginIndex - 1];
+        const qint32 begin = order[beginIndex];
+        for(int endIndex = beginIndex + 1; endIndex < N - 1; endIndex++)
         {
-            return -1;
+            const qint32 end = order[endIndex];
+            const qint32 next = order[endIndex + 1];
+
+            const qreal gain = costs[prev][end] + costs[begin][next] + (backward[endIndex] - backward[beginIndex])
+                               - costs[prev][begin] - costs[end][next] - (forward[endIndex] - forward[beginIndex]);
+
+            if(gain < bestGain)
+            {
+                bestGain = gain;
+                bestBeginIndex = beginIndex;
+                bestEndIndex = endIndex;
+            }
         }
-        costs += route->costs;
+    }
 
-        if(costCutoff > 0 && costs > costCutoff)
+    if(bestBeginIndex < 0)
+    {
+        return false;
+    }
+
+    std::reverse(order.begin() + bestBeginIndex, order.begin() + bestEndIndex + 1);
+    return true;
+}
+
+bool CRouterOptimization::improveOrOpt(const costs_t& costs, QVector<qint32>& order, qreal epsilon)
+{
+    const qint32 N = order.size();
+
+    qreal bestGain = -epsilon;
+    int bestIndex = -1;
+    int bestLength = 0;
+    int bestTarget = -1;
+
+    for(int length = 1; length <= 3; length++)
+    {
+        // move order[index..index + length - 1], start and end are fixed
+        for(int index = 1; index + length < N; index++)
         {
-            return -1;
+            const qint32 prev = order[index - 1];
+            const qint32 first = order[index];
+            const qint32 last = order[index + length - 1];
+            const qint32 next = order[index + length];
+
+            const qreal removeGain = costs[prev][next] - costs[prev][first] - costs[last][next];
+
+            // insert it between order[target] and order[target + 1]
+            for(int target = 0; target < N - 1; target++)
+            {
+                if(target >= index - 1 && target < index + length)
+                {
+                    continue;
+                }
+
+                const qint32 a = order[target];
+                const qint32 b = order[target + 1];
+                const qreal gain = removeGain + costs[a][first] + costs[last][b] - costs[a][b];
+
+                if(gain < bestGain)
+                {
+                    bestGain = gain;
+                    bestIndex = index;
+                    bestLength = length;
+                    bestTarget = target;
+                }
+            }
         }
     }
-    return costs;
+
+    if(bestIndex < 0)
+    {
+        return false;
+    }
+
+    const QVector<qint32>& chain = order.mid(bestIndex, bestLength);
+    order.remove(bestIndex, bestLength);
+
+    // the target's index shifts if it's behind the removed chain
+    int insertIndex = bestTarget < bestIndex ? bestTarget + 1 : bestTarget + 1 - bestLength;
+    for(qint32 idx : chain)
+    {
+        order.insert(insertIndex++, idx);
+    }
+    return true;
+}
+
+void CRouterOptimization::improveLocal(const costs_t& costs, QVector<qint32>& order)
+{
+    // Ignore gains in the range of rounding errors. Else the search might never stop.
+    const qreal epsilon = qMax(qreal(1e-9), qAbs(getCosts(costs, order)) * 1e-12);
+
+    while(improveTwoOpt(costs, order, epsilon) || improveOrOpt(costs, order, epsilon))
+    {
+    }
+}
+
+void CRouterOptimization::perturb(QVector<qint32>& order, quint32& seed)
+{
+    const qint32 N = order.size();
+    if(N < 5)
+    {
+        return;
+    }
+
+    auto random = [&seed](int min, int max)
+    {
+        seed = seed * 1103515245 + 12345;
+        return min + int((seed >> 16) % quint32(max - min + 1));
+    };
+
+    // order[0..i-1] + order[j..k-1] + order[i..j-1] + order[k..N-1]
+    const int i = random(1, N - 3);
+    const int j = random(i + 1, N - 2);
+    const int k = random(j + 1, N - 1);
+
+    QVector<qint32> newOrder;
+    newOrder.reserve(N);
+    newOrder << order.mid(0, i) << order.mid(j, k - j) << order.mid(i, j - i) << order.mid(k);
+    order = newOrder;
 }
 
-qreal CRouterOptimization::bestKnownDistance(const IGisLine::point_t& start, const IGisLine::point_t& end)
+bool CRouterOptimization::getCostMatrix(const QVector<QPointF>& points, costs_t& costs)
 {
-    //10 digits after the decimal point in exponential format should be by far enough
-    QString start_key = QString::number(start.coord.x(), 'e', 10) + QString::number(start.coord.y(), 'e', 10);
-    QString end_key = QString::number(end.coord.x(), 'e', 10) + QString::number(end.coord.y(), 'e', 10);
+    const qint32 N = points.size();
+    costs = costs_t(N, QVector<qreal>(N, 0));
+
+    // The start is never the target of a leg and the end never it's source.
+    QVector<QPair<qint32, qint32> > legs;
+    for(int i = 0; i < N - 1; i++)
+    {
+        for(int j = 1; j < N; j++)
+        {
+            if(i != j && !(i == 0 && j == N - 1))
+            {
+                legs << qMakePair(i, j);
+            }
+        }
+    }
+
+    PROGRESS_SETUP(tr("Optimizing route"), 0, legs.size(), nullptr);
 
-    if(!routingCache.contains(start_key))
+    QEventLoop eventLoop;
+    QHash<quint64, leg_t> legsPending;
+    QList<leg_t> legsSynchronous;
+    int cnt = 0;
+
+    QObject::connect(&CRouterSetup::self(), &CRouterSetup::sigRouteFinished, &eventLoop, [&](quint64 id, const QPolygonF& coords, const QString& error, qreal routeCosts) {
+        if(!legsPending.contains(id))
+        {
+            // request of someone else
+            return;
+        }
+
+        const leg_t leg = legsPending.take(id);
+        if(error.isEmpty() && !coords.isEmpty() && routeCosts >= 0)
+        {
+            routingCache[leg] = {coords, routeCosts};
+        }
+
+        progress.setValue(++cnt);
+        if(legsPending.isEmpty())
+        {
+            eventLoop.quit();
+        }
+    });
+    QObject::connect(&progress, &CProgressDialog::rejected, &eventLoop, &QEventLoop::quit);
+
+    // request all missing legs at once to let the router work in parallel
+    for(const QPair<qint32, qint32>& idx : qAsConst(legs))
+    {
+        const leg_t leg = {points[idx.first], points[idx.second]};
+        if(routingCache.contains(leg) || legsSynchronous.contains(leg))
+        {
+            ++cnt;
+            continue;
+        }
+
+        const quint64 id = CRouterSetup::self().calcRouteAsync(leg.from, leg.to);
+        if(id == 0)
+        {
+            legsSynchronous << leg;
+        }
+        else
+        {
+            legsPending[id] = leg;
+        }
+    }
+
+    if(!legsPending.isEmpty())
     {
-        routingCache[start_key] = {};
+        // user input has to be processed for the cancel button. The progress
+        // dialog is application modal and blocks input to anything else.
+        eventLoop.exec();
     }
 
-    if(routingCache[start_key].contains(end_key))
+    if(progress.wasCanceled())
     {
-        return routingCache[start_key][end_key].costs;
+        for(quint64 id : legsPending.keys())
+        {
+            CRouterSetup::self().cancelRouteAsync(id);
+        }
+        return false;
     }
-    else
+
+    // the router can't route in the background
+    for(const leg_t& leg : qAsConst(legsSynchronous))
     {
-        //Multiply it with the average of the minimum occuring factor and the average factor
-        // to get a reasonable compromise of optimization speed and optimality of results
-        if(totalNumOfRoutes > 0 && minAirToCostFactor > 0)
+        PROGRESS(++cnt, return false);
+        getRoute(leg.from, leg.to);
+    }
+
+    for(const QPair<qint32, qint32>& idx : qAsConst(legs))
+    {
+        const leg_t leg = {points[idx.first], points[idx.second]};
+        const QHash<leg_t, routing_cache_item_t>::const_iterator& item = routingCache.constFind(leg);
+        if(item == routingCache.constEnd() || item->costs < 0)
         {
-            return GPS_Math_DistanceQuick(start.coord.x(), start.coord.y(),
-                                          end.coord.x(), end.coord.y())
-                   * (totalAirToCosts / totalNumOfRoutes + minAirToCostFactor) / 2;
+            costs[idx.first][idx.second] = costsNoRoute;
         }
         else
         {
-            return GPS_Math_DistanceQuick(start.coord.x(), start.coord.y(),
-                                          end.coord.x(), end.coord.y());
+            costs[idx.first][idx.second] = item->costs;
         }
     }
+
+    return true;
 }
 
 const CRouterOptimization::routing_cache_item_t* CRouterOptimization::getRoute(const QPointF& start, const QPointF& end)
 {
-    QString start_key = QString::number(start.x(), 'e', 10) + QString::number(start.y(), 'e', 10);
-    QString end_key = QString::number(end.x(), 'e', 10) + QString::number(end.y(), 'e', 10);
-
-    if(!routingCache.contains(start_key))
-    {
-        routingCache[start_key] = {};
-    }
+    const leg_t leg = {start, end};
 
-    if(!routingCache[start_key].contains(end_key))
+    if(!routingCache.contains(leg))
     {
         routing_cache_item_t cacheItem;
+        cacheItem.costs = -1;
         int response = CRouterSetup::self().calcRoute(start, end, cacheItem.route, &cacheItem.costs);
         if(response < 0)
         {
             return nullptr;
         }
-        routingCache[start_key][end_key] = cacheItem;
-
-        qreal airToCostFactor = cacheItem.costs / GPS_Math_DistanceQuick(start.x(), start.y(), end.x(), end.y());
-        if( airToCostFactor < minAirToCostFactor || minAirToCostFactor < 0)
-        {
-            minAirToCostFactor = airToCostFactor;
-        }
-        totalAirToCosts += airToCostFactor;
-        totalNumOfRoutes++;
+        routingCache[leg] = cacheItem;
     }
-    return &routingCache[start_key][end_key];
+    return &routingCache[leg];
 }
 
 int CRouterOptimization::fillSubPts(SGisLine& line)
@@ -20,8 +20,9 @@
 #define CROUTEROPTIMIZATION_H
 #include <gis/IGisLine.h>
 #include <QCoreApplication>
-#include <QMap>
+#include <QHash>
 #include <QPolygonF>
+#include <QVector>
 
 class CRouterOptimization
 {
@@ -30,6 +31,38 @@ public:
     CRouterOptimization();
     int optimize(SGisLine& line);
 
+    /// costs[i][j] are the costs to get from point i to point j
+    using costs_t = QVector<QVector<qreal> >;
+
+    /**
+       @brief Find a cheap order to visit all points of a cost matrix
+
+       The first and the last point are kept in place. The search starts with the
+       given order 0..n-1 and improves it by moving single points, reversing sections
+       (2-opt) and moving short chains of points (or-opt). Local optima are left by
+       a fixed number of deterministic restarts. The costs don't have to be symmetric.
+
+       @param costs     the cost matrix
+       @return The order as indices into the cost matrix.
+     */
+    static QVector<qint32> optimizeOrder(const costs_t& costs);
+
+    /// the costs of the given order
+    static qreal getCosts(const costs_t& costs, const QVector<qint32>& order);
+
+    /// a routed leg between two points [rad]
+    struct leg_t
+    {
+        QPointF from;
+        QPointF to;
+
+        bool operator==(const leg_t& other) const
+        {
+            return (from.x() == other.from.x()) && (from.y() == other.from.y())
+                   && (to.x() == other.to.x()) && (to.y() == other.to.y());
+        }
+    };
+
 private:
 
     struct routing_cache_item_t
@@ -39,21 +72,39 @@ private:
     };
 
     /// returns value by which the costs were changed
-    qreal createNextBestOrder(const SGisLine& oldOrder, SGisLine& newOrder);
-    qreal twoOptStep(const SGisLine& oldOrder, SGisLine& newOrder);
+    static qreal createNextBestOrder(const costs_t& costs, const QVector<qint32>& oldOrder, QVector<qint32>& newOrder);
+    static qreal twoOptStep(const costs_t& costs, const QVector<qint32>& oldOrder, QVector<qint32>& newOrder);
+
+    /// apply the best improving reversal of a section, returns false if there is none
+    static bool improveTwoOpt(const costs_t& costs, QVector<qint32>& order, qreal epsilon);
+    /// apply the best improving move of a chain of up to 3 points, returns false if there is none
+    static bool improveOrOpt(const costs_t& costs, QVector<qint32>& order, qreal epsilon);
+    /// apply 2-opt and or-opt moves until the order is a local optimum
+    static void improveLocal(const costs_t& costs, QVector<qint32>& order);
+    /// swap two random sections of the order (double bridge)
+    static void perturb(QVector<qint32>& order, quint32& seed);
 
-    qreal getRealRouteCosts(const SGisLine& line, qreal costCutoff = -1);
-    qreal bestKnownDistance(const IGisLine::point_t& start, const IGisLine::point_t& end);
+    /**
+       @brief Get the costs of all legs between the points
+
+       All legs missing in the cache are requested at once. If the router supports
+       it they are calculated in the background and in parallel. Legs without a
+       route get a very high cost.
+
+       @param points    the points of the route [rad]
+       @param costs     receives the cost matrix
+       @return False if the user canceled the operation.
+     */
+    bool getCostMatrix(const QVector<QPointF>& points, costs_t& costs);
     const routing_cache_item_t* getRoute(const QPointF& from, const QPointF& to);
     int fillSubPts(SGisLine& line);
     /// checks if router settings were changed and if yes, discards the routingCache
     void checkRouter();
 
-    QMap<QString, QMap<QString, routing_cache_item_t> > routingCache;
-    qreal minAirToCostFactor = -1;
-    qreal totalAirToCosts = 0;
-    qreal totalNumOfRoutes = 0;
+    QHash<leg_t, routing_cache_item_t> routingCache;
     QString routerOptions = "";
 };
 
+uint qHash(const CRouterOptimization::leg_t& leg, uint seed = 0);
+
 #endif // CROUTEROPTIMIZATION_H
@@ -31,9 +31,37 @@
 #include <routino.h>
 
 QPointer<CProgressDialog> CRouterRoutino::progress;
+thread_local QAtomicInt* CRouterRoutino::asyncCanceled = nullptr;
+
+/**
+   @brief Calculate a route of CRouterRoutino in a thread of it's pool
+ */
+class CRoutinoJob : public QRunnable
+{
+public:
+    CRoutinoJob(CRouterRoutino& router, const CRouterRoutino::request_t& req)
+        : router(router)
+        , req(req)
+    {
+    }
+
+    void run() override
+    {
+        router.runAsync(req);
+    }
+
+private:
+    CRouterRoutino& router;
+    const CRouterRoutino::request_t req;
+};
 
 int ProgressFunc(double complete)
 {
+    if(CRouterRoutino::asyncCanceled != nullptr)
+    {
+        return !CRouterRoutino::asyncCanceled->loadAcquire();
+    }
+
     if(CRouterRoutino::progress.isNull())
     {
         return true;
@@ -52,6 +80,10 @@ CRouterRoutino::CRouterRoutino(QWidget* parent)
     pSelf = this;
     setupUi(this);
 
+    // Routino isn't thread safe. All requests are serialized by the mutex anyway.
+    poolAsync.setMaxThreadCount(1);
+    connect(this, &CRouterRoutino::sigAsyncFinished, this, &CRouterRoutino::slotAsyncFinished, Qt::QueuedConnection);
+
     connect(labelHelp, &QLabel::linkActivated, &CMainWindow::self(), static_cast<void (CMainWindow::*)(const QString&)>(&CMainWindow::slotLinkActivated));
 
     if(Routino_CheckAPIVersion() != ROUTINO_ERROR_NONE)
@@ -115,6 +147,7 @@ CRouterRoutino::~CRouterRoutino()
     cfg.setValue("Route/routino/mode", comboMode->currentIndex());
     cfg.setValue("Route/routino/database", comboDatabase->currentIndex());
 
+    cancelAllAsync();
     freeDatabaseList();
     Routino_FreeXMLProfiles();
     Routino_FreeXMLTranslations();
@@ -321,6 +354,11 @@ void CRouterRoutino::buildDatabaseList()
 
 void CRouterRoutino::freeDatabaseList()
 {
+    // no request must use the databases anymore
+    cancelAllAsync();
+    cacheSegments.clear();
+    currentProfile = nullptr;
+
     for(int i = 0; i < comboDatabase->count(); i++)
     {
         QVariantMap map = comboDatabase->itemData(i, Qt::UserRole).toMap();
@@ -337,10 +375,51 @@ int CRouterRoutino::loadProfiles(const QString& profilesPath)
     {
         currentProfilesPath = profilesPath;
         res = Routino_ParseXMLProfiles(profilesPath.toUtf8());
+
+        // parsing the profiles invalidates all previous profiles
+        currentProfile = nullptr;
     }
     return res;
 }
 
+Routino_Profile* CRouterRoutino::getProfile(Routino_Database* data, const QString& profilesPath, const QString& name)
+{
+    loadProfiles(profilesPath);
+
+    if((currentProfile != nullptr) && (currentProfileName == name) && (currentProfileData == data))
+    {
+        return currentProfile;
+    }
+    currentProfile = nullptr;
+
+    Routino_Profile* profile = Routino_GetProfile(name.toUtf8());
+    if( profile == NULL )
+    {
+        throw tr("Required profile '%1' is not in the current profiles file.").arg(name);
+    }
+
+    int res = Routino_ValidateProfile(data, profile);
+    if(res != 0)
+    {
+        throw xlateRoutinoError(Routino_errno);
+    }
+
+    currentProfile = profile;
+    currentProfileName = name;
+    currentProfileData = data;
+    return profile;
+}
+
+Routino_Translation* CRouterRoutino::getTranslation(const QString& language)
+{
+    // the translations are parsed once on startup
+    if(!translations.contains(language))
+    {
+        translations[language] = Routino_GetTranslation(language.toUtf8());
+    }
+    return translations[language];
+}
+
 void CRouterRoutino::updateHelpText()
 {
     bool haveDB = (comboDatabase->count() != 0);
@@ -349,9 +428,33 @@ void CRouterRoutino::updateHelpText()
     comboDatabase->setEnabled(haveDB);
 }
 
-void CRouterRoutino::calcRoute(const IGisItem::key_t& key)
+bool CRouterRoutino::lockSync()
 {
+    if(busySync)
+    {
+        return false;
+    }
+
     if(!mutex.tryLock())
+    {
+        // a segment calculated in the background, that does not take long
+        CCanvasCursorLock cursorLock(Qt::WaitCursor, __func__);
+        mutex.lock();
+    }
+
+    busySync = true;
+    return true;
+}
+
+void CRouterRoutino::unlockSync()
+{
+    busySync = false;
+    mutex.unlock();
+}
+
+void CRouterRoutino::calcRoute(const IGisItem::key_t& key)
+{
+    if(!lockSync())
     {
         return;
     }
@@ -374,25 +477,13 @@ void CRouterRoutino::calcRoute(const IGisItem::key_t& key)
             throw QString();
         }
 
-        loadProfiles(map["profilesPath"].toString());
-
         rte->reset();
 
         QString strProfile = comboProfile->currentData(Qt::UserRole).toString();
         QString strLanguage = comboLanguage->currentData(Qt::UserRole).toString();
 
-        Routino_Profile* profile = Routino_GetProfile(strProfile.toUtf8());
-        if( profile == NULL )
-        {
-            throw tr("Required profile '%1' is not in the current profiles file.").arg(strProfile);
-        }
-        Routino_Translation* translation = Routino_GetTranslation(strLanguage.toUtf8());
-
-        int res = Routino_ValidateProfile(data, profile);
-        if(res != 0)
-        {
-            throw xlateRoutinoError(Routino_errno);
-        }
+        Routino_Profile* profile = getProfile(data, map["profilesPath"].toString(), strProfile);
+        Routino_Translation* translation = getTranslation(strLanguage);
 
         int options = ROUTINO_ROUTE_LIST_HTML_ALL;
         if(comboMode->currentIndex() == 0)
@@ -446,7 +537,7 @@ void CRouterRoutino::calcRoute(const IGisItem::key_t& key)
         }
     }
 
-    mutex.unlock();
+    unlockSync();
 
     CCanvas::triggerCompleteUpdate(CCanvas::eRedrawGis);
 }
@@ -454,118 +545,224 @@ void CRouterRoutino::calcRoute(const IGisItem::key_t& key)
 
 int CRouterRoutino::calcRoute(const QPointF& p1, const QPointF& p2, QPolygonF& coords, qreal* costs = nullptr)
 {
-    if(!mutex.tryLock())
+    if(!lockSync())
     {
         return -1;
     }
 
     try
     {
-        QVariantMap map = comboDatabase->currentData(Qt::UserRole).toMap();
-        Routino_Database* data = (Routino_Database*)(map["db"].toULongLong());
-        if(nullptr == data)
+        request_t req = getRequest(p1, p2);
+        req.showProgress = true;
+        calcRoute(req, coords, costs);
+    }
+    catch(const QString& msg)
+    {
+        coords.clear();
+
+        if(!msg.isEmpty())
         {
-            throw QString();
+            unlockSync();
+            throw msg;
         }
+    }
 
-        loadProfiles(map["profilesPath"].toString());
+    unlockSync();
+    return coords.size();
+}
 
-        QString strProfile = comboProfile->currentData(Qt::UserRole).toString();
-        QString strLanguage = comboLanguage->currentData(Qt::UserRole).toString();
+bool CRouterRoutino::calcRouteAsync(quint64 id, const QPointF& p1, const QPointF& p2)
+{
+    request_t req = getRequest(p1, p2);
+    if(nullptr == req.data)
+    {
+        return false;
+    }
 
-        Routino_Profile* profile = Routino_GetProfile(strProfile.toUtf8());
-        if( profile == NULL )
-        {
-            throw tr("Required profile '%1' is not in the current profiles file.").arg(strProfile);
-        }
-        Routino_Translation* translation = Routino_GetTranslation(strLanguage.toUtf8());
+    req.id = id;
+    req.canceled = QSharedPointer<QAtomicInt>::create(0);
+    requestsAsync[id] = req.canceled;
 
+    poolAsync.start(new CRoutinoJob(*this, req));
+    return true;
+}
 
-        int res = Routino_ValidateProfile(data, profile);
-        if(res != 0)
-        {
-            throw xlateRoutinoError(Routino_errno);
-        }
+void CRouterRoutino::cancelRouteAsync(quint64 id)
+{
+    QSharedPointer<QAtomicInt> canceled = requestsAsync.take(id);
+    if(!canceled.isNull())
+    {
+        canceled->storeRelease(1);
+    }
+}
 
-        int options = ROUTINO_ROUTE_LIST_HTML_ALL;
-        if(comboMode->currentIndex() == 0)
+void CRouterRoutino::cancelAllAsync()
+{
+    for(const QSharedPointer<QAtomicInt>& canceled : qAsConst(requestsAsync))
+    {
+        canceled->storeRelease(1);
+    }
+    requestsAsync.clear();
+    poolAsync.waitForDone();
+}
+
+void CRouterRoutino::runAsync(const request_t& req)
+{
+    QPolygonF coords;
+    QString error;
+    qreal costs = -1;
+
+    if(!req.canceled->loadAcquire())
+    {
+        QMutexLocker lock(&mutex);
+
+        // let ProgressFunc() abort the calculation as soon as the request is canceled
+        asyncCanceled = req.canceled.data();
+        try
         {
-            options |= ROUTINO_ROUTE_SHORTEST;
+            calcRoute(req, coords, &costs);
         }
-        if(comboMode->currentIndex() == 1)
+        catch(const QString& msg)
         {
-            options |= ROUTINO_ROUTE_QUICKEST;
+            coords.clear();
+            error = msg;
+            costs = -1;
         }
+        asyncCanceled = nullptr;
+    }
 
-        Routino_Waypoint* waypoints[2] = {0};
-        waypoints[0] = Routino_FindWaypoint(data, profile, p1.y() * RAD_TO_DEG, p1.x() * RAD_TO_DEG);
-        if(waypoints[0] == nullptr)
-        {
-            throw xlateRoutinoError(Routino_errno);
-        }
+    // queued to the GUI thread
+    emit sigAsyncFinished(req.id, coords, error, costs);
+}
 
-        waypoints[1] = Routino_FindWaypoint(data, profile, p2.y() * RAD_TO_DEG, p2.x() * RAD_TO_DEG);
-        if(waypoints[1] == nullptr)
+void CRouterRoutino::slotAsyncFinished(quint64 id, const QPolygonF& coords, const QString& error, qreal costs)
+{
+    if(requestsAsync.remove(id) == 0)
+    {
+        // canceled
+        return;
+    }
+
+    emit sigRouteFinished(id, coords, error, costs);
+}
+
+CRouterRoutino::request_t CRouterRoutino::getRequest(const QPointF& p1, const QPointF& p2) const
+{
+    request_t req;
+    req.p1 = p1;
+    req.p2 = p2;
+
+    QVariantMap map = comboDatabase->currentData(Qt::UserRole).toMap();
+    req.data = (Routino_Database*)(map["db"].toULongLong());
+    req.profilesPath = map["profilesPath"].toString();
+    req.profile = comboProfile->currentData(Qt::UserRole).toString();
+    req.language = comboLanguage->currentData(Qt::UserRole).toString();
+    req.mode = comboMode->currentIndex();
+
+    return req;
+}
+
+void CRouterRoutino::calcRoute(const request_t& req, QPolygonF& coords, qreal* costs)
+{
+    if(nullptr == req.data)
+    {
+        throw QString();
+    }
+
+    CRouterRoutinoCache::key_t key;
+    key.database = quint64(req.data);
+    key.profile = req.profile;
+    key.mode = req.mode;
+    key.from = req.p1;
+    key.to = req.p2;
+
+    qreal segmentCosts = 0;
+    if(cacheSegments.find(key, coords, segmentCosts))
+    {
+        if(costs != nullptr)
         {
-            throw xlateRoutinoError(Routino_errno);
+            *costs = segmentCosts;
         }
+        return;
+    }
 
+    Routino_Profile* profile = getProfile(req.data, req.profilesPath, req.profile);
+    Routino_Translation* translation = getTranslation(req.language);
+
+    int options = ROUTINO_ROUTE_LIST_HTML_ALL;
+    if(req.mode == 0)
+    {
+        options |= ROUTINO_ROUTE_SHORTEST;
+    }
+    if(req.mode == 1)
+    {
+        options |= ROUTINO_ROUTE_QUICKEST;
+    }
+
+    Routino_Waypoint* waypoints[2] = {0};
+    waypoints[0] = Routino_FindWaypoint(req.data, profile, req.p1.y() * RAD_TO_DEG, req.p1.x() * RAD_TO_DEG);
+    if(waypoints[0] == nullptr)
+    {
+        throw xlateRoutinoError(Routino_errno);
+    }
+
+    waypoints[1] = Routino_FindWaypoint(req.data, profile, req.p2.y() * RAD_TO_DEG, req.p2.x() * RAD_TO_DEG);
+    if(waypoints[1] == nullptr)
+    {
+        throw xlateRoutinoError(Routino_errno);
+    }
+
+    if(req.showProgress)
+    {
         progress = new CProgressDialog(tr("Calculate route with %1").arg(getOptions()), 0, NOINT, this);
+    }
 
-        Routino_Output* route = Routino_CalculateRoute(data, profile, translation, waypoints, 2, options, ProgressFunc);
+    Routino_Output* route = Routino_CalculateRoute(req.data, profile, translation, waypoints, 2, options, ProgressFunc);
 
+    if(req.showProgress)
+    {
         delete progress;
+    }
 
-        if(route != nullptr)
+    if(route != nullptr)
+    {
+        Routino_Output* next = route;
+        while(next)
         {
-            Routino_Output* next = route;
-            while(next)
+            if(next->type != ROUTINO_POINT_WAYPOINT)
             {
-                if(next->type != ROUTINO_POINT_WAYPOINT)
-                {
-                    coords << QPointF(next->lon, next->lat);
-                }
-                if(costs != nullptr)
-                {
-                    if(comboMode->currentIndex() == 1)
-                    {
-                        // ROUTINO_ROUTE_QUICKEST
-                        // This works, since CRouteOptimization adapts it's weights according to the data it gets
-                        *costs = next->time;
-                    }
-                    else
-                    {
-                        // ROUTINO_ROUTE_SHORTEST
-                        *costs = next->dist;
-                    }
-                }
-                next = next->next;
+                coords << QPointF(next->lon, next->lat);
             }
-            Routino_DeleteRoute(route);
-        }
-        else
-        {
-            if(Routino_errno != ROUTINO_ERROR_PROGRESS_ABORTED)
+            if(req.mode == 1)
             {
-                throw xlateRoutinoError(Routino_errno);
+                // ROUTINO_ROUTE_QUICKEST
+                // This works, since CRouteOptimization adapts it's weights according to the data it gets
+                segmentCosts = next->time;
             }
             else
             {
-                throw QString();
+                // ROUTINO_ROUTE_SHORTEST
+                segmentCosts = next->dist;
             }
+            next = next->next;
+        }
+        Routino_DeleteRoute(route);
+
+        if(costs != nullptr)
+        {
+            *costs = segmentCosts;
         }
+        cacheSegments.insert(key, coords, segmentCosts);
     }
-    catch(const QString& msg)
+    else
     {
-        coords.clear();
-
-        if(!msg.isEmpty())
+        if(Routino_errno != ROUTINO_ERROR_PROGRESS_ABORTED)
         {
-            mutex.unlock();
-            throw msg;
+            throw xlateRoutinoError(Routino_errno);
+        }
+        else
+        {
+            throw QString();
         }
     }
-
-    mutex.unlock();
-    return coords.size();
 }
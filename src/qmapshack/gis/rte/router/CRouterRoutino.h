@@ -20,10 +20,14 @@
 #define CROUTERROUTINO_H
 
 #include "gis/rte/router/IRouter.h"
+#include "gis/rte/router/routino/CRouterRoutinoCache.h"
 #include "ui_IRouterRoutino.h"
 #include <routino.h>
 
+#include <QHash>
 #include <QPoint>
+#include <QSharedPointer>
+#include <QThreadPool>
 
 class CProgressDialog;
 
@@ -40,24 +44,87 @@ public:
 
     void calcRoute(const IGisItem::key_t& key) override;
     int calcRoute(const QPointF& p1, const QPointF& p2, QPolygonF& coords, qreal* costs) override;
+    bool calcRouteAsync(quint64 id, const QPointF& p1, const QPointF& p2) override;
+    void cancelRouteAsync(quint64 id) override;
 
     bool hasFastRouting() override;
 
     QString getOptions() override;
 
     static QPointer<CProgressDialog> progress;
+    /// the cancel flag of the request calculated by the current thread, if it's a request of calcRouteAsync()
+    static thread_local QAtomicInt* asyncCanceled;
 
     void setupPath(const QString& path);
 
+    /// the cache of segments calculated by calcRoute(p1, p2, ...)
+    const CRouterRoutinoCache& getCache() const
+    {
+        return cacheSegments;
+    }
+
+signals:
+    void sigAsyncFinished(quint64 id, const QPolygonF& coords, const QString& error, qreal costs);
+
 private slots:
     void slotSetupPaths();
+    void slotAsyncFinished(quint64 id, const QPolygonF& coords, const QString& error, qreal costs);
 
 
 private:
+    friend class CRoutinoJob;
+
+    /// all parameters needed to calculate a route without access to the widgets
+    struct request_t
+    {
+        quint64 id = 0;
+        QPointF p1;
+        QPointF p2;
+        Routino_Database* data = nullptr;
+        QString profilesPath;
+        QString profile;
+        QString language;
+        qint32 mode = 0;
+        bool showProgress = false;
+        QSharedPointer<QAtomicInt> canceled;
+    };
+
     virtual ~CRouterRoutino();
+    request_t getRequest(const QPointF& p1, const QPointF& p2) const;
+    /**
+       @brief Calculate a route between two points
+
+       The mutex must be locked by the caller.
+
+       @param req       the request
+       @param coords    the route [rad]
+       @param costs     if not nullptr it will receive the costs of the route
+     */
+    void calcRoute(const request_t& req, QPolygonF& coords, qreal* costs);
+    void runAsync(const request_t& req);
+    void cancelAllAsync();
+    /**
+       @brief Lock the mutex for a calculation in the GUI thread
+
+       A calculation of calcRouteAsync() holding the mutex is waited for. A calculation
+       in the GUI thread (e.g. called again by the event loop of its progress dialog)
+       is not.
+
+       @return Return false if a calculation in the GUI thread is running already.
+     */
+    bool lockSync();
+    void unlockSync();
     void buildDatabaseList();
     void freeDatabaseList();
     int loadProfiles(const QString& profilesPath);
+    /**
+       @brief Get a profile validated for a database
+
+       The profile is kept as long as neither the profiles file, the profile's name or the
+       database changes. Throws a QString on errors.
+     */
+    Routino_Profile* getProfile(Routino_Database* data, const QString& profilesPath, const QString& name);
+    Routino_Translation* getTranslation(const QString& language);
     void updateHelpText();
     QString xlateRoutinoError(int err);
     static CRouterRoutino* pSelf;
@@ -65,7 +132,21 @@ private:
     QStringList dbPaths;
     QString currentProfilesPath;
 
+    Routino_Profile* currentProfile = nullptr;
+    QString currentProfileName;
+    Routino_Database* currentProfileData = nullptr;
+
+    QHash<QString, Routino_Translation*> translations;
+
+    CRouterRoutinoCache cacheSegments;
+
     QMutex mutex {QMutex::NonRecursive};
+    /// true while the GUI thread holds the mutex
+    bool busySync = false;
+
+    QThreadPool poolAsync;
+    /// the cancel flags of all pending requests of calcRouteAsync()
+    QHash<quint64, QSharedPointer<QAtomicInt> > requestsAsync;
 };
 
 #endif //CROUTERROUTINO_H
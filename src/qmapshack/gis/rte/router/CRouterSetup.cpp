@@ -43,6 +43,15 @@ CRouterSetup::CRouterSetup(QWidget* parent)
     stackedWidget->addWidget(new CRouterMapQuest(this));
     stackedWidget->addWidget(new CRouterBRouter(this));
 
+    for(int i = 0; i < stackedWidget->count(); i++)
+    {
+        IRouter* router = dynamic_cast<IRouter*>(stackedWidget->widget(i));
+        if(router)
+        {
+            connect(router, &IRouter::sigRouteFinished, this, &CRouterSetup::sigRouteFinished);
+        }
+    }
+
     connect(comboRouter, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &CRouterSetup::slotSelectRouter);
 
     SETTINGS;
@@ -95,6 +104,34 @@ int CRouterSetup::calcRoute(const QPointF& p1, const QPointF& p2, QPolygonF& coo
     return false;
 }
 
+quint64 CRouterSetup::calcRouteAsync(const QPointF& p1, const QPointF& p2)
+{
+    IRouter* router = dynamic_cast<IRouter*>(stackedWidget->currentWidget());
+    if(router)
+    {
+        const quint64 id = ++lastRouteId;
+        if(router->calcRouteAsync(id, p1, p2))
+        {
+            return id;
+        }
+    }
+
+    return 0;
+}
+
+void CRouterSetup::cancelRouteAsync(quint64 id)
+{
+    // the router might have been changed in the meantime
+    for(int i = 0; i < stackedWidget->count(); i++)
+    {
+        IRouter* router = dynamic_cast<IRouter*>(stackedWidget->widget(i));
+        if(router)
+        {
+            router->cancelRouteAsync(id);
+        }
+    }
+}
+
 QString CRouterSetup::getOptions()
 {
     IRouter* router = dynamic_cast<IRouter*>(stackedWidget->currentWidget());
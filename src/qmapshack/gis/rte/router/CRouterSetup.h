@@ -35,6 +35,15 @@ public:
 
     void calcRoute(const IGisItem::key_t& key);
     int calcRoute(const QPointF& p1, const QPointF& p2, QPolygonF& coords, qreal* costs = nullptr);
+    /**
+       @brief Start to calculate a route with the current router in the background
+
+       @param p1    the start point [rad]
+       @param p2    the end point [rad]
+       @return The id of the request or 0 if the router can't route in the background.
+     */
+    quint64 calcRouteAsync(const QPointF& p1, const QPointF& p2);
+    void cancelRouteAsync(quint64 id);
     QString getOptions();
 
     bool hasFastRouting();
@@ -43,6 +52,9 @@ public:
 
     void setRouterTitle(router_e, QString title);
 
+signals:
+    void sigRouteFinished(quint64 id, const QPolygonF& coords, const QString& error, qreal costs);
+
 private slots:
     void slotSelectRouter(int i);
 
@@ -51,6 +63,8 @@ private:
     CRouterSetup(QWidget* parent);
 
     static CRouterSetup* pSelf;
+
+    quint64 lastRouteId = 0;
 };
 
 #endif //CROUTERSETUP_H
@@ -31,6 +31,35 @@ public:
 
     virtual void calcRoute(const IGisItem::key_t& key) = 0;
     virtual int calcRoute(const QPointF& p1, const QPointF& p2, QPolygonF& coords, qreal* costs = nullptr) = 0;
+
+    /**
+       @brief Start to calculate a route between two points without blocking the GUI
+
+       The result is reported by sigRouteFinished() with the same id. Routers that
+       can't route in the background return false. The caller has to use calcRoute()
+       instead.
+
+       @param id    the id to identify the request
+       @param p1    the start point [rad]
+       @param p2    the end point [rad]
+       @return True if the request has been started.
+     */
+    virtual bool calcRouteAsync(quint64 id, const QPointF& p1, const QPointF& p2)
+    {
+        return false;
+    }
+
+    /**
+       @brief Cancel a request started by calcRouteAsync()
+
+       sigRouteFinished() will not be sent for a canceled request.
+
+       @param id    the id of the request
+     */
+    virtual void cancelRouteAsync(quint64 id)
+    {
+    }
+
     virtual bool hasFastRouting()
     {
         return fastRouting;
@@ -40,6 +69,17 @@ public:
 
     virtual void routerSelected() {}
 
+signals:
+    /**
+       @brief Report the result of calcRouteAsync()
+
+       @param id        the id of the request
+       @param coords    the route [rad], empty on error
+       @param error     an error message, empty on success
+       @param costs     the costs of the route as reported by the router, -1 if unknown
+     */
+    void sigRouteFinished(quint64 id, const QPolygonF& coords, const QString& error, qreal costs);
+
 private:
     bool fastRouting;
 };
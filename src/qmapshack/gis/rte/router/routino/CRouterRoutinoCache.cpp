@@ -0,0 +1,65 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "gis/rte/router/routino/CRouterRoutinoCache.h"
+
+#include <QtCore>
+
+uint qHash(const CRouterRoutinoCache::key_t& key, uint seed)
+{
+    seed = qHash(key.database, seed);
+    seed = qHash(key.profile, seed);
+    seed = qHash(key.mode, seed);
+    seed = qHash(key.from.x(), seed);
+    seed = qHash(key.from.y(), seed);
+    seed = qHash(key.to.x(), seed);
+    seed = qHash(key.to.y(), seed);
+    return seed;
+}
+
+CRouterRoutinoCache::CRouterRoutinoCache(qint32 maxPoints)
+    : cache(maxPoints)
+{
+}
+
+bool CRouterRoutinoCache::find(const key_t& key, QPolygonF& coords, qreal& costs)
+{
+    const segment_t* segment = cache.object(key);
+    if(segment == nullptr)
+    {
+        misses++;
+        return false;
+    }
+
+    hits++;
+    coords = segment->coords;
+    costs = segment->costs;
+    return true;
+}
+
+void CRouterRoutinoCache::insert(const key_t& key, const QPolygonF& coords, qreal costs)
+{
+    // the cost of an empty segment must not be 0
+    cache.insert(key, new segment_t {coords, costs}, coords.size() + 1);
+}
+
+void CRouterRoutinoCache::clear()
+{
+    cache.clear();
+}
+
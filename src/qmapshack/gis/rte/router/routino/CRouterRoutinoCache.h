@@ -0,0 +1,111 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CROUTERROUTINOCACHE_H
+#define CROUTERROUTINOCACHE_H
+
+#include <QCache>
+#include <QPolygonF>
+#include <QString>
+
+/**
+   @brief A bounded cache of route segments calculated by Routino
+
+   The segments are identified by the database, the profile, the routing mode and
+   both end points. The least recently used segments are dropped as soon as the
+   total number of points exceeds the limit. The class is not thread safe. The
+   caller has to serialize the access.
+ */
+class CRouterRoutinoCache
+{
+public:
+    struct key_t
+    {
+        quint64 database = 0;
+        QString profile;
+        qint32 mode = 0;
+        QPointF from;   //< [rad]
+        QPointF to;     //< [rad]
+
+        bool operator==(const key_t& other) const
+        {
+            return (database == other.database)
+                   && (mode == other.mode)
+                   && (from.x() == other.from.x()) && (from.y() == other.from.y())
+                   && (to.x() == other.to.x()) && (to.y() == other.to.y())
+                   && (profile == other.profile);
+        }
+    };
+
+    CRouterRoutinoCache(qint32 maxPoints = 500000);
+    virtual ~CRouterRoutinoCache() = default;
+
+    /**
+       @brief Lookup a segment
+
+       @param key       the segment's key
+       @param coords    receives the route of the segment [rad]
+       @param costs     receives the costs of the segment
+       @return True on a cache hit.
+     */
+    bool find(const key_t& key, QPolygonF& coords, qreal& costs);
+
+    /**
+       @brief Add a segment
+
+       @param key       the segment's key
+       @param coords    the route of the segment [rad]
+       @param costs     the costs of the segment
+     */
+    void insert(const key_t& key, const QPolygonF& coords, qreal costs);
+
+    /// drop all segments, px. if the databases are reloaded
+    void clear();
+
+    qint32 count() const
+    {
+        return cache.count();
+    }
+
+    quint32 getHits() const
+    {
+        return hits;
+    }
+
+    quint32 getMisses() const
+    {
+        return misses;
+    }
+
+private:
+    struct segment_t
+    {
+        QPolygonF coords;
+        qreal costs;
+    };
+
+    QCache<key_t, segment_t> cache;
+
+    quint32 hits = 0;
+    quint32 misses = 0;
+};
+
+uint qHash(const CRouterRoutinoCache::key_t& key, uint seed = 0);
+
+#endif //CROUTERROUTINOCACHE_H
+
@@ -630,6 +630,13 @@ public:
     void filterSubPt2Pt();
     void filterChangeStartPoint(qint32 idxNewStartPoint, const QString& wptName);
     void filterLoopsCut(qreal dist);
+    /**
+       @brief Get the parts filterLoopsCut() would cut the track into
+
+       @param minLoopLength the minimum length of a loop in meters
+       @param parts         a list of index ranges (idxTotal of first and last point)
+     */
+    void filterGetLoopsCut(qreal minLoopLength, QList<QPair<qint32, qint32> >& parts) const;
     void filterZeroSpeedDriftCleaner(qreal distance, qreal ratio);
     /** @} */
 
@@ -17,7 +17,10 @@
 **********************************************************************************************/
 
 #include "CMainWindow.h"
+#include "gis/proj_x.h"
 #include "gis/trk/CListTrkPts.h"
+#include "gis/trk/CTableTrkModel.h"
+#include "units/IUnit.h"
 
 CListTrkPts::CListTrkPts(QWidget* parent)
     : QWidget(parent)
@@ -137,10 +140,22 @@ void CListTrkPts::setMouseFocus(qint32 idx)
            << "<th align=left>" << tr("Position") << "</th>"
            << "</tr>";
 
+    // format all timestamps at once
+    QVector<QDateTime> times;
+    QVector<QPointF> positions;
+    for(qint32 i = idxBeg; i <= idxEnd; i++)
+    {
+        const CTrackData::trkpt_t* trkpt = data.getTrkPtByTotalIndex(i);
+        times << trkpt->time;
+        positions << QPointF(trkpt->lon, trkpt->lat) * DEG_TO_RAD;
+    }
+    const QStringList& strTimes = IUnit::datetime2string(times, true, positions);
+
     for(qint32 i = idxBeg; i <= idxEnd; i++)
     {
         bool isInRange = idx1 <= i && i <= idx2;
-        addTableRow(i == idxFocus, *data.getTrkPtByTotalIndex(i), isInRange, stream);
+        const CTrackData::trkpt_t& trkpt = *data.getTrkPtByTotalIndex(i);
+        addTableRow(i == idxFocus, trkpt, trkpt.time.isValid() ? strTimes[i - idxBeg] : "-", isInRange, stream);
     }
 
     stream << "</table>"
@@ -159,7 +174,7 @@ void CListTrkPts::setMouseRangeFocus(const CTrackData::trkpt_t* pt1, const CTrac
     }
 }
 
-void CListTrkPts::addTableRow(bool focus, const CTrackData::trkpt_t& trkpt, bool isInRange, QTextStream& stream)
+void CListTrkPts::addTableRow(bool focus, const CTrackData::trkpt_t& trkpt, const QString& time, bool isInRange, QTextStream& stream)
 {
     QString color = trkpt.isHidden() ? "gray" : "black";
     QString bgFocus = focus ? "#e6e6e6" : "white";
@@ -170,36 +185,15 @@ void CListTrkPts::addTableRow(bool focus, const CTrackData::trkpt_t& trkpt, bool
            << "background: " << bgFocus << ";"
            << "'>";
 
-    stream << "<td style='background: " << bgInRange << ";'>" << QString::number(trkpt.idxTotal) << "</td>";
-
-    stream << "<td>" << (trkpt.time.isValid()
-                         ? IUnit::self().datetime2string(trkpt.time, true, QPointF(trkpt.lon, trkpt.lat) * DEG_TO_RAD)
-                         : "-") << "</td>";
-
-    QString val, unit;
-    IUnit::self().meter2elevation(trkpt.ele, val, unit);
-    stream << "<td>" << val << unit << "</td>";
-
-    IUnit::self().meter2distance(trkpt.deltaDistance, val, unit);
-    stream << "<td>" << val << unit << "</td>";
+    stream << "<td style='background: " << bgInRange << ";'>" << CTableTrkModel::getText(trkpt, CTableTrkModel::eColNum) << "</td>";
 
-    IUnit::self().meter2distance(trkpt.distance, val, unit);
-    stream << "<td>" << val << unit << "</td>";
+    stream << "<td>" << time << "</td>";
 
-    IUnit::self().meter2speed(trkpt.speed, val, unit);
-    stream << "<td>" << val << unit << "</td>";
-
-    IUnit::self().slope2string(trkpt.slope1, val, unit);
-    stream << "<td>" << val << unit << "</td>";
-
-    IUnit::self().meter2elevation(trkpt.ascent, val, unit);
-    stream << "<td>" << val << unit << "</td>";
-
-    IUnit::self().meter2elevation(trkpt.descent, val, unit);
-    stream << "<td>" << val << unit << "</td>";
-
-    IUnit::degToStr(trkpt.lon, trkpt.lat, val);
-    stream << "<td>" << val << "</td>";
+    // use the same formatting as the track point table
+    for(int column = CTableTrkModel::eColTime + 1; column < CTableTrkModel::eColMax; column++)
+    {
+        stream << "<td>" << CTableTrkModel::getText(trkpt, column) << "</td>";
+    }
 
     stream << "</tr>";
 }
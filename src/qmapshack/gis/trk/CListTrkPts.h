@@ -40,7 +40,7 @@ public:
 
 private:
     void setMouseFocus(qint32 idx);
-    void addTableRow(bool focus, const CTrackData::trkpt_t& trkpt, bool isInRange, QTextStream& stream);
+    void addTableRow(bool focus, const CTrackData::trkpt_t& trkpt, const QString& time, bool isInRange, QTextStream& stream);
     QString getTh(const QString& str, const QFontMetrics& fm);
     CGisItemTrk* trk = nullptr;
     static constexpr auto maxLines = 5;
@@ -16,25 +16,38 @@
 
 **********************************************************************************************/
 
-#include "gis/proj_x.h"
 #include "gis/trk/CTableTrk.h"
 #include "helpers/CElevationDialog.h"
 #include "helpers/CSettings.h"
-#include "units/IUnit.h"
 
 #include <QtWidgets>
 
 CTableTrk::CTableTrk(QWidget* parent)
-    : QTreeWidget(parent)
+    : QTreeView(parent)
     , INotifyTrk(CGisItemTrk::eVisualTrkTable)
 {
+    model = new CTableTrkModel(this);
+    proxy = new QSortFilterProxyModel(this);
+    proxy->setSourceModel(model);
+    proxy->setSortRole(CTableTrkModel::eRoleSort);
+    setModel(proxy);
+
+    setRootIsDecorated(false);
+    setItemsExpandable(false);
+    // all rows have the same height. This saves the view from asking the model
+    // for the size hint of each row.
+    setUniformRowHeights(true);
+    sortByColumn(CTableTrkModel::eColNum, Qt::AscendingOrder);
+
     SETTINGS;
     cfg.beginGroup("TrackDetails");
     header()->restoreState(cfg.value("trackPointListState").toByteArray());
     cfg.endGroup();
 
-    connect(this, &CTableTrk::itemSelectionChanged, this, &CTableTrk::slotItemSelectionChanged);
-    connect(this, &CTableTrk::itemDoubleClicked, this, &CTableTrk::slotItemDoubleClicked);
+    setSortingEnabled(true);
+
+    connect(selectionModel(), &QItemSelectionModel::currentChanged, this, &CTableTrk::slotCurrentChanged);
+    connect(this, &CTableTrk::doubleClicked, this, &CTableTrk::slotDoubleClicked);
 }
 
 CTableTrk::~CTableTrk()
@@ -53,45 +66,36 @@ CTableTrk::~CTableTrk()
 
 void CTableTrk::showTopItem()
 {
-    scrollTo(indexFromItem(topLevelItem(0), QAbstractItemView::PositionAtCenter));
+    scrollTo(proxy->index(0, 0), QAbstractItemView::PositionAtCenter);
 }
 
 void CTableTrk::showNextInvalid()
 {
-    qint32 index = 0;
-    QTreeWidgetItem* item = currentItem();
-    if(item != nullptr)
-    {
-        index = indexOfTopLevelItem(item) + 1;
-    }
-
-    const qint32 N = topLevelItemCount();
-    for(; index < N; index++)
-    {
-        QTreeWidgetItem* item = topLevelItem(index);
-        if(item->data(eColNum, Qt::UserRole).toUInt() != 0)
-        {
-            scrollTo(indexFromItem(item, QAbstractItemView::PositionAtCenter));
-            break;
-        }
-    }
+    showInvalid(1);
 }
 
 void CTableTrk::showPrevInvalid()
 {
-    qint32 index = 0;
-    QTreeWidgetItem* item = currentItem();
-    if(item != nullptr)
+    showInvalid(-1);
+}
+
+void CTableTrk::showInvalid(qint32 step)
+{
+    // search in the order of the view, as it might be sorted
+    qint32 row = 0;
+    const QModelIndex& current = currentIndex();
+    if(current.isValid())
     {
-        index = indexOfTopLevelItem(item) - 1;
+        row = current.row() + step;
     }
 
-    for(; index >= 0; index--)
+    const qint32 N = proxy->rowCount();
+    for(; (row >= 0) && (row < N); row += step)
     {
-        QTreeWidgetItem* item = topLevelItem(index);
-        if(item->data(eColNum, Qt::UserRole).toUInt() != 0)
+        const QModelIndex& index = proxy->index(row, 0);
+        if(model->isInvalid(proxy->mapToSource(index).row()))
         {
-            scrollTo(indexFromItem(item, QAbstractItemView::PositionAtCenter));
+            scrollTo(index, QAbstractItemView::PositionAtCenter);
             break;
         }
     }
@@ -100,33 +104,18 @@ void CTableTrk::showPrevInvalid()
 
 void CTableTrk::setTrack(CGisItemTrk* track)
 {
-    setColumnCount(eColMax);
-
-    QStringList labels;
-    labels << "#";
-    labels << tr("Time");
-    labels << tr("Ele.");
-    labels << tr("Delta");
-    labels << tr("Dist.");
-    labels << tr("Speed");
-    labels << tr("Slope");
-    labels << tr("Ascent");
-    labels << tr("Descent");
-    labels << tr("Position");
-    setHeaderLabels(labels);
-
     if(trk != nullptr)
     {
         trk->unregisterVisual(this);
     }
 
-    clear();
     trk = track;
+    model->setTrack(trk);
 
     if(trk != nullptr)
     {
         trk->registerVisual(this);
-        updateData();
+        header()->resizeSections(QHeaderView::ResizeToContents);
     }
 
     adjustSize();
@@ -139,132 +128,53 @@ void CTableTrk::updateData()
         return;
     }
 
-    // use all valid flags as invalid mask. By that only
-    // invalid flags for properties with valid points count
-    quint32 invalidMask = (trk->getAllValidFlags() & CTrackData::trkpt_t::eValidMask) << 16;
-
-    QList<QTreeWidgetItem*> items;
-    const CTrackData& t = trk->getTrackData();
-    for(const CTrackData::trkpt_t& trkpt : t)
+    const bool isReset = model->rowCount() != trk->getCntTotalPoints();
+    model->updateData();
+    if(isReset)
     {
-        QString val, unit;
-
-        QTreeWidgetItem* item = new QTreeWidgetItem();
-        item->setTextAlignment(eColNum, Qt::AlignLeft);
-        item->setTextAlignment(eColEle, Qt::AlignRight);
-        item->setTextAlignment(eColDelta, Qt::AlignRight);
-        item->setTextAlignment(eColDist, Qt::AlignRight);
-        item->setTextAlignment(eColAscent, Qt::AlignRight);
-        item->setTextAlignment(eColDescent, Qt::AlignRight);
-        item->setTextAlignment(eColSpeed, Qt::AlignRight);
-
-        if(!trk->isReadOnly())
-        {
-            item->setToolTip(eColEle, tr("Double click to edit elevation value"));
-        }
-
-        QBrush bg = item->background(0);
-        if(trkpt.isInvalid(CTrackData::trkpt_t::invalid_e(invalidMask)) && !trkpt.isHidden())
-        {
-            bg = QColor(255, 100, 100);
-            item->setData(eColNum, Qt::UserRole, quint32(invalidMask));
-        }
-
-        QBrush fg( trkpt.isHidden() ? Qt::gray : Qt::black );
-        for(int i = 0; i < eColMax; i++)
-        {
-            item->setBackground(i, bg);
-            item->setForeground(i, fg);
-        }
-
-        item->setText(eColNum, QString::number(trkpt.idxTotal));
-
-        item->setText(eColTime, trkpt.time.isValid()
-                      ? IUnit::self().datetime2string(trkpt.time, true, QPointF(trkpt.lon, trkpt.lat) * DEG_TO_RAD)
-                      : "-"
-                      );
-
-        if(trkpt.ele != NOINT)
-        {
-            IUnit::self().meter2elevation(trkpt.ele, val, unit);
-            item->setText(eColEle, tr("%1%2").arg(val, unit));
-        }
-        else
-        {
-            item->setText(eColEle, "-");
-        }
-
-        IUnit::self().meter2distance(trkpt.deltaDistance, val, unit);
-        item->setText(eColDelta, tr("%1%2").arg(val, unit));
-
-        IUnit::self().meter2distance(trkpt.distance, val, unit);
-        item->setText(eColDist, tr("%1%2").arg(val, unit));
-
-        if(trkpt.speed != NOFLOAT)
-        {
-            IUnit::self().meter2speed(trkpt.speed, val, unit);
-            item->setText(eColSpeed, tr("%1%2").arg(val, unit));
-        }
-        else
-        {
-            item->setText(eColSpeed, "-");
-        }
-
-        IUnit::self().slope2string(trkpt.slope1, val, unit);
-        item->setText(eColSlope, (trkpt.slope1 != NOFLOAT)
-                      ? QString("%1%2").arg(val, unit)
-                      : "-"
-                      );
-
-        IUnit::self().meter2elevation(trkpt.ascent, val, unit);
-        item->setText(eColAscent, tr("%1%2").arg(val, unit));
-        IUnit::self().meter2elevation(trkpt.descent, val, unit);
-        item->setText(eColDescent, tr("%1%2").arg(val, unit));
-
-        // position
-        QString str;
-        IUnit::degToStr(trkpt.lon, trkpt.lat, str);
-        item->setText(eColPosition, str);
-
-        items << item;
+        header()->resizeSections(QHeaderView::ResizeToContents);
     }
+}
 
-    clear();
-    addTopLevelItems(items);
-    header()->resizeSections(QHeaderView::ResizeToContents);
+void CTableTrk::setCurrentTrkPt(qint32 idxTotal)
+{
+    ignoreCurrentChanged = true;
+    setCurrentIndex(proxy->mapFromSource(model->index(idxTotal, 0)));
+    ignoreCurrentChanged = false;
 }
 
 
-void CTableTrk::slotItemSelectionChanged()
+void CTableTrk::slotCurrentChanged(const QModelIndex& current, const QModelIndex& previous)
 {
-    QTreeWidgetItem* item = currentItem();
-    if(nullptr != item)
+    if(ignoreCurrentChanged || (trk == nullptr) || !current.isValid())
     {
-        quint32 idx = item->text(eColNum).toUInt();
-        trk->setMouseFocusByTotalIndex(idx, CGisItemTrk::eFocusMouseMove, "CTableTrk");
+        return;
     }
+
+    const qint32 idx = proxy->mapToSource(current).row();
+    trk->setMouseFocusByTotalIndex(idx, CGisItemTrk::eFocusMouseMove, "CTableTrk");
 }
 
-void CTableTrk::slotItemDoubleClicked(QTreeWidgetItem* item, int column)
+void CTableTrk::slotDoubleClicked(const QModelIndex& index)
 {
-    if(trk->isReadOnly())
+    if((trk == nullptr) || trk->isReadOnly() || (index.column() != CTableTrkModel::eColEle))
+    {
+        return;
+    }
+
+    const qint32 idx = proxy->mapToSource(index).row();
+    const CTrackData::trkpt_t* trkpt = trk->getTrackData().getTrkPtByTotalIndex(idx);
+    if((trkpt == nullptr) || (trkpt->lon == NOFLOAT) || (trkpt->lat == NOFLOAT))
     {
         return;
     }
 
-    qint32 idx = item->text(eColNum).toInt();
     qint32 ele = trk->getElevation(idx);
-    qreal lon, lat;
-    IUnit::strToDeg(item->text(eColPosition), lon, lat);
+    QVariant var(ele);
+    CElevationDialog dlg(this, var, ele, {trkpt->lon, trkpt->lat});
 
-    if((column == eColEle) && (lon != NOFLOAT) && (lat != NOFLOAT))
+    if(dlg.exec() == QDialog::Accepted)
     {
-        QVariant var(ele);
-        CElevationDialog dlg(this, var, ele, {lon, lat});
-
-        if(dlg.exec() == QDialog::Accepted)
-        {
-            trk->setElevation(idx, var.toInt());
-        }
+        trk->setElevation(idx, var.toInt());
     }
 }
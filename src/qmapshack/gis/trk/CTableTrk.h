@@ -20,9 +20,12 @@
 #define CTABLETRK_H
 
 #include <gis/trk/CGisItemTrk.h>
-#include <QTreeWidget>
+#include <gis/trk/CTableTrkModel.h>
+#include <QTreeView>
 
-class CTableTrk : public QTreeWidget, public INotifyTrk
+class QSortFilterProxyModel;
+
+class CTableTrk : public QTreeView, public INotifyTrk
 {
     Q_OBJECT
 public:
@@ -36,33 +39,29 @@ public:
     void setMouseRangeFocus(const CTrackData::trkpt_t* pt1, const CTrackData::trkpt_t* pt2) override {}
     void setMouseClickFocus(const CTrackData::trkpt_t* pt) override {}
 
+    /**
+       @brief Make a track point the current row without feeding it back to the track
 
-    enum columns_t
-    {
-        eColNum
-        , eColTime
-        , eColEle
-        , eColDelta
-        , eColDist
-        , eColSpeed
-        , eColSlope
-        , eColAscent
-        , eColDescent
-        , eColPosition
-        , eColMax
-    };
+       @param idxTotal  the point's total index
+     */
+    void setCurrentTrkPt(qint32 idxTotal);
 
     void showTopItem();
     void showNextInvalid();
     void showPrevInvalid();
 
 private slots:
-    void slotItemSelectionChanged();
-    void slotItemDoubleClicked(QTreeWidgetItem* item, int column);
+    void slotCurrentChanged(const QModelIndex& current, const QModelIndex& previous);
+    void slotDoubleClicked(const QModelIndex& index);
 
 private:
+    void showInvalid(qint32 step);
+
     CGisItemTrk* trk = nullptr;
+    CTableTrkModel* model;
+    QSortFilterProxyModel* proxy;
+    /// set while the current row is changed programmatically
+    bool ignoreCurrentChanged = false;
 };
 
 #endif //CTABLETRK_H
-
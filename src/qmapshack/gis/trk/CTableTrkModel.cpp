@@ -0,0 +1,362 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "gis/proj_x.h"
+#include "gis/trk/CGisItemTrk.h"
+#include "gis/trk/CTableTrkModel.h"
+#include "units/IUnit.h"
+
+#include <QtGui>
+
+CTableTrkModel::CTableTrkModel(QObject* parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+void CTableTrkModel::setTrack(CGisItemTrk* track)
+{
+    beginResetModel();
+    trk = track;
+    fingerprints.clear();
+    if(trk != nullptr)
+    {
+        invalidMask = (trk->getAllValidFlags() & CTrackData::trkpt_t::eValidMask) << 16;
+        isReadOnly = trk->isReadOnly();
+
+        const CTrackData& t = trk->getTrackData();
+        fingerprints.reserve(trk->getCntTotalPoints());
+        for(const CTrackData::trkpt_t& trkpt : t)
+        {
+            fingerprints << fingerprint(trkpt);
+        }
+    }
+    endResetModel();
+}
+
+void CTableTrkModel::updateData()
+{
+    if(trk == nullptr)
+    {
+        return;
+    }
+
+    // use all valid flags as invalid mask. By that only
+    // invalid flags for properties with valid points count
+    const quint32 mask = (trk->getAllValidFlags() & CTrackData::trkpt_t::eValidMask) << 16;
+
+    if((trk->getCntTotalPoints() != fingerprints.size()) || (mask != invalidMask) || (trk->isReadOnly() != isReadOnly))
+    {
+        // structural change or a change affecting all rows
+        setTrack(trk);
+        return;
+    }
+
+    // compare the points with the last known state and
+    // signal each block of changed rows
+    qint32 row = 0;
+    qint32 rowFirstChanged = NOIDX;
+    const CTrackData& t = trk->getTrackData();
+    for(const CTrackData::trkpt_t& trkpt : t)
+    {
+        const uint hash = fingerprint(trkpt);
+        if(hash != fingerprints[row])
+        {
+            fingerprints[row] = hash;
+            if(rowFirstChanged == NOIDX)
+            {
+                rowFirstChanged = row;
+            }
+        }
+        else if(rowFirstChanged != NOIDX)
+        {
+            emit dataChanged(index(rowFirstChanged, 0), index(row - 1, eColMax - 1));
+            rowFirstChanged = NOIDX;
+        }
+        ++row;
+    }
+
+    if(rowFirstChanged != NOIDX)
+    {
+        emit dataChanged(index(rowFirstChanged, 0), index(row - 1, eColMax - 1));
+    }
+}
+
+bool CTableTrkModel::isInvalid(qint32 row) const
+{
+    if(trk == nullptr)
+    {
+        return false;
+    }
+
+    const CTrackData::trkpt_t* trkpt = trk->getTrackData().getTrkPtByTotalIndex(row);
+    return (trkpt != nullptr)
+           && trkpt->isInvalid(CTrackData::trkpt_t::invalid_e(invalidMask))
+           && !trkpt->isHidden();
+}
+
+int CTableTrkModel::rowCount(const QModelIndex& parent) const
+{
+    if(parent.isValid())
+    {
+        return 0;
+    }
+    return fingerprints.size();
+}
+
+int CTableTrkModel::columnCount(const QModelIndex& parent) const
+{
+    if(parent.isValid())
+    {
+        return 0;
+    }
+    return eColMax;
+}
+
+QVariant CTableTrkModel::data(const QModelIndex& index, int role) const
+{
+    if((trk == nullptr) || !index.isValid())
+    {
+        return QVariant();
+    }
+
+    const int column = index.column();
+    switch(role)
+    {
+    case Qt::TextAlignmentRole:
+        switch(column)
+        {
+        case eColEle:
+        case eColDelta:
+        case eColDist:
+        case eColSpeed:
+        case eColAscent:
+        case eColDescent:
+            return int(Qt::AlignRight | Qt::AlignVCenter);
+
+        default:
+            return int(Qt::AlignLeft | Qt::AlignVCenter);
+        }
+
+    case Qt::ToolTipRole:
+        if((column == eColEle) && !isReadOnly)
+        {
+            return tr("Double click to edit elevation value");
+        }
+        return QVariant();
+
+    case Qt::BackgroundRole:
+        if(isInvalid(index.row()))
+        {
+            return QBrush(QColor(255, 100, 100));
+        }
+        return QVariant();
+
+    case Qt::DisplayRole:
+    case Qt::ForegroundRole:
+    case eRoleSort:
+        break;
+
+    default:
+        return QVariant();
+    }
+
+    const CTrackData::trkpt_t* trkpt = trk->getTrackData().getTrkPtByTotalIndex(index.row());
+    if(trkpt == nullptr)
+    {
+        return QVariant();
+    }
+
+    switch(role)
+    {
+    case Qt::DisplayRole:
+        return getText(*trkpt, column);
+
+    case Qt::ForegroundRole:
+        return QBrush(trkpt->isHidden() ? Qt::gray : Qt::black);
+
+    case eRoleSort:
+        return sortData(*trkpt, column);
+    }
+
+    return QVariant();
+}
+
+QVariant CTableTrkModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if((orientation != Qt::Horizontal) || (role != Qt::DisplayRole))
+    {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    switch(section)
+    {
+    case eColNum:
+        return "#";
+
+    case eColTime:
+        return tr("Time");
+
+    case eColEle:
+        return tr("Ele.");
+
+    case eColDelta:
+        return tr("Delta");
+
+    case eColDist:
+        return tr("Dist.");
+
+    case eColSpeed:
+        return tr("Speed");
+
+    case eColSlope:
+        return tr("Slope");
+
+    case eColAscent:
+        return tr("Ascent");
+
+    case eColDescent:
+        return tr("Descent");
+
+    case eColPosition:
+        return tr("Position");
+    }
+
+    return QVariant();
+}
+
+QString CTableTrkModel::getText(const CTrackData::trkpt_t& trkpt, int column)
+{
+    QString val, unit;
+
+    switch(column)
+    {
+    case eColNum:
+        return QString::number(trkpt.idxTotal);
+
+    case eColTime:
+        return trkpt.time.isValid()
+               ? IUnit::self().datetime2string(trkpt.time, true, QPointF(trkpt.lon, trkpt.lat) * DEG_TO_RAD)
+               : "-";
+
+    case eColEle:
+        if(trkpt.ele == NOINT)
+        {
+            return "-";
+        }
+        IUnit::self().meter2elevation(trkpt.ele, val, unit);
+        break;
+
+    case eColDelta:
+        IUnit::self().meter2distance(trkpt.deltaDistance, val, unit);
+        break;
+
+    case eColDist:
+        IUnit::self().meter2distance(trkpt.distance, val, unit);
+        break;
+
+    case eColSpeed:
+        if(trkpt.speed == NOFLOAT)
+        {
+            return "-";
+        }
+        IUnit::self().meter2speed(trkpt.speed, val, unit);
+        break;
+
+    case eColSlope:
+        if(trkpt.slope1 == NOFLOAT)
+        {
+            return "-";
+        }
+        IUnit::self().slope2string(trkpt.slope1, val, unit);
+        break;
+
+    case eColAscent:
+        IUnit::self().meter2elevation(trkpt.ascent, val, unit);
+        break;
+
+    case eColDescent:
+        IUnit::self().meter2elevation(trkpt.descent, val, unit);
+        break;
+
+    case eColPosition:
+        IUnit::degToStr(trkpt.lon, trkpt.lat, val);
+        return val;
+
+    default:
+        return QString();
+    }
+
+    return tr("%1%2").arg(val, unit);
+}
+
+QVariant CTableTrkModel::sortData(const CTrackData::trkpt_t& trkpt, int column) const
+{
+    switch(column)
+    {
+    case eColNum:
+        return trkpt.idxTotal;
+
+    case eColTime:
+        return trkpt.time;
+
+    case eColEle:
+        return trkpt.ele;
+
+    case eColDelta:
+        return trkpt.deltaDistance;
+
+    case eColDist:
+        return trkpt.distance;
+
+    case eColSpeed:
+        return trkpt.speed;
+
+    case eColSlope:
+        return trkpt.slope1;
+
+    case eColAscent:
+        return trkpt.ascent;
+
+    case eColDescent:
+        return trkpt.descent;
+
+    case eColPosition:
+        return getText(trkpt, column);
+    }
+
+    return QVariant();
+}
+
+uint CTableTrkModel::fingerprint(const CTrackData::trkpt_t& trkpt)
+{
+    // everything displayed in a row goes into the hash
+    uint hash = qHash(trkpt.idxTotal);
+    hash = qHash(trkpt.time, hash);
+    hash = qHash(trkpt.lon, hash);
+    hash = qHash(trkpt.lat, hash);
+    hash = qHash(trkpt.ele, hash);
+    hash = qHash(trkpt.deltaDistance, hash);
+    hash = qHash(trkpt.distance, hash);
+    hash = qHash(trkpt.speed, hash);
+    hash = qHash(trkpt.slope1, hash);
+    hash = qHash(trkpt.ascent, hash);
+    hash = qHash(trkpt.descent, hash);
+    hash = qHash(trkpt.valid, hash);
+    hash = qHash(trkpt.isHidden(), hash);
+    return hash;
+}
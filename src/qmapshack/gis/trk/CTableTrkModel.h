@@ -0,0 +1,113 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CTABLETRKMODEL_H
+#define CTABLETRKMODEL_H
+
+#include "gis/trk/CTrackData.h"
+
+#include <QAbstractTableModel>
+#include <QVector>
+
+class CGisItemTrk;
+
+/**
+   @brief Table model exposing the points of a track
+
+   The model does not copy any data. All cells are formatted on demand
+   from the track's data. Thus a view will only ask for the rows it
+   actually displays.
+ */
+class CTableTrkModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    CTableTrkModel(QObject* parent);
+    virtual ~CTableTrkModel() = default;
+
+    enum columns_t
+    {
+        eColNum
+        , eColTime
+        , eColEle
+        , eColDelta
+        , eColDist
+        , eColSpeed
+        , eColSlope
+        , eColAscent
+        , eColDescent
+        , eColPosition
+        , eColMax
+    };
+
+    enum role_e
+    {
+        /// the raw, unformatted value of a cell used for sorting
+        eRoleSort = Qt::UserRole + 1
+    };
+
+    void setTrack(CGisItemTrk* track);
+
+    /**
+       @brief Synchronize the model with the track
+
+       If the number of points has changed the model is reset. Else only the
+       rows with changed point data are signaled to the view.
+     */
+    void updateData();
+
+    /**
+       @brief Test if the point of a row is marked invalid
+
+       Only invalid flags for properties with valid points in the
+       track count. Hidden points are never reported invalid.
+
+       @param row   the row (equal to the point's total index)
+       @return True if the point is invalid
+     */
+    bool isInvalid(qint32 row) const;
+
+    /**
+       @brief Get the formatted text of a track point's property
+
+       @param trkpt     the track point
+       @param column    one of columns_t
+       @return The text as displayed in the table
+     */
+    static QString getText(const CTrackData::trkpt_t& trkpt, int column);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    static uint fingerprint(const CTrackData::trkpt_t& trkpt);
+    QVariant sortData(const CTrackData::trkpt_t& trkpt, int column) const;
+
+    CGisItemTrk* trk = nullptr;
+    /// the invalid mask derived from all valid flags of the track
+    quint32 invalidMask = 0;
+    /// the track's read only state as used for the tool tips
+    bool isReadOnly = true;
+    /// a hash over each point's data, to detect changed rows
+    QVector<uint> fingerprints;
+};
+
+#endif //CTABLETRKMODEL_H
+
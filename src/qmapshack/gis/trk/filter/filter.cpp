@@ -26,6 +26,7 @@
 #include "gis/trk/CKnownExtension.h"
 #include "gis/trk/CPropertyTrk.h"
 
+#include <QHash>
 #include <QLineF>
 #include <QtMath>
 
@@ -582,68 +583,217 @@ void CGisItemTrk::filterChangeStartPoint(qint32 idxNewStartPoint, const QString&
     changed(tr("Start Point moved to: ") + wptName.toLatin1(), "://icons/48x48/FilterChangeStartPoint.png");
 }
 
-void CGisItemTrk::filterLoopsCut(qreal minLoopLength)
+namespace
 {
-    IGisProject* project = CGisWorkspace::self().selectProject(false);
-    if(nullptr == project)
+/**
+   @brief A uniform grid of track segments to find intersection candidates
+
+   Each segment is registered in all cells touched by its bounding box. Segments
+   spanning a lot of cells (e.g. gaps in a recording) are kept in a separate
+   list that is always part of the candidates.
+ */
+class CSegmentGrid
+{
+public:
+    CSegmentGrid(qreal cellSize) : cellSize(cellSize) {}
+
+    void clear()
+    {
+        cells.clear();
+        large.clear();
+    }
+
+    void insert(qint32 idx, const QPointF& p1, const QPointF& p2)
+    {
+        qint32 x1, y1, x2, y2;
+        if(!getCells(p1, p2, 0, x1, y1, x2, y2))
+        {
+            large << idx;
+            return;
+        }
+
+        for(qint32 y = y1; y <= y2; y++)
+        {
+            for(qint32 x = x1; x <= x2; x++)
+            {
+                cells[key(x, y)] << idx;
+            }
+        }
+    }
+
+    /**
+       @brief Collect all segments that might intersect with the line between p1 and p2
+
+       @param p1            first point of the line
+       @param p2            second point of the line
+       @param candidates    the segment indices are appended, might contain duplicates
+       @return False if the line covers too many cells to be queried cheaply
+     */
+    bool query(const QPointF& p1, const QPointF& p2, QVector<qint32>& candidates) const
+    {
+        // Widen the box a bit to be on the safe side with
+        // intersections found right on the border of two cells
+        qint32 x1, y1, x2, y2;
+        if(!getCells(p1, p2, 1e-9, x1, y1, x2, y2))
+        {
+            return false;
+        }
+
+        candidates = large;
+        for(qint32 y = y1; y <= y2; y++)
+        {
+            for(qint32 x = x1; x <= x2; x++)
+            {
+                candidates += cells.value(key(x, y));
+            }
+        }
+        return true;
+    }
+
+private:
+    static constexpr qint32 maxCells = 256;
+
+    static quint64 key(qint32 x, qint32 y)
+    {
+        return (quint64(quint32(x)) << 32) | quint32(y);
+    }
+
+    bool getCells(const QPointF& p1, const QPointF& p2, qreal margin, qint32& x1, qint32& y1, qint32& x2, qint32& y2) const
+    {
+        x1 = qFloor((qMin(p1.x(), p2.x()) - margin) / cellSize);
+        x2 = qFloor((qMax(p1.x(), p2.x()) + margin) / cellSize);
+        y1 = qFloor((qMin(p1.y(), p2.y()) - margin) / cellSize);
+        y2 = qFloor((qMax(p1.y(), p2.y()) + margin) / cellSize);
+
+        return (qint64(x2 - x1 + 1) * (y2 - y1 + 1)) <= maxCells;
+    }
+
+    const qreal cellSize;
+    QHash<quint64, QVector<qint32> > cells;
+    QVector<qint32> large;
+};
+}
+
+void CGisItemTrk::filterGetLoopsCut(qreal minLoopLength, QList<QPair<qint32, qint32> >& parts) const
+{
+    parts.clear();
+
+    QVector<const CTrackData::trkpt_t*> pts;
+    QPolygonF line;
+    for(const CTrackData::trkpt_t& pt : trk)
+    {
+        if(!pt.isHidden())
+        {
+            pts << &pt;
+            line << QPointF(pt.lon, pt.lat);
+        }
+    }
+
+    if(pts.isEmpty())
     {
         return;
     }
 
-    int part = 1;
-    QVector<CTrackData::trkpt_t> pts;
+    // A cell spans a few average segments. Thus a segment
+    // has to be tested against a limited number of others, only.
+    qreal extent = 0;
+    for(qint32 i = 1; i < line.size(); i++)
+    {
+        extent += qAbs(line[i].x() - line[i - 1].x()) + qAbs(line[i].y() - line[i - 1].y());
+    }
+    const qreal cellSize = qMax(4 * extent / line.size(), 1e-5);
 
-    for (const CTrackData::trkpt_t& headPt : trk)
+    CSegmentGrid grid(cellSize);
+    QVector<qint32> candidates;
+    // the last index a segment has been tested for, to skip duplicate candidates
+    QVector<qint32> tested(pts.size(), NOIDX);
+
+    // The current part starts with idxFirst. With each new point (idxHead) the
+    // line to the previous point is tested against all segments of the part
+    // but the one adjacent to it. The segment `i` is the line between point i - 1 and i.
+    qint32 idxFirst = 0;
+    for(qint32 idxHead = 3; idxHead < pts.size(); idxHead++)
     {
-        if(headPt.isHidden())
+        if(idxHead < idxFirst + 3)
         {
+            // a part needs at least 4 points to form a loop
             continue;
         }
 
-        pts << headPt;
+        const qint32 idxPrev = idxHead - 1;
+        const qint32 idxNew = idxHead - 2;
+        grid.insert(idxNew, line[idxNew - 1], line[idxNew]);
 
-        if (pts.size() >= 4)
-        {
-            const QLineF headLine = QLineF(headPt.lon, headPt.lat, pts[pts.size() - 2].lon, pts[pts.size() - 2].lat);
+        const QLineF headLine(line[idxHead], line[idxPrev]);
 
-            bool firstCycle = true;
-            CTrackData::trkpt_t prevScannedPt;
-            for (const CTrackData::trkpt_t& scannedPt : qAsConst(pts))
+        auto isLoop = [&](qint32 i)
+        {
+            if(!((pts[idxPrev]->distance - pts[i]->distance) > minLoopLength)) // loop is not long enough to cut the track
             {
-                if (scannedPt.idxTotal == pts[pts.size() - 2].idxTotal)
-                {
-                    break;
-                }
+                return false;
+            }
+
+            const QLineF scannedLine(line[i], line[i - 1]);
+            QPointF intersectionPoint;
+            return headLine.intersect(scannedLine, &intersectionPoint) == QLineF::BoundedIntersection;
+        };
 
-                if (firstCycle)
+        bool found = false;
+        if(grid.query(line[idxHead], line[idxPrev], candidates))
+        {
+            for(qint32 i : qAsConst(candidates))
+            {
+                if(tested[i] != idxHead)
                 {
-                    prevScannedPt = scannedPt;
-                    firstCycle = false;
-                    continue;
+                    tested[i] = idxHead;
+                    if(isLoop(i))
+                    {
+                        found = true;
+                        break;
+                    }
                 }
-
-                const QLineF scannedLine = QLineF(scannedPt.lon, scannedPt.lat, prevScannedPt.lon, prevScannedPt.lat);
-                QPointF intersectionPoint;
-
-                if ( ( headLine.intersect(scannedLine, &intersectionPoint) == QLineF::BoundedIntersection)
-                     &&
-                     (pts[pts.size() - 2].distance - scannedPt.distance) > minLoopLength) // loop is long enough to cut the track)
+            }
+        }
+        else
+        {
+            for(qint32 i = idxFirst + 1; i <= idxNew; i++)
+            {
+                if(isLoop(i))
                 {
-                    new CGisItemTrk(tr("%1 (Part %2)").arg(trk.name).arg(part), pts.first().idxTotal, pts[pts.size() - 2].idxTotal, trk, project);
-                    part++;
-                    pts.remove(0, pts.size() - 2);
-
+                    found = true;
                     break;
                 }
-
-                prevScannedPt = scannedPt;
             }
         }
-    }
 
+        if(found)
+        {
+            parts << qMakePair(pts[idxFirst]->idxTotal, pts[idxPrev]->idxTotal);
+            idxFirst = idxPrev;
+            grid.clear();
+        }
+    }
 
     // last part : no loop detected but this last part should be copied, too
-    new CGisItemTrk(tr("%1 (Part %2)").arg(trk.name).arg(part), pts.first().idxTotal, pts.last().idxTotal, trk, project);
+    parts << qMakePair(pts[idxFirst]->idxTotal, pts.last()->idxTotal);
+}
+
+void CGisItemTrk::filterLoopsCut(qreal minLoopLength)
+{
+    IGisProject* project = CGisWorkspace::self().selectProject(false);
+    if(nullptr == project)
+    {
+        return;
+    }
+
+    QList<QPair<qint32, qint32> > parts;
+    filterGetLoopsCut(minLoopLength, parts);
+
+    int part = 1;
+    for(const QPair<qint32, qint32>& range : qAsConst(parts))
+    {
+        new CGisItemTrk(tr("%1 (Part %2)").arg(trk.name).arg(part++), range.first, range.second, trk, project);
+    }
 }
 
 void CGisItemTrk::filterZeroSpeedDriftCleaner(qreal distance, qreal ratio)
@@ -0,0 +1,138 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "helpers/CFileScanner.h"
+
+#include <QtCore>
+
+/// the number of files reported at once
+#define BATCH_SIZE 50
+/// the maximum time to collect files before reporting them [ms]
+#define BATCH_TIME 250
+
+CFileScanner::CFileScanner(qint64 keySize, QObject* parent)
+    : QThread(parent)
+    , keySize(keySize)
+{
+}
+
+CFileScanner::~CFileScanner()
+{
+    abort();
+}
+
+void CFileScanner::abort()
+{
+    {
+        QMutexLocker lock(&mutex);
+        keepGoing = false;
+    }
+    wait();
+}
+
+bool CFileScanner::getKeepGoing() const
+{
+    QMutexLocker lock(&mutex);
+    return keepGoing;
+}
+
+void CFileScanner::scan(const QStringList& paths, const QStringList& filters)
+{
+    abort();
+
+    QMutexLocker lock(&mutex);
+    this->paths = paths;
+    this->filters = filters;
+    files.clear();
+    complete = false;
+    keepGoing = true;
+    start();
+}
+
+QList<CFileScanner::file_t> CFileScanner::getFiles(qint32 from) const
+{
+    QMutexLocker lock(&mutex);
+    return files.mid(from);
+}
+
+bool CFileScanner::isComplete() const
+{
+    QMutexLocker lock(&mutex);
+    return complete;
+}
+
+void CFileScanner::waitForComplete()
+{
+    wait();
+}
+
+QString CFileScanner::calcKey(const QString& filename, qint64 size)
+{
+    QFile f(filename);
+    f.open(QIODevice::ReadOnly);
+    QCryptographicHash md5(QCryptographicHash::Md5);
+    md5.addData(f.read(qMin(size, f.size())));
+    return md5.result().toHex();
+}
+
+void CFileScanner::run()
+{
+    QStringList paths;
+    QStringList filters;
+    {
+        QMutexLocker lock(&mutex);
+        paths = this->paths;
+        filters = this->filters;
+    }
+
+    QList<file_t> batch;
+    QElapsedTimer timer;
+    timer.start();
+
+    for(const QString& path : qAsConst(paths))
+    {
+        QDir dir(path);
+        const QStringList& filenames = dir.entryList(filters, QDir::Files | QDir::Readable, QDir::Name);
+        for(const QString& filename : filenames)
+        {
+            if(!getKeepGoing())
+            {
+                return;
+            }
+
+            file_t file;
+            file.filename = dir.absoluteFilePath(filename);
+            file.key = calcKey(file.filename, keySize);
+            batch << file;
+
+            if((batch.size() >= BATCH_SIZE) || timer.hasExpired(BATCH_TIME))
+            {
+                QMutexLocker lock(&mutex);
+                files += batch;
+                batch.clear();
+                timer.restart();
+                emit sigFilesFound();
+            }
+        }
+    }
+
+    QMutexLocker lock(&mutex);
+    files += batch;
+    complete = keepGoing;
+    emit sigFilesFound();
+}
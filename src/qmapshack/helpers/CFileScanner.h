@@ -0,0 +1,114 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CFILESCANNER_H
+#define CFILESCANNER_H
+
+#include <QMutex>
+#include <QStringList>
+#include <QThread>
+
+/**
+   @brief Search paths for files on a worker thread
+
+   Scanning large directories on slow (network) storage can take quite some
+   time. This thread lists the given paths and calculates a key for each file
+   found. The key is a MD5 hash over the first bytes of the file and is used
+   to identify a map or DEM file in the configuration.
+
+   Results are collected in an internal list. Consumers get notified by
+   sigFilesFound() and query new entries via getFiles().
+ */
+class CFileScanner : public QThread
+{
+    Q_OBJECT
+public:
+    struct file_t
+    {
+        /// the absolute path of the file
+        QString filename;
+        /// the MD5 hash over the first bytes of the file
+        QString key;
+    };
+
+    /**
+       @param keySize   the number of bytes used to calculate the key
+       @param parent    the parent object, usually the main window
+     */
+    CFileScanner(qint64 keySize, QObject* parent);
+    virtual ~CFileScanner();
+
+    /**
+       @brief Restart the scan with new paths
+
+       A scan in progress is aborted and all results are dropped.
+
+       @param paths     a list of directories to search in
+       @param filters   a list of wildcard filters like "*.img"
+     */
+    void scan(const QStringList& paths, const QStringList& filters);
+
+    /**
+       @brief Get files found by the current scan
+       @param from  the index of the first file to return
+       @return A list of files. It's empty if there are no new files.
+     */
+    QList<file_t> getFiles(qint32 from) const;
+
+    /**
+       @brief Check if the current scan has finished without being aborted
+     */
+    bool isComplete() const;
+
+    /**
+       @brief Block until the current scan is complete
+     */
+    void waitForComplete();
+
+    /**
+       @brief Calculate the key for a file
+       @param filename  the file's path
+       @param size      the number of bytes to read
+       @return The MD5 hash as hex string
+     */
+    static QString calcKey(const QString& filename, qint64 size);
+
+signals:
+    /**
+       @brief Emitted in batches while new files are found and when the scan is complete.
+     */
+    void sigFilesFound();
+
+protected:
+    void run() override;
+
+private:
+    void abort();
+    bool getKeepGoing() const;
+
+    mutable QMutex mutex;
+    bool keepGoing = false;
+    bool complete = false;
+
+    const qint64 keySize;
+    QStringList paths;
+    QStringList filters;
+    QList<file_t> files;
+};
+
+#endif //CFILESCANNER_H
@@ -49,6 +49,11 @@ void CWptIconManager::removeNumberedBullets()
     mapNumberedBullets.clear();
 }
 
+void CWptIconManager::clearIconCache()
+{
+    iconCache.clear();
+}
+
 QPixmap CWptIconManager::createGrayscale(QString path)
 {
     QPixmap pixmap(path);
@@ -61,6 +66,7 @@ QPixmap CWptIconManager::createGrayscale(QString path)
 
 void CWptIconManager::init()
 {
+    clearIconCache();
     wptIcons.clear();
 
     wptIcons["Default"] = icon_t(wptDefault, 16, 16);
@@ -207,6 +213,8 @@ void CWptIconManager::setWptIconByName(const QString& name, const QString& filen
 {
     QPixmap icon(filename);
     wptIcons[name] = icon_t(filename, icon.width() >> 1, icon.height() >> 1);
+    // unknown names are cached with the default icon, thus drop all entries
+    clearIconCache();
 }
 
 
@@ -218,6 +226,7 @@ void CWptIconManager::setWptIconByName(const QString& name, const QPixmap& icon)
 
     icon.save(filename);
     wptIcons[name] = icon_t(filename, icon.width() >> 1, icon.height() >> 1);
+    clearIconCache();
 }
 
 QPixmap CWptIconManager::loadIcon(const QString& path)
@@ -236,8 +245,20 @@ QPixmap CWptIconManager::loadIcon(const QString& path)
 }
 
 
-QPixmap CWptIconManager::getWptIconByName(const QString& name, QPointF& focus, QString* src)
+QPixmap CWptIconManager::getWptIconByName(const QString& name, QPointF& focus, QString* src, qint32 maxSize)
 {
+    const QPair<QString, qint32> key(name, maxSize);
+    if(iconCache.contains(key))
+    {
+        const cached_icon_t& cached = iconCache[key];
+        focus = cached.focus;
+        if(src)
+        {
+            *src = cached.path;
+        }
+        return cached.icon;
+    }
+
     QPixmap icon;
     QString path;
 
@@ -264,23 +285,25 @@ QPixmap CWptIconManager::getWptIconByName(const QString& name, QPointF& focus, Q
 
     icon = loadIcon(path);
 
-    // Limit icon size to 22 pixel max.
-    if(icon.width() > 22 || icon.height() > 22)
+    // Limit icon size to maxSize pixel.
+    if(icon.width() > maxSize || icon.height() > maxSize)
     {
         qreal s;
         if(icon.width() > icon.height())
         {
-            s = 22.0 / icon.width();
+            s = qreal(maxSize) / icon.width();
         }
         else
         {
-            s = 22.0 / icon.height();
+            s = qreal(maxSize) / icon.height();
         }
 
         focus = focus * s;
         icon = icon.scaled(icon.size() * s, Qt::KeepAspectRatio, Qt::SmoothTransformation);
     }
 
+    iconCache[key] = {icon, focus, path};
+
     return icon;
 }
 
@@ -23,6 +23,7 @@
 
 #include <QAction>
 #include <QFont>
+#include <QHash>
 #include <QMap>
 #include <QMenu>
 #include <QObject>
@@ -52,7 +53,20 @@ public:
 
 
     void init();
-    QPixmap getWptIconByName(const QString& name, QPointF& focus, QString* src = nullptr);
+    /**
+       @brief Get the icon for a waypoint symbol name
+
+       The icon is scaled down to fit into maxSize x maxSize pixels. The result is
+       cached by name and size. Thus loading thousands of waypoints with the same
+       symbol will decode and scale the icon only once.
+
+       @param name      the symbol name. If unknown the default icon is returned
+       @param focus     will receive the icon's focus point, scaled like the icon
+       @param src       if not nullptr it will receive the path of the icon file
+       @param maxSize   the maximum width and height of the icon in pixel
+       @return The icon's pixmap
+     */
+    QPixmap getWptIconByName(const QString& name, QPointF& focus, QString* src = nullptr, qint32 maxSize = 22);
     QString selectWptIcon(QWidget* parent);
 
     QMenu* getWptIconMenu(const QString& title, QObject* obj, const char* slot, QWidget* parent);
@@ -73,6 +87,7 @@ private:
     void setWptIconByName(const QString& name, const QString& filename);
     void setWptIconByName(const QString& name, const QPixmap& icon);
     void removeNumberedBullets();
+    void clearIconCache();
 
     static CWptIconManager* pSelf;
     static const char* wptDefault;
@@ -81,6 +96,16 @@ private:
 
     QMap<QString, icon_t> wptIcons;
 
+    struct cached_icon_t
+    {
+        QPixmap icon;
+        QPointF focus;
+        QString path;
+    };
+
+    /// scaled icons as returned by getWptIconByName(), keyed by name and maximum size
+    QHash<QPair<QString, qint32>, cached_icon_t> iconCache;
+
     QMap<qint32, QString> mapNumberedBullets;
 
     QPixmap createGrayscale(QString path);
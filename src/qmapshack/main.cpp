@@ -18,6 +18,7 @@
 
 #include "CMainWindow.h"
 #include "CSingleInstanceProxy.h"
+#include "print/CBatchRender.h"
 #include "setup/IAppSetup.h"
 #include "version.h"
 
@@ -47,6 +48,14 @@ int main(int argc, char** argv)
     // setup default proxy
     QNetworkProxyFactory::setUseSystemConfiguration(true);
 
+    // Render the jobs without showing the main window and quit. The main window
+    // is still needed as it owns the workspace and the map/DEM setup.
+    if(!qlOpts->renderJobs.isEmpty())
+    {
+        CMainWindow w;
+        return CBatchRender::exec(qlOpts->renderJobs, qlOpts->arguments);
+    }
+
     // make sure this is the one and only instance on the system
     CSingleInstanceProxy s(qlOpts->arguments);
 
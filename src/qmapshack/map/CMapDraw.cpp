@@ -20,6 +20,7 @@
 #include "CMainWindow.h"
 #include "gis/Poi.h"
 #include "helpers/CDraw.h"
+#include "helpers/CFileScanner.h"
 #include "helpers/CSettings.h"
 #include "map/cache/CDiskCache.h"
 #include "map/CMapDraw.h"
@@ -32,12 +33,14 @@
 #include <QtGui>
 #include <QtWidgets>
 
-
+/// the number of bytes used to calculate a map's key
+#define MAP_KEY_SIZE 0x1000
 
 QList<CMapDraw*> CMapDraw::maps;
 QString CMapDraw::cachePath = "";
 QStringList CMapDraw::mapPaths;
 QStringList CMapDraw::supportedFormats = QString("*.vrt|*.jnx|*.img|*.rmap|*.wmts|*.tms|*.gemf").split('|');
+CFileScanner* CMapDraw::scanner = nullptr;
 
 
 CMapDraw::CMapDraw(CCanvas* parent)
@@ -48,6 +51,13 @@ CMapDraw::CMapDraw(CCanvas* parent)
     connect(canvas, &CCanvas::destroyed, mapList, &CMapList::deleteLater);
     connect(mapList, &CMapList::sigChanged, this, &CMapDraw::emitSigCanvasUpdate);
 
+    if(scanner == nullptr)
+    {
+        scanner = new CFileScanner(MAP_KEY_SIZE, &CMainWindow::self());
+        scanner->scan(mapPaths, supportedFormats);
+    }
+    connect(scanner, &CFileScanner::sigFilesFound, this, &CMapDraw::slotFilesFound);
+
     buildMapList();
 
     maps << this;
@@ -102,6 +112,11 @@ void CMapDraw::setupMapPath(const QStringList& paths)
 {
     mapPaths = paths;
 
+    if(scanner != nullptr)
+    {
+        scanner->scan(mapPaths, supportedFormats);
+    }
+
     for(CMapDraw* map : qAsConst(maps))
     {
         QStringList keys;
@@ -286,7 +301,7 @@ void CMapDraw::loadConfig(QSettings& cfg) /* override */
     zoom(idx);
 }
 
-CMapItem* CMapDraw::createMapItem(const QString& filename, QSet<QString>& maps)
+CMapItem* CMapDraw::createMapItem(const QString& filename, const QString& key, QSet<QString>& maps)
 {
     CMapItem* item = new CMapItem(*mapList, this);
 
@@ -294,7 +309,7 @@ CMapItem* CMapDraw::createMapItem(const QString& filename, QSet<QString>& maps)
     maps.insert(fi.completeBaseName());
 
     item->setText(0, fi.completeBaseName().replace("_", " "));
-    item->setFilename(filename);
+    item->setFilename(filename, key);
     item->updateIcon();
     return item;
 }
@@ -303,9 +318,12 @@ void CMapDraw::buildMapList(const QString& filename)
 {
     QMutexLocker lock(&CMapItem::mutexActiveMaps);
     mapList->clear();
+    mapNames.clear();
+    keysPending.clear();
+    useMapPaths = false;
+    scanDone = true;
 
-    QSet<QString> maps;
-    CMapItem* item = createMapItem(filename, maps);
+    CMapItem* item = createMapItem(filename, CFileScanner::calcKey(filename, MAP_KEY_SIZE), mapNames);
     item->activate();
 }
 
@@ -313,28 +331,86 @@ void CMapDraw::buildMapList()
 {
     QMutexLocker lock(&CMapItem::mutexActiveMaps);
     mapList->clear();
+    mapNames.clear();
+    keysPending.clear();
+    useMapPaths = true;
+    scanDone = false;
+    cntScanned = 0;
+
+    // take all files the scanner has found so far
+    slotFilesFound();
+}
+
+void CMapDraw::slotFilesFound()
+{
+    if(!useMapPaths || scanDone)
+    {
+        return;
+    }
+
+    QMutexLocker lock(&CMapItem::mutexActiveMaps);
 
-    QSet<QString> maps;
+    // query the state first, to be sure to get all files if complete
+    const bool complete = scanner->isComplete();
+    const QList<CFileScanner::file_t>& files = scanner->getFiles(cntScanned);
+    cntScanned += files.size();
 
-    for(const QString& path : qAsConst(mapPaths))
+    for(const CFileScanner::file_t& file : files)
     {
-        QDir dir(path);
+        createMapItem(file.filename, file.key, mapNames);
+    }
 
-        // find available maps
-        const QStringList& filenames = dir.entryList(supportedFormats, QDir::Files | QDir::Readable, QDir::Name);
-        for(const QString& filename : filenames)
-        {
-            createMapItem(dir.absoluteFilePath(filename), maps);
-        }
+    if(!files.isEmpty())
+    {
+        mapList->sort();
     }
 
-    mapList->sort();
+    if(complete)
+    {
+        scanDone = true;
+        CDiskCache::cleanupRemovedMaps(mapNames);
+    }
 
-    CDiskCache::cleanupRemovedMaps(maps);
+    restorePendingMaps();
 
     mapList->updateHelpText();
 }
 
+void CMapDraw::restorePendingMaps()
+{
+    QMutexLocker lock(&CMapItem::mutexActiveMaps);
+
+    while(!keysPending.isEmpty())
+    {
+        CMapItem* item = nullptr;
+        for(int i = 0; i < mapList->count(); i++)
+        {
+            CMapItem* map = mapList->item(i);
+            if(map && map->getKey() == keysPending.first())
+            {
+                item = map;
+                break;
+            }
+        }
+
+        if((item == nullptr) && !scanDone)
+        {
+            break;
+        }
+
+        keysPending.removeFirst();
+
+        if(item != nullptr)
+        {
+            /**
+                @Note   the item will load it's configuration upon successful activation
+                        by calling loadConfigForMapItem().
+             */
+            item->activate();
+        }
+    }
+}
+
 void CMapDraw::saveActiveMapsList(QStringList& keys)
 {
     SETTINGS;
@@ -358,6 +434,9 @@ void CMapDraw::saveActiveMapsList(QStringList& keys, QSettings& cfg)
             keys << item->getKey();
         }
     }
+
+    // maps not found yet by the scan are still part of the configuration
+    keys += keysPending;
 }
 
 void CMapDraw::loadConfigForMapItem(CMapItem* item)
@@ -379,23 +458,8 @@ void CMapDraw::restoreActiveMapsList(const QStringList& keys)
 {
     QMutexLocker lock(&CMapItem::mutexActiveMaps);
 
-    for(const QString& key : keys)
-    {
-        for(int i = 0; i < mapList->count(); i++)
-        {
-            CMapItem* item = mapList->item(i);
-
-            if(item && item->getKey() == key)
-            {
-                /**
-                    @Note   the item will load it's configuration upon successful activation
-                            by calling loadConfigForMapItem().
-                 */
-                item->activate();
-                break;
-            }
-        }
-    }
+    keysPending += keys;
+    restorePendingMaps();
 
     mapList->updateHelpText();
 }
@@ -404,6 +468,12 @@ void CMapDraw::restoreActiveMapsList(const QStringList& keys, QSettings& cfg)
 {
     QMutexLocker lock(&CMapItem::mutexActiveMaps);
 
+    if(!scanDone)
+    {
+        scanner->waitForComplete();
+        slotFilesFound();
+    }
+
     for(const QString& key : keys)
     {
         for(int i = 0; i < mapList->count(); i++)
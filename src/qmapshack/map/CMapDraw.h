@@ -20,10 +20,12 @@
 #define CMAPDRAW_H
 
 #include "canvas/IDrawContext.h"
+#include <QSet>
 #include <QStringList>
 
 class QPainter;
 class CCanvas;
+class CFileScanner;
 class CMapList;
 class QSettings;
 class CMapItem;
@@ -138,22 +140,41 @@ signals:
 protected:
     void drawt(buffer_t& currentBuffer) override;
 
+private slots:
+    /**
+       @brief Add the files found by the scanner since the last call to mapList.
+
+       Pending maps are restored as soon as they are found. Once the scan is
+       complete all remaining pending maps are dropped.
+     */
+    void slotFilesFound();
 
 private:
     /**
        @brief Create a CMapItem from a filename
 
        @param filename the map's filename, can be a resuource, too
+       @param key   the map's MD5 key
        @param maps  a set to collect the paths of all collected maps.
 
        @return The created map item.
      */
-    CMapItem* createMapItem(const QString& filename, QSet<QString>& maps);
+    CMapItem* createMapItem(const QString& filename, const QString& key, QSet<QString>& maps);
     /**
-       @brief Search in paths found in mapPaths for files with supported extensions and add them to mapList.
+       @brief Fill mapList with the files found in mapPaths
 
+       The paths are scanned in the background by the scanner shared by all
+       CMapDraw objects. The map list will be populated incrementally by
+       slotFilesFound().
      */
     void buildMapList();
+    /**
+       @brief Activate pending maps in the order they have been requested
+
+       A pending map not found yet will stop the restore to keep the order of
+       active maps. Unless the scan is complete. Then missing maps are skipped.
+     */
+    void restorePendingMaps();
     /**
        @brief Save list of active maps to configuration file
 
@@ -171,10 +192,18 @@ private:
     void saveActiveMapsList(QStringList& keys);
     /**
        @brief Restore list of active maps from configuration file
+
+       Maps not found yet by a running scan are restored as soon as they show up.
+
        @param keys MD5 hash keys to identify the maps
      */
     void restoreActiveMapsList(const QStringList& keys);
+    /**
+       @brief Restore list of active maps from the given configuration
 
+       As the configuration object is only valid during this call, this will
+       wait for a running scan to complete.
+     */
     void restoreActiveMapsList(const QStringList& keys, QSettings& cfg);
 
     /// the treewidget holding all active and inactive map items
@@ -194,6 +223,20 @@ private:
     /// a list of supported map formats
     static QStringList supportedFormats;
 
+    /// search mapPaths for maps in the background
+    static CFileScanner* scanner;
+
+    /// the number of files already taken from the scanner
+    qint32 cntScanned = 0;
+    /// true if all files of the scanner have been taken
+    bool scanDone = false;
+    /// false if the map list was built from a single file
+    bool useMapPaths = true;
+    /// the basenames of all maps in the list
+    QSet<QString> mapNames;
+    /// keys of maps to activate once they are found
+    QStringList keysPending;
+
     bool hasActiveMap = false;
 };
 
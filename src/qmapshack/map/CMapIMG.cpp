@@ -1221,6 +1221,9 @@ quint8 CMapIMG::scale2bits(const QPointF& scale)
 
 void CMapIMG::draw(IDrawContext::buffer_t& buf) /* override */
 {
+    // the objects of the last frame are about to become invalid
+    clearPickIndex();
+
     if(map->needsRedraw())
     {
         return;
@@ -1342,6 +1345,47 @@ void CMapIMG::draw(IDrawContext::buffer_t& buf) /* override */
     drawLabels(p, labels);
 
     p.restore();
+
+    buildPickIndex(QRectF(pp, QSizeF(buf.image.size())));
+}
+
+void CMapIMG::buildPickIndex(const QRectF& area)
+{
+    pickPolygons.reset(area);
+    for(int i = 0; i < polygons.size(); i++)
+    {
+        const QPolygonF& poly = polygons[i].pixel;
+        if(poly.size() > 2)
+        {
+            pickPolygons.insert(poly.boundingRect(), i);
+        }
+    }
+
+    pickPolylines.reset(area);
+    for(int i = 0; i < polylines.size(); i++)
+    {
+        pickPolylines.insertSegments(polylines[i].pixel, i);
+    }
+
+    pickPoints.reset(area);
+    for(int i = 0; i < points.size(); i++)
+    {
+        pickPoints.insert(QRectF(points[i].pos, QSizeF(0, 0)), i);
+    }
+
+    pickPois.reset(area);
+    for(int i = 0; i < pois.size(); i++)
+    {
+        pickPois.insert(QRectF(pois[i].pos, QSizeF(0, 0)), i);
+    }
+}
+
+void CMapIMG::clearPickIndex()
+{
+    pickPolygons.clear();
+    pickPolylines.clear();
+    pickPoints.clear();
+    pickPois.clear();
 }
 
 void CMapIMG::loadVisibleData(bool fast, polytype_t& polygons, polytype_t& polylines, pointtype_t& points, pointtype_t& pois, unsigned level, const QRectF& viewport, QPainter& p)
@@ -2291,8 +2335,8 @@ void CMapIMG::getToolTip(const QPoint& px, QString& infotext) const /* override
     QString str;
 
     QMultiMap<QString, QString> dict;
-    getInfoPoints(points, px, dict);
-    getInfoPoints(pois, px, dict);
+    getInfoPoints(points, pickPoints, px, dict);
+    getInfoPoints(pois, pickPois, px, dict);
     getInfoPolylines(px, dict);
 
     const QStringList& values = dict.values();
@@ -2342,10 +2386,16 @@ void CMapIMG::getToolTip(const QPoint& px, QString& infotext) const /* override
 
 void CMapIMG::findPOICloseBy(const QPoint& pt, poi_t& poi) const /*override;*/
 {
-    for(auto& list : {points, pois})
+    const QRectF rect(pt.x() - 10, pt.y() - 10, 20, 20);
+    QVector<quint64> ids;
+
+    const QList<QPair<const pointtype_t*, const CGarminPickIndex*> > lists = {{&points, &pickPoints}, {&pois, &pickPois}};
+    for(const QPair<const pointtype_t*, const CGarminPickIndex*>& list : lists)
     {
-        for(const CGarminPoint& point : list)
+        list.second->find(rect, ids);
+        for(quint64 id : qAsConst(ids))
         {
+            const CGarminPoint& point = (*list.first)[id];
             QPoint x = pt - QPoint(point.pos.x(), point.pos.y());
             if(x.manhattanLength() < 10)
             {
@@ -2374,10 +2424,14 @@ void CMapIMG::findPOICloseBy(const QPoint& pt, poi_t& poi) const /*override;*/
     }
 }
 
-void CMapIMG::getInfoPoints(const pointtype_t& points, const QPoint& pt, QMultiMap<QString, QString>& dict) const
+void CMapIMG::getInfoPoints(const pointtype_t& points, const CGarminPickIndex& pick, const QPoint& pt, QMultiMap<QString, QString>& dict) const
 {
-    for(const CGarminPoint& point : points)
+    QVector<quint64> ids;
+    pick.find(QRectF(pt.x() - 10, pt.y() - 10, 20, 20), ids);
+
+    for(quint64 id : qAsConst(ids))
     {
+        const CGarminPoint& point = points[id];
         QPoint x = pt - QPoint(point.pos.x(), point.pos.y());
         if(x.manhattanLength() < 10)
         {
@@ -2413,59 +2467,55 @@ void CMapIMG::getInfoPolylines(const QPoint& pt, QMultiMap<QString, QString>& di
 
     bool found = false;
 
-    for(const CGarminPolygon& line : polylines)
+    QVector<quint64> ids;
+    pickPolylines.find(QRectF(pt.x() - shortest, pt.y() - shortest, 2 * shortest, 2 * shortest), ids);
+
+    // see http://local.wasp.uwa.edu.au/~pbourke/geometry/pointline/
+    for(quint64 id : qAsConst(ids))
     {
-        int len = line.pixel.size();
-        // need at least 2 points
-        if(len < 2)
-        {
-            continue;
-        }
+        const CGarminPolygon& line = polylines[CGarminPickIndex::getIndex(id)];
+        const int i = CGarminPickIndex::getSegment(id);
 
-        // see http://local.wasp.uwa.edu.au/~pbourke/geometry/pointline/
-        for(int i = 1; i < len; ++i)
-        {
-            p1.u = line.pixel[i - 1].x();
-            p1.v = line.pixel[i - 1].y();
-            p2.u = line.pixel[i].x();
-            p2.v = line.pixel[i].y();
+        p1.u = line.pixel[i - 1].x();
+        p1.v = line.pixel[i - 1].y();
+        p2.u = line.pixel[i].x();
+        p2.v = line.pixel[i].y();
 
-            qreal dx = p2.u - p1.u;
-            qreal dy = p2.v - p1.v;
+        qreal dx = p2.u - p1.u;
+        qreal dy = p2.v - p1.v;
 
-            // distance between p1 and p2
-            qreal d_p1_p2 = qSqrt(dx * dx + dy * dy);
+        // distance between p1 and p2
+        qreal d_p1_p2 = qSqrt(dx * dx + dy * dy);
 
-            u = ((pt.x() - p1.u) * dx + (pt.y() - p1.v) * dy) / (d_p1_p2 * d_p1_p2);
+        u = ((pt.x() - p1.u) * dx + (pt.y() - p1.v) * dy) / (d_p1_p2 * d_p1_p2);
 
-            if(u < 0.0 || u > 1.0)
-            {
-                continue;
-            }
+        if(u < 0.0 || u > 1.0)
+        {
+            continue;
+        }
 
-            // coord. (x,y) of the point on line defined by [p1,p2] close to pt
-            qreal x = p1.u + u * dx;
-            qreal y = p1.v + u * dy;
+        // coord. (x,y) of the point on line defined by [p1,p2] close to pt
+        qreal x = p1.u + u * dx;
+        qreal y = p1.v + u * dy;
 
-            qreal distance = qSqrt((x - pt.x()) * (x - pt.x()) + (y - pt.y()) * (y - pt.y()));
+        qreal distance = qSqrt((x - pt.x()) * (x - pt.x()) + (y - pt.y()) * (y - pt.y()));
 
-            if(distance < shortest)
-            {
-                type = line.type;
-                value.clear();
-                value << (line.hasLabel() ? line.getLabelText() : "-");
-
-                resPt.setX(x);
-                resPt.setY(y);
-                shortest = distance;
-                found = true;
-            }
-            else if(distance == shortest)
+        if(distance < shortest)
+        {
+            type = line.type;
+            value.clear();
+            value << (line.hasLabel() ? line.getLabelText() : "-");
+
+            resPt.setX(x);
+            resPt.setY(y);
+            shortest = distance;
+            found = true;
+        }
+        else if(distance == shortest)
+        {
+            if(line.hasLabel())
             {
-                if(line.hasLabel())
-                {
-                    value << line.getLabelText();
-                }
+                value << line.getLabelText();
             }
         }
     }
@@ -2507,8 +2557,12 @@ void CMapIMG::getInfoPolygons(const QPoint& pt, QMultiMap<QString, QString>& dic
     const qreal x = pt.x();
     const qreal y = pt.y();
 
-    for(const CGarminPolygon& line : polygons)
+    QVector<quint64> ids;
+    pickPolygons.find(QRectF(x, y, 0, 0), ids);
+
+    for(quint64 id : qAsConst(ids))
     {
+        const CGarminPolygon& line = polygons[id];
         int npol = line.pixel.size();
         if(npol > 2)
         {
@@ -2561,8 +2615,32 @@ void CMapIMG::getInfoPolygons(const QPoint& pt, QMultiMap<QString, QString>& dic
 
 bool CMapIMG::findPolylineCloseBy(const QPointF& pt1, const QPointF& pt2, qint32 threshold, QPolygonF& polyline) /* override */
 {
-    for(const CGarminPolygon& line : qAsConst(polylines))
+    // only polylines with segments close to both points are of interest
+    auto findLines = [&](const QPointF& pt)
+    {
+        QVector<quint64> ids;
+        pickPolylines.find(QRectF(pt.x() - threshold, pt.y() - threshold, 2 * threshold, 2 * threshold), ids);
+
+        QVector<quint32> lines;
+        for(quint64 id : qAsConst(ids))
+        {
+            const quint32 idx = CGarminPickIndex::getIndex(id);
+            if(lines.isEmpty() || lines.last() != idx)
+            {
+                lines << idx;
+            }
+        }
+        return lines;
+    };
+
+    const QVector<quint32>& lines1 = findLines(pt1);
+    const QVector<quint32>& lines2 = findLines(pt2);
+    QVector<quint32> lines;
+    std::set_intersection(lines1.begin(), lines1.end(), lines2.begin(), lines2.end(), std::back_inserter(lines));
+
+    for(quint32 idx : qAsConst(lines))
     {
+        const CGarminPolygon& line = polylines[idx];
         if(line.pixel.size() < 2)
         {
             continue;
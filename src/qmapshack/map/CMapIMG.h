@@ -19,6 +19,7 @@
 #ifndef CMAPIMG_H
 #define CMAPIMG_H
 
+#include "map/garmin/CGarminPickIndex.h"
 #include "map/garmin/CGarminPoint.h"
 #include "map/garmin/CGarminPolygon.h"
 #include "map/garmin/CGarminTyp.h"
@@ -187,9 +188,12 @@ private:
 
     void collectText(const CGarminPolygon& item, const QPolygonF& line, const QFont& font, const QFontMetricsF& metrics, qint32 lineWidth);
 
-    void getInfoPoints(const pointtype_t& points, const QPoint& pt, QMultiMap<QString, QString>& dict) const;
+    void getInfoPoints(const pointtype_t& points, const CGarminPickIndex& pick, const QPoint& pt, QMultiMap<QString, QString>& dict) const;
     void getInfoPolylines(const QPoint& pt, QMultiMap<QString, QString>& dict) const;
     void getInfoPolygons(const QPoint& pt, QMultiMap<QString, QString>& dict) const;
+    /// index the objects of the frame just drawn, area is the buffer [px]
+    void buildPickIndex(const QRectF& area);
+    void clearPickIndex();
 
 #pragma pack(1)
     // Garmin IMG file header structure, to the start of the FAT blocks
@@ -499,6 +503,16 @@ private:
     pointtype_t points;
     pointtype_t pois;
 
+    /**
+       The pick indices of the objects above in screen pixel coordinates. They are
+       built after a frame has been drawn completely and are empty else. Polylines
+       are indexed by segment, polygons by bounding box.
+     */
+    CGarminPickIndex pickPolygons;
+    CGarminPickIndex pickPolylines;
+    CGarminPickIndex pickPoints;
+    CGarminPickIndex pickPois;
+
     QVector<strlbl_t> labels;
 
     struct textpath_t
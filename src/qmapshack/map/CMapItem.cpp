@@ -43,16 +43,10 @@ CMapItem::~CMapItem()
 {
 }
 
-void CMapItem::setFilename(const QString& name)
+void CMapItem::setFilename(const QString& name, const QString& hash)
 {
     filename = name;
-
-    QFile f(filename);
-    f.open(QIODevice::ReadOnly);
-    QCryptographicHash md5(QCryptographicHash::Md5);
-    md5.addData(f.read(qMin(0x1000LL, f.size())));
-    key = md5.result().toHex();
-    f.close();
+    key = hash;
 }
 
 void CMapItem::saveConfig(QSettings& cfg) const
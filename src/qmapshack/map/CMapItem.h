@@ -34,7 +34,15 @@ public:
     CMapItem(QTreeWidget* parent, CMapDraw* map);
     virtual ~CMapItem();
 
-    void setFilename(const QString& name);
+    /**
+       @brief Set the map's file and key
+
+       The map file itself is not opened until the item is activated.
+
+       @param name  the map's filename
+       @param hash  the MD5 hash identifying the map, see CFileScanner::calcKey()
+     */
+    void setFilename(const QString& name, const QString& hash);
 
     void saveConfig(QSettings& cfg) const;
     void loadConfig(QSettings& cfg);
@@ -99,10 +99,22 @@ void CMapList::clear()
 
 void CMapList::sort()
 {
+    // active items stay on top in their order
+    int first = 0;
+    while(first < treeWidget->topLevelItemCount())
+    {
+        CMapItem* item = dynamic_cast<CMapItem*>(treeWidget->topLevelItem(first));
+        if(item == nullptr || !item->isActivated())
+        {
+            break;
+        }
+        first++;
+    }
+
     QList<CMapItem*> items1;
-    while(treeWidget->topLevelItemCount())
+    while(treeWidget->topLevelItemCount() > first)
     {
-        CMapItem* item = dynamic_cast<CMapItem*>(treeWidget->takeTopLevelItem(0));
+        CMapItem* item = dynamic_cast<CMapItem*>(treeWidget->takeTopLevelItem(treeWidget->topLevelItemCount() - 1));
         if(item != nullptr)
         {
             items1 << item;
@@ -117,6 +129,12 @@ void CMapList::sort()
         items2 << item;
     }
     treeWidget->addTopLevelItems(items2);
+
+    // items added while a filter is set have to be filtered, too
+    if(!lineFilter->text().isEmpty())
+    {
+        slotFilter(lineFilter->text());
+    }
 }
 
 int CMapList::count()
@@ -52,6 +52,7 @@ public:
     virtual ~CMapList();
 
     void clear();
+    /// sort all inactive maps by name, active maps stay on top
     void sort();
     int count();
     CMapItem* item(int i);
@@ -18,9 +18,11 @@
 
 #include "CMainWindow.h"
 #include "gis/proj_x.h"
+#include "helpers/CDraw.h"
 #include "helpers/CFileExt.h"
 #include "map/CMapDraw.h"
 #include "map/CMapMAP.h"
+#include "units/IUnit.h"
 
 #include <QtWidgets>
 
@@ -28,6 +30,276 @@
 
 #define INT_TO_RAD(x) (qreal(x) / (1e6 * RAD_TO_DEG))
 
+/// do not draw the map if the viewport needs more tiles than this
+#define MAX_TILES 1024
+
+static inline qint32 lon2tileX(qreal lon, quint8 z)
+{
+    const qint32 n = 1 << z;
+    return qBound(0, qFloor((lon + 180.0) / 360.0 * n), n - 1);
+}
+
+static inline qint32 lat2tileY(qreal lat, quint8 z)
+{
+    const qint32 n = 1 << z;
+    const qreal latRad = qBound(-85.0511, lat, 85.0511) * DEG_TO_RAD;
+    return qBound(0, qFloor((1.0 - qLn(qTan(latRad) + 1.0 / qCos(latRad)) / M_PI) / 2.0 * n), n - 1);
+}
+
+static inline qreal tileX2lon(qint32 x, quint8 z)
+{
+    return x / qreal(1 << z) * 360.0 - 180.0;
+}
+
+static inline qreal tileY2lat(qint32 y, quint8 z)
+{
+    const qreal n = M_PI - 2.0 * M_PI * y / qreal(1 << z);
+    return RAD_TO_DEG * qAtan(0.5 * (qExp(n) - qExp(-n)));
+}
+
+/**
+   @brief A very simple render theme
+
+   The entries are ordered by drawing order. A tag "key=*" matches all values of key.
+ */
+struct mapsforge_style_t
+{
+    const char* tag;
+    bool isArea;
+    QRgb color;
+    qreal width;        //< line width in [px] at zoom level 15
+    QRgb casing;        //< line casing color, 0 for none
+    Qt::PenStyle style;
+    quint8 minZoom;
+};
+
+static const mapsforge_style_t mapsforgeStyles[] =
+{
+    // areas
+    {"landuse=farmland", true, 0xFFEEF0D5, 0, 0, Qt::SolidLine, 0}
+    , {"landuse=meadow", true, 0xFFCDEBB0, 0, 0, Qt::SolidLine, 0}
+    , {"landuse=grass", true, 0xFFCDEBB0, 0, 0, Qt::SolidLine, 0}
+    , {"landuse=residential", true, 0xFFE0DFDF, 0, 0, Qt::SolidLine, 0}
+    , {"landuse=industrial", true, 0xFFEBDBE8, 0, 0, Qt::SolidLine, 0}
+    , {"landuse=commercial", true, 0xFFF2DAD9, 0, 0, Qt::SolidLine, 0}
+    , {"landuse=retail", true, 0xFFFFD6D1, 0, 0, Qt::SolidLine, 0}
+    , {"natural=heath", true, 0xFFD6D99F, 0, 0, Qt::SolidLine, 0}
+    , {"natural=scrub", true, 0xFFC8D7AB, 0, 0, Qt::SolidLine, 0}
+    , {"natural=grassland", true, 0xFFCDEBB0, 0, 0, Qt::SolidLine, 0}
+    , {"landuse=forest", true, 0xFFADD19E, 0, 0, Qt::SolidLine, 0}
+    , {"natural=wood", true, 0xFFADD19E, 0, 0, Qt::SolidLine, 0}
+    , {"natural=glacier", true, 0xFFDDECEC, 0, 0, Qt::SolidLine, 0}
+    , {"natural=sea", true, 0xFFAAD3DF, 0, 0, Qt::SolidLine, 0}
+    , {"natural=nosea", true, 0xFFF2EFE9, 0, 0, Qt::SolidLine, 0}
+    , {"leisure=park", true, 0xFFC8FACC, 0, 0, Qt::SolidLine, 0}
+    , {"leisure=pitch", true, 0xFFAAE0CB, 0, 0, Qt::SolidLine, 0}
+    , {"amenity=parking", true, 0xFFEEEEEE, 0, 0, Qt::SolidLine, 0}
+    , {"natural=water", true, 0xFFAAD3DF, 0, 0, Qt::SolidLine, 0}
+    , {"waterway=riverbank", true, 0xFFAAD3DF, 0, 0, Qt::SolidLine, 0}
+    , {"landuse=reservoir", true, 0xFFAAD3DF, 0, 0, Qt::SolidLine, 0}
+    , {"building=*", true, 0xFFD9D0C9, 0, 0, Qt::SolidLine, 14}
+    // lines
+    , {"waterway=stream", false, 0xFFAAD3DF, 1.0, 0, Qt::SolidLine, 13}
+    , {"waterway=canal", false, 0xFFAAD3DF, 1.5, 0, Qt::SolidLine, 12}
+    , {"waterway=river", false, 0xFFAAD3DF, 2.5, 0, Qt::SolidLine, 8}
+    , {"boundary=national_park", false, 0xFF7BB07B, 1.5, 0, Qt::DashLine, 8}
+    , {"highway=path", false, 0xFFFA8072, 1.0, 0, Qt::DashLine, 13}
+    , {"highway=footway", false, 0xFFFA8072, 1.0, 0, Qt::DashLine, 14}
+    , {"highway=cycleway", false, 0xFF0000FF, 1.0, 0, Qt::DashLine, 13}
+    , {"highway=bridleway", false, 0xFF008000, 1.0, 0, Qt::DashLine, 13}
+    , {"highway=steps", false, 0xFFFA8072, 2.0, 0, Qt::DotLine, 15}
+    , {"highway=track", false, 0xFF996600, 1.2, 0, Qt::DashLine, 12}
+    , {"highway=service", false, 0xFFFFFFFF, 1.5, 0xFFBBBBBB, Qt::SolidLine, 14}
+    , {"highway=living_street", false, 0xFFFFFFFF, 2.5, 0xFFBBBBBB, Qt::SolidLine, 13}
+    , {"highway=residential", false, 0xFFFFFFFF, 2.5, 0xFFBBBBBB, Qt::SolidLine, 12}
+    , {"highway=unclassified", false, 0xFFFFFFFF, 2.5, 0xFFBBBBBB, Qt::SolidLine, 11}
+    , {"highway=tertiary", false, 0xFFFFFFFF, 3.0, 0xFF8F8F8F, Qt::SolidLine, 10}
+    , {"highway=secondary", false, 0xFFF7FABF, 3.5, 0xFF707D05, Qt::SolidLine, 9}
+    , {"highway=primary", false, 0xFFFCD6A4, 4.0, 0xFFA06B00, Qt::SolidLine, 7}
+    , {"highway=trunk", false, 0xFFF9B29C, 4.5, 0xFFC84E2F, Qt::SolidLine, 5}
+    , {"highway=motorway", false, 0xFFE892A2, 5.0, 0xFFDC2A67, Qt::SolidLine, 5}
+    , {"railway=rail", false, 0xFF707070, 1.5, 0, Qt::SolidLine, 10}
+    , {"aerialway=*", false, 0xFF606060, 1.0, 0, Qt::DashDotLine, 12}
+};
+
+static const QRgb colorWater = 0xFFAAD3DF;
+
+/**
+   @brief Decode and render a single tile
+
+   The job renders the tile into it's own image. As the tile's area is clipped
+   ways crossing several tiles are drawn seamlessly.
+ */
+class CMapMAPTileJob : public QRunnable
+{
+public:
+    CMapMAPTileJob(CMapMAP& map, qint32 idxLayer, qint32 x, qint32 y, quint8 zoom, const IDrawContext::buffer_t& buf, const QString& projStr)
+        : map(map)
+        , idxLayer(idxLayer)
+        , x(x)
+        , y(y)
+        , zoom(zoom)
+        , ref1(buf.ref1)
+        , scale(buf.scale * buf.zoomFactor)
+        , bufRect(buf.image.rect())
+        , projStr(projStr)
+    {
+        setAutoDelete(false);
+    }
+
+    void run() override;
+
+    /// the rendered tile, a null image if the tile has nothing to draw
+    QImage img;
+    /// the position of the image in the buffer
+    QPoint pos;
+
+private:
+    void convertRad2Px(const CProj& proj, QPolygonF& line) const
+    {
+        proj.transform(line, PJ_INV);
+        for(QPointF& pt : line)
+        {
+            pt = (pt - ref1m) / scale;
+        }
+    }
+
+    CMapMAP& map;
+    const qint32 idxLayer;
+    const qint32 x;
+    const qint32 y;
+    const quint8 zoom;
+    const QPointF ref1;
+    const QPointF scale;
+    const QRect bufRect;
+    const QString projStr;
+    QPointF ref1m;
+};
+
+void CMapMAPTileJob::run()
+{
+    // the map will be redrawn anyway
+    if(map.map->needsRedraw())
+    {
+        return;
+    }
+
+    const quint8 baseZoom = map.layers.at(idxLayer).baseZoom;
+
+    CMapMAP::tile_t tile;
+    map.getTile(idxLayer, x, y, zoom, tile);
+
+    if(!tile.isWater && tile.ways.isEmpty())
+    {
+        return;
+    }
+
+    // each job has it's own projection object as they are not thread safe
+    CProj proj(projStr, "EPSG:4326");
+    if(!proj.isValid())
+    {
+        return;
+    }
+
+    ref1m = ref1;
+    proj.transform(ref1m, PJ_INV);
+
+    const qreal lon1 = tileX2lon(x, baseZoom) * DEG_TO_RAD;
+    const qreal lon2 = tileX2lon(x + 1, baseZoom) * DEG_TO_RAD;
+    const qreal lat1 = tileY2lat(y, baseZoom) * DEG_TO_RAD;
+    const qreal lat2 = tileY2lat(y + 1, baseZoom) * DEG_TO_RAD;
+
+    QPolygonF tileArea;
+    tileArea << QPointF(lon1, lat1) << QPointF(lon2, lat1) << QPointF(lon2, lat2) << QPointF(lon1, lat2);
+    convertRad2Px(proj, tileArea);
+
+    const QRect& rect = tileArea.boundingRect().toAlignedRect().intersected(bufRect);
+    if(rect.isEmpty())
+    {
+        return;
+    }
+
+    img = QImage(rect.size(), QImage::Format_ARGB32_Premultiplied);
+    img.fill(Qt::transparent);
+    pos = rect.topLeft();
+
+    QPainter p(&img);
+    USE_ANTI_ALIASING(p, true);
+    p.translate(-pos);
+
+    QPainterPath clip;
+    clip.addPolygon(tileArea);
+    p.setClipPath(clip);
+
+    if(tile.isWater)
+    {
+        p.setPen(Qt::NoPen);
+        p.setBrush(QColor(colorWater));
+        p.drawPolygon(tileArea);
+    }
+
+    // line widths are defined for zoom level 15
+    const qreal widthFactor = qBound(0.3, qPow(2.0, (zoom - 15) * 0.5), 4.0);
+
+    // project all ways once
+    QVector<QVector<QPolygonF> > lines(tile.ways.size());
+    for(int i = 0; i < tile.ways.size(); i++)
+    {
+        lines[i] = tile.ways[i].polygons;
+        for(QPolygonF& line : lines[i])
+        {
+            convertRad2Px(proj, line);
+        }
+    }
+
+    // areas, holes are cut out by the odd-even fill rule
+    p.setPen(Qt::NoPen);
+    for(int i = 0; i < tile.ways.size(); i++)
+    {
+        const mapsforge_style_t& style = mapsforgeStyles[tile.ways[i].style];
+        if(!style.isArea)
+        {
+            continue;
+        }
+
+        QPainterPath path;
+        for(const QPolygonF& line : qAsConst(lines[i]))
+        {
+            path.addPolygon(line);
+        }
+        p.setBrush(QColor(style.color));
+        p.drawPath(path);
+    }
+
+    // lines, first all casings then the lines itself
+    p.setBrush(Qt::NoBrush);
+    for(int pass = 0; pass < 2; pass++)
+    {
+        for(int i = 0; i < tile.ways.size(); i++)
+        {
+            const mapsforge_style_t& style = mapsforgeStyles[tile.ways[i].style];
+            if(style.isArea || ((pass == 0) && (style.casing == 0)))
+            {
+                continue;
+            }
+
+            const qreal width = style.width * widthFactor;
+            if(pass == 0)
+            {
+                p.setPen(QPen(QColor(style.casing), width + 2, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+            }
+            else
+            {
+                p.setPen(QPen(QColor(style.color), width, style.style, Qt::RoundCap, Qt::RoundJoin));
+            }
+
+            for(const QPolygonF& line : qAsConst(lines[i]))
+            {
+                p.drawPolyline(line);
+            }
+        }
+    }
+}
 
 
 CMapMAP::CMapMAP(const QString& filename, CMapDraw* parent)
@@ -142,11 +414,474 @@ void CMapMAP::readBasics()
         stream >> layer.offsetSubFile;
         stream >> layer.sizeSubFile;
 
+        layer.tileX1 = lon2tileX(INT_TO_DEG(header.minLon), layer.baseZoom);
+        layer.tileX2 = lon2tileX(INT_TO_DEG(header.maxLon), layer.baseZoom);
+        layer.tileY1 = lat2tileY(INT_TO_DEG(header.maxLat), layer.baseZoom);
+        layer.tileY2 = lat2tileY(INT_TO_DEG(header.minLat), layer.baseZoom);
+
         layers << layer;
     }
     // ---------- end file header ----------------------
+
+    setupStyles();
+}
+
+void CMapMAP::setupStyles()
+{
+    const int N = sizeof(mapsforgeStyles) / sizeof(mapsforge_style_t);
+
+    tagToStyle.fill(-1, header.tagsWays.size());
+    for(int i = 0; i < header.tagsWays.size(); i++)
+    {
+        const QString& tag = header.tagsWays[i];
+        const QString& key = tag.section('=', 0, 0) + "=*";
+
+        for(int n = 0; n < N; n++)
+        {
+            const QString style = mapsforgeStyles[n].tag;
+            if((style == tag) || (style == key))
+            {
+                tagToStyle[i] = n;
+                break;
+            }
+        }
+    }
+}
+
+void CMapMAP::readTileIndex(layer_t& layer)
+{
+    if(!layer.index.isEmpty())
+    {
+        return;
+    }
+
+    CFileExt file(filename);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        throw exce_t(eErrOpen, tr("Failed to open: ") + filename);
+    }
+
+    quint64 offset = layer.offsetSubFile;
+    if(header.flags & eHeaderFlagDebugInfo)
+    {
+        // skip "+++IndexStart+++"
+        offset += 16;
+    }
+
+    const qint64 size = qint64(layer.tileX2 - layer.tileX1 + 1) * (layer.tileY2 - layer.tileY1 + 1) * 5;
+    if(!file.seek(offset))
+    {
+        throw exce_t(eErrAccess, tr("Failed to read: ") + filename);
+    }
+
+    layer.index = file.read(size);
+    if(layer.index.size() != size)
+    {
+        layer.index.clear();
+        throw exce_t(errFormat, tr("Bad tile index: ") + filename);
+    }
+}
+
+static inline quint64 readIndexEntry(const QByteArray& index, qint32 i)
+{
+    const quint8* p = reinterpret_cast<const quint8*>(index.constData()) + i * 5;
+    return (quint64(p[0]) << 32) | (quint64(p[1]) << 24) | (quint64(p[2]) << 16) | (quint64(p[3]) << 8) | quint64(p[4]);
+}
+
+void CMapMAP::getTile(qint32 idxLayer, qint32 x, qint32 y, quint8 zoom, tile_t& tile)
+{
+    const quint64 key = (quint64(idxLayer) << 59) | (quint64(zoom) << 54) | (quint64(x) << 27) | quint64(y);
+
+    quint64 offset;
+    quint64 size;
+    layer_t layer;
+    {
+        QMutexLocker lock(&mutex);
+        tile_t* cached = tileCache.object(key);
+        if(cached != nullptr)
+        {
+            tile = *cached;
+            return;
+        }
+
+        try
+        {
+            readTileIndex(layers[idxLayer]);
+        }
+        catch(const exce_t& e)
+        {
+            qDebug() << e.msg;
+            return;
+        }
+
+        // a flat copy as the index data is implicitly shared
+        layer = layers[idxLayer];
+    }
+
+    const qint32 w = layer.tileX2 - layer.tileX1 + 1;
+    const qint32 N = layer.index.size() / 5;
+    const qint32 i = (y - layer.tileY1) * w + (x - layer.tileX1);
+    if((i < 0) || (i >= N))
+    {
+        return;
+    }
+
+    const quint64 entry = readIndexEntry(layer.index, i);
+    offset = entry & 0x7FFFFFFFFFULL;
+    size = ((i + 1) < N ? (readIndexEntry(layer.index, i + 1) & 0x7FFFFFFFFFULL) : layer.sizeSubFile) - offset;
+
+    tile_t * decoded = new tile_t();
+    decoded->isWater = entry & 0x8000000000ULL;
+
+    if((size > 0) && (offset + size <= layer.sizeSubFile))
+    {
+        CFileExt file(filename);
+        if(file.open(QIODevice::ReadOnly) && file.seek(layer.offsetSubFile + offset))
+        {
+            try
+            {
+                decodeTile(layer, x, y, zoom, file.read(size), *decoded);
+            }
+            catch(const exce_t& e)
+            {
+                qDebug() << e.msg;
+                decoded->ways.clear();
+            }
+        }
+    }
+
+    qint32 cost = 1;
+    for(const way_t& way : qAsConst(decoded->ways))
+    {
+        for(const QPolygonF& line : way.polygons)
+        {
+            cost += line.size();
+        }
+    }
+
+    tile = *decoded;
+
+    QMutexLocker lock(&mutex);
+    tileCache.insert(key, decoded, cost);
+}
+
+QVector<quint32> CMapMAP::readTags(QDataStream& stream, qint32 N, const QStringList& tags)
+{
+    QVector<quint32> ids(N);
+    for(qint32 n = 0; n < N; n++)
+    {
+        uintX id;
+        stream >> id;
+        if(id >= quint64(tags.size()))
+        {
+            throw exce_t(errFormat, tr("Bad tag ID in tile."));
+        }
+        ids[n] = id;
+    }
+
+    // since version 5 tags can have values attached. They follow the list of IDs.
+    for(quint32 id : qAsConst(ids))
+    {
+        const QString& tag = tags[id];
+        if(tag.endsWith("=%b"))
+        {
+            stream.skipRawData(1);
+        }
+        else if(tag.endsWith("=%h"))
+        {
+            stream.skipRawData(2);
+        }
+        else if(tag.endsWith("=%i") || tag.endsWith("=%f"))
+        {
+            stream.skipRawData(4);
+        }
+        else if(tag.endsWith("=%s"))
+        {
+            utf8 value;
+            stream >> value;
+        }
+    }
+
+    return ids;
+}
+
+void CMapMAP::decodeTile(const layer_t& layer, qint32 x, qint32 y, quint8 zoom, const QByteArray& data, tile_t& tile) const
+{
+    const bool debug = header.flags & eHeaderFlagDebugInfo;
+    // the tile's top left corner is the reference of all coordinates
+    const qreal lon0 = tileX2lon(x, layer.baseZoom);
+    const qreal lat0 = tileY2lat(y, layer.baseZoom);
+
+    QDataStream stream(data);
+    stream.setByteOrder(QDataStream::BigEndian);
+
+    if(debug)
+    {
+        stream.skipRawData(32);
+    }
+
+    // zoom table, the rows are cumulative. Sum up all ways up to the requested zoom level
+    quint64 nWays = 0;
+    for(quint8 z = layer.minZoom; z <= layer.maxZoom; z++)
+    {
+        uintX pois, ways;
+        stream >> pois >> ways;
+        if(z <= zoom)
+        {
+            nWays += ways;
+        }
+    }
+
+    // POIs are not drawn yet, skip them. Their rows in the zoom table add up like the ones of the ways.
+    uintX offsetFirstWay;
+    stream >> offsetFirstWay;
+    stream.skipRawData(int(offsetFirstWay));
+
+    for(quint64 n = 0; n < nWays; n++)
+    {
+        if(stream.status() != QDataStream::Ok)
+        {
+            throw exce_t(errFormat, tr("Unexpected end of tile data."));
+        }
+
+        if(debug)
+        {
+            stream.skipRawData(32);
+        }
+
+        uintX sizeWay;
+        stream >> sizeWay;
+        const qint64 posNext = stream.device()->pos() + qint64(sizeWay);
+
+        quint16 subTiles;
+        quint8 special;
+        stream >> subTiles >> special;
+
+        way_t way;
+        way.layer = qint8(special >> 4) - 5;
+
+        const QVector<quint32>& ids = readTags(stream, special & 0x0F, header.tagsWays);
+        for(quint32 id : ids)
+        {
+            if(tagToStyle[id] >= 0)
+            {
+                way.style = tagToStyle[id];
+                break;
+            }
+        }
+
+        if((way.style < 0) || (mapsforgeStyles[way.style].minZoom > zoom))
+        {
+            stream.device()->seek(posNext);
+            continue;
+        }
+
+        quint8 flags;
+        stream >> flags;
+
+        utf8 text;
+        if(flags & 0x80)
+        {
+            stream >> text;     // name
+        }
+        if(flags & 0x40)
+        {
+            stream >> text;     // house number
+        }
+        if(flags & 0x20)
+        {
+            stream >> text;     // reference
+        }
+        if(flags & 0x10)
+        {
+            intX lat, lon;
+            stream >> lat >> lon;   // label position
+        }
+
+        quint64 nBlocks = 1;
+        if(flags & 0x08)
+        {
+            uintX n;
+            stream >> n;
+            nBlocks = n;
+        }
+
+        const bool doubleDelta = flags & 0x04;
+
+        for(quint64 b = 0; b < nBlocks; b++)
+        {
+            uintX nCoordBlocks;
+            stream >> nCoordBlocks;
+
+            for(quint64 c = 0; c < nCoordBlocks; c++)
+            {
+                uintX nNodes;
+                stream >> nNodes;
+                if(nNodes > quint64(data.size()))
+                {
+                    throw exce_t(errFormat, tr("Bad number of nodes in way."));
+                }
+
+                QPolygonF line(int(nNodes));
+                qint64 lat = 0;
+                qint64 lon = 0;
+                // the previous single delta for double delta encoding
+                qint64 deltaLat = 0;
+                qint64 deltaLon = 0;
+                for(quint64 i = 0; i < nNodes; i++)
+                {
+                    intX dLat, dLon;
+                    stream >> dLat >> dLon;
+
+                    if(i == 0)
+                    {
+                        // the first node is the offset to the tile's top left corner
+                        lat = dLat;
+                        lon = dLon;
+                    }
+                    else if(doubleDelta)
+                    {
+                        deltaLat += dLat;
+                        deltaLon += dLon;
+                        lat += deltaLat;
+                        lon += deltaLon;
+                    }
+                    else
+                    {
+                        lat += dLat;
+                        lon += dLon;
+                    }
+
+                    line[i] = QPointF((lon0 + INT_TO_DEG(lon)) * DEG_TO_RAD, (lat0 + INT_TO_DEG(lat)) * DEG_TO_RAD);
+                }
+
+                way.polygons << line;
+            }
+        }
+
+        tile.ways << way;
+        stream.device()->seek(posNext);
+    }
+
+    // keep the drawing order of the render theme. Within a style respect the OSM layer.
+    std::stable_sort(tile.ways.begin(), tile.ways.end(), [](const way_t& w1, const way_t& w2)
+    {
+        return w1.layer == w2.layer ? w1.style < w2.style : w1.layer < w2.layer;
+    });
 }
 
 void CMapMAP::draw(IDrawContext::buffer_t& buf) /* override */
 {
+    if(map->needsRedraw() || layers.isEmpty())
+    {
+        return;
+    }
+
+    QPointF bufferScale = buf.scale * buf.zoomFactor;
+    if(isOutOfScale(bufferScale))
+    {
+        return;
+    }
+
+    // select zoom level the same way as the tile maps do
+    qint32 z = 20;
+    qreal d = NOFLOAT;
+    for(qint32 i = 0; i < 21; i++)
+    {
+        qreal s = 0.055 * (1 << i);
+        if(qAbs(s - bufferScale.x()) < d)
+        {
+            z = i;
+            d = qAbs(s - bufferScale.x());
+        }
+    }
+    quint8 zoom = 21 - z;
+
+    // find the sub-file for the zoom level, clamp to the available zoom range
+    qint32 idxLayer = -1;
+    for(int i = 0; i < layers.size(); i++)
+    {
+        const layer_t& layer = layers[i];
+        if((layer.minZoom <= zoom) && (zoom <= layer.maxZoom))
+        {
+            idxLayer = i;
+            break;
+        }
+    }
+
+    if(idxLayer < 0)
+    {
+        quint8 minZoom = 0xFF;
+        quint8 maxZoom = 0;
+        qint32 idxMin = 0;
+        qint32 idxMax = 0;
+        for(int i = 0; i < layers.size(); i++)
+        {
+            if(layers[i].minZoom < minZoom)
+            {
+                minZoom = layers[i].minZoom;
+                idxMin = i;
+            }
+            if(layers[i].maxZoom > maxZoom)
+            {
+                maxZoom = layers[i].maxZoom;
+                idxMax = i;
+            }
+        }
+
+        idxLayer = zoom < minZoom ? idxMin : idxMax;
+        zoom = qBound(minZoom, zoom, maxZoom);
+    }
+
+    const layer_t& layer = layers[idxLayer];
+
+    // calculate maximum viewport
+    qreal x1 = qMax(buf.ref1.x() < buf.ref4.x() ? buf.ref1.x() : buf.ref4.x(), ref1.x());
+    qreal y1 = qMin(buf.ref1.y() > buf.ref2.y() ? buf.ref1.y() : buf.ref2.y(), ref1.y());
+    qreal x2 = qMin(buf.ref2.x() > buf.ref3.x() ? buf.ref2.x() : buf.ref3.x(), ref2.x());
+    qreal y2 = qMax(buf.ref3.y() < buf.ref4.y() ? buf.ref3.y() : buf.ref4.y(), ref2.y());
+
+    if((x1 >= x2) || (y1 <= y2))
+    {
+        return;
+    }
+
+    const qint32 col1 = qMax(layer.tileX1, lon2tileX(x1 * RAD_TO_DEG, layer.baseZoom));
+    const qint32 col2 = qMin(layer.tileX2, lon2tileX(x2 * RAD_TO_DEG, layer.baseZoom));
+    const qint32 row1 = qMax(layer.tileY1, lat2tileY(y1 * RAD_TO_DEG, layer.baseZoom));
+    const qint32 row2 = qMin(layer.tileY2, lat2tileY(y2 * RAD_TO_DEG, layer.baseZoom));
+
+    if(((col2 - col1 + 1) * (row2 - row1 + 1)) > MAX_TILES)
+    {
+        return;
+    }
+
+    // decode and render all tiles in parallel
+    const QString& projStr = map->getProjection();
+    QList<CMapMAPTileJob*> jobs;
+    for(qint32 row = row1; row <= row2; row++)
+    {
+        for(qint32 col = col1; col <= col2; col++)
+        {
+            CMapMAPTileJob * job = new CMapMAPTileJob(*this, idxLayer, col, row, zoom, buf, projStr);
+            jobs << job;
+            pool.start(job);
+        }
+    }
+    pool.waitForDone();
+
+    if(!map->needsRedraw())
+    {
+        QPainter p(&buf.image);
+        p.setOpacity(getOpacity() / 100.0);
+        for(const CMapMAPTileJob* job : qAsConst(jobs))
+        {
+            if(!job->img.isNull())
+            {
+                p.drawImage(job->pos, job->img);
+            }
+        }
+    }
+
+    qDeleteAll(jobs);
 }
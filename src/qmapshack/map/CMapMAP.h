@@ -22,9 +22,13 @@
 #include "map/IMap.h"
 #include "map/mapsforge/types.h"
 
+#include <QCache>
 #include <QList>
+#include <QMutex>
+#include <QThreadPool>
 
 class CMapDraw;
+class CMapMAPTileJob;
 
 class CMapMAP : public IMap
 {
@@ -36,6 +40,9 @@ public:
     void draw(IDrawContext::buffer_t& buf) override;
 
 private:
+    friend class CMapMAPTileJob;
+    friend class test_QMapShack;
+
     enum exce_e {eErrOpen, eErrAccess, errFormat, errAbort};
     struct exce_t
     {
@@ -53,6 +60,15 @@ private:
         quint8 maxZoom;
         quint64 offsetSubFile;
         quint64 sizeSubFile;
+
+        // tile range of the sub-file at base zoom level
+        qint32 tileX1 = 0;
+        qint32 tileY1 = 0;
+        qint32 tileX2 = 0;
+        qint32 tileY2 = 0;
+
+        /// the raw tile index, loaded on demand
+        QByteArray index;
     };
 
     enum header_flags_e
@@ -96,8 +112,69 @@ private:
 
     QList<layer_t> layers;
 
+    /// a decoded way with it's style and coordinates in [rad]
+    struct way_t
+    {
+        qint8 layer = 0;
+        qint16 style = -1;
+        /// first polygon is the outline, all others are holes
+        QVector<QPolygonF> polygons;
+    };
+
+    /// a decoded tile
+    struct tile_t
+    {
+        bool isWater = false;
+        QVector<way_t> ways;
+    };
+
     void readBasics();
 
+    /**
+       @brief Load the tile index of a sub-file if not already done
+
+       @param layer     the sub-file's layer definition
+     */
+    void readTileIndex(layer_t& layer);
+
+    /**
+       @brief Get a tile from the cache or decode it from file
+
+       This is thread safe and called by the raster jobs.
+
+       @param idxLayer  the index into layers
+       @param x         the tile's x at the layer's base zoom level
+       @param y         the tile's y at the layer's base zoom level
+       @param zoom      the zoom level to decode
+       @param tile      the tile object to receive the data
+     */
+    void getTile(qint32 idxLayer, qint32 x, qint32 y, quint8 zoom, tile_t& tile);
+
+    /**
+       @brief Decode a tile's ways from raw tile data
+
+       @param layer     the tile's sub-file
+       @param x         the tile's x at the layer's base zoom level
+       @param y         the tile's y at the layer's base zoom level
+       @param zoom      the zoom level to decode
+       @param data      the raw tile data
+       @param tile      the tile object to receive the data
+     */
+    void decodeTile(const layer_t& layer, qint32 x, qint32 y, quint8 zoom, const QByteArray& data, tile_t& tile) const;
+
+    /**
+       @brief Read tag IDs and skip optional tag values
+
+       @param stream    the stream positioned at the first tag ID
+       @param N         number of tags
+       @param tags      the list of tag strings to resolve the IDs
+       @return The tag IDs
+     */
+    static QVector<quint32> readTags(QDataStream& stream, qint32 N, const QStringList& tags);
+
+    /// map the way tags of the header to styles of the render theme
+    void setupStyles();
+
     QString filename;
 
     header_t header;
@@ -106,6 +183,17 @@ private:
     QPointF ref1;
     /// bottom right point of the map
     QPointF ref2;
+
+    /// for each way tag ID the style of the render theme, -1 if not drawn
+    QVector<qint16> tagToStyle;
+
+    /// mutex to serialize access to the tile index and tile cache
+    mutable QMutex mutex;
+    /// decoded tiles, the cost is the number of points
+    QCache<quint64, tile_t> tileCache {2000000};
+
+    /// thread pool to decode and render tiles in parallel
+    QThreadPool pool;
 };
 
 #endif //CMAPMAP_H
@@ -16,11 +16,14 @@
 
 **********************************************************************************************/
 
+#include "CMainWindow.h"
 #include "helpers/CSettings.h"
 #include "helpers/Signals.h"
 #include "map/CMapDraw.h"
 #include "map/CMapPropSetup.h"
+#include "map/CMapSeedDialog.h"
 #include "map/IMap.h"
+#include "map/IMapOnline.h"
 #include "units/IUnit.h"
 
 #include <QtWidgets>
@@ -51,11 +54,14 @@ CMapPropSetup::CMapPropSetup(IMap* mapfile, CMapDraw* map)
     connect(spinCacheSize, static_cast<void (QSpinBox::*)(int) >(&QSpinBox::valueChanged), mapfile, &IMap::slotSetCacheSize);
     connect(spinCacheExpiration, static_cast<void (QSpinBox::*)(int) >(&QSpinBox::valueChanged), mapfile, &IMap::slotSetCacheExpiration);
 
+    connect(pushSeedCache, &QPushButton::clicked, this, &CMapPropSetup::slotSeedCache);
+
     connect(toolOpenTypFile, &QToolButton::pressed, this, &CMapPropSetup::slotLoadTypeFile);
     connect(toolClearTypFile, &QToolButton::pressed, this, &CMapPropSetup::slotClearTypeFile);
 
     frameVectorItems->setVisible( mapfile->hasFeatureVectorItems() );
     frameTileCache->setVisible( mapfile->hasFeatureTileCache() );
+    pushSeedCache->setVisible(dynamic_cast<IMapOnline*>(mapfile) != nullptr);
 
     if(mapfile->hasFeatureLayers())
     {
@@ -155,3 +161,15 @@ void CMapPropSetup::slotClearTypeFile()
     mapfile->slotSetTypeFile("");
     slotPropertiesChanged();
 }
+
+void CMapPropSetup::slotSeedCache()
+{
+    IMapOnline* online = dynamic_cast<IMapOnline*>(mapfile);
+    if(online == nullptr)
+    {
+        return;
+    }
+
+    CMapSeedDialog dlg(online, map, CMainWindow::getBestWidgetForParent());
+    dlg.exec();
+}
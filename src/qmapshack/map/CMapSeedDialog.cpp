@@ -0,0 +1,257 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "gis/CGisWorkspace.h"
+#include "gis/trk/CGisItemTrk.h"
+#include "helpers/CSettings.h"
+#include "map/cache/CTileSeeder.h"
+#include "map/CMapDraw.h"
+#include "map/CMapSeedDialog.h"
+#include "map/IMapOnline.h"
+#include "units/IUnit.h"
+
+#include <QtWidgets>
+
+/// ask the user before seeding more tiles than this
+#define SEED_WARN_LIMIT 50000
+/// refuse to seed more tiles than this
+#define SEED_MAX_TILES  2000000
+
+CMapSeedDialog::CMapSeedDialog(IMapOnline* mapfile, CMapDraw* map, QWidget* parent)
+    : QDialog(parent)
+    , mapfile(mapfile)
+    , map(map)
+{
+    setupUi(this);
+    setWindowTitle(tr("Seed tile cache of %1").arg(mapfile->getName()));
+
+    seeder = mapfile->createSeeder(this);
+    connect(seeder, &CTileSeeder::sigProgress, this, &CMapSeedDialog::slotProgress);
+    connect(seeder, &CTileSeeder::sigFinished, this, &CMapSeedDialog::slotFinished);
+    connect(pushStart, &QPushButton::clicked, this, &CMapSeedDialog::slotStart);
+    connect(pushStop, &QPushButton::clicked, this, &CMapSeedDialog::slotStop);
+
+    const QStringList& levels = mapfile->getSeedLevels();
+    comboLevelMin->addItems(levels);
+    comboLevelMax->addItems(levels);
+
+    CGisItemTrk* trk = dynamic_cast<CGisItemTrk*>(CGisWorkspace::self().getItemByKey(CGisItemTrk::getKeyUserFocus()));
+    if(trk != nullptr)
+    {
+        labelTrack->setText(trk->getName());
+    }
+    else
+    {
+        labelTrack->setText(tr("(no track with focus)"));
+        radioTrack->setEnabled(false);
+    }
+
+    cfgGroup = "MapSeed/" + mapfile->getName();
+
+    SETTINGS;
+    cfg.beginGroup(cfgGroup);
+    comboLevelMin->setCurrentIndex(qMin(cfg.value("levelMin", 0).toInt(), levels.count() - 1));
+    comboLevelMax->setCurrentIndex(qMin(cfg.value("levelMax", levels.count() - 1).toInt(), levels.count() - 1));
+    spinCorridor->setValue(cfg.value("corridor", spinCorridor->value()).toInt());
+    radioLast->setEnabled(cfg.contains("areas"));
+    cfg.endGroup();
+
+    labelStatus->setText(tr("Press 'Start' to download all tiles of the selected area."));
+}
+
+CMapSeedDialog::~CMapSeedDialog()
+{
+}
+
+void CMapSeedDialog::reject() /* override */
+{
+    seeder->stop();
+    QDialog::reject();
+}
+
+void CMapSeedDialog::getAreas(QList<QRectF>& areas)
+{
+    areas.clear();
+
+    if(radioViewport->isChecked())
+    {
+        areas << map->getViewport();
+    }
+    else if(radioTrack->isChecked())
+    {
+        CGisItemTrk* trk = dynamic_cast<CGisItemTrk*>(CGisWorkspace::self().getItemByKey(CGisItemTrk::getKeyUserFocus()));
+        if(trk == nullptr)
+        {
+            return;
+        }
+
+        QPolygonF line;
+        trk->getPolylineFromData(line);
+
+        // cover the track with a chain of rectangles with the corridor's width
+        const qreal w = spinCorridor->value() / 2.0 / 6371010.0;
+        QPointF last = NOPOINTF;
+        for(const QPointF& pt : qAsConst(line))
+        {
+            QList<QPointF> pts;
+            if(last == NOPOINTF)
+            {
+                pts << pt;
+            }
+            else
+            {
+                const QPointF d = pt - last;
+                const qreal dist = qSqrt(qPow(d.x() * qCos(pt.y()), 2) + qPow(d.y(), 2));
+                const qint32 N = qCeil(dist / w);
+                for(qint32 n = 1; n <= N; n++)
+                {
+                    pts << last + d * n / N;
+                }
+            }
+            last = pt;
+
+            for(const QPointF& p : qAsConst(pts))
+            {
+                const qreal wLon = w / qMax(0.01, qCos(p.y()));
+                areas << QRectF(QPointF(p.x() - wLon, p.y() + w), QPointF(p.x() + wLon, p.y() - w));
+            }
+        }
+    }
+    else if(radioLast->isChecked())
+    {
+        SETTINGS;
+        cfg.beginGroup(cfgGroup);
+        const QVariantList& list = cfg.value("areas").toList();
+        for(const QVariant& area : list)
+        {
+            areas << area.toRectF();
+        }
+        cfg.endGroup();
+    }
+}
+
+void CMapSeedDialog::slotStart()
+{
+    if(mapfile.isNull())
+    {
+        return;
+    }
+
+    QList<QRectF> areas;
+    getAreas(areas);
+    if(areas.isEmpty())
+    {
+        return;
+    }
+
+    qint32 levelMin = comboLevelMin->currentIndex();
+    qint32 levelMax = comboLevelMax->currentIndex();
+    if(levelMin > levelMax)
+    {
+        qSwap(levelMin, levelMax);
+    }
+
+    // count the tiles first, the urls of a large area do not fit into memory
+    qint64 cntTiles = 0;
+    for(qint32 level = levelMin; level <= levelMax; level++)
+    {
+        cntTiles += mapfile->getSeedTiles(areas, level, nullptr);
+    }
+
+    if(cntTiles > SEED_MAX_TILES)
+    {
+        const QString& msg = tr("The selected area has %1 tiles. That is more than %2 tiles. Please select a smaller area or less levels.").arg(cntTiles).arg(SEED_MAX_TILES);
+        QMessageBox::warning(this, tr("Seed tile cache..."), msg, QMessageBox::Ok);
+        return;
+    }
+
+    if(cntTiles > SEED_WARN_LIMIT)
+    {
+        const QString& msg = tr("The selected area has %1 tiles. Do you really want to download all of them?").arg(cntTiles);
+        if(QMessageBox::question(this, tr("Seed tile cache..."), msg, QMessageBox::Yes | QMessageBox::No, QMessageBox::No) != QMessageBox::Yes)
+        {
+            return;
+        }
+    }
+
+    // store the setup to be able to resume the operation
+    QVariantList list;
+    for(const QRectF& area : qAsConst(areas))
+    {
+        list << area;
+    }
+
+    SETTINGS;
+    cfg.beginGroup(cfgGroup);
+    cfg.setValue("levelMin", levelMin);
+    cfg.setValue("levelMax", levelMax);
+    cfg.setValue("corridor", spinCorridor->value());
+    cfg.setValue("areas", list);
+    cfg.endGroup();
+    radioLast->setEnabled(true);
+
+    // pass the urls level by level to the seeder
+    QPointer<IMapOnline> online = mapfile;
+    qint32 level = levelMin;
+    setRunning(true);
+    seeder->start(qint32(cntTiles), [online, areas, level, levelMax](QSet<QString>& urls) mutable
+    {
+        if(online.isNull() || (level > levelMax))
+        {
+            return false;
+        }
+        online->getSeedTiles(areas, level++, &urls);
+        return true;
+    });
+}
+
+void CMapSeedDialog::slotStop()
+{
+    seeder->stop();
+}
+
+void CMapSeedDialog::slotProgress()
+{
+    const CTileSeeder::progress_t& progress = seeder->getProgress();
+
+    progressBar->setMaximum(qMax(1, progress.total));
+    progressBar->setValue(progress.cached + progress.done + progress.failed);
+
+    labelStatus->setText(tr("%1 tiles in area, %2 already in cache, %3 downloaded, %4 failed<br/>%5 tiles/s, %6 kB/s")
+                         .arg(progress.total)
+                         .arg(progress.cached)
+                         .arg(progress.done)
+                         .arg(progress.failed)
+                         .arg(progress.tilesPerSecond, 0, 'f', 1)
+                         .arg(progress.bytesPerSecond / 1024, 0, 'f', 1));
+}
+
+void CMapSeedDialog::slotFinished()
+{
+    setRunning(false);
+    map->emitSigCanvasUpdate();
+}
+
+void CMapSeedDialog::setRunning(bool yes)
+{
+    pushStart->setEnabled(!yes);
+    pushStop->setEnabled(yes);
+    groupArea->setEnabled(!yes);
+    comboLevelMin->setEnabled(!yes);
+    comboLevelMax->setEnabled(!yes);
+}
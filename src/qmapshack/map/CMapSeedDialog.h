@@ -0,0 +1,63 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CMAPSEEDDIALOG_H
+#define CMAPSEEDDIALOG_H
+
+#include "ui_IMapSeedDialog.h"
+#include <QDialog>
+#include <QPointer>
+
+class CMapDraw;
+class CTileSeeder;
+class IMapOnline;
+
+class CMapSeedDialog : public QDialog, private Ui::IMapSeedDialog
+{
+    Q_OBJECT
+public:
+    CMapSeedDialog(IMapOnline* mapfile, CMapDraw* map, QWidget* parent);
+    virtual ~CMapSeedDialog();
+
+public slots:
+    void reject() override;
+
+private slots:
+    void slotStart();
+    void slotStop();
+    void slotProgress();
+    void slotFinished();
+
+private:
+    /**
+       @brief Get the areas to seed as selected by the user
+
+       @param areas     a list to receive rectangles in [rad]
+     */
+    void getAreas(QList<QRectF>& areas);
+    void setRunning(bool yes);
+
+    QPointer<IMapOnline> mapfile;
+    CMapDraw* map;
+    CTileSeeder* seeder;
+
+    /// the group used to store the dialog's settings
+    QString cfgGroup;
+};
+
+#endif //CMAPSEEDDIALOG_H
@@ -97,6 +97,17 @@ CMapTMS::CMapTMS(const QString& filename, CMapDraw* parent)
         minZoomLevel = xmlTms.firstChildElement("MinZoomLevel").text().toInt();
     }
 
+    // optional limits to be used when seeding the cache
+    if(xmlTms.firstChildElement("MaxConnections").isElement())
+    {
+        maxConnections = xmlTms.firstChildElement("MaxConnections").text().toInt();
+    }
+
+    if(xmlTms.firstChildElement("MaxRequestsPerSecond").isElement())
+    {
+        maxRequestsPerSecond = xmlTms.firstChildElement("MaxRequestsPerSecond").text().toDouble();
+    }
+
     const QDomNodeList& xmlLayers = xmlTms.elementsByTagName("Layer");
     qint32 N = xmlLayers.count();
     layers.resize(N);
@@ -238,6 +249,82 @@ void CMapTMS::loadConfig(QSettings& cfg)
 }
 
 
+void CMapTMS::getSeedRange(qint32& zMin, qint32& zMax) const
+{
+    // the map's zoom levels run reverse to the tile levels (see draw())
+    zMin = qMax(0, 21 - qMin(20, maxZoomLevel));
+    zMax = qMin(20, 21 - minZoomLevel);
+}
+
+QStringList CMapTMS::getSeedLevels() const /* override */
+{
+    qint32 zMin, zMax;
+    getSeedRange(zMin, zMax);
+
+    QStringList levels;
+    for(qint32 z = zMin; z <= zMax; z++)
+    {
+        levels << tr("Zoom level %1").arg(z);
+    }
+    return levels;
+}
+
+qint64 CMapTMS::getSeedTiles(const QList<QRectF>& areas, qint32 level, QSet<QString>* urls) /* override */
+{
+    QMutexLocker lock(&mutex);
+
+    qint32 zMin, zMax;
+    getSeedRange(zMin, zMax);
+
+    const qint32 z = zMin + level;
+    if((z < zMin) || (z > zMax))
+    {
+        return 0;
+    }
+
+    const qint32 n = 1 << z;
+    qint64 cnt = 0;
+    const qreal maxLat = 85.0511;
+
+    for(const layer_t& layer : qAsConst(layers))
+    {
+        if(!layer.enabled || ((21 - z) < layer.minZoomLevel) || ((21 - z) > layer.maxZoomLevel))
+        {
+            continue;
+        }
+
+        for(const QRectF& area : areas)
+        {
+            const qreal lon1 = qMax(-180.0, area.left() * RAD_TO_DEG);
+            const qreal lon2 = qMin( 180.0, area.right() * RAD_TO_DEG);
+            const qreal lat1 = qBound(-maxLat, area.top() * RAD_TO_DEG, maxLat);
+            const qreal lat2 = qBound(-maxLat, area.bottom() * RAD_TO_DEG, maxLat);
+
+            const qint32 col1 = qBound(0, lon2tile(lon1, z) / 256, n - 1);
+            const qint32 col2 = qBound(0, lon2tile(lon2, z) / 256, n - 1);
+            const qint32 row1 = qBound(0, lat2tile(lat1, z) / 256, n - 1);
+            const qint32 row2 = qBound(0, lat2tile(lat2, z) / 256, n - 1);
+
+            cnt += qint64(row2 - row1 + 1) * (col2 - col1 + 1);
+            if(urls == nullptr)
+            {
+                continue;
+            }
+
+            for(qint32 row = row1; row <= row2; row++)
+            {
+                for(qint32 col = col1; col <= col2; col++)
+                {
+                    *urls << createUrl(layer, col, row, z);
+                }
+            }
+        }
+    }
+
+    return cnt;
+}
+
+
 void CMapTMS::slotLayersChanged(QListWidgetItem* item)
 {
     QMutexLocker lock(&mutex);
@@ -312,12 +399,84 @@ QString CMapTMS::createUrl(const layer_t& layer, int x, int y, int z)
 }
 
 
+void CMapTMS::prefetchTiles(const layer_t& layer, qint32 z, qint32 col1, qint32 col2, qint32 row1, qint32 row2, const QPointF& motion)
+{
+    auto prefetch = [&](qint32 col, qint32 row, qint32 zoom)
+    {
+        const qint32 n = 1 << zoom;
+        if((col < 0) || (col >= n) || (row < 0) || (row >= n))
+        {
+            return true;
+        }
+        return queuePrefetch(createUrl(layer, col, row, zoom));
+    };
+
+    // one ring of tiles beyond the viewport in the direction of motion
+    const QPoint& dir = getPrefetchDirection(motion);
+    if(dir.x() != 0)
+    {
+        const qint32 col = dir.x() > 0 ? col2 + 1 : col1 - 1;
+        for(qint32 row = row1 - 1; row <= row2 + 1; row++)
+        {
+            if(!prefetch(col, row, z))
+            {
+                return;
+            }
+        }
+    }
+    if(dir.y() != 0)
+    {
+        const qint32 row = dir.y() > 0 ? row2 + 1 : row1 - 1;
+        for(qint32 col = col1 - 1; col <= col2 + 1; col++)
+        {
+            if(!prefetch(col, row, z))
+            {
+                return;
+            }
+        }
+    }
+
+    // the parent zoom level covering the viewport (the map's zoom level index runs reverse to z)
+    if((z > 0) && ((21 - (z - 1)) <= layer.maxZoomLevel))
+    {
+        for(qint32 row = row1 >> 1; row <= (row2 >> 1); row++)
+        {
+            for(qint32 col = col1 >> 1; col <= (col2 >> 1); col++)
+            {
+                if(!prefetch(col, row, z - 1))
+                {
+                    return;
+                }
+            }
+        }
+    }
+
+    // the child zoom level of the viewport's center, as far as the budget allows
+    if((z < 20) && ((21 - (z + 1)) >= layer.minZoomLevel))
+    {
+        const qint32 dCol = (col2 - col1) / 4;
+        const qint32 dRow = (row2 - row1) / 4;
+        for(qint32 row = (row1 + dRow) << 1; row <= (((row2 - dRow) << 1) + 1); row++)
+        {
+            for(qint32 col = (col1 + dCol) << 1; col <= (((col2 - dCol) << 1) + 1); col++)
+            {
+                if(!prefetch(col, row, z + 1))
+                {
+                    return;
+                }
+            }
+        }
+    }
+}
+
+
 void CMapTMS::draw(IDrawContext::buffer_t& buf) /* override */
 {
     QMutexLocker lock(&mutex);
 
     timeLastUpdate.start();
     urlQueue.clear();
+    resetPrefetch();
 
     if(map->needsRedraw())
     {
@@ -426,6 +585,8 @@ void CMapTMS::draw(IDrawContext::buffer_t& buf) /* override */
             }
         }
 
+        prefetchTiles(layer, z, col1, col2, row1, row2, buf.motion);
+
         emit sigQueueChanged();
     }
 }
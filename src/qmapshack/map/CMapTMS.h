@@ -40,12 +40,30 @@ public:
     void saveConfig(QSettings& cfg) override;
     void loadConfig(QSettings& cfg) override;
 
+    QStringList getSeedLevels() const override;
+    qint64 getSeedTiles(const QList<QRectF>& areas, qint32 level, QSet<QString>* urls) override;
+
 private slots:
     void slotLayersChanged(QListWidgetItem* item);
 
 private:
     struct layer_t;
     QString createUrl(const layer_t& layer, int x, int y, int z);
+    /**
+       @brief Queue tiles around the viewport for prefetching
+
+       This will queue one ring of tiles beyond the viewport in the direction of motion,
+       followed by the tiles of the parent and child zoom levels.
+
+       @param layer     the layer to prefetch tiles for
+       @param z         the currently drawn tile zoom level
+       @param col1      the viewport's first tile column
+       @param col2      the viewport's last tile column
+       @param row1      the viewport's first tile row
+       @param row2      the viewport's last tile row
+       @param motion    the pan motion of the viewport
+     */
+    void prefetchTiles(const layer_t& layer, qint32 z, qint32 col1, qint32 col2, qint32 row1, qint32 row2, const QPointF& motion);
 
     struct layer_t
     {
@@ -62,6 +80,13 @@ private:
 
     QVector<layer_t> layers;
 
+    /**
+       @brief Get the range of tile levels (z) used to draw the map
+       @param zMin  the coarsest level
+       @param zMax  the finest level
+     */
+    void getSeedRange(qint32& zMin, qint32& zMax) const;
+
     qint32 minZoomLevel = 1;
     qint32 maxZoomLevel = 21;
 };
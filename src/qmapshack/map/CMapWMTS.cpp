@@ -369,12 +369,264 @@ void CMapWMTS::slotLayersChanged(QListWidgetItem* item)
 }
 
 
+QString CMapWMTS::createUrl(const layer_t& layer, const QString& tileMatrixId, qint32 row, qint32 col)
+{
+    QString url = layer.resourceURL;
+    url = url.replace("{TileMatrix}", tileMatrixId, Qt::CaseInsensitive);
+    url = url.replace("{TileRow}", QString::number(row), Qt::CaseInsensitive);
+    url = url.replace("{TileCol}", QString::number(col), Qt::CaseInsensitive);
+    return url;
+}
+
+QStringList CMapWMTS::getSeedLevels() const /* override */
+{
+    // The levels are the union of the tile matrix IDs of all enabled layers,
+    // ordered from the coarsest to the finest scale. Each layer resolves the
+    // ID with it's own tile matrix set.
+    QMap<QString, qreal> scales;
+    for(const layer_t& layer : layers)
+    {
+        if(!layer.enabled || !tilesets.contains(layer.tileMatrixSet))
+        {
+            continue;
+        }
+
+        const tileset_t& tileset = tilesets[layer.tileMatrixSet];
+        for(auto it = tileset.tilematrix.constBegin(); it != tileset.tilematrix.constEnd(); ++it)
+        {
+            scales[it.key()] = qMax(scales.value(it.key(), 0.0), it.value().scale);
+        }
+    }
+
+    QStringList ids = scales.keys();
+    std::sort(ids.begin(), ids.end(), [&scales](const QString& id1, const QString& id2)
+    {
+        return scales[id1] > scales[id2];
+    });
+    return ids;
+}
+
+qint64 CMapWMTS::getSeedTiles(const QList<QRectF>& areas, qint32 level, QSet<QString>* urls) /* override */
+{
+    QMutexLocker lock(&mutex);
+
+    const QStringList& ids = getSeedLevels();
+    if((level < 0) || (level >= ids.count()))
+    {
+        return 0;
+    }
+    const QString& tileMatrixId = ids[level];
+    qint64 cnt = 0;
+
+    for(const layer_t& layer : qAsConst(layers))
+    {
+        if(!layer.enabled || !tilesets.contains(layer.tileMatrixSet))
+        {
+            continue;
+        }
+
+        // skip layers without a tile matrix of that level
+        const tileset_t& tileset = tilesets[layer.tileMatrixSet];
+        if(!tileset.tilematrix.contains(tileMatrixId))
+        {
+            continue;
+        }
+
+        const tilematrix_t& tilematrix = tileset.tilematrix[tileMatrixId];
+
+        limit_t limit;
+        if(!getLimit(layer, tilematrix, tileMatrixId, limit))
+        {
+            continue;
+        }
+
+        for(const QRectF& area : areas)
+        {
+            QRectF areaDeg(area.topLeft() * RAD_TO_DEG, area.bottomRight() * RAD_TO_DEG);
+            if(!layer.boundingBox.intersects(areaDeg.normalized()))
+            {
+                continue;
+            }
+
+            // convert area to layer's coordinate system
+            QPointF pt1 = area.topLeft();
+            QPointF pt2 = area.bottomRight();
+
+            tileset.proj.transform(pt1, PJ_INV);
+            tileset.proj.transform(pt2, PJ_INV);
+
+            if(tileset.proj.isSrcLatLong())
+            {
+                pt1 *= RAD_TO_DEG;
+                pt2 *= RAD_TO_DEG;
+            }
+
+            qint32 col1, col2, row1, row2;
+            getTileRange(tilematrix, limit, pt1, pt2, col1, col2, row1, row2);
+
+            cnt += qint64(row2 - row1 + 1) * (col2 - col1 + 1);
+            if(urls == nullptr)
+            {
+                continue;
+            }
+
+            for(qint32 row = row1; row <= row2; row++)
+            {
+                for(qint32 col = col1; col <= col2; col++)
+                {
+                    *urls << createUrl(layer, tileMatrixId, row, col);
+                }
+            }
+        }
+    }
+
+    return cnt;
+}
+
+bool CMapWMTS::getLimit(const layer_t& layer, const tilematrix_t& tilematrix, const QString& tileMatrixId, limit_t& limit)
+{
+    if(!layer.limits.isEmpty())
+    {
+        if(!layer.limits.contains(tileMatrixId))
+        {
+            return false;
+        }
+        limit = layer.limits[tileMatrixId];
+    }
+    else
+    {
+        limit.minTileCol = 0;
+        limit.maxTileCol = tilematrix.matrixWidth;
+        limit.minTileRow = 0;
+        limit.maxTileRow = tilematrix.matrixHeight;
+    }
+    return true;
+}
+
+void CMapWMTS::getTileRange(const tilematrix_t& tilematrix, const limit_t& limit, const QPointF& pt1, const QPointF& pt2, qint32& col1, qint32& col2, qint32& row1, qint32& row2)
+{
+    qreal xscale = tilematrix.scale * 0.28e-3;
+    qreal yscale = -tilematrix.scale * 0.28e-3;
+
+    col1 = qFloor((pt1.x() - tilematrix.topLeft.x()) / ( xscale * tilematrix.tileWidth));
+    row1 = qFloor((pt1.y() - tilematrix.topLeft.y()) / ( yscale * tilematrix.tileHeight));
+    col2 = qFloor((pt2.x() - tilematrix.topLeft.x()) / ( xscale * tilematrix.tileWidth));
+    row2 = qFloor((pt2.y() - tilematrix.topLeft.y()) / ( yscale * tilematrix.tileHeight));
+
+    col1 = qBound(limit.minTileCol, col1, limit.maxTileCol);
+    col2 = qBound(limit.minTileCol, col2, limit.maxTileCol);
+    row1 = qBound(limit.minTileRow, row1, limit.maxTileRow);
+    row2 = qBound(limit.minTileRow, row2, limit.maxTileRow);
+}
+
+void CMapWMTS::prefetchTiles(const layer_t& layer, const tileset_t& tileset, const QString& tileMatrixId, const QPointF& pt1, const QPointF& pt2, qint32 col1, qint32 col2, qint32 row1, qint32 row2, const QPointF& motion)
+{
+    limit_t limit;
+    const tilematrix_t& tilematrix = tileset.tilematrix[tileMatrixId];
+    if(!getLimit(layer, tilematrix, tileMatrixId, limit))
+    {
+        return;
+    }
+
+    auto prefetch = [&](const QString& id, const limit_t& lim, qint32 col, qint32 row)
+    {
+        if((col < lim.minTileCol) || (col > lim.maxTileCol) || (row < lim.minTileRow) || (row > lim.maxTileRow))
+        {
+            return true;
+        }
+        return queuePrefetch(createUrl(layer, id, row, col));
+    };
+
+    // one ring of tiles beyond the viewport in the direction of motion
+    const QPoint& dir = getPrefetchDirection(motion);
+    if(dir.x() != 0)
+    {
+        const qint32 col = dir.x() > 0 ? col2 + 1 : col1 - 1;
+        for(qint32 row = row1 - 1; row <= row2 + 1; row++)
+        {
+            if(!prefetch(tileMatrixId, limit, col, row))
+            {
+                return;
+            }
+        }
+    }
+    if(dir.y() != 0)
+    {
+        const qint32 row = dir.y() > 0 ? row2 + 1 : row1 - 1;
+        for(qint32 col = col1 - 1; col <= col2 + 1; col++)
+        {
+            if(!prefetch(tileMatrixId, limit, col, row))
+            {
+                return;
+            }
+        }
+    }
+
+    // find the tile matrices with the next coarser and finer scale
+    QString idParent;
+    QString idChild;
+    qreal scaleParent = NOFLOAT;
+    qreal scaleChild = 0;
+    const QStringList& keys = tileset.tilematrix.keys();
+    for(const QString& key : keys)
+    {
+        const qreal scale = tileset.tilematrix[key].scale;
+        if((scale > tilematrix.scale) && (scale < scaleParent))
+        {
+            idParent = key;
+            scaleParent = scale;
+        }
+        if((scale < tilematrix.scale) && (scale > scaleChild))
+        {
+            idChild = key;
+            scaleChild = scale;
+        }
+    }
+
+    // the parent level covers the whole viewport, the child level only the center part
+    const QPointF d = (pt2 - pt1) / 4;
+    const QList<QPair<QString, QRectF> > levels = {
+        {idParent, QRectF(pt1, pt2)}
+        , {idChild, QRectF(pt1 + d, pt2 - d)}
+    };
+
+    for(const QPair<QString, QRectF>& level : levels)
+    {
+        if(level.first.isEmpty())
+        {
+            continue;
+        }
+
+        limit_t levelLimit;
+        const tilematrix_t& levelMatrix = tileset.tilematrix[level.first];
+        if(!getLimit(layer, levelMatrix, level.first, levelLimit))
+        {
+            continue;
+        }
+
+        qint32 levelCol1, levelCol2, levelRow1, levelRow2;
+        getTileRange(levelMatrix, levelLimit, level.second.topLeft(), level.second.bottomRight(), levelCol1, levelCol2, levelRow1, levelRow2);
+        for(qint32 row = levelRow1; row <= levelRow2; row++)
+        {
+            for(qint32 col = levelCol1; col <= levelCol2; col++)
+            {
+                if(!prefetch(level.first, levelLimit, col, row))
+                {
+                    return;
+                }
+            }
+        }
+    }
+}
+
+
 void CMapWMTS::draw(IDrawContext::buffer_t& buf) /* override */
 {
     QMutexLocker lock(&mutex);
 
     timeLastUpdate.start();
     urlQueue.clear();
+    resetPrefetch();
 
     if(map->needsRedraw())
     {
@@ -426,7 +678,6 @@ void CMapWMTS::draw(IDrawContext::buffer_t& buf) /* override */
         }
 
         const tileset_t& tileset = tilesets[layer.tileMatrixSet];
-        const QMap<QString, limit_t>& limits = layer.limits;
 
         // convert viewport to layer's coordinate system
         QPointF pt1(x1, y1);
@@ -461,76 +712,20 @@ void CMapWMTS::draw(IDrawContext::buffer_t& buf) /* override */
 
 
         // get min/max col/row values for that level
-        qint32 minRow, maxRow, minCol, maxCol;
+        limit_t limit;
         const tilematrix_t& tilematrix = tileset.tilematrix[tileMatrixId];
-        if(!limits.isEmpty())
-        {
-            if(limits.contains(tileMatrixId))
-            {
-                const limit_t& limit = limits[tileMatrixId];
-                minCol = limit.minTileCol;
-                maxCol = limit.maxTileCol;
-                minRow = limit.minTileRow;
-                maxRow = limit.maxTileRow;
-            }
-            else
-            {
-                // layer has limits but not for the selected tileMatrixId -> skip layer
-                continue;
-            }
-        }
-        else
+        if(!getLimit(layer, tilematrix, tileMatrixId, limit))
         {
-            minCol = 0;
-            maxCol = tilematrix.matrixWidth;
-            minRow = 0;
-            maxRow = tilematrix.matrixHeight;
+            // layer has limits but not for the selected tileMatrixId -> skip layer
+            continue;
         }
 
-
         // derive range of col/row to request tiles
         qreal xscale = tilematrix.scale * 0.28e-3;
         qreal yscale = -tilematrix.scale * 0.28e-3;
 
-        qint32 col1 = qFloor((pt1.x() - tilematrix.topLeft.x()) / ( xscale * tilematrix.tileWidth));
-        qint32 row1 = qFloor((pt1.y() - tilematrix.topLeft.y()) / ( yscale * tilematrix.tileHeight));
-        qint32 col2 = qFloor((pt2.x() - tilematrix.topLeft.x()) / ( xscale * tilematrix.tileWidth));
-        qint32 row2 = qFloor((pt2.y() - tilematrix.topLeft.y()) / ( yscale * tilematrix.tileHeight));
-
-
-        if(col1 < minCol)
-        {
-            col1 = minCol;
-        }
-        if(col1 > maxCol)
-        {
-            col1 = maxCol;
-        }
-        if(row1 < minRow)
-        {
-            row1 = minRow;
-        }
-        if(row1 > maxRow)
-        {
-            row1 = maxRow;
-        }
-
-        if(col2 < minCol)
-        {
-            col2 = minCol;
-        }
-        if(col2 > maxCol)
-        {
-            col2 = maxCol;
-        }
-        if(row2 < minRow)
-        {
-            row2 = minRow;
-        }
-        if(row2 > maxRow)
-        {
-            row2 = maxRow;
-        }
+        qint32 col1, col2, row1, row2;
+        getTileRange(tilematrix, limit, pt1, pt2, col1, col2, row1, row2);
 
 
         // start to request tiles. draw tiles in cache, queue urls of tile yet to be requested
@@ -538,10 +733,7 @@ void CMapWMTS::draw(IDrawContext::buffer_t& buf) /* override */
         {
             for(qint32 col = col1; col <= col2; col++)
             {
-                QString url = layer.resourceURL;
-                url = url.replace("{TileMatrix}", tileMatrixId, Qt::CaseInsensitive);
-                url = url.replace("{TileRow}", QString::number(row), Qt::CaseInsensitive);
-                url = url.replace("{TileCol}", QString::number(col), Qt::CaseInsensitive);
+                const QString& url = createUrl(layer, tileMatrixId, row, col);
 
                 if(diskCache->contains(url))
                 {
@@ -568,6 +760,8 @@ void CMapWMTS::draw(IDrawContext::buffer_t& buf) /* override */
             }
         }
 
+        prefetchTiles(layer, tileset, tileMatrixId, pt1, pt2, col1, col2, row1, row2, buf.motion);
+
         emit sigQueueChanged();
     }
 }
@@ -43,6 +43,9 @@ public:
     void saveConfig(QSettings& cfg) override;
     void loadConfig(QSettings& cfg) override;
 
+    QStringList getSeedLevels() const override;
+    qint64 getSeedTiles(const QList<QRectF>& areas, qint32 level, QSet<QString>* urls) override;
+
 private slots:
     void slotLayersChanged(QListWidgetItem* item);
 
@@ -85,6 +88,25 @@ private:
     };
 
     QMap<QString, tileset_t> tilesets;
+
+    QString createUrl(const layer_t& layer, const QString& tileMatrixId, qint32 row, qint32 col);
+    /**
+       @brief Get the col/row limits of a tile matrix for a layer
+
+       @return Return false if the layer has limits but none for the given tile matrix.
+     */
+    static bool getLimit(const layer_t& layer, const tilematrix_t& tilematrix, const QString& tileMatrixId, limit_t& limit);
+    /**
+       @brief Get the range of tiles covering an area given in the tile set's coordinate system
+     */
+    static void getTileRange(const tilematrix_t& tilematrix, const limit_t& limit, const QPointF& pt1, const QPointF& pt2, qint32& col1, qint32& col2, qint32& row1, qint32& row2);
+    /**
+       @brief Queue tiles around the viewport for prefetching
+
+       This will queue one ring of tiles beyond the viewport in the direction of motion,
+       followed by the tiles of the next coarser and finer tile matrix.
+     */
+    void prefetchTiles(const layer_t& layer, const tileset_t& tileset, const QString& tileMatrixId, const QPointF& pt1, const QPointF& pt2, qint32 col1, qint32 col2, qint32 row1, qint32 row2, const QPointF& motion);
 };
 
 #endif //CMAPWMTS_H
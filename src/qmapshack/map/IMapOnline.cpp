@@ -19,6 +19,7 @@
 
 #include "CMainWindow.h"
 #include "map/cache/CDiskCache.h"
+#include "map/cache/CTileSeeder.h"
 #include "map/CMapDraw.h"
 #include "map/IMapOnline.h"
 
@@ -51,26 +52,42 @@ bool IMapOnline::httpsCheck(const QString& url)
 }
 
 
+/// maximum number of concurrent requests for visible tiles
+#define MAX_PENDING             6
+/// maximum number of concurrent requests for prefetched tiles
+#define MAX_PENDING_PREFETCH    2
+/// maximum number of tiles queued for prefetching per draw cycle
+#define MAX_PREFETCH_PER_DRAW   48
+
 void IMapOnline::slotQueueChanged()
 {
     QMutexLocker lock(&mutex);
 
-    if(!urlQueue.isEmpty() && urlPending.size() < 6)
+    if(!urlQueue.isEmpty() && urlPending.size() < MAX_PENDING)
     {
         // request up to 6 pending request
-        for(int i = 0; i < (6 - urlPending.size()); i++)
+        for(int i = 0; i < (MAX_PENDING - urlPending.size()); i++)
         {
             QString url = urlQueue.dequeue();
             lastRequest = urlQueue.isEmpty();
 
-            QNetworkRequest request;
-            request.setUrl(url);
-            for(const rawHeaderItem_t& item : qAsConst(rawHeaderItems))
+            if(urlPendingPrefetch.contains(url))
+            {
+                // the tile is already on it's way. Just promote it to a visible tile.
+                urlPendingPrefetch.removeAll(url);
+                urlPending << url;
+            }
+            else
             {
-                request.setRawHeader(item.name.toLatin1(), item.value.toLatin1());
+                QNetworkRequest request;
+                request.setUrl(url);
+                for(const rawHeaderItem_t& item : qAsConst(rawHeaderItems))
+                {
+                    request.setRawHeader(item.name.toLatin1(), item.value.toLatin1());
+                }
+                accessManager->get(request);
+                urlPending << url;
             }
-            accessManager->get(request);
-            urlPending << url;
 
             if(lastRequest)
             {
@@ -85,6 +102,26 @@ void IMapOnline::slotQueueChanged()
         map->emitSigCanvasUpdate();
     }
 
+    // prefetch tiles only if there is no visible tile left to request
+    while(urlQueue.isEmpty() && urlPending.isEmpty() && !urlQueuePrefetch.isEmpty() && (urlPendingPrefetch.size() < MAX_PENDING_PREFETCH))
+    {
+        QString url = urlQueuePrefetch.dequeue();
+        if(diskCache->contains(url))
+        {
+            continue;
+        }
+
+        QNetworkRequest request;
+        request.setUrl(url);
+        request.setPriority(QNetworkRequest::LowPriority);
+        for(const rawHeaderItem_t& item : qAsConst(rawHeaderItems))
+        {
+            request.setRawHeader(item.name.toLatin1(), item.value.toLatin1());
+        }
+        accessManager->get(request);
+        urlPendingPrefetch << url;
+    }
+
     if(timeLastUpdate.elapsed() > 2000)
     {
         timeLastUpdate.start();
@@ -123,6 +160,17 @@ void IMapOnline::slotRequestFinished(QNetworkReply* reply)
 
         urlPending.removeAll(url);
     }
+    else if(urlPendingPrefetch.contains(url))
+    {
+        QImage img;
+        if(!reply->error())
+        {
+            img.loadFromData(reply->readAll());
+        }
+        diskCache->store(url, img);
+
+        urlPendingPrefetch.removeAll(url);
+    }
 
     // debug output any error
     if(reply->error())
@@ -146,3 +194,73 @@ void IMapOnline::configureCache()
     diskCache = new CDiskCache(getCachePath(), getCacheSize(), getCacheExpiration(), this);
 }
 
+
+CTileSeeder* IMapOnline::createSeeder(QObject* parent)
+{
+    QMutexLocker lock(&mutex);
+
+    CTileSeeder* seeder = new CTileSeeder(diskCache, parent);
+
+    QList<QPair<QByteArray, QByteArray> > headers;
+    for(const rawHeaderItem_t& item : qAsConst(rawHeaderItems))
+    {
+        headers << qMakePair(item.name.toLatin1(), item.value.toLatin1());
+    }
+    seeder->setRawHeaders(headers);
+    seeder->setRateLimit(maxConnections, maxRequestsPerSecond);
+
+    return seeder;
+}
+
+void IMapOnline::resetPrefetch()
+{
+    QMutexLocker lock(&mutex);
+
+    urlQueuePrefetch.clear();
+    prefetchBudget = MAX_PREFETCH_PER_DRAW;
+}
+
+bool IMapOnline::queuePrefetch(const QString& url)
+{
+    QMutexLocker lock(&mutex);
+
+    if(prefetchBudget <= 0)
+    {
+        return false;
+    }
+
+    if(url.isEmpty() || diskCache->contains(url) || urlQueue.contains(url) || urlPending.contains(url)
+       || urlQueuePrefetch.contains(url) || urlPendingPrefetch.contains(url))
+    {
+        return true;
+    }
+
+    urlQueuePrefetch << url;
+    --prefetchBudget;
+    return true;
+}
+
+QPoint IMapOnline::getPrefetchDirection(const QPointF& motion)
+{
+    const qreal ax = qAbs(motion.x());
+    const qreal ay = qAbs(motion.y());
+    const qreal a = qMax(ax, ay);
+
+    // ignore jitter
+    if(a < 2.0)
+    {
+        return QPoint();
+    }
+
+    // only take an axis into account if it has a significant part of the motion
+    QPoint dir;
+    if(ax > 0.4 * a)
+    {
+        dir.rx() = motion.x() > 0 ? 1 : -1;
+    }
+    if(ay > 0.4 * a)
+    {
+        dir.ry() = motion.y() > 0 ? 1 : -1;
+    }
+    return dir;
+}
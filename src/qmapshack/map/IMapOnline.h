@@ -22,9 +22,11 @@
 #include "map/IMap.h"
 #include <QMutex>
 #include <QQueue>
+#include <QSet>
 #include <QTime>
 
 class CDiskCache;
+class CTileSeeder;
 class QNetworkAccessManager;
 class QNetworkReply;
 
@@ -54,11 +56,23 @@ protected:
     QNetworkAccessManager* accessManager = nullptr;
     QList<QString> urlPending;
 
+    /// a queue with tile urls to prefetch with low priority
+    QQueue<QString> urlQueuePrefetch;
+    /// prefetch requests currently sent
+    QList<QString> urlPendingPrefetch;
+    /// the number of prefetch tiles still allowed to be queued in this draw cycle
+    qint32 prefetchBudget = 0;
+
 
     bool lastRequest = false;
     QTime timeLastUpdate;
     QString name;
 
+    /// maximum number of concurrent requests when seeding the cache
+    qint32 maxConnections = 2;
+    /// maximum number of requests per second when seeding the cache, 0 for no limit
+    qreal maxRequestsPerSecond = 4;
+
     static bool httpsCheck(const QString& url);
 
     void registerHeaderItem(const QString& name, const QString& value)
@@ -71,10 +85,66 @@ protected:
 
     void configureCache() override;
 
+    /**
+       @brief Reset the prefetch queue and budget at the start of a draw cycle
+     */
+    void resetPrefetch();
+
+    /**
+       @brief Queue a tile url to be fetched into the cache with low priority
+
+       Tiles already in the cache, requested or queued are ignored. Prefetch requests are
+       only sent if no visible tile is waiting for download.
+
+       @param url   the tile's url
+       @return Return false if the prefetch budget of the current draw cycle is exhausted.
+     */
+    bool queuePrefetch(const QString& url);
+
+    /**
+       @brief Get the direction to prefetch tiles from the viewport motion
+
+       @param motion    the pan motion as passed by IDrawContext::buffer_t::motion
+       @return A point with -1, 0 or 1 for each axis, in screen orientation
+     */
+    static QPoint getPrefetchDirection(const QPointF& motion);
+
 public:
     void slotQueueChanged();
     void slotRequestFinished(QNetworkReply* reply);
 
+    const QString& getName() const
+    {
+        return name;
+    }
+
+    /**
+       @brief Get the tile levels available to seed the cache
+
+       @return A list of names, ordered from the coarsest to the finest level
+     */
+    virtual QStringList getSeedLevels() const = 0;
+
+    /**
+       @brief Collect the urls of all tiles of enabled layers intersecting the given areas
+
+       @param areas     a list of rectangles in [rad] (top left, bottom right)
+       @param level     the tile level as index into the list returned by getSeedLevels()
+       @param urls      a set to receive the urls, if nullptr the tiles are counted only
+       @return The number of tiles. Tiles of overlapping areas are counted more than once.
+     */
+    virtual qint64 getSeedTiles(const QList<QRectF>& areas, qint32 level, QSet<QString>* urls) = 0;
+
+    /**
+       @brief Create a seeder object to download tiles into this map's cache
+
+       The seeder is setup with the map's raw header items and rate limits.
+
+       @param parent    the seeder's parent object
+       @return A pointer to the new object.
+     */
+    CTileSeeder* createSeeder(QObject* parent);
+
 
     IMapOnline(CMapDraw* parent);
     virtual ~IMapOnline() {}
@@ -76,6 +76,22 @@ void CDiskCache::store(const QString& key, QImage& img)
     }
 }
 
+void CDiskCache::seed(const QString& key, QImage& img)
+{
+    QMutexLocker lock(&mutex);
+
+    QCryptographicHash md5(QCryptographicHash::Md5);
+    md5.addData(key.toLatin1());
+
+    QString hash = md5.result().toHex();
+    QString filename = QString("%1.png").arg(hash);
+
+    if(img.save(dir.absoluteFilePath(filename)))
+    {
+        table[hash] = filename;
+    }
+}
+
 void CDiskCache::restore(const QString& key, QImage& img)
 {
     QMutexLocker lock(&mutex);
@@ -128,8 +144,8 @@ void CDiskCache::slotCleanup()
 
     const QFileInfoList& files = dir.entryInfoList(QStringList("*.png"), QDir::Files);
     QDateTime now = QDateTime::currentDateTime();
-    qint32 maxSizeBytes = maxSizeMB * 1024 * 1024;
-    qint32 tmpSize = 0;
+    qint64 maxSizeBytes = qint64(maxSizeMB) * 1024 * 1024;
+    qint64 tmpSize = 0;
     // expire old files and calculate cache size
     for(const QFileInfo& fileinfo : files)
     {
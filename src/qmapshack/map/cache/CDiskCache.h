@@ -34,6 +34,15 @@ public:
     virtual ~CDiskCache() = default;
 
     void store(const QString& key, QImage& img);
+    /**
+       @brief Store an image to disk without keeping it in memory
+
+       Used to seed the cache with a large number of tiles.
+
+       @param key   the tile's key (url)
+       @param img   the tile's image, must not be null
+     */
+    void seed(const QString& key, QImage& img);
     void restore(const QString& key, QImage& img);
     bool contains(const QString& key) const;
 
@@ -0,0 +1,242 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "map/cache/CDiskCache.h"
+#include "map/cache/CTileSeeder.h"
+
+#include <QtNetwork>
+
+CTileSeeder::CTileSeeder(CDiskCache* diskCache, QObject* parent)
+    : QObject(parent)
+    , diskCache(diskCache)
+{
+    accessManager = new QNetworkAccessManager(this);
+    connect(accessManager, &QNetworkAccessManager::finished, this, &CTileSeeder::slotRequestFinished);
+
+    timer = new QTimer(this);
+    timer->setSingleShot(false);
+    connect(timer, &QTimer::timeout, this, &CTileSeeder::slotRequestNext);
+
+    setRateLimit(maxConnections, 0);
+}
+
+void CTileSeeder::setRateLimit(qint32 connections, qreal requestsPerSecond)
+{
+    maxConnections = qMax(1, connections);
+    rateLimited = requestsPerSecond > 0;
+    // without a rate limit the timer just polls the queue
+    timer->setInterval(rateLimited ? qCeil(1000.0 / requestsPerSecond) : 50);
+}
+
+void CTileSeeder::start(const QSet<QString>& urls)
+{
+    bool done = false;
+    start(urls.count(), [urls, done](QSet<QString>& chunk) mutable
+    {
+        if(done)
+        {
+            return false;
+        }
+        chunk = urls;
+        done = true;
+        return true;
+    });
+}
+
+void CTileSeeder::start(qint32 total, const fNextUrls& next)
+{
+    stop();
+
+    if(diskCache.isNull())
+    {
+        return;
+    }
+
+    progress = progress_t();
+    progress.total = total;
+
+    nextUrls = next;
+    cntUrls = 0;
+    urlQueue.clear();
+
+    running = true;
+    timeStart.start();
+
+    fillQueue();
+    emit sigProgress();
+
+    if(urlQueue.isEmpty())
+    {
+        finish();
+        return;
+    }
+
+    timer->start();
+    slotRequestNext();
+}
+
+void CTileSeeder::fillQueue()
+{
+    while(urlQueue.isEmpty() && nextUrls)
+    {
+        QSet<QString> urls;
+        if(!nextUrls(urls))
+        {
+            // now the real number of tiles is known
+            nextUrls = nullptr;
+            progress.total = cntUrls;
+            break;
+        }
+
+        cntUrls += urls.count();
+        for(const QString& url : qAsConst(urls))
+        {
+            if(diskCache->contains(url))
+            {
+                progress.cached++;
+            }
+            else
+            {
+                urlQueue << url;
+            }
+        }
+    }
+}
+
+void CTileSeeder::stop()
+{
+    nextUrls = nullptr;
+    urlQueue.clear();
+    // clear the pending list first as aborted replies will be reported as finished
+    urlPending.clear();
+
+    const QList<QNetworkReply*>& replies = accessManager->findChildren<QNetworkReply*>();
+    for(QNetworkReply* reply : replies)
+    {
+        reply->abort();
+    }
+
+    if(running)
+    {
+        finish();
+    }
+}
+
+void CTileSeeder::finish()
+{
+    timer->stop();
+    running = false;
+    emit sigProgress();
+    emit sigFinished();
+}
+
+void CTileSeeder::slotRequestNext()
+{
+    if(urlQueue.isEmpty() && !diskCache.isNull())
+    {
+        fillQueue();
+    }
+
+    // with a rate limit a single request is sent per timer event,
+    // else all free connections are used.
+    while(!urlQueue.isEmpty() && (urlPending.count() < maxConnections))
+    {
+        QString url = urlQueue.dequeue();
+
+        QNetworkRequest request;
+        request.setUrl(url);
+        for(const QPair<QByteArray, QByteArray>& header : qAsConst(rawHeaders))
+        {
+            request.setRawHeader(header.first, header.second);
+        }
+        accessManager->get(request);
+        urlPending << url;
+
+        if(rateLimited)
+        {
+            break;
+        }
+    }
+}
+
+void CTileSeeder::slotRequestFinished(QNetworkReply* reply)
+{
+    reply->deleteLater();
+
+    const QString& url = reply->url().toString();
+    if(!urlPending.remove(url))
+    {
+        // a reply of a stopped seed operation
+        return;
+    }
+
+    if(diskCache.isNull())
+    {
+        // the map's cache has been reconfigured, there is no point to continue
+        stop();
+        return;
+    }
+
+    QImage img;
+    if(!reply->error())
+    {
+        const QByteArray& data = reply->readAll();
+        progress.bytes += data.size();
+        img.loadFromData(data);
+    }
+    else
+    {
+        qDebug() << "Request to" << url << "failed:" << reply->errorString();
+    }
+
+    if(img.isNull())
+    {
+        // do not store anything to retry the tile when seeding is resumed
+        progress.failed++;
+    }
+    else
+    {
+        diskCache->seed(url, img);
+        progress.done++;
+    }
+
+    const qreal elapsed = timeStart.elapsed() / 1000.0;
+    if(elapsed > 0)
+    {
+        progress.tilesPerSecond = (progress.done + progress.failed) / elapsed;
+        progress.bytesPerSecond = progress.bytes / elapsed;
+    }
+
+    if(urlQueue.isEmpty())
+    {
+        fillQueue();
+    }
+
+    if(urlQueue.isEmpty() && urlPending.isEmpty())
+    {
+        finish();
+        return;
+    }
+
+    emit sigProgress();
+
+    if(!rateLimited)
+    {
+        slotRequestNext();
+    }
+}
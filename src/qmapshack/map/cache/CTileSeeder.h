@@ -0,0 +1,150 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CTILESEEDER_H
+#define CTILESEEDER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QPair>
+#include <QPointer>
+#include <QQueue>
+#include <QSet>
+
+#include <functional>
+
+class CDiskCache;
+class QNetworkAccessManager;
+class QNetworkReply;
+class QTimer;
+
+/**
+   @brief Download a list of tiles into a tile cache
+
+   The seeder is used to fill the cache of an online map for offline use. It requests
+   the tiles with a limited number of concurrent connections and a limited request rate.
+   Tiles already in the cache are skipped. Thus an interrupted seed operation is resumed
+   by simply starting it again with the same list of tiles.
+ */
+class CTileSeeder : public QObject
+{
+    Q_OBJECT
+public:
+    CTileSeeder(CDiskCache* diskCache, QObject* parent);
+    virtual ~CTileSeeder() = default;
+
+    void setRawHeaders(const QList<QPair<QByteArray, QByteArray> >& headers)
+    {
+        rawHeaders = headers;
+    }
+
+    /**
+       @brief Set the limits used to request tiles
+
+       @param connections       maximum number of concurrent requests
+       @param requestsPerSecond maximum number of requests per second, 0 for no limit
+     */
+    void setRateLimit(qint32 connections, qreal requestsPerSecond);
+
+    /**
+       @brief Get the next chunk of urls to seed
+
+       @param urls  a set to receive the urls
+       @return False if there are no more urls.
+     */
+    using fNextUrls = std::function<bool(QSet<QString>& urls)>;
+
+    /**
+       @brief Start to download all tiles not in the cache yet
+       @param urls  the urls of all tiles to seed
+     */
+    void start(const QSet<QString>& urls);
+    /**
+       @brief Start to download all tiles not in the cache yet
+
+       The urls are requested chunk by chunk, e.g. level by level. The next chunk
+       is requested as soon as all urls of the previous one have been sent. Thus
+       the urls of a large seed area are not kept in memory all at once.
+
+       @param total the expected number of tiles, used for the progress until all chunks are known
+       @param next  called to get the next chunk of urls
+     */
+    void start(qint32 total, const fNextUrls& next);
+    /**
+       @brief Stop all pending requests
+
+       Tiles already received are kept in the cache.
+     */
+    void stop();
+
+    bool isRunning() const
+    {
+        return running;
+    }
+
+    struct progress_t
+    {
+        qint32 total = 0;       //< number of tiles in the seed area
+        qint32 cached = 0;      //< number of tiles found in the cache when started
+        qint32 done = 0;        //< number of tiles received since started
+        qint32 failed = 0;      //< number of failed requests since started
+        qint64 bytes = 0;       //< number of bytes received since started
+        qreal tilesPerSecond = 0;
+        qreal bytesPerSecond = 0;
+    };
+
+    const progress_t& getProgress() const
+    {
+        return progress;
+    }
+
+signals:
+    void sigProgress();
+    void sigFinished();
+
+private slots:
+    void slotRequestNext();
+    void slotRequestFinished(QNetworkReply* reply);
+
+private:
+    void finish();
+    /// fill the empty queue with the next chunk of urls not in the cache
+    void fillQueue();
+
+    QPointer<CDiskCache> diskCache;
+    QNetworkAccessManager* accessManager;
+    QTimer* timer;
+
+    QList<QPair<QByteArray, QByteArray> > rawHeaders;
+
+    qint32 maxConnections = 2;
+    bool rateLimited = false;
+
+    fNextUrls nextUrls;
+    /// the number of urls received from nextUrls so far
+    qint32 cntUrls = 0;
+
+    QQueue<QString> urlQueue;
+    QSet<QString> urlPending;
+
+    bool running = false;
+    progress_t progress;
+    QElapsedTimer timeStart;
+};
+
+#endif //CTILESEEDER_H
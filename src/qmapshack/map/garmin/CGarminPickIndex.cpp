@@ -0,0 +1,134 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "map/garmin/CGarminPickIndex.h"
+
+#include <QtCore>
+
+CGarminPickIndex::CGarminPickIndex(qreal cellSize)
+    : cellSize(cellSize)
+{
+}
+
+void CGarminPickIndex::reset(const QRectF& area)
+{
+    this->area = area.normalized();
+    const qint32 newCols = qMax(1, qCeil(this->area.width() / cellSize));
+    const qint32 newRows = qMax(1, qCeil(this->area.height() / cellSize));
+
+    if(newCols != cols || newRows != rows)
+    {
+        cols = newCols;
+        rows = newRows;
+        cells = QVector<QVector<quint64> >(cols * rows);
+    }
+    else
+    {
+        // keep the allocated memory for the next frame
+        for(QVector<quint64>& cell : cells)
+        {
+            cell.resize(0);
+        }
+    }
+}
+
+void CGarminPickIndex::clear()
+{
+    cells.clear();
+    cols = 0;
+    rows = 0;
+}
+
+bool CGarminPickIndex::getCells(const QRectF& rect, qint32& col1, qint32& row1, qint32& col2, qint32& row2) const
+{
+    if(cells.isEmpty())
+    {
+        return false;
+    }
+
+    // objects not converted to pixel coordinates or broken data
+    if(!qIsFinite(rect.left()) || !qIsFinite(rect.top()) || !qIsFinite(rect.right()) || !qIsFinite(rect.bottom()))
+    {
+        return false;
+    }
+
+    // clamp before the conversion to int to handle coordinates far outside
+    auto toCol = [this](qreal x)
+    {
+        return qBound(0, qFloor(qBound(qreal(-1), (x - area.left()) / cellSize, qreal(cols))), cols - 1);
+    };
+    auto toRow = [this](qreal y)
+    {
+        return qBound(0, qFloor(qBound(qreal(-1), (y - area.top()) / cellSize, qreal(rows))), rows - 1);
+    };
+
+    col1 = toCol(rect.left());
+    col2 = toCol(rect.right());
+    row1 = toRow(rect.top());
+    row2 = toRow(rect.bottom());
+    return true;
+}
+
+void CGarminPickIndex::insert(const QRectF& rect, quint64 id)
+{
+    qint32 col1, row1, col2, row2;
+    if(!getCells(rect.normalized(), col1, row1, col2, row2))
+    {
+        return;
+    }
+
+    for(qint32 row = row1; row <= row2; row++)
+    {
+        for(qint32 col = col1; col <= col2; col++)
+        {
+            cells[row * cols + col] << id;
+        }
+    }
+}
+
+void CGarminPickIndex::insertSegments(const QPolygonF& line, quint32 idx)
+{
+    const qint32 len = line.size();
+    for(qint32 i = 1; i < len; i++)
+    {
+        insert(QRectF(line[i - 1], line[i]), makeId(idx, i));
+    }
+}
+
+void CGarminPickIndex::find(const QRectF& rect, QVector<quint64>& ids) const
+{
+    ids.resize(0);
+
+    qint32 col1, row1, col2, row2;
+    if(!getCells(rect.normalized(), col1, row1, col2, row2))
+    {
+        return;
+    }
+
+    for(qint32 row = row1; row <= row2; row++)
+    {
+        for(qint32 col = col1; col <= col2; col++)
+        {
+            ids << cells[row * cols + col];
+        }
+    }
+
+    // restore the order of the objects to get the same result as a linear search
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+}
@@ -0,0 +1,107 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CGARMINPICKINDEX_H
+#define CGARMINPICKINDEX_H
+
+#include <QPolygonF>
+#include <QRectF>
+#include <QVector>
+
+/**
+   @brief A grid over screen pixel coordinates to find drawn objects close to a point
+
+   Each cell lists the ids of all objects whose bounding box touches the cell. Objects
+   and queries outside the grid's area are clamped to the border cells. Thus a query
+   returns a superset of all objects touching the query rectangle. The caller has to
+   do the exact test on them.
+ */
+class CGarminPickIndex
+{
+public:
+    CGarminPickIndex(qreal cellSize = 32);
+    virtual ~CGarminPickIndex() = default;
+
+    /**
+       @brief Remove all objects and set the area covered by the grid
+
+       @param area  the area in screen pixel coordinates
+     */
+    void reset(const QRectF& area);
+
+    /// remove all objects
+    void clear();
+
+    bool isEmpty() const
+    {
+        return cells.isEmpty();
+    }
+
+    /**
+       @brief Add an object by it's bounding box
+
+       @param rect  the bounding box [px]
+       @param id    the id reported by find()
+     */
+    void insert(const QRectF& rect, quint64 id);
+
+    /**
+       @brief Add all segments of a polyline
+
+       Each segment is added with an id made by makeId() from the polyline's index
+       and the index of the segment's end point.
+
+       @param line  the polyline [px]
+       @param idx   the index of the polyline
+     */
+    void insertSegments(const QPolygonF& line, quint32 idx);
+
+    /**
+       @brief Get all objects touching a rectangle
+
+       @param rect  the rectangle [px]
+       @param ids   receives the ids in ascending order without duplicates
+     */
+    void find(const QRectF& rect, QVector<quint64>& ids) const;
+
+    static quint64 makeId(quint32 idx, quint32 segment)
+    {
+        return (quint64(idx) << 32) | segment;
+    }
+
+    static quint32 getIndex(quint64 id)
+    {
+        return id >> 32;
+    }
+
+    static quint32 getSegment(quint64 id)
+    {
+        return id & 0xFFFFFFFF;
+    }
+
+private:
+    bool getCells(const QRectF& rect, qint32& col1, qint32& row1, qint32& col2, qint32& row2) const;
+
+    const qreal cellSize;
+    QRectF area;
+    qint32 cols = 0;
+    qint32 rows = 0;
+    QVector<QVector<quint64> > cells;
+};
+
+#endif //CGARMINPICKINDEX_H
@@ -71,6 +71,7 @@ void CMouseEditArea::slotCopyToOrig()
 void CMouseEditArea::slotCopyToNew()
 {
     canvas->reportStatus(key.item, "");
+    waitForRouting();
 
     if(points.size() < 3)
     {
@@ -86,6 +86,7 @@ void CMouseEditTrk::slotCopyToOrig()
 void CMouseEditTrk::slotCopyToNew()
 {
     canvas->reportStatus(key.item, "");
+    waitForRouting();
 
     if(points.size() < 2)
     {
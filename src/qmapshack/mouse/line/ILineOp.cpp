@@ -228,10 +228,14 @@ ILineOp::~ILineOp()
 void ILineOp::cancelDelayedRouting()
 {
     timerRouting->stop();
+    parentHandler->cancelRouting();
 }
 
 void ILineOp::startDelayedRouting()
 {
+    // the point has moved again, any route still calculated for it is obsolete
+    parentHandler->cancelRouting();
+
     if(parentHandler->useAutoRouting())
     {
         timerRouting->start();
@@ -380,8 +384,17 @@ void ILineOp::showRoutingErrorMessage(const QString& msg) const
     }
 }
 
-void ILineOp::tryRouting(IGisLine::point_t& pt1, IGisLine::point_t& pt2) const
+void ILineOp::tryRouting(qint32 idx)
 {
+    if(parentHandler->startRouting(idx))
+    {
+        return;
+    }
+
+    CCanvasCursorLock cursorLock(Qt::WaitCursor, __func__);
+
+    IGisLine::point_t& pt1 = points[idx];
+    IGisLine::point_t& pt2 = points[idx + 1];
     QPolygonF subs;
 
     try
@@ -413,14 +426,13 @@ void ILineOp::finalizeOperation(qint32 idx)
 
     if(parentHandler->useAutoRouting())
     {
-        CCanvasCursorLock cursorLock(Qt::WaitCursor, __func__);
         if(idx > 0)
         {
-            tryRouting(points[idx - 1], points[idx]);
+            tryRouting(idx - 1);
         }
         if(idx < (points.size() - 1))
         {
-            tryRouting(points[idx], points[idx + 1]);
+            tryRouting(idx);
         }
     }
     else if(parentHandler->useVectorRouting() || parentHandler->useTrackRouting())
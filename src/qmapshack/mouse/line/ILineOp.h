@@ -117,7 +117,15 @@ protected:
     QPolygonF subLinePixel2;
 
 private:
-    void tryRouting(IGisLine::point_t& pt1, IGisLine::point_t& pt2) const;
+    /**
+       @brief Route the segment from point idx to idx + 1
+
+       The segment is routed in the background if the router supports it.
+       Otherwise the route is calculated right away.
+
+       @param idx   the index of the segment's first point
+     */
+    void tryRouting(qint32 idx);
 
     QTimer* timerRouting;
     QTime buttonPressTime;
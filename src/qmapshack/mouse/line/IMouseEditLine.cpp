@@ -23,8 +23,10 @@
 #include "gis/GeoMath.h"
 #include "gis/IGisLine.h"
 #include "gis/rte/router/CRouterOptimization.h"
+#include "gis/rte/router/CRouterSetup.h"
 #include "gis/trk/CGisItemTrk.h"
 #include "helpers/CDraw.h"
+#include "helpers/CProgressDialog.h"
 #include "helpers/CSettings.h"
 #include "mouse/CMouseAdapter.h"
 #include "mouse/line/CLineOpAddPoint.h"
@@ -37,6 +39,8 @@
 
 #include <QtWidgets>
 
+#define ROUTING_TIMEOUT 30000 // ms
+
 IMouseEditLine::IMouseEditLine(const IGisItem::key_t& key, const QPointF& point, bool enableStatus, const QString& type, CGisDraw* gis, CCanvas* canvas, CMouseAdapter* mouse)
     : IMouse(gis, canvas, mouse)
     , key(key)
@@ -69,6 +73,11 @@ IMouseEditLine::IMouseEditLine(const IGisItem::key_t& key, IGisLine& src, bool e
 
 IMouseEditLine::~IMouseEditLine()
 {
+    for(quint64 id : routingsPending.keys())
+    {
+        CRouterSetup::self().cancelRouteAsync(id);
+    }
+
     canvas->reportStatus("IMouseEditLine", "");
     canvas->reportStatus(key.item, "");
     canvas->reportStatus("Optimization", "");
@@ -121,6 +130,8 @@ void IMouseEditLine::commonSetup()
     connect(scrOptEditLine->toolUndo, &QPushButton::clicked, this, &IMouseEditLine::slotUndo         );
     connect(scrOptEditLine->toolRedo, &QPushButton::clicked, this, &IMouseEditLine::slotRedo         );
 
+    connect(&CRouterSetup::self(), &CRouterSetup::sigRouteFinished, this, &IMouseEditLine::slotRouteFinished);
+
     SETTINGS;
     int mode = cfg.value("Route/drawMode", 0).toInt();
     switch(mode)
@@ -225,6 +236,16 @@ void IMouseEditLine::draw(QPainter& p, CCanvas::redraw_e needsRedraw, const QRec
 
     drawLine(pixelLine, Qt::magenta, 5, p);
 
+    // segments still routed in the background are drawn as provisional lines
+    p.setPen(QPen(Qt::white, 3, Qt::DashLine, Qt::FlatCap));
+    for(const routing_t& routing : qAsConst(routingsPending))
+    {
+        QPolygonF line;
+        line << routing.coord1 << routing.coord2;
+        gis->convertRad2Px(line);
+        p.drawPolyline(line);
+    }
+
     p.setPen(Qt::NoPen);
     p.setBrush(Qt::black);
     QRect r2(0, 0, 7, 7);
@@ -355,6 +376,9 @@ void IMouseEditLine::slotTrackRouting()
 
 void IMouseEditLine::slotOptimize()
 {
+    // the optimizer needs the router
+    waitForRouting();
+
     canvas->reportStatus(key.item, "");
     canvas->reportStatus("Optimization", QString("<b>%1</b><br/>").arg(tr("Started Optimization.")));
 
@@ -415,6 +439,8 @@ void IMouseEditLine::slotAbortEx(bool showMB)
 
 void IMouseEditLine::slotCopyToOrig()
 {
+    waitForRouting();
+
     QMutexLocker lock(&IGisItem::mutexItems);
 
     IGisLine* line = getGisLine();
@@ -498,6 +524,186 @@ void IMouseEditLine::slotRedo()
     updateStatus();
 }
 
+/**
+   @brief Find a segment in a line by the coordinates of its points
+
+   @param line      the line
+   @param idx       the index of the segment's first point at the time the route was requested
+   @param coord1    the coordinate of the segment's first point
+   @param coord2    the coordinate of the segment's last point
+   @return The index of the segment's first point or NOIDX if the segment does not exist anymore.
+ */
+static qint32 findSegment(const SGisLine& line, qint32 idx, const QPointF& coord1, const QPointF& coord2)
+{
+    auto isSegment = [&](qint32 i)
+    {
+        return (i >= 0) && ((i + 1) < line.size()) && (line[i].coord == coord1) && (line[i + 1].coord == coord2);
+    };
+
+    // points might have been added or removed in the meantime
+    if(isSegment(idx))
+    {
+        return idx;
+    }
+
+    for(qint32 i = 0; i < (line.size() - 1); i++)
+    {
+        if(isSegment(i))
+        {
+            return i;
+        }
+    }
+    return NOIDX;
+}
+
+/**
+   @brief Replace the subpoints of a segment by a route
+
+   @param line      the line
+   @param idx       the index of the segment's first point at the time the route was requested
+   @param coord1    the coordinate of the segment's first point
+   @param coord2    the coordinate of the segment's last point
+   @param coords    the route
+   @param onlyEmpty if true a segment with subpoints is not changed
+   @return True if the segment has been found in the line.
+ */
+static bool applyRoute(SGisLine& line, qint32 idx, const QPointF& coord1, const QPointF& coord2, const QPolygonF& coords, bool onlyEmpty)
+{
+    idx = findSegment(line, idx, coord1, coord2);
+    if(idx == NOIDX)
+    {
+        return false;
+    }
+
+    IGisLine::point_t& pt = line[idx];
+    if(onlyEmpty && !pt.subpts.isEmpty())
+    {
+        return true;
+    }
+
+    pt.subpts.clear();
+    for(const QPointF& sub : coords)
+    {
+        pt.subpts << IGisLine::subpt_t(sub);
+    }
+    return true;
+}
+
+bool IMouseEditLine::startRouting(qint32 idx)
+{
+    const IGisLine::point_t& pt1 = points[idx];
+    const IGisLine::point_t& pt2 = points[idx + 1];
+
+    // requests are matched by coordinates as indices shift when points are inserted or removed
+    QHash<quint64, routing_t>::iterator it = routingsPending.begin();
+    while(it != routingsPending.end())
+    {
+        if((it->coord1 == pt1.coord) && (it->coord2 == pt2.coord))
+        {
+            CRouterSetup::self().cancelRouteAsync(it.key());
+            it = routingsPending.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    const quint64 id = CRouterSetup::self().calcRouteAsync(pt1.coord, pt2.coord);
+    if(id == 0)
+    {
+        return false;
+    }
+
+    routingsPending[id] = {idx, pt1.coord, pt2.coord};
+    return true;
+}
+
+void IMouseEditLine::cancelRouting()
+{
+    if(routingsPending.isEmpty())
+    {
+        return;
+    }
+
+    // a request is still of use as long as its segment exists in the line or in the last stored state
+    const SGisLine* stored = (idxHistory != NOIDX) ? &history[idxHistory] : nullptr;
+
+    QHash<quint64, routing_t>::iterator it = routingsPending.begin();
+    while(it != routingsPending.end())
+    {
+        const bool inLine = findSegment(points, it->idx, it->coord1, it->coord2) != NOIDX;
+        const bool inHistory = (stored != nullptr) && (findSegment(*stored, it->idx, it->coord1, it->coord2) != NOIDX);
+        if(!inLine && !inHistory)
+        {
+            CRouterSetup::self().cancelRouteAsync(it.key());
+            it = routingsPending.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void IMouseEditLine::waitForRouting()
+{
+    if(routingsPending.isEmpty())
+    {
+        return;
+    }
+
+    CProgressDialog progress(tr("Wait for routing..."), 0, NOINT, canvas);
+    QElapsedTimer elapsed;
+    elapsed.start();
+    while(!routingsPending.isEmpty() && !progress.wasCanceled() && !elapsed.hasExpired(ROUTING_TIMEOUT))
+    {
+        // as long as the modal progress dialog is not shown user input must not reach the canvas
+        QEventLoop::ProcessEventsFlags flags = QEventLoop::WaitForMoreEvents;
+        if(!progress.isVisible())
+        {
+            flags |= QEventLoop::ExcludeUserInputEvents;
+        }
+        QApplication::processEvents(flags);
+    }
+
+    // don't wait for a router that does not respond or the user gave up on, keep the segments as they are
+    for(quint64 id : routingsPending.keys())
+    {
+        CRouterSetup::self().cancelRouteAsync(id);
+    }
+    routingsPending.clear();
+}
+
+void IMouseEditLine::slotRouteFinished(quint64 id, const QPolygonF& coords, const QString& error)
+{
+    if(!routingsPending.contains(id))
+    {
+        // request of another line or canceled
+        return;
+    }
+
+    const routing_t routing = routingsPending.take(id);
+    if(error.isEmpty())
+    {
+        applyRoute(points, routing.idx, routing.coord1, routing.coord2, coords, false);
+
+        // the operation might have been stored to the history already without the route
+        for(SGisLine& line : history)
+        {
+            applyRoute(line, routing.idx, routing.coord1, routing.coord2, coords, true);
+        }
+    }
+
+    if(lineOp != nullptr)
+    {
+        lineOp->showRoutingErrorMessage(error);
+    }
+
+    canvas->slotTriggerCompleteUpdate(CCanvas::eRedrawMouse);
+    updateStatus();
+}
+
 void IMouseEditLine::updateStatus()
 {
     if(!enableStatus || points.isEmpty())
@@ -25,6 +25,7 @@
 #include "gis/rte/router/CRouterOptimization.h"
 #include "mouse/IMouse.h"
 #include <QDebug>
+#include <QHash>
 #include <QPointer>
 #include <QPolygonF>
 
@@ -78,6 +79,23 @@ public:
     void storeToHistory(const SGisLine& line);
     void restoreFromHistory(SGisLine& line);
 
+    /**
+       @brief Start to route the segment from point idx to idx + 1 in the background
+
+       The result is merged into the line as soon as it is available. A pending
+       request of the same segment is canceled. Requests are matched by the
+       coordinates of the segment's points as indices shift when points are
+       inserted or removed.
+
+       @param idx   the index of the segment's first point
+       @return False if the router can't route in the background.
+     */
+    bool startRouting(qint32 idx);
+    /**
+       @brief Cancel background routing of segments that are neither part of the line nor of the last stored state
+     */
+    void cancelRouting();
+
     virtual void updateStatus();
 
 protected slots:
@@ -113,6 +131,9 @@ protected slots:
     void slotUndo();
     void slotRedo();
 
+private slots:
+    void slotRouteFinished(quint64 id, const QPolygonF& coords, const QString& error);
+
 protected:
     virtual void drawLine(const QPolygonF& l, const QColor color, int width, QPainter& p);
     /**
@@ -123,6 +144,9 @@ protected:
 
     virtual void startNewLine(const QPointF& point);
 
+    /// block until all segments routed in the background are merged into the line, the user canceled or the router timed out
+    void waitForRouting();
+
     /// shadow cursor needed to restore cursor after some actions providing their own cursor.
     QCursor cursor1;
 
@@ -157,6 +181,17 @@ private:
     QString type;
 
     CRouterOptimization optimizer;
+
+    /// a segment routed in the background
+    struct routing_t
+    {
+        qint32 idx;
+        QPointF coord1;
+        QPointF coord2;
+    };
+
+    /// the pending background routing requests by request id
+    QHash<quint64, routing_t> routingsPending;
 };
 
 #endif //IMOUSEEDITLINE_H
@@ -0,0 +1,70 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "plot/CPlotEnvelope.h"
+
+void CPlotEnvelope::add(int ptx, int pty)
+{
+    if(!isEmpty && (ptx == x))
+    {
+        if(pty < min)
+        {
+            min = pty;
+            minFirst = false;
+        }
+        if(pty > max)
+        {
+            max = pty;
+            minFirst = true;
+        }
+        last = pty;
+        return;
+    }
+
+    flush();
+
+    isEmpty = false;
+    x = ptx;
+    first = last = min = max = pty;
+    minFirst = true;
+}
+
+void CPlotEnvelope::flush()
+{
+    if(isEmpty)
+    {
+        return;
+    }
+    isEmpty = true;
+
+    line << QPointF(x, first);
+
+    // the extrema in the order they appeared, skip points equal to their predecessor
+    const int ext1 = minFirst ? min : max;
+    const int ext2 = minFirst ? max : min;
+    int prev = first;
+    for(int y : {ext1, ext2, last})
+    {
+        if(y != prev)
+        {
+            line << QPointF(x, y);
+            prev = y;
+        }
+    }
+}
+
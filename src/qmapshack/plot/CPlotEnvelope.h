@@ -0,0 +1,78 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CPLOTENVELOPE_H
+#define CPLOTENVELOPE_H
+
+#include <QPolygonF>
+
+/**
+   @brief Reduce a polyline to a min/max envelope per pixel column
+
+   Consecutive points with the same x pixel coordinate are reduced to the first,
+   the minimum, the maximum and the last point of the column in the order of
+   their occurrence. Drawing the result looks exactly like drawing all points,
+   as all segments within a column are covered by the vertical extent of the
+   column and the segments to the neighbouring columns are kept.
+ */
+class CPlotEnvelope
+{
+public:
+    CPlotEnvelope(QPolygonF& line) : line(line) {}
+    virtual ~CPlotEnvelope()
+    {
+        flush();
+    }
+
+    /**
+       @brief Add a data point
+
+       @param ptx   the x pixel coordinate
+       @param pty   the y pixel coordinate
+     */
+    void add(int ptx, int pty);
+
+    /**
+       @brief Flush the current column and append a point without reduction
+
+       @param pt    the point to append, px. a base point of the plot's area
+     */
+    void append(const QPointF& pt)
+    {
+        flush();
+        line << pt;
+    }
+
+    /// append the pending column to the line
+    void flush();
+
+private:
+    QPolygonF& line;
+
+    bool isEmpty = true;
+    int x = 0;
+    int first = 0;
+    int last = 0;
+    int min = 0;
+    int max = 0;
+    /// true if the minimum has been found before the maximum
+    bool minFirst = true;
+};
+
+#endif //CPLOTENVELOPE_H
+
@@ -18,6 +18,7 @@
 **********************************************************************************************/
 
 #include "plot/CPlotAxis.h"
+#include "plot/CPlotEnvelope.h"
 #include "plot/IPlot.h"
 
 #include "CMainWindow.h"
@@ -841,6 +842,10 @@ QPolygonF IPlot::getVisiblePolygon(const QPolygonF& polyline, QPolygonF& line) c
     int ptx = NOINT;
     int pty = NOINT;
 
+    // reduce the points to a min/max envelope per pixel column,
+    // there are way more points than pixels for long tracks
+    CPlotEnvelope envelope(line);
+
     for(const QPointF& pt : polyline)
     {
         int oldPtx = ptx;
@@ -856,18 +861,18 @@ QPolygonF IPlot::getVisiblePolygon(const QPolygonF& polyline, QPolygonF& line) c
                 // we may need to interpolate things if we just found the first visible point
                 if(NOINT != oldPtx && ptx > left)
                 {
-                    line << getBasePoint(left);
+                    envelope.append(getBasePoint(left));
 
                     int intPty = oldPty + ((oldPty - pty) * (left - oldPtx)) / (oldPtx - ptx);
-                    line << QPointF(left, intPty);
+                    envelope.append(QPointF(left, intPty));
                 }
                 else
                 {
-                    line << getBasePoint(ptx);
+                    envelope.append(getBasePoint(ptx));
                 }
             }
 
-            line << QPointF(ptx, pty);
+            envelope.add(ptx, pty);
         }
         else if(ptx > right)
         {
@@ -878,14 +883,14 @@ QPolygonF IPlot::getVisiblePolygon(const QPolygonF& polyline, QPolygonF& line) c
                 oldPty = oldPty + (pty - oldPty) / (left - oldPtx);
                 oldPtx = left;
 
-                line << getBasePoint(oldPtx);
-                line << QPointF(oldPtx, oldPty);
+                envelope.append(getBasePoint(oldPtx));
+                envelope.append(QPointF(oldPtx, oldPty));
             }
 
             // interpolate the value at `right`
             pty = (ptx - oldPtx) == 0 ? NOINT : oldPty + ((pty - oldPty) * (right - oldPtx)) / (ptx - oldPtx);
             ptx = right;
-            line << QPointF(ptx, pty);
+            envelope.append(QPointF(ptx, pty));
         }
 
         if(ptx >= right)
@@ -893,7 +898,7 @@ QPolygonF IPlot::getVisiblePolygon(const QPolygonF& polyline, QPolygonF& line) c
             break;
         }
     }
-    line << getBasePoint(ptx);
+    envelope.append(getBasePoint(ptx));
     return line;
 }
 
@@ -31,6 +31,11 @@
 #include <QSqlQuery>
 #include <QtWidgets>
 
+/// the number of cached POIs before least recently used cells are dropped
+#define MAX_CACHED_POIS  100000
+/// the number of cached cells before least recently used cells are dropped
+#define MAX_CACHED_CELLS 100000
+
 CPoiPOI::CPoiPOI(const QString& filename, CPoiDraw* parent)
     : IPoi(parent)
     , filename(filename)
@@ -78,6 +83,49 @@ CPoiPOI::CPoiPOI(const QString& filename, CPoiDraw* parent)
     QSqlDatabase::removeDatabase(filename + "_bbox");
 }
 
+CPoiPOI::~CPoiPOI()
+{
+    for(const QString& connection : qAsConst(connections))
+    {
+        QSqlDatabase::removeDatabase(connection);
+    }
+}
+
+QSqlDatabase CPoiPOI::getDatabase()
+{
+    QMutexLocker lock(&mutex);
+
+    // a connection can only be used by the thread that created it.
+    // Keep one per thread open as long as the POI file is loaded.
+    const QString& connection = filename + "_" + QString::number(quintptr(QThread::currentThreadId()));
+    if(!QSqlDatabase::contains(connection))
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connection);
+        db.setDatabaseName(filename);
+        connections << connection;
+        if(!db.open())
+        {
+            qDebug() << "failed to open database" << db.lastError();
+        }
+        return db;
+    }
+
+    return QSqlDatabase::database(connection);
+}
+
+QList<quint64> CPoiPOI::getActiveCategories() const
+{
+    QList<quint64> categories;
+    for(auto it = categoryActivated.constBegin(); it != categoryActivated.constEnd(); ++it)
+    {
+        if(it.value() == Qt::Checked)
+        {
+            categories << it.key();
+        }
+    }
+    return categories;
+}
+
 
 void CPoiPOI::draw(IDrawContext::buffer_t& buf)
 {
@@ -121,33 +169,48 @@ void CPoiPOI::draw(IDrawContext::buffer_t& buf)
         xMax = 180 * DEG_TO_RAD;
     }
 
+    // cell range in view
+    const int lonM10Min = qFloor(xMin * RAD_TO_DEG * 10);
+    const int lonM10Max = qCeil(xMax * RAD_TO_DEG * 10) - 1;
+    const int latM10Min = qFloor(yMin * RAD_TO_DEG * 10);
+    const int latM10Max = qCeil(yMax * RAD_TO_DEG * 10) - 1;
+
     // draw POI
     QMutexLocker lock(&mutex);
+    drawCycle++;
     displayedPois.clear();
+    displayedPoisGrid.clear();
+    gridSize = IPoi::iconSize() * 2;
+
+    const QList<quint64>& categories = getActiveCategories();
+    loadPOIsFromFile(categories, lonM10Min, lonM10Max, latM10Min, latM10Max);
+    if(poi->needsRedraw())
+    {
+        return;
+    }
+
     QRectF freeSpaceRect (QPointF(), IPoi::iconSize() * 2);
+    QVector<qint32> candidates;
     //Find POIs in view
-    const QList<quint64>& keys = categoryActivated.keys();
-    for(quint64 categoryID : keys)
+    for(quint64 categoryID : categories)
     {
-        if(categoryActivated[categoryID] != Qt::Checked)
-        {
-            continue;
-        }
-        for(int minLonM10 = qFloor(xMin * RAD_TO_DEG * 10); minLonM10 < qCeil(xMax * RAD_TO_DEG * 10); minLonM10++)
+        for(int minLonM10 = lonM10Min; minLonM10 <= lonM10Max; minLonM10++)
         {
-            for(int minLatM10 = qFloor(yMin * RAD_TO_DEG * 10); minLatM10 < qCeil(yMax * RAD_TO_DEG * 10); minLatM10++)
+            for(int minLatM10 = latM10Min; minLatM10 <= latM10Max; minLatM10++)
             {
-                if(!loadedPoisByArea.contains(categoryID) ||
-                   !loadedPoisByArea[categoryID].contains(minLonM10) ||
-                   !loadedPoisByArea[categoryID][minLonM10].contains(minLatM10))
-                {
-                    loadPOIsFromFile(categoryID, minLonM10, minLatM10);
-                }
                 if(poi->needsRedraw())
                 {
                     return;
                 }
-                for(quint64 poiToDrawID : qAsConst(loadedPoisByArea)[categoryID][minLonM10][minLatM10])
+
+                auto cell = loadedCells.find(cellKey(categoryID, minLonM10, minLatM10));
+                if(cell == loadedCells.end())
+                {
+                    continue;
+                }
+                cell->lastUse = drawCycle;
+
+                for(quint64 poiToDrawID : qAsConst(cell->pois))
                 {
                     const CRawPoi& poiToDraw = loadedPois[poiToDrawID];
                     QPointF pt = poiToDraw.getCoordinates();
@@ -155,9 +218,13 @@ void CPoiPOI::draw(IDrawContext::buffer_t& buf)
 
                     freeSpaceRect.moveCenter(pt);
 
+                    // as the candidates are sorted the POI is added to the same group as
+                    // if all groups were tested in the order they have been created
                     bool foundIntersection = false;
-                    for(poiGroup_t& poiGroup : displayedPois)
+                    getPoiGroupCandidates(freeSpaceRect, candidates);
+                    for(qint32 idx : qAsConst(candidates))
                     {
+                        poiGroup_t& poiGroup = displayedPois[idx];
                         if(poiGroup.iconLocation.intersects(freeSpaceRect))
                         {
                             foundIntersection = true;
@@ -174,13 +241,16 @@ void CPoiPOI::draw(IDrawContext::buffer_t& buf)
                         poiGroup.iconLocation = iconRect;
                         poiGroup.iconCenter = poiToDraw.getCoordinates();
                         poiGroup.pois.insert(poiToDrawID);
-                        displayedPois.append(poiGroup);
+                        addPoiGroup(poiGroup);
                     }
                 }
             }
         }
     }
 
+    // all cells in view are marked with the current draw cycle and won't be dropped
+    trimCache();
+
     //Draw Icons
     for(const poiGroup_t& poiGroup : qAsConst(displayedPois))
     {
@@ -278,25 +348,29 @@ void CPoiPOI::findPoisIn(const QRectF& degRect, QSet<poi_t>& pois, QList<QPointF
 
     //Find POIs
     QSet<quint64> copiedItems; //Some Items may appear in multiple categories. We only want to copy those once.
-    const QList<quint64>& keys = categoryActivated.keys();
-    for(quint64 categoryID : keys)
+    const QList<quint64>& categories = getActiveCategories();
+    const int lonM10Min = qFloor(degRect.left() * 10);
+    const int lonM10Max = qFloor(degRect.right() * 10);
+    const int latM10Min = qFloor(degRect.bottom() * 10);
+    const int latM10Max = qFloor(degRect.top() * 10);
+
+    //Imagine the user moves the screen in an l-shape while updating the selection rectangle. It is possible that some cells are not loaded then
+    loadPOIsFromFile(categories, lonM10Min, lonM10Max, latM10Min, latM10Max);
+
+    for(quint64 categoryID : categories)
     {
-        if(categoryActivated[categoryID] != Qt::Checked)
+        for(int minLonM10 = lonM10Min; minLonM10 <= lonM10Max; minLonM10++)
         {
-            continue;
-        }
-        for(int minLonM10 = qFloor(degRect.left() * 10); minLonM10 <= qFloor(degRect.right() * 10); minLonM10++)
-        {
-            for(int minLatM10 = qFloor(degRect.bottom() * 10); minLatM10 <= qFloor(degRect.top() * 10); minLatM10++)
+            for(int minLatM10 = latM10Min; minLatM10 <= latM10Max; minLatM10++)
             {
-                //Imagine the user moves the screen in an l-shape while updating the selection rectangle. It is possible that some tiles are not laded then
-                if(!loadedPoisByArea.contains(categoryID) ||
-                   !loadedPoisByArea[categoryID].contains(minLonM10) ||
-                   !loadedPoisByArea[categoryID][minLonM10].contains(minLatM10))
+                auto cell = loadedCells.find(cellKey(categoryID, minLonM10, minLatM10));
+                if(cell == loadedCells.end())
                 {
-                    loadPOIsFromFile(categoryID, minLonM10, minLatM10);
+                    continue;
                 }
-                for(quint64 poiFoundID : qAsConst(loadedPoisByArea)[categoryID][minLonM10][minLatM10])
+                cell->lastUse = drawCycle;
+
+                for(quint64 poiFoundID : qAsConst(cell->pois))
                 {
                     const CRawPoi& poiItemFound = loadedPois[poiFoundID];
                     if(!copiedItems.contains(poiItemFound.getKey()))
@@ -472,9 +546,11 @@ void CPoiPOI::getPoiIcon(QPixmap& icon, const CRawPoi& poi, const QString& defin
 
 bool CPoiPOI::overlapsWithIcon(const QRectF& rect) const
 {
-    for(const poiGroup_t& poiGroup : displayedPois)
+    QVector<qint32> candidates;
+    getPoiGroupCandidates(rect, candidates);
+    for(qint32 idx : qAsConst(candidates))
     {
-        if(poiGroup.iconLocation.intersects(rect))
+        if(displayedPois[idx].iconLocation.intersects(rect))
         {
             return true;
         }
@@ -484,8 +560,11 @@ bool CPoiPOI::overlapsWithIcon(const QRectF& rect) const
 
 bool CPoiPOI::getPoiGroupCloseBy(const QPoint& px, CPoiPOI::poiGroup_t& poiItem) const
 {
-    for(const poiGroup_t& poiGroup : displayedPois)
+    QVector<qint32> candidates;
+    getPoiGroupCandidates(QRectF(px, QSizeF(0, 0)), candidates);
+    for(qint32 idx : qAsConst(candidates))
     {
+        const poiGroup_t& poiGroup = displayedPois[idx];
         if(poiGroup.iconLocation.contains(px))
         {
             poiItem = poiGroup;
@@ -495,57 +574,192 @@ bool CPoiPOI::getPoiGroupCloseBy(const QPoint& px, CPoiPOI::poiGroup_t& poiItem)
     return false;
 }
 
-void CPoiPOI::loadPOIsFromFile(quint64 categoryID, int minLonM10, int minLatM10)
+quint64 CPoiPOI::gridKey(const QPointF& pt) const
+{
+    const qint32 x = qFloor(pt.x() / gridSize.width());
+    const qint32 y = qFloor(pt.y() / gridSize.height());
+    return (quint64(quint32(x)) << 32) | quint32(y);
+}
+
+void CPoiPOI::addPoiGroup(const poiGroup_t& poiGroup)
+{
+    displayedPoisGrid[gridKey(poiGroup.iconLocation.center())].append(displayedPois.size());
+    displayedPois.append(poiGroup);
+}
+
+void CPoiPOI::getPoiGroupCandidates(const QRectF& rect, QVector<qint32>& candidates) const
+{
+    candidates.clear();
+
+    // an icon can intersect the rectangle if it's center is closer than half the icon size.
+    // The grid size is twice the icon size used by the last draw cycle.
+    const QSizeF iconSize = gridSize / 2;
+    const QRectF& area = rect.normalized().adjusted(-iconSize.width() / 2, -iconSize.height() / 2, iconSize.width() / 2, iconSize.height() / 2);
+
+    const qint32 x1 = qFloor(area.left() / gridSize.width());
+    const qint32 x2 = qFloor(area.right() / gridSize.width());
+    const qint32 y1 = qFloor(area.top() / gridSize.height());
+    const qint32 y2 = qFloor(area.bottom() / gridSize.height());
+
+    // a large rectangle is cheaper to test against all groups
+    if(qint64(x2 - x1 + 1) * (y2 - y1 + 1) > displayedPoisGrid.size())
+    {
+        for(auto it = displayedPoisGrid.constBegin(); it != displayedPoisGrid.constEnd(); ++it)
+        {
+            candidates += it.value();
+        }
+    }
+    else
+    {
+        for(qint32 x = x1; x <= x2; x++)
+        {
+            for(qint32 y = y1; y <= y2; y++)
+            {
+                auto it = displayedPoisGrid.constFind((quint64(quint32(x)) << 32) | quint32(y));
+                if(it != displayedPoisGrid.constEnd())
+                {
+                    candidates += it.value();
+                }
+            }
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+}
+
+void CPoiPOI::loadPOIsFromFile(const QList<quint64>& categories, int lonM10Min, int lonM10Max, int latM10Min, int latM10Max)
 {
     QMutexLocker lock(&mutex);
 
+    // find the bounding box of all missing cells
+    int missingLonMin = INT_MAX;
+    int missingLonMax = INT_MIN;
+    int missingLatMin = INT_MAX;
+    int missingLatMax = INT_MIN;
+    QList<quint64> missingCategories;
+    for(quint64 categoryID : categories)
+    {
+        bool isMissing = false;
+        for(int lonM10 = lonM10Min; lonM10 <= lonM10Max; lonM10++)
+        {
+            for(int latM10 = latM10Min; latM10 <= latM10Max; latM10++)
+            {
+                auto cell = loadedCells.find(cellKey(categoryID, lonM10, latM10));
+                if(cell != loadedCells.end())
+                {
+                    // protect visible cells from being dropped by trimCache()
+                    cell->lastUse = drawCycle;
+                }
+                else
+                {
+                    isMissing = true;
+                    missingLonMin = qMin(missingLonMin, lonM10);
+                    missingLonMax = qMax(missingLonMax, lonM10);
+                    missingLatMin = qMin(missingLatMin, latM10);
+                    missingLatMax = qMax(missingLatMax, latM10);
+                }
+            }
+        }
+        if(isMissing)
+        {
+            missingCategories << categoryID;
+        }
+    }
+
+    if(missingCategories.isEmpty())
+    {
+        return;
+    }
+
     // check if query is within bounds
-    if(!bbox.intersects({minLonM10 / 10.0, minLatM10 / 10.0, 0.1, 0.1}))
+    const QRectF area(missingLonMin / 10.0, missingLatMin / 10.0, (missingLonMax - missingLonMin + 1) / 10.0, (missingLatMax - missingLatMin + 1) / 10.0);
+    if(!bbox.intersects(area))
     {
         return;
     }
 
-    //Open Database here so it is owned by the right thread
-    if(!QSqlDatabase::contains(filename))
+    // Do not try again to load an area that exceeded the cache limits before.
+    const QRect areaMissing(QPoint(missingLonMin, missingLatMin), QPoint(missingLonMax, missingLatMax));
+    const QSet<quint64>& setMissingCategories = missingCategories.toSet();
+    if(areaMissing.contains(areaTooDense) && setMissingCategories.contains(categoriesTooDense))
     {
-        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", filename);
-        db.setDatabaseName(filename);
-        if(!db.open())
+        return;
+    }
+
+    // stop if the visible cells alone exceed the cache limit
+    const qint64 cntNewCells = qint64(missingCategories.size()) * areaMissing.width() * areaMissing.height();
+    if(cntNewCells <= MAX_CACHED_CELLS)
+    {
+        trimCache(qint32(cntNewCells));
+    }
+    if(loadedCells.size() + cntNewCells > MAX_CACHED_CELLS)
+    {
+        qDebug() << "POI: too many cells to load" << cntNewCells;
+        areaTooDense = areaMissing;
+        categoriesTooDense = setMissingCategories;
+        return;
+    }
+
+    // register all missing cells. Cells loaded already are not touched.
+    QSet<quint64> newCells;
+    QStringList ids;
+    for(quint64 categoryID : qAsConst(missingCategories))
+    {
+        ids << QString::number(categoryID);
+        for(int lonM10 = missingLonMin; lonM10 <= missingLonMax; lonM10++)
         {
-            qDebug() << "failed to open database" << db.lastError();
-            isActivated = false;
-            return;
+            for(int latM10 = missingLatMin; latM10 <= missingLatMax; latM10++)
+            {
+                const quint64 key = cellKey(categoryID, lonM10, latM10);
+                if(!loadedCells.contains(key))
+                {
+                    loadedCells[key].lastUse = drawCycle;
+                    newCells << key;
+                }
+            }
         }
     }
 
-    QSqlQuery query(QSqlDatabase::database(filename));
-    query.prepare("SELECT main.poi_index.maxLat, main.poi_index.maxLon, main.poi_index.minLat, main.poi_index.minLon, main.poi_data.data, main.poi_data.id "
-                  "FROM main.poi_data, main.poi_index "
-                  "WHERE main.poi_data.id IN "
-                  "("
-                  "    SELECT main.poi_category_map.id "
-                  "    FROM main.poi_category_map "
-                  "    WHERE main.poi_category_map.id IN "
-                  "    ( "
-                  "        SELECT main.poi_index.id "
-                  "        FROM main.poi_index "
-                  "        WHERE main.poi_index.maxLat<:maxLat "
-                  "        AND main.poi_index.minLat>=:minLat "
-                  "        AND main.poi_index.maxLon<:maxLon "
-                  "        AND main.poi_index.minLon>=:minLon "
-                  "    ) "
-                  "    AND main.poi_category_map.category=:categoryID "
-                  ") "
-                  "AND main.poi_data.id = main.poi_index.id");
-    query.bindValue(":maxLat", QString::number((minLatM10 + 1) / 10., 'f'));
-    query.bindValue(":minLat", QString::number(minLatM10 / 10., 'f'));
-    query.bindValue(":maxLon", QString::number((minLonM10 + 1) / 10., 'f'));
-    query.bindValue(":minLon", QString::number(minLonM10 / 10., 'f'));
-    query.bindValue(":categoryID", categoryID);
-    query.exec();
+    QSqlQuery query(getDatabase());
+    query.prepare("SELECT main.poi_index.maxLat, main.poi_index.maxLon, main.poi_index.minLat, main.poi_index.minLon, main.poi_data.data, main.poi_data.id, main.poi_category_map.category "
+                  "FROM main.poi_index "
+                  "JOIN main.poi_category_map ON main.poi_category_map.id = main.poi_index.id "
+                  "JOIN main.poi_data ON main.poi_data.id = main.poi_index.id "
+                  "WHERE main.poi_index.maxLat<:maxLat "
+                  "AND main.poi_index.minLat>=:minLat "
+                  "AND main.poi_index.maxLon<:maxLon "
+                  "AND main.poi_index.minLon>=:minLon "
+                  "AND main.poi_category_map.category IN (" + ids.join(",") + ")");
+    query.bindValue(":maxLat", QString::number((missingLatMax + 1) / 10., 'f'));
+    query.bindValue(":minLat", QString::number(missingLatMin / 10., 'f'));
+    query.bindValue(":maxLon", QString::number((missingLonMax + 1) / 10., 'f'));
+    query.bindValue(":minLon", QString::number(missingLonMin / 10., 'f'));
+    if(!query.exec())
+    {
+        qDebug() << "failed to query POIs" << query.lastError();
+        return;
+    }
+
     while (query.next())
     {
-        quint64 key = query.value(eSqlColumnPoiId).toUInt();
+        const quint64 categoryID = query.value(eSqlColumnPoiCategory).toULongLong();
+        const QPointF coordinates((query.value(eSqlColumnPoiMaxLon).toDouble() + query.value(eSqlColumnPoiMinLon).toDouble()) / 2,
+                                  (query.value(eSqlColumnPoiMaxLat).toDouble() + query.value(eSqlColumnPoiMinLat).toDouble()) / 2);
+
+        const quint64 keyCell = cellKey(categoryID, qFloor(coordinates.x() * 10), qFloor(coordinates.y() * 10));
+        if(!newCells.contains(keyCell))
+        {
+            continue;
+        }
+
+        const quint64 key = query.value(eSqlColumnPoiId).toUInt();
+        loadedCells[keyCell].pois.append(key);
+        if(poiRefCount[key]++ > 0)
+        {
+            // TODO: The POI is already loaded for another category. The difference between those will be the category. Some better handling should be done
+            continue;
+        }
+
         const QStringList& data = query.value(eSqlColumnPoiData).toString().split("\r");
         QString garminIcon;
         for(const QString& tag : data)
@@ -556,13 +770,69 @@ void CPoiPOI::loadPOIsFromFile(quint64 categoryID, int minLonM10, int minLatM10)
                 break;
             }
         }
-        loadedPoisByArea[categoryID][minLonM10][minLatM10].append(key);
-        // TODO: this overwrites a POI if it already was loaded. The difference between those will be the category. Some better handling should be done
-        loadedPois[key] = CRawPoi(data,
-                                  QPointF((query.value(eSqlColumnPoiMaxLon).toDouble() + query.value(eSqlColumnPoiMinLon).toDouble()) / 2 * DEG_TO_RAD,
-                                          (query.value(eSqlColumnPoiMaxLat).toDouble() + query.value(eSqlColumnPoiMinLat).toDouble()) / 2 * DEG_TO_RAD),
-                                  key, categoryNames[categoryID], garminIcon);
-    }
-    // Close database, as this method is called from mutiple threads.
-    QSqlDatabase::removeDatabase(filename);
+        loadedPois[key] = CRawPoi(data, coordinates * DEG_TO_RAD, key, categoryNames[categoryID], garminIcon);
+
+        if(loadedPois.size() > MAX_CACHED_POIS)
+        {
+            trimCache();
+            if(loadedPois.size() > MAX_CACHED_POIS)
+            {
+                // The visible cells alone exceed the limit. As the new cells
+                // are incomplete they are dropped altogether.
+                qDebug() << "POI: too many POIs to load";
+                for(quint64 keyNewCell : qAsConst(newCells))
+                {
+                    dropCell(keyNewCell);
+                }
+                areaTooDense = areaMissing;
+                categoriesTooDense = setMissingCategories;
+                return;
+            }
+        }
+    }
+}
+
+void CPoiPOI::trimCache(qint32 cntNewCells)
+{
+    QMutexLocker lock(&mutex);
+
+    if((loadedPois.size() <= MAX_CACHED_POIS) && ((loadedCells.size() + cntNewCells) <= MAX_CACHED_CELLS))
+    {
+        return;
+    }
+
+    QVector<QPair<quint64, quint64>> candidates;
+    for(auto it = loadedCells.constBegin(); it != loadedCells.constEnd(); ++it)
+    {
+        if(it->lastUse < drawCycle)
+        {
+            candidates << qMakePair(it->lastUse, it.key());
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    // drop down to 3/4 of the limits to avoid trimming on every draw cycle
+    for(const auto& candidate : qAsConst(candidates))
+    {
+        if((loadedPois.size() <= (MAX_CACHED_POIS * 3 / 4)) && ((loadedCells.size() + cntNewCells) <= (MAX_CACHED_CELLS * 3 / 4)))
+        {
+            break;
+        }
+
+        dropCell(candidate.second);
+    }
+}
+
+void CPoiPOI::dropCell(quint64 key)
+{
+    const cell_t& cell = loadedCells[key];
+    for(quint64 keyPoi : cell.pois)
+    {
+        if(--poiRefCount[keyPoi] == 0)
+        {
+            poiRefCount.remove(keyPoi);
+            loadedPois.remove(keyPoi);
+        }
+    }
+    loadedCells.remove(key);
 }
@@ -25,7 +25,9 @@
 #include "poi/IPoi.h"
 
 #include <QCoreApplication>
+#include <QHash>
 #include <QMutex>
+#include <QSqlDatabase>
 #include <QTimer>
 
 class CPoiPOI : public IPoi
@@ -33,11 +35,22 @@ class CPoiPOI : public IPoi
     Q_DECLARE_TR_FUNCTIONS(CPoiPOI)
 public:
     CPoiPOI(const QString& filename, CPoiDraw* parent);
-    virtual ~CPoiPOI() = default;
+    virtual ~CPoiPOI();
 
     void addTreeWidgetItems(QTreeWidget* widget) override;
-    // category, minLon multiplied by 10, minLat multiplied by 10. POIs are loaded in squares of degrees (should be fine enough to not hang the system)
-    void loadPOIsFromFile(quint64 categoryID, int minLonM10, int minLatM10);
+    /**
+       @brief Load all POIs of a range of cells not loaded yet
+
+       POIs are cached in cells of 0.1° x 0.1°. The cell coordinates are lon/lat multiplied by 10.
+       All missing cells of all given categories are loaded by a single query.
+
+       @param categories    a list of category IDs
+       @param lonM10Min     the most western cell
+       @param lonM10Max     the most eastern cell
+       @param latM10Min     the most southern cell
+       @param latM10Max     the most northern cell
+     */
+    void loadPOIsFromFile(const QList<quint64>& categories, int lonM10Min, int lonM10Max, int latM10Min, int latM10Max);
 
     void draw(IDrawContext::buffer_t& buf) override;
 
@@ -74,7 +87,8 @@ private:
         eSqlColumnPoiMinLat,
         eSqlColumnPoiMinLon,
         eSqlColumnPoiData,
-        eSqlColumnPoiId
+        eSqlColumnPoiId,
+        eSqlColumnPoiCategory
     };
     enum SqlColumnCategory_e
     {
@@ -88,6 +102,46 @@ private:
     bool overlapsWithIcon(const QRectF& rect) const;
     bool getPoiGroupCloseBy(const QPoint& px, poiGroup_t& poiItem) const;
 
+    /// append a group to displayedPois and register it in the screen space grid
+    void addPoiGroup(const poiGroup_t& poiGroup);
+
+    /**
+       @brief Get all groups with an icon possibly intersecting a rectangle
+
+       @param rect          the rectangle in pixel
+       @param candidates    the indices into displayedPois in ascending order
+     */
+    void getPoiGroupCandidates(const QRectF& rect, QVector<qint32>& candidates) const;
+
+    /// the key of the grid cell containing the point in pixel
+    quint64 gridKey(const QPointF& pt) const;
+
+    /// get the database connection of the calling thread, open it if necessary
+    QSqlDatabase getDatabase();
+
+    /// the key of a cell in the cell index
+    static inline quint64 cellKey(quint64 categoryID, int lonM10, int latM10)
+    {
+        return (categoryID << 32) | (quint64(lonM10 + 0x8000) << 16) | quint64(latM10 + 0x8000);
+    }
+
+    /**
+       @brief Get the IDs of all active categories
+     */
+    QList<quint64> getActiveCategories() const;
+
+    /**
+       @brief Drop least recently used cells if the number of cached POIs exceeds the limit
+
+       Cells used by the current draw cycle are never dropped.
+
+       @param cntNewCells   the number of cells about to be loaded
+     */
+    void trimCache(qint32 cntNewCells = 0);
+
+    /// remove a cell and all POIs not referenced by other cells
+    void dropCell(quint64 key);
+
     mutable QMutex mutex {QMutex::Recursive};
     QString filename;
     QTimer* loadTimer;
@@ -95,10 +149,31 @@ private:
 
     QMap<quint64, Qt::CheckState> categoryActivated;
     QMap<quint64, QString> categoryNames;
-    // category, minLon multiplied by 10, minLat multiplied by 10. POIs are loaded in squares of degrees (should be fine enough to not hang the system)
-    QMap<quint64, QMap<int, QMap<int, QList<quint64>>>> loadedPoisByArea;
-    QMap<quint64, CRawPoi> loadedPois;
+    /// a cell of 0.1° x 0.1° of a single category
+    struct cell_t
+    {
+        QVector<quint64> pois;
+        /// the draw cycle the cell was used last
+        quint64 lastUse = 0;
+    };
+
+    /// all loaded cells, see cellKey()
+    QHash<quint64, cell_t> loadedCells;
+    QHash<quint64, CRawPoi> loadedPois;
+    /// the number of cells referencing a POI in loadedPois
+    QHash<quint64, qint32> poiRefCount;
+    /// counter of draw cycles for the LRU
+    quint64 drawCycle = 0;
+    /// the cells in [0.1°] and the categories exceeding the cache limits on their own
+    QRect areaTooDense;
+    QSet<quint64> categoriesTooDense;
+    /// the names of the database connections opened by all threads
+    QSet<QString> connections;
     QList<poiGroup_t> displayedPois;
+    /// screen space grid of displayedPois. Each cell holds the indices of the groups with their icon center inside.
+    QHash<quint64, QVector<qint32>> displayedPoisGrid;
+    /// the size of a grid cell in pixel
+    QSizeF gridSize {1, 1};
     QRectF bbox;
 
 
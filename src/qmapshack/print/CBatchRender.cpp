@@ -0,0 +1,234 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "canvas/CCanvas.h"
+#include "gis/CGisWorkspace.h"
+#include "gis/proj_x.h"
+#include "print/CBatchRender.h"
+#include "print/CTiledImageWriter.h"
+
+#include <iostream>
+#include <QtCore>
+
+QList<CBatchRender::job_t> CBatchRender::readJobs(const QString& filename)
+{
+    QFileInfo fi(filename);
+    if(!fi.isFile())
+    {
+        throw tr("Job file '%1' does not exist.").arg(filename);
+    }
+
+    QSettings cfg(filename, QSettings::IniFormat);
+    if(cfg.status() != QSettings::NoError)
+    {
+        throw tr("Failed to read job file '%1'.").arg(filename);
+    }
+
+    const QDir dir = fi.absoluteDir();
+    QList<job_t> jobs;
+
+    const QStringList& names = cfg.childGroups();
+    for(const QString& name : names)
+    {
+        job_t job;
+        job.name = name;
+
+        cfg.beginGroup(name);
+        const QString& view = cfg.value("view").toString();
+        // a value with commas is read as list
+        const QStringList& area = cfg.value("area").toStringList().join(",").split(",");
+        const QString& size = cfg.value("size").toString();
+        const QString& zoom = cfg.value("zoom").toString();
+        const QString& output = cfg.value("output").toString();
+        cfg.endGroup(); // name
+
+        if(!view.isEmpty())
+        {
+            job.view = dir.absoluteFilePath(view);
+            if(!QFileInfo(job.view).isFile())
+            {
+                throw tr("Job '%1': View file '%2' does not exist.").arg(name, job.view);
+            }
+        }
+
+        if(area.size() != 4)
+        {
+            throw tr("Job '%1': The area must be given as 'west,north,east,south'.").arg(name);
+        }
+
+        qreal coord[4];
+        for(int i = 0; i < 4; i++)
+        {
+            bool ok = false;
+            coord[i] = area[i].trimmed().toDouble(&ok);
+            if(!ok)
+            {
+                throw tr("Job '%1': Bad coordinate '%2' in area.").arg(name, area[i]);
+            }
+        }
+        if(coord[0] >= coord[2] || coord[1] <= coord[3])
+        {
+            throw tr("Job '%1': The area is empty.").arg(name);
+        }
+        job.area = QRectF(QPointF(coord[0], coord[1]), QPointF(coord[2], coord[3]));
+
+        if(!size.isEmpty())
+        {
+            const QStringList& values = size.split('x');
+            bool ok1 = false;
+            bool ok2 = false;
+            if(values.size() == 2)
+            {
+                job.size = QSize(values[0].toInt(&ok1), values[1].toInt(&ok2));
+            }
+            if(!ok1 || !ok2 || job.size.isEmpty())
+            {
+                throw tr("Job '%1': The size must be given as 'WIDTHxHEIGHT'.").arg(name);
+            }
+        }
+
+        if(!zoom.isEmpty())
+        {
+            bool ok = false;
+            job.zoom = zoom.toInt(&ok);
+            if(!ok || job.zoom < 0)
+            {
+                throw tr("Job '%1': Bad zoom level '%2'.").arg(name, zoom);
+            }
+        }
+
+        if(job.zoom < 0 && !job.size.isValid())
+        {
+            throw tr("Job '%1': Either zoom or size or both must be given.").arg(name);
+        }
+
+        if(output.isEmpty())
+        {
+            throw tr("Job '%1': No output file given.").arg(name);
+        }
+        job.output = dir.absoluteFilePath(output);
+
+        jobs << job;
+    }
+
+    if(jobs.isEmpty())
+    {
+        throw tr("Job file '%1' has no jobs.").arg(filename);
+    }
+
+    return jobs;
+}
+
+int CBatchRender::exec(const QString& filename, const QStringList& files)
+{
+    QList<job_t> jobs;
+    try
+    {
+        jobs = readJobs(filename);
+    }
+    catch(const QString& msg)
+    {
+        std::cerr << msg.toUtf8().constData() << std::endl;
+        return 1;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for(const QString& file : files)
+    {
+        try
+        {
+            CGisWorkspace::self().loadGisProjectQuiet(file);
+        }
+        catch(const QString& msg)
+        {
+            std::cerr << msg.toUtf8().constData() << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "loaded " << files.size() << " file(s) in " << timer.elapsed() << " ms" << std::endl;
+
+    int res = 0;
+    qint64 total = 0;
+    for(const job_t& job : qAsConst(jobs))
+    {
+        timer.restart();
+        try
+        {
+            render(job);
+        }
+        catch(const QString& msg)
+        {
+            std::cerr << job.name.toUtf8().constData() << ": " << msg.toUtf8().constData() << std::endl;
+            res = 1;
+            continue;
+        }
+
+        const qint64 elapsed = timer.elapsed();
+        total += elapsed;
+        std::cout << job.name.toUtf8().constData() << ": " << elapsed << " ms" << std::endl;
+    }
+
+    std::cout << "rendered " << jobs.size() << " job(s) in " << total << " ms" << std::endl;
+    return res;
+}
+
+void CBatchRender::render(const job_t& job)
+{
+    // each job gets it's own canvas to start with the same state
+    QScopedPointer<CCanvas> canvas(new CCanvas(nullptr, "batch"));
+
+    if(!job.view.isEmpty())
+    {
+        // the view's maps are restored after the map paths are scanned completely
+        QSettings view(job.view, QSettings::IniFormat);
+        canvas->loadConfig(view);
+    }
+
+    const QRectF area(job.area.topLeft() * DEG_TO_RAD, job.area.bottomRight() * DEG_TO_RAD);
+    const QPointF& focus = area.center();
+
+    if(job.zoom < 0)
+    {
+        canvas->zoomTo(area, job.size);
+    }
+    else
+    {
+        canvas->zoom(job.zoom);
+    }
+
+    QSize size = job.size;
+    if(!size.isValid())
+    {
+        QPointF pt1 = area.topLeft();
+        QPointF pt2 = area.bottomRight();
+        canvas->convertRad2Px(pt1);
+        canvas->convertRad2Px(pt2);
+        size = QSize(qRound(qAbs(pt2.x() - pt1.x())), qRound(qAbs(pt2.y() - pt1.y())));
+        if(size.isEmpty())
+        {
+            throw tr("The area is smaller than a pixel at zoom level %1.").arg(job.zoom);
+        }
+    }
+
+    CTiledImageWriter writer(job.output, size);
+    canvas->print(writer, QRectF(QPointF(0, 0), size), focus);
+    writer.close();
+}
@@ -0,0 +1,95 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CBATCHRENDER_H
+#define CBATCHRENDER_H
+
+#include <QCoreApplication>
+#include <QList>
+#include <QRectF>
+#include <QSize>
+
+/**
+   @brief Render map views to image files without showing the main window
+
+   The jobs are read from an INI file with one group per job:
+
+        [overview]
+        view=alps.view
+        area=10.5,47.8,12.0,46.9
+        size=2000x1500
+        output=overview.png
+
+        [detail]
+        view=alps.view
+        area=11.30,47.30,11.45,47.22
+        zoom=3
+        output=detail.tif
+
+   - view: a view file as saved by QMapShack with the projection, the active maps and DEMs (optional)
+   - area: the area as "west,north,east,south" in [°]
+   - zoom: the zoom level, the closest zoom level fitting the area into the size if missing
+   - size: the image size in [px], the size of the area at the zoom level if missing
+   - output: the image file (*.tif, *.png or *.jpg), a GeoTIFF is georeferenced
+
+   Relative paths are relative to the job file. GIS files passed on the command line
+   are loaded once and are drawn on all jobs. Only GPX, TCX, QMS and SLF files are
+   supported as they can be loaded without user interaction. The time needed for each job is printed
+   to stdout. Thus a job file can be used as reproducible render benchmark. Use the
+   'offscreen' platform plugin on systems without display.
+ */
+class CBatchRender
+{
+    Q_DECLARE_TR_FUNCTIONS(CBatchRender)
+public:
+    struct job_t
+    {
+        QString name;
+        QString view;
+        /// the area in [°], top left to bottom right
+        QRectF area;
+        /// the zoom index, -1 to fit the area into size
+        qint32 zoom = -1;
+        /// the image size in [px], invalid to derive it from area and zoom
+        QSize size;
+        QString output;
+    };
+
+    /**
+       @brief Read all jobs from a job file
+
+       Throws a QString with an error message if the file or one of the jobs is invalid.
+
+       @param filename  the job file
+       @return A list of jobs sorted by their names.
+     */
+    static QList<job_t> readJobs(const QString& filename);
+
+    /**
+       @brief Load GIS files and render all jobs of a job file
+       @param filename  the job file
+       @param files     a list of GIS files to load
+       @return The process' exit code. 0 if all files have been loaded and all jobs have been rendered.
+     */
+    static int exec(const QString& filename, const QStringList& files);
+
+private:
+    static void render(const job_t& job);
+};
+
+#endif //CBATCHRENDER_H
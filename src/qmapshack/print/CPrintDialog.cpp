@@ -26,6 +26,7 @@
 #include "helpers/CProgressDialog.h"
 #include "helpers/CSettings.h"
 #include "print/CPrintDialog.h"
+#include "print/CTiledImageWriter.h"
 
 #include <QtPrintSupport>
 #include <QtWidgets>
@@ -256,20 +257,15 @@ void CPrintDialog::slotSave()
     canvas->convertRad2Px(pt2);
 
     QRectF rect(pt1, pt2);
-    QImage img(rect.size().toSize(), QImage::Format_ARGB32);
-
-    QPainter p(&img);
-    USE_ANTI_ALIASING(p, true);
-
-    canvas->print(p, rect, rectSelArea.center());
 
     SETTINGS;
     QString path = cfg.value("Paths/lastImagePath", "./").toString();
 
     QString filterPNG = "PNG Image (*.png)";
     QString filterJPG = "JPEG Image (*.jpg)";
+    QString filterTIF = "GeoTIFF Image (*.tif)";
     QString filter = filterPNG;
-    QString filename = QFileDialog::getSaveFileName(this, tr("Save map..."), path, filterPNG + ";; " + filterJPG, &filter);
+    QString filename = QFileDialog::getSaveFileName(this, tr("Save map..."), path, filterPNG + ";; " + filterJPG + ";; " + filterTIF, &filter);
     if(filename.isEmpty())
     {
         return;
@@ -284,6 +280,10 @@ void CPrintDialog::slotSave()
     {
         expectedSuffix = "jpg";
     }
+    else if(filter == filterTIF)
+    {
+        expectedSuffix = "tif";
+    }
 
     QFileInfo fi(filename);
     if(fi.suffix().toLower() != expectedSuffix)
@@ -291,7 +291,19 @@ void CPrintDialog::slotSave()
         filename += "." + expectedSuffix;
     }
 
-    img.save(filename);
+    // The image is rendered and written in tiles. It is never held in memory completely.
+    try
+    {
+        CCanvasCursorLock cursorLock(Qt::WaitCursor, __func__);
+        CTiledImageWriter writer(filename, rect.size().toSize());
+        canvas->print(writer, rect, rectSelArea.center());
+        writer.close();
+    }
+    catch(const QString& msg)
+    {
+        QMessageBox::critical(this, tr("Save map..."), msg, QMessageBox::Ok);
+        return;
+    }
 
     cfg.setValue("Paths/lastImagePath", fi.absolutePath());
 
@@ -115,11 +115,16 @@ void CScreenshotDialog::slotPrint()
         return;
     }
 
+    /*
+        Do not scale the images to the printer's resolution. A full page at 1200 dpi
+        would need a huge buffer. Let the painter scale them while printing instead.
+     */
     const QRectF& r = printer.pageRect(QPrinter::DevicePixel);
-    const QPixmap& canvasScaled = pixmap.scaled(r.size().toSize(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    const QSizeF& sizeCanvas = QSizeF(sizePixmap).scaled(r.size(), Qt::KeepAspectRatio);
 
     QPainter p(&printer);
-    p.drawPixmap(0, 0, canvasScaled);
+    p.setRenderHint(QPainter::SmoothPixmapTransform, true);
+    p.drawPixmap(QRectF(QPointF(0, 0), sizeCanvas), pixmap, QRectF(pixmap.rect()));
 
     CGisItemTrk* trk = getTrackForProfile();
     if(trk != nullptr)
@@ -129,18 +134,18 @@ void CScreenshotDialog::slotPrint()
         QImage image(plot.size(), QImage::Format_ARGB32);
         plot.save(image, nullptr);
 
-        const QImage& profileScaled = image.scaled(r.size().toSize(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        const QSizeF& sizeProfile = QSizeF(image.size()).scaled(r.size(), Qt::KeepAspectRatio);
 
-        if(r.height() > (canvasScaled.height() + profileScaled.height()))
+        if(r.height() > (sizeCanvas.height() + sizeProfile.height()))
         {
-            p.translate(0, canvasScaled.height());
+            p.translate(0, sizeCanvas.height());
         }
         else
         {
             printer.newPage();
         }
 
-        p.drawImage(0, 0, profileScaled);
+        p.drawImage(QRectF(QPointF(0, 0), sizeProfile), image, QRectF(image.rect()));
     }
 
 
@@ -0,0 +1,56 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "print/CTileRenderer.h"
+
+#include <QtGui>
+
+CTileRenderer::CTileRenderer(const QSize& size, qint32 tileSize, qint32 margin)
+    : tileSize(tileSize)
+    , margin(margin)
+{
+    for(qint32 y = 0; y < size.height(); y += tileSize)
+    {
+        for(qint32 x = 0; x < size.width(); x += tileSize)
+        {
+            tile_t tile;
+            tile.rectCore = QRect(x, y, qMin(tileSize, size.width() - x), qMin(tileSize, size.height() - y));
+            tile.rectTile = QRect(x - margin, y - margin, tileSize + 2 * margin, tileSize + 2 * margin);
+            tiles << tile;
+        }
+    }
+}
+
+void CTileRenderer::render(const fRenderTile& render, const fWriteTile& write) const
+{
+    QImage img(getTileSize(), QImage::Format_ARGB32);
+
+    const qint32 N = tiles.size();
+    for(qint32 n = 0; n < N; n++)
+    {
+        const tile_t& tile = tiles[n];
+
+        img.fill(Qt::transparent);
+        {
+            QPainter p(&img);
+            render(p, n);
+        }
+
+        write(img.copy(tile.rectCore.translated(-tile.rectTile.topLeft())), tile.rectCore.topLeft());
+    }
+}
@@ -0,0 +1,105 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CTILERENDERER_H
+#define CTILERENDERER_H
+
+#include <QImage>
+#include <QList>
+#include <QRect>
+
+#include <functional>
+
+class QPainter;
+
+/**
+   @brief Render a large image in tiles of fixed size
+
+   Rendering a large area (e.g. an A0 page at 300 dpi) in one pass needs
+   several full size buffers per draw context. Instead the area is split into
+   tiles. Each tile is rendered with a margin on all sides. Only the tile's core
+   is passed on. Thus labels and symbols crossing the core's border are drawn
+   completely by both adjacent tiles and each tile passes on it's part of it.
+
+   All tiles have the same size, including the margin. Tiles at the right and
+   bottom border just have a smaller core.
+ */
+class CTileRenderer
+{
+public:
+    struct tile_t
+    {
+        /// the part of the output covered by the tile in [px]
+        QRect rectCore;
+        /// the core plus the margin in [px], relative to the output
+        QRect rectTile;
+    };
+
+    /**
+       @brief Render a tile
+
+       @param p     a painter to the tile's image. The origin is the top left corner of tile_t::rectTile
+       @param n     the index of the tile in getTiles()
+     */
+    using fRenderTile = std::function<void(QPainter& p, qint32 n)>;
+
+    /**
+       @brief Pass on the core of a rendered tile
+
+       @param img   the image of the tile's core
+       @param pos   the position of the image in the output in [px]
+     */
+    using fWriteTile = std::function<void(const QImage& img, const QPoint& pos)>;
+
+    /**
+       @param size      the size of the output in [px]
+       @param tileSize  the size of a tile's core in [px]
+       @param margin    the margin rendered around each tile's core in [px]
+     */
+    CTileRenderer(const QSize& size, qint32 tileSize = 1024, qint32 margin = 256);
+    virtual ~CTileRenderer() = default;
+
+    const QList<tile_t>& getTiles() const
+    {
+        return tiles;
+    }
+
+    /// the size of a tile including the margin
+    QSize getTileSize() const
+    {
+        return QSize(tileSize + 2 * margin, tileSize + 2 * margin);
+    }
+
+    /**
+       @brief Render all tiles row by row
+
+       Only a single tile image is allocated.
+
+       @param render    called to render a tile
+       @param write     called with the core of each rendered tile
+     */
+    void render(const fRenderTile& render, const fWriteTile& write) const;
+
+private:
+    const qint32 tileSize;
+    const qint32 margin;
+
+    QList<tile_t> tiles;
+};
+
+#endif //CTILERENDERER_H
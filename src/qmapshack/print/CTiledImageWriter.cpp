@@ -0,0 +1,167 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "gis/proj_x.h"
+#include "print/CTiledImageWriter.h"
+
+#include <gdal_priv.h>
+#include <ogr_spatialref.h>
+#include <QtCore>
+
+CTiledImageWriter::CTiledImageWriter(const QString& filename, const QSize& size)
+    : filename(filename)
+    , size(size)
+{
+    const QString& suffix = QFileInfo(filename).suffix().toLower();
+    if(suffix == "tif" || suffix == "tiff")
+    {
+        format = "GTiff";
+    }
+    else if(suffix == "png")
+    {
+        format = "PNG";
+    }
+    else if(suffix == "jpg" || suffix == "jpeg")
+    {
+        format = "JPEG";
+        // JPEG has no alpha channel
+        nBands = 3;
+    }
+    else
+    {
+        throw tr("Unsupported image format: %1").arg(suffix);
+    }
+
+    GDALDriver* driver = GetGDALDriverManager()->GetDriverByName("GTiff");
+    if(driver == nullptr)
+    {
+        throw tr("GDAL has no GeoTIFF driver.");
+    }
+
+    // PNG and JPEG can't be written in tiles. Collect them in a temporary GeoTIFF.
+    const QString& target = format == "GTiff" ? filename : tmpDir.filePath("image.tif");
+
+    QList<QByteArray> args = {"TILED=YES", "COMPRESS=LZW", "BIGTIFF=IF_SAFER"};
+    if(nBands == 4)
+    {
+        args << "ALPHA=YES";
+    }
+    QVector<char*> cargs;
+    for(QByteArray& arg : args)
+    {
+        cargs << arg.data();
+    }
+    cargs << nullptr;
+
+    dataset = driver->Create(target.toUtf8(), size.width(), size.height(), nBands, GDT_Byte, cargs.data());
+    if(dataset == nullptr)
+    {
+        throw tr("Failed to create %1").arg(target);
+    }
+}
+
+CTiledImageWriter::~CTiledImageWriter()
+{
+    if(dataset != nullptr)
+    {
+        GDALClose(dataset);
+    }
+}
+
+void CTiledImageWriter::setGeoReference(const QString& proj, const QPointF& ref, const QPointF& pxSize)
+{
+    if(dataset == nullptr || format != "GTiff")
+    {
+        return;
+    }
+
+    OGRSpatialReference oSRS;
+    if(oSRS.SetFromUserInput(proj.toUtf8()) != OGRERR_NONE)
+    {
+        throw tr("Failed to set projection: %1").arg(proj);
+    }
+
+    // geographic coordinates of the draw context are in [rad]
+    const qreal factor = oSRS.IsGeographic() ? RAD_TO_DEG : 1.0;
+
+    double adfGeoTransform[6] =
+    {
+        ref.x() * factor, pxSize.x() * factor, 0
+        , ref.y() * factor, 0, pxSize.y() * factor
+    };
+
+    char* wkt = nullptr;
+    oSRS.exportToWkt(&wkt);
+    dataset->SetProjection(wkt);
+    CPLFree(wkt);
+    dataset->SetGeoTransform(adfGeoTransform);
+}
+
+void CTiledImageWriter::write(const QImage& img, const QPoint& pos)
+{
+    if(dataset == nullptr)
+    {
+        throw tr("The image is already closed.");
+    }
+
+    const QRect& rect = QRect(pos, img.size()) & QRect(QPoint(0, 0), size);
+    if(rect.isEmpty())
+    {
+        return;
+    }
+
+    // RGBA8888 has the same byte order on all platforms
+    const QImage& tile = img.convertToFormat(QImage::Format_RGBA8888);
+    const uchar* data = tile.constBits() + (rect.y() - pos.y()) * tile.bytesPerLine() + (rect.x() - pos.x()) * 4;
+
+    int bands[] = {1, 2, 3, 4};
+    CPLErr err = dataset->RasterIO(GF_Write, rect.x(), rect.y(), rect.width(), rect.height()
+                                   , (void*)data, rect.width(), rect.height(), GDT_Byte
+                                   , nBands, bands, 4, tile.bytesPerLine(), 1);
+    if(err != CE_None)
+    {
+        throw tr("Failed to write tile at %1,%2").arg(pos.x()).arg(pos.y());
+    }
+}
+
+void CTiledImageWriter::close()
+{
+    if(dataset == nullptr)
+    {
+        return;
+    }
+
+    if(format != "GTiff")
+    {
+        GDALDriver* driver = GetGDALDriverManager()->GetDriverByName(format.toLatin1());
+        if(driver == nullptr)
+        {
+            throw tr("GDAL has no %1 driver.").arg(format);
+        }
+
+        GDALDataset* copy = driver->CreateCopy(filename.toUtf8(), dataset, false, nullptr, nullptr, nullptr);
+        if(copy == nullptr)
+        {
+            throw tr("Failed to create %1").arg(filename);
+        }
+        GDALClose(copy);
+    }
+
+    GDALClose(dataset);
+    dataset = nullptr;
+}
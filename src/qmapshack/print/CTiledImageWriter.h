@@ -0,0 +1,82 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CTILEDIMAGEWRITER_H
+#define CTILEDIMAGEWRITER_H
+
+#include <QCoreApplication>
+#include <QImage>
+#include <QTemporaryDir>
+
+class GDALDataset;
+
+/**
+   @brief Write an image tile by tile to a file
+
+   The image is never held in memory completely. A GeoTIFF is written directly
+   as tiled file. For PNG and JPEG the tiles are collected in a temporary GeoTIFF
+   first, which is copied line by line to the target format by close().
+
+   The format is derived from the filename's suffix. All methods throw a QString
+   with an error message on failure.
+ */
+class CTiledImageWriter
+{
+    Q_DECLARE_TR_FUNCTIONS(CTiledImageWriter)
+public:
+    /**
+       @param filename  the target file (*.tif, *.png or *.jpg)
+       @param size      the size of the complete image in [px]
+     */
+    CTiledImageWriter(const QString& filename, const QSize& size);
+    virtual ~CTiledImageWriter();
+
+    /**
+       @brief Add georeference information
+
+       It's stored with GeoTIFF files only.
+
+       @param proj      the projection string as used by the draw contexts
+       @param ref       the coordinate of the top left corner in the projection's units
+       @param pxSize    the size of a pixel in the projection's units
+     */
+    void setGeoReference(const QString& proj, const QPointF& ref, const QPointF& pxSize);
+
+    /**
+       @brief Write a tile to the image
+       @param img   the tile's image
+       @param pos   the tile's position in the image in [px]
+     */
+    void write(const QImage& img, const QPoint& pos);
+
+    /**
+       @brief Flush all data and write the target file
+     */
+    void close();
+
+private:
+    QString filename;
+    QString format;
+    QSize size;
+    qint32 nBands = 4;
+
+    QTemporaryDir tmpDir;
+    GDALDataset* dataset = nullptr;
+};
+
+#endif //CTILEDIMAGEWRITER_H
@@ -19,6 +19,7 @@
 #include "realtime/CRtSelectSource.h"
 #include "realtime/CRtWorkspace.h"
 #include "realtime/gpstether/CRtGpsTether.h"
+#include "realtime/gpstether/CRtNmeaReplay.h"
 #include "realtime/opensky/CRtOpenSky.h"
 
 
@@ -68,6 +69,7 @@ CRtSelectSource::CRtSelectSource(CRtWorkspace& wks)
     // append the list by adding other sources
     addSource<CRtOpenSky>(wks, listWidget);
     addSource<CRtGpsTether>(wks, listWidget);
+    addSource<CRtNmeaReplay>(wks, listWidget);
 
     // update GUI state
     slotSelectionChanged();
@@ -23,6 +23,8 @@
 
 #include <QtWidgets>
 
+#define RECORD_WINDOW 24 // hours
+
 IRtInfo::IRtInfo(IRtSource* source, QWidget* parent)
     : QWidget(parent)
     , source(source)
@@ -81,11 +83,53 @@ void IRtInfo::slotToTrack()
     }
 
     CTrackData data;
-    fillTrackData(data);
+    if(loadAll)
+    {
+        fillTrackData(data);
+    }
+    else
+    {
+        // the track has to cover the complete record, not just the loaded part
+        const QString filename = record->getFilename();
+        const bool ok = record->setFile(filename);
+        if(ok)
+        {
+            fillTrackData(data);
+        }
+        else
+        {
+            QMessageBox::critical(this, tr("Failed..."), record->getError(), QMessageBox::Ok);
+        }
+
+        openRecord(filename);
+        if(!ok)
+        {
+            return;
+        }
+    }
 
     new CGisItemTrk(data, prj);
 }
 
+void IRtInfo::slotLoadAll(bool yes)
+{
+    loadAll = yes;
+
+    if(record == nullptr)
+    {
+        return;
+    }
+
+    startRecord(record->getFilename());
+    emit source->sigChanged();
+}
+
+bool IRtInfo::openRecord(const QString& filename)
+{
+    return loadAll ? record->setFile(filename) : record->setFileLast(filename, RECORD_WINDOW * 3600);
+}
+
+
 
 void IRtInfo::draw(QPainter& p, const QPolygonF& viewport, QList<QRectF>& blockedAreas, CRtDraw* rt)
 {
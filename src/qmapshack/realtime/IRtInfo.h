@@ -40,11 +40,26 @@ protected slots:
     void slotSetFilename();
     void slotResetRecord();
     void slotToTrack();
+    void slotLoadAll(bool yes);
 
 protected:
     virtual void startRecord(const QString& filename) = 0;
     virtual void fillTrackData(CTrackData& data) = 0;
 
+    /**
+       @brief Set the file of the record and load it
+
+       Loading a large record takes a while. Thus only the last hours of the record are
+       loaded unless loadAll is set.
+
+       @param filename  the record's filename
+       @return Return true on success.
+     */
+    bool openRecord(const QString& filename);
+
+    /// set true to load the complete record
+    bool loadAll = false;
+
     QPointer<IRtSource> source;
     QPointer<IRtRecord> record;
 };
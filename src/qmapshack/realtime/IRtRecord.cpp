@@ -21,63 +21,319 @@
 
 #include <QtCore>
 
+#define INDEX_INTERVAL  100
+#define INDEX_VERSION   1
+#define FLUSH_TIMEOUT   1000
+
+/**
+   @brief Get the entry at the given position of a memory mapped record
+
+   @param ptr       pointer to the mapped record
+   @param size      the size of the record
+   @param offset    the entry's position, it's moved to the next entry
+   @param data      the entry's data, it references the mapped memory
+
+   @return Return false if the entry exceeds the record or the checksum does not match
+ */
+static bool nextEntry(const uchar* ptr, qint64 size, qint64& offset, QByteArray& data)
+{
+    // an entry is the crc16 followed by the byte array as serialized by QDataStream
+    if(size - offset < qint64(sizeof(quint16) + sizeof(quint32)))
+    {
+        return false;
+    }
+
+    const quint16 crc = qFromLittleEndian<quint16>(ptr + offset);
+    quint32 len = qFromLittleEndian<quint32>(ptr + offset + sizeof(quint16));
+    offset += sizeof(quint16) + sizeof(quint32);
+
+    // that's a null byte array
+    if(len == 0xFFFFFFFF)
+    {
+        len = 0;
+    }
+
+    if(qint64(len) > size - offset)
+    {
+        return false;
+    }
+
+    data = QByteArray::fromRawData(reinterpret_cast<const char*>(ptr + offset), len);
+    offset += len;
+
+    return qChecksum(data.constData(), data.size()) == crc;
+}
+
 IRtRecord::IRtRecord(QObject* parent)
     : QObject(parent)
 {
+    timerFlush = new QTimer(this);
+    timerFlush->setSingleShot(true);
+    timerFlush->setInterval(FLUSH_TIMEOUT);
+    connect(timerFlush, &QTimer::timeout, this, &IRtRecord::slotFlush);
 }
 
-bool IRtRecord::setFile(const QString& fn)
+bool IRtRecord::setFile(const QString& fn, const QDateTime& from, const QDateTime& to)
 {
+    timerFlush->stop();
+    file.close();
+    fileIndex.close();
+
     track.clear();
+    index.clear();
+    sizeRecord = 0;
+    cntSinceIndex = 0;
     filename = fn;
 
     if(QFile::exists(filename))
     {
-        return readFile(filename);
+        if(!readFile(filename, from, to))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        writeIndex();
+    }
+
+    return openFiles();
+}
+
+bool IRtRecord::setFileLast(const QString& fn, qint64 span)
+{
+    spanLast = span;
+    const bool ok = setFile(fn);
+    spanLast = 0;
+    return ok;
+}
+
+bool IRtRecord::openFiles()
+{
+    file.setFileName(filename);
+    if(!file.open(QIODevice::Append))
+    {
+        error = tr("Failed to open record for writing.");
+        return false;
+    }
+
+    // the index is optional, it will be rebuilt if it's missing
+    fileIndex.setFileName(filename + ".idx");
+    if(!fileIndex.open(QIODevice::Append))
+    {
+        qDebug() << "Failed to open record index" << fileIndex.fileName();
     }
+
     return true;
 }
 
-bool IRtRecord::readFile(const QString& filename)
+bool IRtRecord::readFile(const QString& filename, const QDateTime& from, const QDateTime& to)
 {
-    QFile file(filename);
-    if(!file.open(QIODevice::ReadOnly))
+    QFile fileRead(filename);
+    if(!fileRead.open(QIODevice::ReadOnly))
     {
         error = tr("Failed to open record for reading.");
         return false;
     }
 
-    QDataStream stream(&file);
+    const qint64 size = fileRead.size();
+    const uchar* ptr = nullptr;
+    if(size > 0)
+    {
+        ptr = fileRead.map(0, size);
+        if(ptr == nullptr)
+        {
+            error = tr("Failed to open record for reading.");
+            return false;
+        }
+    }
+
+    // drop all entries from the index starting with pos and cut the record at pos
+    auto truncate = [&](qint64 pos)
+    {
+        error = tr("Failed to read entry. Truncate record to last valid entry.");
+        fileRead.unmap(const_cast<uchar*>(ptr));
+        fileRead.close();
+        QFile::resize(filename, pos);
+
+        while(!index.isEmpty() && index.last().offset >= pos)
+        {
+            index.removeLast();
+        }
+        writeIndex();
+    };
+
+    bool indexChanged = !readIndex(size);
+    const qint32 cntIndex = index.size();
+
+    qint64 timeLast = -1;
+    qint64 bad = indexRecord(ptr, size, timeLast);
+    if(bad >= 0 && cntIndex > 0)
+    {
+        // the index does not match. Maybe the record has been
+        // replaced. Read the complete record to be sure.
+        index.clear();
+        indexChanged = true;
+        bad = indexRecord(ptr, size, timeLast);
+    }
+
+    if(bad >= 0)
+    {
+        truncate(bad);
+        return false;
+    }
+
+    indexChanged |= index.size() != cntIndex;
+    sizeRecord = size;
+
+    // a window at the record's end starts relative to the last entry
+    QDateTime first = from;
+    if(spanLast > 0 && timeLast >= 0)
+    {
+        first = QDateTime::fromMSecsSinceEpoch(timeLast - spanLast * 1000, Qt::UTC);
+    }
+
+    // get the range of the record covering the time window from the index
+    qint64 start = 0;
+    qint64 end = size;
+    for(const index_t& entry : qAsConst(index))
+    {
+        if(first.isValid() && entry.time <= first.toMSecsSinceEpoch())
+        {
+            start = entry.offset;
+        }
+        if(to.isValid() && entry.time > to.toMSecsSinceEpoch())
+        {
+            end = entry.offset;
+            break;
+        }
+    }
+
+    const bool hasWindow = first.isValid() || to.isValid();
+    qint64 offset = start;
+    while(offset < end)
+    {
+        const qint64 pos = offset;
+        QByteArray data;
+        if(!nextEntry(ptr, size, offset, data))
+        {
+            truncate(pos);
+            return false;
+        }
+
+        if(hasWindow)
+        {
+            const QDateTime& timestamp = readTimestamp(data);
+            if((first.isValid() && timestamp < first) || (to.isValid() && timestamp > to))
+            {
+                continue;
+            }
+        }
+
+        readEntry(data);
+    }
+
+    if(indexChanged)
+    {
+        writeIndex();
+    }
+
+    return true;
+}
+
+qint64 IRtRecord::indexRecord(const uchar* ptr, qint64 size, qint64& timeLast)
+{
+    // Entries covered by the index have been tested already.
+    // Start with the last entry in the index.
+    qint64 offset = index.isEmpty() ? 0 : index.last().offset;
+    qint32 cnt = 0;
+
+    QByteArray data;
+    while(offset < size)
+    {
+        const qint64 pos = offset;
+        if(!nextEntry(ptr, size, offset, data))
+        {
+            return pos;
+        }
+
+        if(cnt == 0 && (index.isEmpty() || index.last().offset < pos))
+        {
+            index << index_t {pos, readTimestamp(data).toMSecsSinceEpoch()};
+        }
+        cnt = (cnt + 1) % INDEX_INTERVAL;
+    }
+
+    if(!data.isNull())
+    {
+        timeLast = readTimestamp(data).toMSecsSinceEpoch();
+    }
+
+    cntSinceIndex = cnt;
+    return -1;
+}
+
+bool IRtRecord::readIndex(qint64 size)
+{
+    index.clear();
+
+    QFile f(filename + ".idx");
+    if(!f.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    QDataStream stream(&f);
     stream.setVersion(QDataStream::Qt_5_2);
     stream.setByteOrder(QDataStream::LittleEndian);
 
-    while(!stream.atEnd())
+    quint8 version = 0;
+    stream >> version;
+    if(version != INDEX_VERSION)
     {
-        quint64 size = stream.device()->pos();
+        return false;
+    }
 
-        quint16 crc;
-        QByteArray data;
-        stream >> crc >> data;
+    while(!stream.atEnd())
+    {
+        index_t entry;
+        stream >> entry.offset >> entry.time;
 
-        if((qChecksum(data.data(), data.size()) != crc) || (stream.status() != QDataStream::Ok))
+        // drop incomplete entries and entries past the end of the record
+        if((stream.status() != QDataStream::Ok) || (entry.offset >= size) || (!index.isEmpty() && entry.offset <= index.last().offset))
         {
-            error = tr("Failed to read entry. Truncate record to last valid entry.");
-            file.close();
-            QFile::resize(filename, size);
             return false;
         }
 
-        readEntry(data);
+        index << entry;
     }
 
-    file.close();
     return true;
 }
 
-bool IRtRecord::writeEntry(const QByteArray& data)
+void IRtRecord::writeIndex()
 {
-    QFile file(filename);
-    if(!file.open(QIODevice::Append))
+    QFile f(filename + ".idx");
+    if(!f.open(QIODevice::WriteOnly))
+    {
+        qDebug() << "Failed to write record index" << f.fileName();
+        return;
+    }
+
+    QDataStream stream(&f);
+    stream.setVersion(QDataStream::Qt_5_2);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    stream << quint8(INDEX_VERSION);
+    for(const index_t& entry : qAsConst(index))
+    {
+        stream << entry.offset << entry.time;
+    }
+}
+
+bool IRtRecord::writeEntry(const QByteArray& data, const QDateTime& timestamp)
+{
+    if(!file.isOpen())
     {
         error = tr("Failed to open record for writing.");
         return false;
@@ -93,14 +349,54 @@ bool IRtRecord::writeEntry(const QByteArray& data)
     if(stream.status() != QDataStream::Ok)
     {
         error = tr("Failed to write entry.");
-        file.close();
         return false;
     }
 
-    file.close();
+    if(cntSinceIndex == 0)
+    {
+        const index_t entry {sizeRecord, timestamp.toMSecsSinceEpoch()};
+        index << entry;
+
+        if(fileIndex.isOpen())
+        {
+            QDataStream streamIndex(&fileIndex);
+            streamIndex.setVersion(QDataStream::Qt_5_2);
+            streamIndex.setByteOrder(QDataStream::LittleEndian);
+            streamIndex << entry.offset << entry.time;
+        }
+    }
+    cntSinceIndex = (cntSinceIndex + 1) % INDEX_INTERVAL;
+    sizeRecord += sizeof(crc) + sizeof(quint32) + data.size();
+
+    // write the buffered data to disk a second after the first entry at the latest
+    if(!timerFlush->isActive())
+    {
+        timerFlush->start();
+    }
+
     return true;
 }
 
+void IRtRecord::slotFlush()
+{
+    file.flush();
+    fileIndex.flush();
+}
+
+QDateTime IRtRecord::readTimestamp(const QByteArray& data)
+{
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_5_2);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    quint8 version;
+    stream >> version;
+
+    CTrackData::trkpt_t trkpt;
+    stream >> trkpt;
+    return trkpt.time;
+}
+
 bool IRtRecord::readEntry(QByteArray& data)
 {
     QDataStream stream(&data, QIODevice::ReadOnly);
@@ -118,8 +414,18 @@ bool IRtRecord::readEntry(QByteArray& data)
 
 void IRtRecord::reset()
 {
+    timerFlush->stop();
+    file.close();
+    fileIndex.close();
+
     track.clear();
+    index.clear();
+    sizeRecord = 0;
+    cntSinceIndex = 0;
+
     QFile::resize(filename, 0);
+    writeIndex();
+    openFiles();
 }
 
 void IRtRecord::draw(QPainter& p, const QPolygonF& viewport, QList<QRectF>& blockedAreas, CRtDraw* rt)
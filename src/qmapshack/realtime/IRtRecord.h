@@ -27,7 +27,20 @@
 
 class CRtDraw;
 class QPainter;
+class QTimer;
 
+/**
+   @brief Base class for records of realtime sources
+
+   The record file is a sequence of entries, each with a crc16 and a byte array. It is
+   kept open while recording and written buffered. The buffer is flushed a second after
+   the first unwritten entry at the latest.
+
+   Alongside the record an index file (record's filename + ".idx") is written. It stores
+   the file position and timestamp of every 100th entry. Thus a time window of the record
+   can be loaded without parsing the whole file. A missing or broken index is rebuilt from
+   the record. The entries are expected to be in chronological order.
+ */
 class IRtRecord : public QObject
 {
     Q_OBJECT
@@ -42,19 +55,40 @@ public:
     /**
        @brief Set file name to record into
 
-       If the file exists this will read the file and append new data.
+       If the file exists this will read the file and append new data. The track is
+       restricted to the entries within the time window. An invalid date/time leaves the
+       window open on that side.
+
+       @param fn    the filename as string
+       @param from  the start of the time window
+       @param to    the end of the time window
+
+       @return Return true on success.
+     */
+    virtual bool setFile(const QString& fn, const QDateTime& from = QDateTime(), const QDateTime& to = QDateTime());
+    /**
+       @brief Set file name to record into and load the last part of the record only
+
+       Like setFile() with a time window ending at the record's last entry. Thus an old
+       record is not loaded empty.
 
-       @param fn  the filename as string
+       @param fn    the filename as string
+       @param span  the length of the time window [s]
 
        @return Return true on success.
      */
-    virtual bool setFile(const QString& fn);
+    bool setFileLast(const QString& fn, qint64 span);
 
     virtual const QString& getError() const
     {
         return error;
     }
 
+    const QString& getFilename() const
+    {
+        return filename;
+    }
+
     /**
        @brief Draw the record data into the draw context
 
@@ -78,11 +112,12 @@ protected:
 
        A crc16 is calculated and stored together with the byte array into the file.
 
-       @param data  the byte array to store
+       @param data      the byte array to store
+       @param timestamp the entry's timestamp used for the index
 
        @return Return true on success.
      */
-    virtual bool writeEntry(const QByteArray& data);
+    virtual bool writeEntry(const QByteArray& data, const QDateTime& timestamp);
 
     /**
        @brief A block data has been read and needs further processing
@@ -97,21 +132,79 @@ protected:
      */
     virtual bool readEntry(QByteArray& data);
 
+    /**
+       @brief Get the timestamp of a data entry
+
+       This is used to build the index and to select entries within a time window.
+
+       @param data  the byte array with the data entry.
+
+       @return The entry's timestamp.
+     */
+    virtual QDateTime readTimestamp(const QByteArray& data);
+
 protected:
     QVector<CTrackData::trkpt_t> track;
 
+private slots:
+    void slotFlush();
+
 private:
 
     /**
-       @brief Reads file content entry by entry and tests for the checksum
+       @brief Map the file into memory and read the entries within the time window
+
+       The part of the record not covered by the index is read completely to test the
+       checksums and to update the index.
 
        @param filename  the file name to open and read.
+       @param from      the start of the time window
+       @param to        the end of the time window
 
        @return Return true on success.
      */
-    virtual bool readFile(const QString& filename);
+    virtual bool readFile(const QString& filename, const QDateTime& from, const QDateTime& to);
+
+    /**
+       @brief Read the index file and drop all index entries not matching the record
+
+       @param size  the size of the record file
+       @return Return true if the index has been read without changes.
+     */
+    bool readIndex(qint64 size);
+    void writeIndex();
+    /**
+       @brief Test all entries not covered by the index and add them to the index
+
+       @param ptr       pointer to the mapped record
+       @param size      the size of the record
+       @param timeLast  set to the timestamp of the last entry [ms], unchanged if the record is empty
+
+       @return The position of the first invalid entry or -1 if all entries are valid.
+     */
+    qint64 indexRecord(const uchar* ptr, qint64 size, qint64& timeLast);
+    bool openFiles();
+
+    struct index_t
+    {
+        /// the entry's position in the record file
+        qint64 offset;
+        /// the entry's timestamp in [ms] since epoch
+        qint64 time;
+    };
 
     QString filename;
+    QFile file;
+    QFile fileIndex;
+    QTimer* timerFlush;
+
+    QVector<index_t> index;
+    /// the size of the record including buffered data
+    qint64 sizeRecord = 0;
+    /// the number of entries written since the last index entry
+    qint32 cntSinceIndex = 0;
+    /// the length of the time window at the record's end [s], 0 to use the window passed to readFile()
+    qint64 spanLast = 0;
 
     QString error;
 };
@@ -17,6 +17,7 @@
 **********************************************************************************************/
 
 #include "realtime/gpstether/CRtGpsTether.h"
+#include "realtime/gpstether/CRtNmeaReplay.h"
 #include "realtime/IRtSource.h"
 #include "realtime/opensky/CRtOpenSky.h"
 
@@ -52,6 +53,9 @@ IRtSource* IRtSource::create(int type, QTreeWidget* parent)
 
     case eTypeGpsTether:
         return new CRtGpsTether(parent);
+
+    case eTypeNmeaReplay:
+        return new CRtNmeaReplay(parent);
     }
 
     return nullptr;
@@ -37,6 +37,7 @@ public:
         eTypeNone
         , eTypeOpenSky
         , eTypeGpsTether
+        , eTypeNmeaReplay
     };
 
     IRtSource(type_e type, bool singleInstanceOnly, QTreeWidget* parent);
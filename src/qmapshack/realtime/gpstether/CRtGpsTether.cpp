@@ -103,7 +103,11 @@ void CRtGpsTether::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF
         return;
     }
 
-    QPointF pos = info->getPosition();
+    drawPosition(p, info->getPosition(), info->getHeading(), rt);
+}
+
+void CRtGpsTether::drawPosition(QPainter& p, QPointF pos, qreal heading, CRtDraw* rt)
+{
     if(pos == NOPOINTF)
     {
         return;
@@ -117,7 +121,6 @@ void CRtGpsTether::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF
     p.drawEllipse(pos, 10, 10);
     p.drawEllipse(pos, 2, 2);
 
-    qreal heading = info->getHeading();
     if(heading == NOFLOAT)
     {
         return;
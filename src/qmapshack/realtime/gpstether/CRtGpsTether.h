@@ -44,6 +44,16 @@ public:
 
     void fastDraw(QPainter& p, const QRectF& viewport, CRtDraw* rt) override;
 
+    /**
+       @brief Draw the GPS position marker with an optional heading arrow
+
+       @param p         the painter to use
+       @param pos       the position in [°] or NOPOINTF
+       @param heading   the heading in [°] or NOFLOAT
+       @param rt        the realtime draw context
+     */
+    static void drawPosition(QPainter& p, QPointF pos, qreal heading, CRtDraw* rt);
+
     static const QString strIcon;
 
 private:
@@ -37,10 +37,12 @@ CRtGpsTetherInfo::CRtGpsTetherInfo(CRtGpsTether& source, QWidget* parent)
     connect(toolConnect, &QToolButton::toggled, this, &CRtGpsTetherInfo::slotConnect);
     connect(toolPause, &QToolButton::toggled, toolReset, &QToolButton::setEnabled);
     connect(toolPause, &QToolButton::toggled, toolFile, &QToolButton::setEnabled);
+    connect(toolPause, &QToolButton::toggled, toolLoadAll, &QToolButton::setEnabled);
     connect(toolPause, &QToolButton::toggled, toolToTrack, &QToolButton::setEnabled);
     connect(toolFile, &QToolButton::clicked, this, &CRtGpsTetherInfo::slotSetFilename);
     connect(toolReset, &QToolButton::clicked, this, &CRtGpsTetherInfo::slotResetRecord);
     connect(toolToTrack, &QToolButton::clicked, this, &CRtGpsTetherInfo::slotToTrack);
+    connect(toolLoadAll, &QToolButton::toggled, this, &CRtGpsTetherInfo::slotLoadAll);
 
     socket = new QTcpSocket(this);
     connect(socket, &QTcpSocket::connected, this, &CRtGpsTetherInfo::slotConnected);
@@ -54,12 +56,6 @@ CRtGpsTetherInfo::CRtGpsTetherInfo(CRtGpsTether& source, QWidget* parent)
     connect(timer, &QTimer::timeout, this, &CRtGpsTetherInfo::slotUpdate);
 
     labelStatus->setText("-");
-
-    dict["GSV"] = [&](const QStringList& t){nmeaGSV(t);};
-    dict["GSA"] = [&](const QStringList& t){nmeaGSA(t);};
-    dict["RMC"] = [&](const QStringList& t){nmeaRMC(t);};
-    dict["GGA"] = [&](const QStringList& t){nmeaGGA(t);};
-    dict["VTG"] = [&](const QStringList& t){nmeaVTG(t);};
 }
 
 CRtGpsTetherInfo::~CRtGpsTetherInfo()
@@ -113,6 +109,7 @@ void CRtGpsTetherInfo::loadSettings(QSettings& cfg)
     spinPort->setValue(cfg.value("port", 10110).toUInt());
     checkAutomaticConnect->setChecked(cfg.value("automatic connect", false).toBool());
     checkCenterPosition->setChecked(cfg.value("center position", false).toBool());
+    toolLoadAll->setChecked(cfg.value("load all", false).toBool());
     startRecord(cfg.value("filename", "").toString());
     if(toolRecord->isEnabled())
     {
@@ -129,32 +126,19 @@ void CRtGpsTetherInfo::saveSettings(QSettings& cfg) const
     cfg.setValue("automatic connect", checkAutomaticConnect->isChecked());
     cfg.setValue("center position", checkCenterPosition->isChecked());
     cfg.setValue("filename", toolFile->toolTip());
+    cfg.setValue("load all", toolLoadAll->isChecked());
     cfg.setValue("record", toolRecord->isChecked());
 }
 
 
 QPointF CRtGpsTetherInfo::getPosition() const
 {
-    if(gga.isValid)
-    {
-        return QPointF(gga.lon, gga.lat);
-    }
-    if(rmc.isValid)
-    {
-        return QPointF(rmc.lon, rmc.lat);
-    }
-
-    return NOPOINTF;
+    return nmea.getPosition();
 }
 
 qreal CRtGpsTetherInfo::getHeading() const
 {
-    if(vtg.isValid)
-    {
-        return vtg.trackDegreesTrue;
-    }
-
-    return NOFLOAT;
+    return nmea.getHeading();
 }
 
 void CRtGpsTetherInfo::slotConnect(bool yes)
@@ -191,9 +175,7 @@ void CRtGpsTetherInfo::slotDisconnected()
     toolConnect->setChecked(false);
     toolConnect->setIcon(QIcon("://icons/32x32/Disconnected.png"));
 
-    rmc.isValid = false;
-    gga.isValid = false;
-    vtg.isValid = false;
+    nmea.reset();
 
     slotUpdate();
 
@@ -208,51 +190,20 @@ void CRtGpsTetherInfo::slotError(QAbstractSocket::SocketError /*socketError*/)
 
 void CRtGpsTetherInfo::slotReadyRead()
 {
-    while(socket->canReadLine())
-    {
-        QString line = socket->readLine();
-        line = line.simplified();
-        if(!verifyLine(line))
-        {
-            continue;
-        }
-        line.chop(3);
-
-        const QStringList& tokens = line.mid(1).split(',');
-        dict.value(tokens[0].mid(2), nmeaDefault)(tokens);
-    }
+    // Just parse the sentences. The GUI is updated by the timer. Thus
+    // receivers with a high update rate do not flood the GUI thread.
+    nmea.read(*socket);
 }
 
 void CRtGpsTetherInfo::slotUpdate()
 {
-    qreal lon = NOFLOAT;
-    qreal lat = NOFLOAT;
-    qreal ele = NOFLOAT;
-    qreal speed = NOFLOAT;
-    qreal heading = NOFLOAT;
-    QDateTime timestamp;
-
-    if(rmc.isValid)
-    {
-        timestamp = rmc.datetime;
-        lon = rmc.lon;
-        lat = rmc.lat;
-        speed = rmc.groundSpeed;
-    }
-
-    if(gga.isValid)
-    {
-        timestamp = gga.datetime;
-        lon = gga.lon;
-        lat = gga.lat;
-        ele = gga.altAboveSeaLevel;
-    }
-
-    if(vtg.isValid)
-    {
-        heading = vtg.trackDegreesTrue;
-        speed = vtg.speedMeters;
-    }
+    const QPointF& pos = nmea.getPosition();
+    const qreal lon = pos != NOPOINTF ? pos.x() : NOFLOAT;
+    const qreal lat = pos != NOPOINTF ? pos.y() : NOFLOAT;
+    const qreal ele = nmea.getElevation();
+    const qreal speed = nmea.getSpeed();
+    const qreal heading = nmea.getHeading();
+    const QDateTime& timestamp = nmea.getTimestamp();
 
     QString val, unit;
     IUnit::degToStr(lon, lat, val);
@@ -277,10 +228,9 @@ void CRtGpsTetherInfo::slotUpdate()
             CCanvas* canvas = CMainWindow::self().getVisibleCanvas();
             if(canvas != nullptr)
             {
-                const QPointF& pos = getPosition();
                 if(pos != NOPOINTF)
                 {
-                    canvas->followPosition(getPosition());
+                    canvas->followPosition(pos);
                 }
             }
         }
@@ -290,153 +240,6 @@ void CRtGpsTetherInfo::slotUpdate()
     lastTimestamp = timestamp;
 }
 
-bool CRtGpsTetherInfo::verifyLine(const QString& line)
-{
-    quint8 cs = 0;
-    const QByteArray& data = line.toLatin1();
-
-    for(int i = 1; i < data.size() - 3; i++)
-    {
-        cs ^= data[i];
-    }
-
-    return line.rightRef(2).toInt(0, 16) == cs;
-}
-
-void CRtGpsTetherInfo::nmeaGSV(const QStringList& /*tokens*/)
-{
-}
-
-void CRtGpsTetherInfo::nmeaGSA(const QStringList& tokens)
-{
-    const QString& id = tokens[0];
-    if(tokens.count() < 18)
-    {
-        qDebug() << id << "too short";
-        return;
-    }
-
-//    qDebug() << id << "ok" << tokens;
-    if(tokens[2].toInt() < 2)
-    {
-        gsa.isValid = false;
-        return;
-    }
-    gsa.isValid = true;
-    gsa.fix = tokens[2].toInt();
-    gsa.hdop = tokens[16].toDouble();
-    gsa.vdop = tokens[17].toDouble();
-}
-
-void CRtGpsTetherInfo::nmeaRMC(const QStringList& tokens)
-{
-    const QString& id = tokens[0];
-    if(tokens.count() < 12)
-    {
-        qDebug() << id << "too short";
-        return;
-    }
-
-//    qDebug() << id << "ok";
-    if(tokens[2] == "V")
-    {
-        rmc.isValid = false;
-        return;
-    }
-    rmc.isValid = true;
-    rmc.datetime = QDateTime::fromString(tokens[1] + tokens[9], "hhmmss.00ddMMyy").addYears(100);
-    rmc.datetime.setTimeSpec(Qt::UTC);
-
-    {
-        qreal tmp = tokens[3].toDouble();
-        qreal val = int(tmp / 100);
-        val += (tmp - val * 100) / 60;
-        rmc.lat = tokens[4] == "N" ? val : -val;
-    }
-
-    {
-        qreal tmp = tokens[5].toDouble();
-        qreal val = int(tmp / 100);
-        val += (tmp - val * 100) / 60;
-        rmc.lon = tokens[6] == "E" ? val : -val;
-    }
-
-    rmc.groundSpeed = tokens[7].toDouble() * 1.852 / 3.6;
-    rmc.magneticVariation = tokens[11] == "E" ? tokens[10].toDouble() : -tokens[10].toDouble();
-    rmc.trackMadeGood = tokens[8].toDouble();
-}
-
-void CRtGpsTetherInfo::nmeaGGA(const QStringList& tokens)
-{
-    const QString& id = tokens[0];
-    if(tokens.count() < 15)
-    {
-        qDebug() << id << "too short";
-        return;
-    }
-
-    // qDebug() << id << "ok" << tokens;
-    if(tokens[6].toInt() == 0)
-    {
-        gga.isValid = false;
-        return;
-    }
-
-    gga.isValid = true;
-    gga.datetime.setTime(QTime::fromString(tokens[1], "hhmmss.00"));
-    gga.datetime.setDate(QDate::currentDate());
-    gga.datetime.setTimeSpec(Qt::UTC);
-
-    {
-        qreal tmp = tokens[2].toDouble();
-        qreal val = int(tmp / 100);
-        val += (tmp - val * 100) / 60;
-        gga.lat = tokens[3] == "N" ? val : -val;
-    }
-
-    {
-        qreal tmp = tokens[4].toDouble();
-        qreal val = int(tmp / 100);
-        val += (tmp - val * 100) / 60;
-        gga.lon = tokens[5] == "E" ? val : -val;
-    }
-    gga.quality = tokens[6].toInt();
-    gga.numSatelites = tokens[7].toInt();
-    gga.horizDilution = tokens[8].toDouble();
-    gga.altAboveSeaLevel = tokens[9].toDouble();
-    gga.geodialSeparation = tokens[11].toDouble();
-    gga.age = tokens[13].toInt();
-    gga.diffRefStation = tokens[14].toInt();
-
-
-//    qDebug() << gga.datetime << gga.lat << gga.lon << gga.quality << gga.numSatelites
-//             << gga.altAboveSeaLevel << gga.geodialSeparation << gga.horizDilution;
-}
-
-void CRtGpsTetherInfo::nmeaVTG(const QStringList& tokens)
-{
-    const QString& id = tokens[0];
-    if(tokens.count() < 9)
-    {
-        qDebug() << id << "too short";
-        return;
-    }
-
-//    qDebug() << id << "ok" << tokens;
-    if(tokens[1] == "")
-    {
-        vtg.isValid = false;
-        return;
-    }
-
-    vtg.isValid = true;
-    vtg.trackDegreesTrue = tokens[1].toDouble();
-    vtg.trackDegreesMagnetic = tokens[3].toDouble();
-    vtg.speedKnots = tokens[5].toDouble();
-    vtg.speedMeters = tokens[7].toDouble() / 3.6;
-}
-
-
 void CRtGpsTetherInfo::startRecord(const QString& filename)
 {
     delete record;
@@ -451,7 +254,7 @@ void CRtGpsTetherInfo::startRecord(const QString& filename)
 
     record = new CRtGpsTetherRecord(this);
 
-    if(!record->setFile(filename))
+    if(!openRecord(filename))
     {
         delete record;
         QMessageBox::critical(this, tr("Failed..."), record->getError(), QMessageBox::Ok);
@@ -20,10 +20,10 @@
 #define CRTGPSINFO_H
 
 #include "realtime/gpstether/CRtGpsTetherRecord.h"
+#include "realtime/gpstether/CRtNmeaParser.h"
 #include "realtime/IRtInfo.h"
 #include "ui_IRtGpsTetherInfo.h"
 
-#include <functional>
 #include <QTcpSocket>
 #include <QWidget>
 
@@ -56,81 +56,18 @@ private slots:
     void slotUpdate();
 
 private:
-    bool verifyLine(const QString& line);
     void disconnectFromHost();
     void autoConnect(int msec);
 
-    using fNemaLine = std::function<void(const QStringList&)>;
-    fNemaLine nmeaDefault = [&](const QStringList& t){qDebug() << t[0] << "unknown";};
-
-    void nmeaGSV(const QStringList& tokens);
-    void nmeaRMC(const QStringList& tokens);
-    void nmeaGGA(const QStringList& tokens);
-    void nmeaVTG(const QStringList& tokens);
-    void nmeaGSA(const QStringList& tokens);
-
-
-private:
     void startRecord(const QString& filename) override;
     void fillTrackData(CTrackData& data) override;
 
     QTcpSocket* socket;
     QTimer* timer;
 
-    QHash<QString, fNemaLine> dict;
+    CRtNmeaParser nmea;
 
     QDateTime lastTimestamp;
-
-    struct rmc_t
-    {
-        bool isValid {false};
-        QDateTime datetime;
-        qreal lat {0.0};
-        qreal lon {0.0};
-        qreal groundSpeed {0.0};
-        qreal trackMadeGood {0.0};
-        qreal magneticVariation {0.0};
-    };
-
-    rmc_t rmc;
-
-    struct gga_t
-    {
-        bool isValid {false};
-        QDateTime datetime;
-        qreal lat  {0.0};
-        qreal lon  {0.0};
-        qint32 quality {-1};
-        qint32 numSatelites {0};
-        qreal horizDilution {0.0};
-        qreal altAboveSeaLevel {0.0};
-        qreal geodialSeparation {0.0};
-        qreal age {0};
-        qint32 diffRefStation {0};
-    };
-
-    gga_t gga;
-
-    struct vtg_t
-    {
-        bool isValid {false};
-        qreal trackDegreesTrue {0.0};
-        qreal trackDegreesMagnetic {0.0};
-        qreal speedKnots {0.0};
-        qreal speedMeters {0.0};
-    };
-
-    vtg_t vtg;
-
-    struct gsa_t
-    {
-        bool isValid {false};
-        int fix {0};
-        qreal hdop {0.0};
-        qreal vdop {0.0};
-    };
-
-    gsa_t gsa;
 };
 
 #endif //CRTGPSINFO_H
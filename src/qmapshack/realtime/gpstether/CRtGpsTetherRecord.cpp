@@ -47,7 +47,7 @@ bool CRtGpsTetherRecord::writeEntry(qreal lon, qreal lat, qreal ele, qreal speed
     stream << trkpt;
     track << trkpt;
 
-    return writeEntry(data);
+    return writeEntry(data, trkpt.time);
 }
 
 
@@ -0,0 +1,420 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "realtime/gpstether/CRtNmeaParser.h"
+#include "units/IUnit.h"
+
+#include <QtCore>
+
+/*
+   The field parsers below work on the zero terminated fields of a sentence.
+   They are independent from the locale and do not allocate memory.
+ */
+
+static inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static qreal toReal(const char* str)
+{
+    bool negative = *str == '-';
+    if(negative || *str == '+')
+    {
+        str++;
+    }
+
+    qreal val = 0;
+    qreal div = 1;
+    bool fraction = false;
+    for(; *str != 0; str++)
+    {
+        if(isDigit(*str))
+        {
+            val = val * 10 + (*str - '0');
+            if(fraction)
+            {
+                div *= 10;
+            }
+        }
+        else if(*str == '.' && !fraction)
+        {
+            fraction = true;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    return negative ? -val / div : val / div;
+}
+
+static qint32 toInt(const char* str)
+{
+    return qint32(toReal(str));
+}
+
+static qint32 toInt(const char* str, qint32 digits)
+{
+    qint32 val = 0;
+    for(qint32 i = 0; i < digits; i++)
+    {
+        if(!isDigit(str[i]))
+        {
+            return -1;
+        }
+        val = val * 10 + (str[i] - '0');
+    }
+    return val;
+}
+
+// convert ddmm.mmmm and the hemisphere to degree
+static qreal toDegree(const char* value, const char* hemisphere, char positive)
+{
+    qreal tmp = toReal(value);
+    qreal val = int(tmp / 100);
+    val += (tmp - val * 100) / 60;
+    return hemisphere[0] == positive ? val : -val;
+}
+
+// convert hhmmss.sss to time, the fraction is optional
+static QTime toTime(const char* str)
+{
+    const qint32 h = toInt(str, 2);
+    const qint32 m = h < 0 ? -1 : toInt(str + 2, 2);
+    const qint32 s = m < 0 ? -1 : toInt(str + 4, 2);
+    if(s < 0)
+    {
+        return QTime();
+    }
+
+    qint32 ms = 0;
+    if(str[6] == '.')
+    {
+        qint32 scale = 100;
+        for(const char* p = str + 7; isDigit(*p) && scale > 0; p++)
+        {
+            ms += (*p - '0') * scale;
+            scale /= 10;
+        }
+    }
+
+    return QTime(h, m, s, ms);
+}
+
+// convert ddmmyy to date
+static QDate toDate(const char* str)
+{
+    const qint32 d = toInt(str, 2);
+    const qint32 m = d < 0 ? -1 : toInt(str + 2, 2);
+    const qint32 y = m < 0 ? -1 : toInt(str + 4, 2);
+    if(y < 0)
+    {
+        return QDate();
+    }
+
+    return QDate(2000 + y, m, d);
+}
+
+qint32 CRtNmeaParser::read(QIODevice& dev)
+{
+    qint32 cnt = 0;
+    while(readLine(dev))
+    {
+        cnt++;
+    }
+    return cnt;
+}
+
+bool CRtNmeaParser::readLine(QIODevice& dev)
+{
+    // a file's last line does not need a line feed
+    if(dev.atEnd() || (dev.isSequential() && !dev.canReadLine()))
+    {
+        return false;
+    }
+
+    const qint64 size = dev.readLine(buffer, sizeof(buffer));
+    if(size > 0)
+    {
+        parse(buffer, qint32(size));
+    }
+
+    return size >= 0;
+}
+
+bool CRtNmeaParser::parse(char* line, qint32 size)
+{
+    // strip white space and line feeds
+    while(size > 0 && line[size - 1] <= ' ')
+    {
+        size--;
+    }
+    while(size > 0 && *line <= ' ')
+    {
+        line++;
+        size--;
+    }
+
+    if(!verifyLine(line, size))
+    {
+        cntRejected++;
+        return false;
+    }
+
+    // drop the checksum and split the fields in place
+    line[size - 3] = 0;
+    cntTokens = 0;
+    tokens[cntTokens++] = line + 1;
+    for(char* p = line + 1; *p != 0 && cntTokens < maxTokens; p++)
+    {
+        if(*p == ',')
+        {
+            *p = 0;
+            tokens[cntTokens++] = p + 1;
+        }
+    }
+
+    const char* id = tokens[0];
+    const char* type = qstrlen(id) > 2 ? id + 2 : "";
+    if(qstrcmp(type, "RMC") == 0)
+    {
+        nmeaRMC();
+    }
+    else if(qstrcmp(type, "GGA") == 0)
+    {
+        nmeaGGA();
+    }
+    else if(qstrcmp(type, "VTG") == 0)
+    {
+        nmeaVTG();
+    }
+    else if(qstrcmp(type, "GSA") == 0)
+    {
+        nmeaGSA();
+    }
+    else if(qstrcmp(type, "GSV") == 0)
+    {
+        nmeaGSV();
+    }
+    else
+    {
+        qDebug() << id << "unknown";
+    }
+
+    return true;
+}
+
+bool CRtNmeaParser::verifyLine(const char* line, qint32 size)
+{
+    if(size < 4 || line[size - 3] != '*')
+    {
+        return false;
+    }
+
+    quint8 cs = 0;
+    for(qint32 i = 1; i < size - 3; i++)
+    {
+        cs ^= quint8(line[i]);
+    }
+
+    qint32 val = 0;
+    for(qint32 i = size - 2; i < size; i++)
+    {
+        const char c = line[i];
+        val <<= 4;
+        if(isDigit(c))
+        {
+            val |= c - '0';
+        }
+        else if(c >= 'A' && c <= 'F')
+        {
+            val |= c - 'A' + 10;
+        }
+        else if(c >= 'a' && c <= 'f')
+        {
+            val |= c - 'a' + 10;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return val == cs;
+}
+
+void CRtNmeaParser::reset()
+{
+    rmc.isValid = false;
+    gga.isValid = false;
+    vtg.isValid = false;
+    gsa.isValid = false;
+}
+
+QPointF CRtNmeaParser::getPosition() const
+{
+    if(gga.isValid)
+    {
+        return QPointF(gga.lon, gga.lat);
+    }
+    if(rmc.isValid)
+    {
+        return QPointF(rmc.lon, rmc.lat);
+    }
+
+    return NOPOINTF;
+}
+
+qreal CRtNmeaParser::getElevation() const
+{
+    return gga.isValid ? gga.altAboveSeaLevel : NOFLOAT;
+}
+
+qreal CRtNmeaParser::getSpeed() const
+{
+    if(vtg.isValid)
+    {
+        return vtg.speedMeters;
+    }
+    if(rmc.isValid)
+    {
+        return rmc.groundSpeed;
+    }
+
+    return NOFLOAT;
+}
+
+qreal CRtNmeaParser::getHeading() const
+{
+    return vtg.isValid ? vtg.trackDegreesTrue : NOFLOAT;
+}
+
+QDateTime CRtNmeaParser::getTimestamp() const
+{
+    if(gga.isValid)
+    {
+        return gga.datetime;
+    }
+    if(rmc.isValid)
+    {
+        return rmc.datetime;
+    }
+
+    return QDateTime();
+}
+
+void CRtNmeaParser::nmeaGSV()
+{
+}
+
+void CRtNmeaParser::nmeaGSA()
+{
+    if(cntTokens < 18)
+    {
+        qDebug() << tokens[0] << "too short";
+        return;
+    }
+
+    const qint32 fix = toInt(tokens[2]);
+    if(fix < 2)
+    {
+        gsa.isValid = false;
+        return;
+    }
+    gsa.isValid = true;
+    gsa.fix = fix;
+    gsa.hdop = toReal(tokens[16]);
+    gsa.vdop = toReal(tokens[17]);
+}
+
+void CRtNmeaParser::nmeaRMC()
+{
+    if(cntTokens < 12)
+    {
+        qDebug() << tokens[0] << "too short";
+        return;
+    }
+
+    if(tokens[2][0] == 'V')
+    {
+        rmc.isValid = false;
+        return;
+    }
+    rmc.isValid = true;
+    rmc.datetime = QDateTime(toDate(tokens[9]), toTime(tokens[1]), Qt::UTC);
+    rmc.lat = toDegree(tokens[3], tokens[4], 'N');
+    rmc.lon = toDegree(tokens[5], tokens[6], 'E');
+    rmc.groundSpeed = toReal(tokens[7]) * 1.852 / 3.6;
+    rmc.magneticVariation = tokens[11][0] == 'E' ? toReal(tokens[10]) : -toReal(tokens[10]);
+    rmc.trackMadeGood = toReal(tokens[8]);
+}
+
+void CRtNmeaParser::nmeaGGA()
+{
+    if(cntTokens < 15)
+    {
+        qDebug() << tokens[0] << "too short";
+        return;
+    }
+
+    const qint32 quality = toInt(tokens[6]);
+    if(quality == 0)
+    {
+        gga.isValid = false;
+        return;
+    }
+
+    // GGA has no date. Take it from RMC if available.
+    const QDate& date = rmc.isValid ? rmc.datetime.date() : QDateTime::currentDateTimeUtc().date();
+
+    gga.isValid = true;
+    gga.datetime = QDateTime(date, toTime(tokens[1]), Qt::UTC);
+    gga.lat = toDegree(tokens[2], tokens[3], 'N');
+    gga.lon = toDegree(tokens[4], tokens[5], 'E');
+    gga.quality = quality;
+    gga.numSatelites = toInt(tokens[7]);
+    gga.horizDilution = toReal(tokens[8]);
+    gga.altAboveSeaLevel = toReal(tokens[9]);
+    gga.geodialSeparation = toReal(tokens[11]);
+    gga.age = toReal(tokens[13]);
+    gga.diffRefStation = toInt(tokens[14]);
+}
+
+void CRtNmeaParser::nmeaVTG()
+{
+    if(cntTokens < 9)
+    {
+        qDebug() << tokens[0] << "too short";
+        return;
+    }
+
+    if(tokens[1][0] == 0)
+    {
+        vtg.isValid = false;
+        return;
+    }
+
+    vtg.isValid = true;
+    vtg.trackDegreesTrue = toReal(tokens[1]);
+    vtg.trackDegreesMagnetic = toReal(tokens[3]);
+    vtg.speedKnots = toReal(tokens[5]);
+    vtg.speedMeters = toReal(tokens[7]) / 3.6;
+}
+
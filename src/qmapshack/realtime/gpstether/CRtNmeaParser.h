@@ -0,0 +1,168 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CRTNMEAPARSER_H
+#define CRTNMEAPARSER_H
+
+#include <QDateTime>
+#include <QPointF>
+
+class QIODevice;
+
+/**
+   @brief Parser for a NMEA 0183 stream as used by the GPS realtime sources
+
+   Lines are read into a fixed buffer and split in place. Thus parsing a sentence
+   does not allocate any memory, which matters for receivers with 10-20 Hz update
+   rate. The same parser is used for a live TCP stream and for replaying a log file.
+ */
+class CRtNmeaParser
+{
+public:
+    CRtNmeaParser() = default;
+    virtual ~CRtNmeaParser() = default;
+
+    /**
+       @brief Read and parse all complete lines available from a device
+
+       @param dev   the device to read from, e.g. a socket
+       @return The number of lines read.
+     */
+    qint32 read(QIODevice& dev);
+
+    /**
+       @brief Read and parse a single line from a device
+
+       @param dev   the device to read from
+       @return False if there is no complete line to read.
+     */
+    bool readLine(QIODevice& dev);
+
+    /**
+       @brief Parse a single sentence
+
+       @note The line is modified while parsing.
+
+       @param line  a pointer to the line's data
+       @param size  the number of bytes in the line
+       @return True if the sentence has passed the checksum test.
+     */
+    bool parse(char* line, qint32 size);
+
+    /**
+       @brief Test the checksum of a sentence
+
+       @param line  a pointer to the sentence's data without trailing whitespace
+       @param size  the number of bytes in the sentence
+       @return True if the sentence ends with a matching checksum "*hh".
+     */
+    static bool verifyLine(const char* line, qint32 size);
+
+    /// mark all data as invalid, e.g. after the connection has been lost
+    void reset();
+
+    /// the position in [°] or NOPOINTF
+    QPointF getPosition() const;
+    /// the elevation in [m] or NOFLOAT
+    qreal getElevation() const;
+    /// the speed in [m/s] or NOFLOAT
+    qreal getSpeed() const;
+    /// the heading in [°] or NOFLOAT
+    qreal getHeading() const;
+    /// the timestamp of the last fix or an invalid QDateTime
+    QDateTime getTimestamp() const;
+
+    /// the number of lines rejected because of a bad checksum
+    quint32 getRejected() const
+    {
+        return cntRejected;
+    }
+
+private:
+    void nmeaGSV();
+    void nmeaRMC();
+    void nmeaGGA();
+    void nmeaVTG();
+    void nmeaGSA();
+
+    static constexpr qint32 maxLineSize = 256;
+    static constexpr qint32 maxTokens = 32;
+
+    /// the buffer to read lines into
+    char buffer[maxLineSize];
+    /// pointers to the zero terminated fields of the current sentence
+    const char* tokens[maxTokens];
+    /// the number of fields in the current sentence
+    qint32 cntTokens = 0;
+
+    quint32 cntRejected = 0;
+
+    struct rmc_t
+    {
+        bool isValid {false};
+        QDateTime datetime;
+        qreal lat {0.0};
+        qreal lon {0.0};
+        qreal groundSpeed {0.0};
+        qreal trackMadeGood {0.0};
+        qreal magneticVariation {0.0};
+    };
+
+    rmc_t rmc;
+
+    struct gga_t
+    {
+        bool isValid {false};
+        QDateTime datetime;
+        qreal lat  {0.0};
+        qreal lon  {0.0};
+        qint32 quality {-1};
+        qint32 numSatelites {0};
+        qreal horizDilution {0.0};
+        qreal altAboveSeaLevel {0.0};
+        qreal geodialSeparation {0.0};
+        qreal age {0};
+        qint32 diffRefStation {0};
+    };
+
+    gga_t gga;
+
+    struct vtg_t
+    {
+        bool isValid {false};
+        qreal trackDegreesTrue {0.0};
+        qreal trackDegreesMagnetic {0.0};
+        qreal speedKnots {0.0};
+        qreal speedMeters {0.0};
+    };
+
+    vtg_t vtg;
+
+    struct gsa_t
+    {
+        bool isValid {false};
+        int fix {0};
+        qreal hdop {0.0};
+        qreal vdop {0.0};
+    };
+
+    gsa_t gsa;
+};
+
+#endif //CRTNMEAPARSER_H
+
@@ -0,0 +1,101 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "realtime/CRtDraw.h"
+#include "realtime/gpstether/CRtGpsTether.h"
+#include "realtime/gpstether/CRtNmeaReplay.h"
+#include "realtime/gpstether/CRtNmeaReplayInfo.h"
+
+#include <QtWidgets>
+
+const QString CRtNmeaReplay::strIcon("://icons/48x48/Gps.png");
+
+CRtNmeaReplay::CRtNmeaReplay(QTreeWidget* parent)
+    : IRtSource(eTypeNmeaReplay, false, parent)
+{
+    setIcon(eColumnIcon, QIcon(strIcon));
+    setText(eColumnName, tr("NMEA Replay"));
+    setCheckState(eColumnCheckBox, Qt::Checked);
+
+    CRtNmeaReplay::registerWithTreeWidget();
+}
+
+
+void CRtNmeaReplay::registerWithTreeWidget()
+{
+    QTreeWidget* tree = treeWidget();
+    if(tree != nullptr)
+    {
+        QTreeWidgetItem* itemInfo = new QTreeWidgetItem(this);
+        itemInfo->setFlags(Qt::ItemIsEnabled | Qt::ItemNeverHasChildren);
+        info = new CRtNmeaReplayInfo(*this, tree);
+        connect(info, &CRtNmeaReplayInfo::sigChanged, this, &CRtNmeaReplay::sigChanged);
+
+        tree->setItemWidget(itemInfo, eColumnWidget, info);
+        emit sigChanged();
+    }
+}
+
+void CRtNmeaReplay::loadSettings(QSettings& cfg)
+{
+    QMutexLocker lock(&IRtSource::mutex);
+
+    IRtSource::loadSettings(cfg);
+
+    if(info != nullptr)
+    {
+        info->loadSettings(cfg);
+    }
+
+    emit sigChanged();
+}
+
+void CRtNmeaReplay::saveSettings(QSettings& cfg) const
+{
+    QMutexLocker lock(&IRtSource::mutex);
+
+    IRtSource::saveSettings(cfg);
+
+    if(!info.isNull())
+    {
+        info->saveSettings(cfg);
+    }
+}
+
+
+QString CRtNmeaReplay::getDescription() const
+{
+    return tr("<b>NMEA Replay</b><br/>"
+              "Replay a recorded NMEA log at real or accelerated speed."
+              );
+}
+
+void CRtNmeaReplay::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>& blockedAreas, CRtDraw* rt)
+{
+    if(info.isNull() || checkState(eColumnCheckBox) != Qt::Checked)
+    {
+        return;
+    }
+
+    CRtGpsTether::drawPosition(p, info->getPosition(), info->getHeading(), rt);
+}
+
+void CRtNmeaReplay::fastDraw(QPainter& p, const QRectF& viewport, CRtDraw* rt)
+{
+}
+
@@ -0,0 +1,234 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "canvas/CCanvas.h"
+#include "CMainWindow.h"
+#include "helpers/CSettings.h"
+#include "realtime/gpstether/CRtNmeaReplay.h"
+#include "realtime/gpstether/CRtNmeaReplayInfo.h"
+#include "units/IUnit.h"
+
+#include <QtWidgets>
+
+/// gaps in the log are not replayed longer than this [ms]
+constexpr qint64 maxDelay = 5000;
+/// the number of lines to parse before returning to the event loop
+constexpr qint32 maxLinesPerCall = 1000;
+
+CRtNmeaReplayInfo::CRtNmeaReplayInfo(CRtNmeaReplay& source, QWidget* parent)
+    : IRtInfo(&source, parent)
+{
+    setupUi(this);
+
+    comboSpeed->addItem("1x", 1.0);
+    comboSpeed->addItem("2x", 2.0);
+    comboSpeed->addItem("5x", 5.0);
+    comboSpeed->addItem("10x", 10.0);
+    comboSpeed->addItem("20x", 20.0);
+    comboSpeed->addItem(tr("max."), 0.0);
+
+    connect(toolHelp, &QToolButton::clicked, this, &CRtNmeaReplayInfo::slotHelp);
+    connect(toolFile, &QToolButton::clicked, this, &CRtNmeaReplayInfo::slotSelectFile);
+    connect(toolPlay, &QToolButton::toggled, this, &CRtNmeaReplayInfo::slotPlay);
+    connect(toolRestart, &QToolButton::clicked, this, &CRtNmeaReplayInfo::slotRestart);
+
+    timerReplay = new QTimer(this);
+    timerReplay->setSingleShot(true);
+    connect(timerReplay, &QTimer::timeout, this, &CRtNmeaReplayInfo::slotReplay);
+
+    timerUpdate = new QTimer(this);
+    timerUpdate->setSingleShot(false);
+    timerUpdate->setInterval(1000);
+    connect(timerUpdate, &QTimer::timeout, this, &CRtNmeaReplayInfo::slotUpdate);
+
+    labelStatus->setText("-");
+}
+
+void CRtNmeaReplayInfo::slotHelp() const
+{
+    QMessageBox::information(CMainWindow::getBestWidgetForParent(), tr("Help"),
+                             tr("NMEA Replay\n"
+                                "Replay a NMEA log file as if it was received from a GPS. "
+                                "The sentences are parsed the same way as for the GPS Tether "
+                                "source. The time between two fixes is taken from the log and "
+                                "divided by the selected replay speed. With \"max.\" the log is "
+                                "replayed as fast as possible."
+                                )
+                             );
+}
+
+void CRtNmeaReplayInfo::loadSettings(QSettings& cfg)
+{
+    openFile(cfg.value("filename", "").toString());
+    comboSpeed->setCurrentIndex(cfg.value("speed", 0).toInt());
+    checkCenterPosition->setChecked(cfg.value("center position", false).toBool());
+}
+
+void CRtNmeaReplayInfo::saveSettings(QSettings& cfg) const
+{
+    cfg.setValue("filename", file.fileName());
+    cfg.setValue("speed", comboSpeed->currentIndex());
+    cfg.setValue("center position", checkCenterPosition->isChecked());
+}
+
+QPointF CRtNmeaReplayInfo::getPosition() const
+{
+    return nmea.getPosition();
+}
+
+qreal CRtNmeaReplayInfo::getHeading() const
+{
+    return nmea.getHeading();
+}
+
+void CRtNmeaReplayInfo::openFile(const QString& filename)
+{
+    toolPlay->setChecked(false);
+    file.close();
+    file.setFileName(filename);
+
+    labelFile->setText(filename.isEmpty() ? "-" : QFileInfo(filename).fileName());
+    labelFile->setToolTip(filename);
+    labelStatus->setText("-");
+
+    slotRestart();
+}
+
+void CRtNmeaReplayInfo::slotSelectFile()
+{
+    SETTINGS;
+    QString path = cfg.value("Paths/realtimeData", QDir::homePath()).toString();
+    const QString& filename = QFileDialog::getOpenFileName(this, tr("Select NMEA log..."), path, "NMEA (*.nmea *.log *.txt);;All (*)");
+
+    if(filename.isEmpty())
+    {
+        return;
+    }
+
+    openFile(filename);
+
+    path = QFileInfo(filename).absolutePath();
+    cfg.setValue("Paths/realtimeData", path);
+}
+
+void CRtNmeaReplayInfo::slotPlay(bool yes)
+{
+    if(!yes)
+    {
+        timerReplay->stop();
+        timerUpdate->stop();
+        slotUpdate();
+        return;
+    }
+
+    if(!file.isOpen() && !file.open(QIODevice::ReadOnly))
+    {
+        labelStatus->setText("<b style='color: red;'>" + file.errorString() + "</b>");
+        toolPlay->setChecked(false);
+        return;
+    }
+
+    labelStatus->setText("-");
+    timerReplay->start(0);
+    timerUpdate->start();
+}
+
+void CRtNmeaReplayInfo::slotRestart()
+{
+    if(file.isOpen())
+    {
+        file.seek(0);
+    }
+
+    nmea.reset();
+    slotUpdate();
+}
+
+void CRtNmeaReplayInfo::slotReplay()
+{
+    const QDateTime last = nmea.getTimestamp();
+
+    qint32 cnt = 0;
+    while(nmea.readLine(file))
+    {
+        const QDateTime& timestamp = nmea.getTimestamp();
+        if(last.isValid() && timestamp.isValid() && timestamp != last)
+        {
+            // a new fix: wait the time between both fixes, scaled by the replay speed
+            const qreal speed = comboSpeed->currentData().toReal();
+            const qint64 delay = speed > 0 ? qBound(qint64(0), qint64(last.msecsTo(timestamp) / speed), maxDelay) : 0;
+            timerReplay->start(delay);
+            return;
+        }
+
+        if(++cnt == maxLinesPerCall)
+        {
+            timerReplay->start(0);
+            return;
+        }
+    }
+
+    toolPlay->setChecked(false);
+    labelStatus->setText(tr("End of file."));
+}
+
+void CRtNmeaReplayInfo::slotUpdate()
+{
+    const QPointF& pos = nmea.getPosition();
+    const qreal lon = pos != NOPOINTF ? pos.x() : NOFLOAT;
+    const qreal lat = pos != NOPOINTF ? pos.y() : NOFLOAT;
+    const qreal ele = nmea.getElevation();
+    const qreal speed = nmea.getSpeed();
+    const qreal heading = nmea.getHeading();
+    const QDateTime& timestamp = nmea.getTimestamp();
+
+    QString val, unit;
+    IUnit::degToStr(lon, lat, val);
+    labelPosition->setText(val);
+    IUnit::self().meter2elevation(ele, val, unit);
+    labelElevation->setText(QString("%1%2").arg(val, unit));
+    IUnit::self().meter2speed(speed, val, unit);
+    labelSpeed->setText(QString("%1%2").arg(val, unit));
+    labelHeading->setText(heading != NOFLOAT ? QString("%1°").arg(heading, 0, 'f', 0) : "-");
+    labelTime->setText(timestamp.isValid() ? timestamp.toLocalTime().toString() : "-");
+
+    if(lastTimestamp != timestamp)
+    {
+        if(checkCenterPosition->isChecked() && pos != NOPOINTF)
+        {
+            CCanvas* canvas = CMainWindow::self().getVisibleCanvas();
+            if(canvas != nullptr)
+            {
+                canvas->followPosition(pos);
+            }
+        }
+        emit sigChanged();
+    }
+
+    lastTimestamp = timestamp;
+}
+
+void CRtNmeaReplayInfo::startRecord(const QString& /*filename*/)
+{
+    // the log file is the record
+}
+
+void CRtNmeaReplayInfo::fillTrackData(CTrackData& /*data*/)
+{
+}
+
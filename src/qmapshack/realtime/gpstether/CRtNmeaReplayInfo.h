@@ -0,0 +1,73 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CRTNMEAREPLAYINFO_H
+#define CRTNMEAREPLAYINFO_H
+
+#include "realtime/gpstether/CRtNmeaParser.h"
+#include "realtime/IRtInfo.h"
+#include "ui_IRtNmeaReplayInfo.h"
+
+#include <QFile>
+#include <QWidget>
+
+class CRtNmeaReplay;
+class QSettings;
+
+class CRtNmeaReplayInfo : public IRtInfo, private Ui::IRtNmeaReplayInfo
+{
+    Q_OBJECT
+public:
+    CRtNmeaReplayInfo(CRtNmeaReplay& source, QWidget* parent);
+    virtual ~CRtNmeaReplayInfo() = default;
+
+    void loadSettings(QSettings& cfg);
+    void saveSettings(QSettings& cfg) const;
+
+    QPointF getPosition() const;
+    qreal getHeading() const;
+signals:
+    void sigChanged();
+
+private slots:
+    void slotHelp() const;
+    void slotSelectFile();
+    void slotPlay(bool yes);
+    void slotRestart();
+    void slotReplay();
+    void slotUpdate();
+
+private:
+    void openFile(const QString& filename);
+
+    void startRecord(const QString& filename) override;
+    void fillTrackData(CTrackData& data) override;
+
+    QFile file;
+    /// feeds the parser with the sentences of the log
+    QTimer* timerReplay;
+    /// updates the GUI independent from the replay speed
+    QTimer* timerUpdate;
+
+    CRtNmeaParser nmea;
+
+    QDateTime lastTimestamp;
+};
+
+#endif //CRTNMEAREPLAYINFO_H
+
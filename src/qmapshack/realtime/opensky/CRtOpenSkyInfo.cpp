@@ -33,16 +33,19 @@ CRtOpenSkyInfo::CRtOpenSkyInfo(CRtOpenSky& source, QWidget* parent)
     connect(checkShowNames, &QCheckBox::toggled, &source, &CRtOpenSky::slotSetShowNames);
     connect(toolPause, &QToolButton::toggled, toolReset, &QToolButton::setEnabled);
     connect(toolPause, &QToolButton::toggled, toolFile, &QToolButton::setEnabled);
+    connect(toolPause, &QToolButton::toggled, toolLoadAll, &QToolButton::setEnabled);
     connect(toolPause, &QToolButton::toggled, toolToTrack, &QToolButton::setEnabled);
     connect(toolPause, &QToolButton::toggled, lineKey, &QLineEdit::setEnabled);
     connect(toolFile, &QToolButton::clicked, this, &CRtOpenSkyInfo::slotSetFilename);
     connect(toolReset, &QToolButton::clicked, this, &CRtOpenSkyInfo::slotResetRecord);
     connect(toolToTrack, &QToolButton::clicked, this, &CRtOpenSkyInfo::slotToTrack);
+    connect(toolLoadAll, &QToolButton::toggled, this, &CRtOpenSkyInfo::slotLoadAll);
 }
 
 void CRtOpenSkyInfo::loadSettings(QSettings& cfg)
 {
     lineKey->setText(cfg.value("callsign", "").toString());
+    toolLoadAll->setChecked(cfg.value("load all", false).toBool());
     startRecord(cfg.value("filename", "").toString());
 }
 
@@ -50,6 +53,7 @@ void CRtOpenSkyInfo::saveSettings(QSettings& cfg) const
 {
     cfg.setValue("callsign", lineKey->text());
     cfg.setValue("filename", toolFile->toolTip());
+    cfg.setValue("load all", toolLoadAll->isChecked());
 }
 
 void CRtOpenSkyInfo::slotUpdate()
@@ -91,7 +95,7 @@ void CRtOpenSkyInfo::startRecord(const QString& filename)
 
     record = new CRtOpenSkyRecord(this);
 
-    if(!record->setFile(filename))
+    if(!openRecord(filename))
     {
         delete record;
         QMessageBox::critical(this, tr("Failed..."), record->getError(), QMessageBox::Ok);
@@ -43,6 +43,6 @@ bool CRtOpenSkyRecord::writeEntry(const CRtOpenSky::aircraft_t& aircraft)
     stream << trkpt;
     track << trkpt;
 
-    return writeEntry(data);
+    return writeEntry(data, trkpt.time);
 }
 
@@ -31,13 +31,15 @@ public:
     const bool logfile;          // -f, print debug messages to logfile
     const bool nosplash;         // -n, do not display splash screen
     const QString configfile;
+    const QString renderJobs;    // -r, render the jobs of this file without GUI
     const QStringList arguments;
 
-    CAppOpts(bool doDebug, bool doLogfile, bool noSplash, const QString& config, const QStringList& args)
+    CAppOpts(bool doDebug, bool doLogfile, bool noSplash, const QString& config, const QString& jobs, const QStringList& args)
         : debug(doDebug)
         , logfile(doLogfile)
         , nosplash(noSplash)
         , configfile(config)
+        , renderJobs(jobs)
         , arguments(args)
     {
     }
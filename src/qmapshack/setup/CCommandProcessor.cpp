@@ -40,6 +40,10 @@ CAppOpts* CCommandProcessor::processOptions(const QStringList& arguments)
     QCommandLineOption configOption(QStringList() << "c" << "config", tr("File with QMapShack configuration."), tr("file"));
     parser.addOption(configOption);
 
+    QCommandLineOption renderOption(QStringList() << "r" << "render", tr("Render the views defined in the job file to image files and quit without showing the main window. "
+                                                                         "Use it with '-platform offscreen' on systems without display."), tr("file"));
+    parser.addOption(renderOption);
+
     parser.addPositionalArgument("files", tr("Files for future use."));
 
     if (!parser.parse(arguments))
@@ -54,5 +58,5 @@ CAppOpts* CCommandProcessor::processOptions(const QStringList& arguments)
         exit(0);
     }
 
-    return new CAppOpts(parser.isSet(debugOption), parser.isSet(logfileOption), parser.isSet(nosplashOption), parser.value(configOption), parser.positionalArguments());
+    return new CAppOpts(parser.isSet(debugOption), parser.isSet(logfileOption), parser.isSet(nosplashOption), parser.value(configOption), parser.value(renderOption), parser.positionalArguments());
 }
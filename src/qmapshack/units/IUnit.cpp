@@ -777,43 +777,115 @@ QDateTime IUnit::parseTimestamp(const QString& timetext, int& tzoffset)
     return datetime;
 }
 
-QString IUnit::datetime2string(const QDateTime& time, bool shortDate, const QPointF& pos)
+/**
+   @brief Get a timezone by it's IANA id
+
+   Resolving a timezone from the tz database is expensive. Thus all timezones
+   are kept once they have been resolved. The function is thread safe.
+ */
+static QTimeZone getTimeZone(const QByteArray& id)
 {
-    QTimeZone tz;
+    static QMutex mutex;
+    static QHash<QByteArray, QTimeZone> timeZones;
+
+    QMutexLocker lock(&mutex);
+    QHash<QByteArray, QTimeZone>::const_iterator tz = timeZones.constFind(id);
+    if(tz == timeZones.constEnd())
+    {
+        tz = timeZones.insert(id, QTimeZone(id));
+    }
+    return *tz;
+}
 
+QByteArray IUnit::getTimeZoneId(const QPointF& pos)
+{
     tz_mode_e tmpMode = (pos != NOPOINTF) ? timeZoneMode : eTZLocal;
 
     switch(tmpMode)
     {
     case eTZUtc:
-        tz = QTimeZone("UTC");
-        break;
+        return "UTC";
 
     case eTZLocal:
-        tz = QTimeZone(QTimeZone::systemTimeZoneId());
-        break;
+    {
+        // the system's timezone is not expected to change while the application is running
+        static const QByteArray idLocal = QTimeZone::systemTimeZoneId();
+        return idLocal;
+    }
 
     case eTZAuto:
-        tz = QTimeZone(pos2timezone(pos));
-        break;
+        return pos2timezone(pos);
 
     case eTZSelected:
-        tz = QTimeZone(timeZone);
-        break;
+        return timeZone;
     }
 
-    QDateTime tmp = time.toTimeZone(tz);
+    return QByteArray();
+}
+
+QString IUnit::datetime2string(const QDateTime& time, bool shortDate, const QPointF& pos)
+{
+    QDateTime tmp = time.toTimeZone(getTimeZone(getTimeZoneId(pos)));
     return tmp.toString((shortDate | useShortFormat) ? Qt::ISODate : Qt::SystemLocaleLongDate);
 }
 
+/// the pixel of the timezone map covering a position [rad]
+static QPoint pos2cell(const QPointF& pos)
+{
+    return QPoint(qRound(2048.0 / 360.0 * (180.0 + pos.x() * RAD_TO_DEG)), qRound(1024.0 / 180.0 * (90.0 - pos.y() * RAD_TO_DEG)));
+}
+
+QStringList IUnit::datetime2string(const QVector<QDateTime>& times, bool shortDate, const QVector<QPointF>& pos)
+{
+    const Qt::DateFormat format = (shortDate | useShortFormat) ? Qt::ISODate : Qt::SystemLocaleLongDate;
+
+    QStringList strings;
+    strings.reserve(times.size());
+
+    // the timezones resolved so far, to skip the locked lookup
+    QHash<QByteArray, QTimeZone> timeZones;
+    QHash<QByteArray, QTimeZone>::const_iterator tz = timeZones.constEnd();
+
+    QByteArray id;
+    QPoint lastCell(-1, -1);
+    for(int i = 0; i < times.size(); i++)
+    {
+        const QPointF& p = i < pos.size() ? pos[i] : NOPOINTF;
+        if(timeZoneMode == eTZAuto && p != NOPOINTF)
+        {
+            // all positions in the same cell of the timezone map share the timezone
+            const QPoint& cell = pos2cell(p);
+            if(cell == lastCell)
+            {
+                strings << times[i].toTimeZone(*tz).toString(format);
+                continue;
+            }
+            lastCell = cell;
+            id = pos2timezone(p);
+        }
+        else
+        {
+            lastCell = QPoint(-1, -1);
+            id = getTimeZoneId(p);
+        }
+
+        tz = timeZones.constFind(id);
+        if(tz == timeZones.constEnd())
+        {
+            tz = timeZones.insert(id, getTimeZone(id));
+        }
+
+        strings << times[i].toTimeZone(*tz).toString(format);
+    }
+
+    return strings;
+}
+
 QByteArray IUnit::pos2timezone(const QPointF& pos)
 {
     static QImage imgTimezone = QPixmap(":/pics/timezones.png").toImage();
 
-    int x = qRound(2048.0 / 360.0 * (180.0 + pos.x() * RAD_TO_DEG));
-    int y = qRound(1024.0 / 180.0 * (90.0 - pos.y() * RAD_TO_DEG));
-
-    QRgb rgb = imgTimezone.pixel(x, y);
+    QRgb rgb = imgTimezone.pixel(pos2cell(pos));
 
     if(qRed(rgb) == 0 && qGreen(rgb) == 0)
     {
@@ -116,6 +116,21 @@ public:
      */
     static QString datetime2string(const QDateTime& time, bool shortDate, const QPointF& pos = NOPOINTF);
 
+    /**
+       @brief Convert a list of date time objects to strings using the current timezone configuration
+
+       The result is the same as calling datetime2string() for each object. But the
+       timezone is looked up only if the position moves to another cell of the timezone
+       map and each timezone is resolved once. Use it to format large sets of timestamps
+       like the points of a track.
+
+       @param times         the date/time objects
+       @param shortDate     set true to get short ISO time strings
+       @param pos           optional the positions attached to the date/time objects [rad]
+       @return              A time string for each date/time object.
+     */
+    static QStringList datetime2string(const QVector<QDateTime>& times, bool shortDate, const QVector<QPointF>& pos = QVector<QPointF>());
+
     /// find the timezone setup by position
     static QByteArray pos2timezone(const QPointF& pos);
 
@@ -187,6 +202,9 @@ protected:
 
     static QDateTime parseTimestamp(const QString& timetext, int& tzoffset);
 
+    /// the IANA id of the timezone to use for a date/time object at the given position
+    static QByteArray getTimeZoneId(const QPointF& pos);
+
     static tz_mode_e timeZoneMode;
     static QByteArray timeZone;
     static bool useShortFormat;
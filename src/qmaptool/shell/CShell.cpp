@@ -27,23 +27,30 @@ CShell::CShell(QWidget* parent)
     : QTextBrowser(parent)
 {
     pSelf = this;
-
-    connect(&cmd, &QProcess::readyReadStandardError, this, &CShell::slotStderr);
-    connect(&cmd, &QProcess::readyReadStandardOutput, this, &CShell::slotStdout);
-
-    connect(&cmd, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this, &CShell::slotFinished);
-    connect(&cmd, static_cast<void (QProcess::*)(QProcess::ProcessError)   >(&QProcess::error), this, &CShell::slotError);
 }
 
 void CShell::slotError(QProcess::ProcessError error)
 {
+    QProcess* proc = qobject_cast<QProcess*>(sender());
+    if(!chainsRunning.contains(proc))
+    {
+        return;
+    }
+
+    const chain_t& chain = chainsRunning[proc];
+    const QString& prefix = isParallel ? "[" + chain.label + "] " : "";
+
+    moveCursor(QTextCursor::End);
     setTextColor(Qt::red);
-    insertPlainText(QString(tr("Execution of external program `%1` failed: ")).arg(cmd.program()));
+    insertPlainText(prefix + QString(tr("Execution of external program `%1` failed: ")).arg(proc->program()));
     switch(error)
     {
     case QProcess::FailedToStart:
         insertPlainText(QString(tr("Process cannot be started.\n")));
-        insertPlainText(QString(tr("Make sure the required packages are installed, `%1` exists and is executable.\n")).arg(cmd.program()));
+        insertPlainText(QString(tr("Make sure the required packages are installed, `%1` exists and is executable.\n")).arg(proc->program()));
+        // there will be no finished signal. The error can be emitted while
+        // starting the process, thus the clean up is deferred.
+        QTimer::singleShot(0, this, [this, proc](){processDone(proc, false);});
         break;
 
     case QProcess::Crashed:
@@ -58,43 +65,58 @@ void CShell::slotError(QProcess::ProcessError error)
 
 void CShell::slotStderr()
 {
-    QString str;
-    setTextColor(Qt::red);
-    str = cmd.readAllStandardError();
-
-    if(str[0] == '\r')
+    QProcess* proc = qobject_cast<QProcess*>(sender());
+    if(!chainsRunning.contains(proc))
     {
-#ifdef Q_OS_WIN64
-        if(str.contains("\n"))
-        {
-            insertPlainText("\n");
-        }
-        else
-#endif // Q_OS_WIN64
-        {
-            moveCursor( QTextCursor::End, QTextCursor::MoveAnchor );
-            moveCursor( QTextCursor::StartOfLine, QTextCursor::MoveAnchor );
-            moveCursor( QTextCursor::End, QTextCursor::KeepAnchor );
-            textCursor().removeSelectedText();
-        }
+        return;
+    }
 
+    chain_t& chain = chainsRunning[proc];
+    output(chain, chain.bufErr, proc->readAllStandardError(), Qt::red);
+}
 
-#ifdef Q_OS_WIN64
-        str = str.split("\r").last().remove("\r").remove("\n");
-#else
-        str = str.split("\r").last();
-#endif
+void CShell::slotStdout()
+{
+    QProcess* proc = qobject_cast<QProcess*>(sender());
+    if(!chainsRunning.contains(proc))
+    {
+        return;
     }
 
-    insertPlainText(str);
-    verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+    chain_t& chain = chainsRunning[proc];
+    output(chain, chain.bufOut, proc->readAllStandardOutput(), Qt::blue);
 }
 
-void CShell::slotStdout()
+void CShell::output(chain_t& chain, QString& buffer, QString str, const QColor& color)
 {
-    QString str;
-    setTextColor(Qt::blue);
-    str = cmd.readAllStandardOutput();
+    if(str.isEmpty())
+    {
+        return;
+    }
+
+    setTextColor(color);
+
+    if(isParallel)
+    {
+        // the output of several processes is interleaved. Write complete lines
+        // only and prefix them with the chain's label. Progress updates using
+        // a carriage return are reduced to the last update of a line.
+        buffer += str;
+        qint32 idx;
+        while((idx = buffer.indexOf('\n')) >= 0)
+        {
+            QString line = buffer.left(idx);
+            buffer.remove(0, idx + 1);
+
+            const QStringList& parts = line.split("\r", QString::SkipEmptyParts);
+            line = parts.isEmpty() ? QString() : parts.last();
+
+            moveCursor(QTextCursor::End);
+            insertPlainText("[" + chain.label + "] " + line + "\n");
+        }
+        verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+        return;
+    }
 
     if(str[0] == '\r')
     {
@@ -139,35 +161,71 @@ void CShell::stdErr(const QString& str)
 
 void CShell::slotFinished(int exitCode, QProcess::ExitStatus status)
 {
-    if(exitCode || status)
+    processDone(qobject_cast<QProcess*>(sender()), !(exitCode || status));
+}
+
+void CShell::processDone(QProcess* proc, bool success)
+{
+    if(!chainsRunning.contains(proc))
     {
-        emit sigFinishedJob(jobId);
-        setTextColor(Qt::red);
-        append(tr("!!! failed !!!\n"));
         return;
     }
 
-    ++idxCommand;
+    chain_t chain = chainsRunning.take(proc);
+    proc->deleteLater();
+
+    // flush incomplete lines
+    if(isParallel)
+    {
+        output(chain, chain.bufOut, "\n", Qt::blue);
+        output(chain, chain.bufErr, "\n", Qt::red);
+    }
+
+    if(!success)
+    {
+        if(isParallel)
+        {
+            setTextColor(Qt::red);
+            append("[" + chain.label + "] " + tr("!!! failed !!!\n"));
+        }
+        hasFailed = true;
+    }
+    else if(++chain.idx < chain.cmds.size())
+    {
+        startChain(chain);
+        return;
+    }
+
     nextCommand();
 }
 
 void CShell::slotCancel()
 {
-    if(cmd.state() == QProcess::NotRunning)
+    if(chainsRunning.isEmpty())
     {
         return;
     }
 
     stdOut(tr("\nCanceled by user's request.\n"));
-    cmd.kill();
-    cmd.waitForFinished(10000);
+    chainsPending.clear();
+    hasFailed = true;
+
+    const QList<QProcess*>& procs = chainsRunning.keys();
+    for(QProcess* proc : procs)
+    {
+        proc->kill();
+    }
+    for(QProcess* proc : procs)
+    {
+        proc->waitForFinished(10000);
+    }
 }
 
 int CShell::execute(QList<CShellCmd> cmds)
 {
     CMainWindow::self().makeShellVisible();
 
-    if(cmd.state() != QProcess::NotRunning)
+    if(!chainsRunning.isEmpty())
     {
         return -1;
     }
@@ -176,23 +234,102 @@ int CShell::execute(QList<CShellCmd> cmds)
 
     idxCommand = 0;
     commands = cmds;
+    chainsPending.clear();
+    hasFailed = false;
+    maxProcesses = qMax(1, QThread::idealThreadCount());
 
     nextCommand();
     return ++jobId;
 }
 
-
-void CShell::nextCommand()
+void CShell::finishJob()
 {
-    if(idxCommand >= commands.size())
+    emit sigFinishedJob(jobId);
+    if(hasFailed)
+    {
+        setTextColor(Qt::red);
+        append(tr("!!! failed !!!\n"));
+    }
+    else
     {
-        emit sigFinishedJob(jobId);
         setTextColor(Qt::darkGreen);
         append(tr("!!! done !!!\n"));
-        return;
     }
+}
+
+void CShell::nextCommand()
+{
+    for(;;)
+    {
+        if(hasFailed)
+        {
+            // let running processes finish but do not start new ones
+            chainsPending.clear();
+            if(chainsRunning.isEmpty())
+            {
+                finishJob();
+            }
+            return;
+        }
+
+        while((chainsRunning.size() < maxProcesses) && !chainsPending.isEmpty())
+        {
+            chain_t chain = chainsPending.takeFirst();
+            startChain(chain);
+        }
+
+        if(!chainsRunning.isEmpty())
+        {
+            return;
+        }
+
+        if(idxCommand >= commands.size())
+        {
+            finishJob();
+            return;
+        }
+
+        // setup next stage
+        if(commands[idxCommand].getChain() < 0)
+        {
+            chain_t chain;
+            chain.cmds << commands[idxCommand++];
+            chainsPending << chain;
+        }
+        else
+        {
+            QHash<qint32, qint32> chainIndex;
+            while((idxCommand < commands.size()) && (commands[idxCommand].getChain() >= 0))
+            {
+                const CShellCmd& command = commands[idxCommand++];
+                if(!chainIndex.contains(command.getChain()))
+                {
+                    chainIndex[command.getChain()] = chainsPending.size();
+                    chain_t chain;
+                    chain.label = command.getLabel().isEmpty() ? QString::number(command.getChain()) : command.getLabel();
+                    chainsPending << chain;
+                }
+                chainsPending[chainIndex[command.getChain()]].cmds << command;
+            }
+        }
+
+        isParallel = chainsPending.size() > 1;
+    }
+}
+
+void CShell::startChain(chain_t& chain)
+{
+    QProcess* proc = new QProcess(this);
+    connect(proc, &QProcess::readyReadStandardError, this, &CShell::slotStderr);
+    connect(proc, &QProcess::readyReadStandardOutput, this, &CShell::slotStdout);
+
+    connect(proc, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this, &CShell::slotFinished);
+    connect(proc, static_cast<void (QProcess::*)(QProcess::ProcessError)   >(&QProcess::error), this, &CShell::slotError);
+
+    const CShellCmd& command = chain.cmds[chain.idx];
+    const QString& prefix = isParallel ? "[" + chain.label + "] " : "";
+    stdOut(prefix + command.getCmd() + " " + command.getArgs().join(" ") + "\n");
 
-    const CShellCmd& command = commands[idxCommand];
-    stdOut(command.getCmd() + " " + command.getArgs().join(" ") + "\n");
-    cmd.start(command.getCmd(), command.getArgs());
+    chainsRunning[proc] = chain;
+    proc->start(command.getCmd(), command.getArgs());
 }
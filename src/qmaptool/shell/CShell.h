@@ -21,6 +21,7 @@
 
 #include "shell/CShellCmd.h"
 
+#include <QHash>
 #include <QList>
 #include <QProcess>
 #include <QTextBrowser>
@@ -36,6 +37,16 @@ public:
 
     virtual ~CShell() = default;
 
+    /**
+       @brief Execute a list of commands
+
+       Consecutive commands with a chain ID >= 0 form a stage. Within a stage all commands
+       of the same chain are run in order, but different chains are run in parallel. Commands
+       with a chain ID < 0 are run alone after all previous commands finished.
+
+       @param cmds  the list of commands
+       @return The job ID or -1 if another job is still running
+     */
     int execute(QList<CShellCmd> cmds);
 signals:
     void sigFinishedJob(qint32 jobId);
@@ -52,19 +63,53 @@ protected slots:
     virtual void slotFinished(int exitCode, QProcess::ExitStatus status);
 
 protected:
+    /// commands of a single chain to be executed in order
+    struct chain_t
+    {
+        QList<CShellCmd> cmds;
+        qint32 idx = 0;
+        QString label;
+        /// incomplete lines of stdout and stderr if the output is prefixed by the label
+        QString bufOut;
+        QString bufErr;
+    };
+
     void nextCommand();
+    /// start the next command of a chain in a new process
+    void startChain(chain_t& chain);
+    /// report the result of the job
+    void finishJob();
+    /**
+       @brief Continue or abort a chain after a process finished
+
+       @param proc      the process that finished
+       @param success   true if the process finished without error
+     */
+    void processDone(QProcess* proc, bool success);
 
     /// write text to stdout color channel of the text browser
     void stdOut(const QString& str);
     /// write text to stderr color channel of the text browser
     void stdErr(const QString& str);
 
-    QProcess cmd;
+    /// write process output to the text browser
+    void output(chain_t& chain, QString& buffer, QString str, const QColor& color);
 
     QList<CShellCmd> commands;
     qint32 idxCommand = 0;
     qint32 jobId = 0;
 
+    /// chains of the current stage not started yet
+    QList<chain_t> chainsPending;
+    /// chains of the current stage running right now
+    QHash<QProcess*, chain_t> chainsRunning;
+    /// true if the current stage runs more than one chain
+    bool isParallel = false;
+    /// true if a command failed or the job has been canceled
+    bool hasFailed = false;
+    /// the maximum number of processes running in parallel
+    qint32 maxProcesses = 1;
+
 private:
     friend class Ui_IMainWindow;
     CShell(QWidget* parent);
@@ -72,4 +117,3 @@ private:
 };
 
 #endif //CSHELL_H
-
@@ -38,9 +38,35 @@ public:
         return args;
     }
 
+    qint32 getChain() const
+    {
+        return chain;
+    }
+
+    const QString& getLabel() const
+    {
+        return label;
+    }
+
+    /**
+       @brief Make the command part of a chain of commands
+
+       Chains of commands can be run in parallel by CShell
+
+       @param id        the chain's ID, -1 to run the command sequentially
+       @param text      a label to attribute the command's output to
+     */
+    void setChain(qint32 id, const QString& text)
+    {
+        chain = id;
+        label = text;
+    }
+
 private:
     QString cmd;
     QStringList args;
+    qint32 chain = -1;
+    QString label;
 };
 
 #endif //CSHELLCMD_H
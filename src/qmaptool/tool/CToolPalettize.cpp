@@ -219,6 +219,7 @@ void CToolPalettize::buildCmdFinal(QList<CShellCmd>& cmds)
             args << inFilename;
             args << outFilename;
             cmds << CShellCmd(IAppSetup::self().getQmtrgb2pct(), args);
+            setChain(cmds, cmds.size() - 1, n, inFilename);
         }
 
         inputFileList2->close();
@@ -276,6 +277,7 @@ void CToolPalettize::buildCmdFinal(QList<CShellCmd>& cmds)
             QString outFilename = fi.absoluteDir().absoluteFilePath(fi.completeBaseName() + lineSuffix->text() + "." + fi.suffix());
 
             // ---- command n*3 ----------------------
+            const qint32 from = cmds.size();
             args.clear();
             args << "--pct" << pctFilename;
             args << inFilename;
@@ -296,6 +298,9 @@ void CToolPalettize::buildCmdFinal(QList<CShellCmd>& cmds)
 
             // ---- command n*3 + 2 ----------------------
             groupOverviews->buildCmd(cmds, lastOutFilname, "nearest");
+
+            // the commands of each file are independent from other files
+            setChain(cmds, from, n, inFilename);
         }
     }
 }
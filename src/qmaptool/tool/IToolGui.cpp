@@ -24,6 +24,8 @@
 #include "shell/CShell.h"
 #include "tool/IToolGui.h"
 
+#include <QFileInfo>
+
 IToolGui::IToolGui(QWidget* parent)
     : QWidget(parent)
 {
@@ -39,6 +41,15 @@ QString IToolGui::createTempFile(const QString& ext)
     return tmpFile->fileName();
 }
 
+void IToolGui::setChain(QList<CShellCmd>& cmds, qint32 from, qint32 chain, const QString& filename)
+{
+    const QString& label = QFileInfo(filename).fileName();
+    for(qint32 i = from; i < cmds.size(); i++)
+    {
+        cmds[i].setChain(chain, label);
+    }
+}
+
 bool IToolGui::finished(qint32 id)
 {
     if(id == jobId)
@@ -69,7 +80,10 @@ void IToolGui::start(CItemTreeWidget* itemTree)
             IItem* item = dynamic_cast<IItem*>(layer->child(m));
             if(nullptr != item)
             {
+                // the commands of each file are independent from other files
+                const qint32 from = cmds.size();
                 buildCmd(cmds, item);
+                setChain(cmds, from, from, item->getFilename());
             }
         }
     }
@@ -91,7 +105,10 @@ void IToolGui::start(CItemListWidget* itemList, bool allFiles)
             const IItem* item = dynamic_cast<const IItem*>(itemList->item(n));
             if(nullptr != item)
             {
+                // the commands of each file are independent from other files
+                const qint32 from = cmds.size();
                 buildCmd(cmds, item);
+                setChain(cmds, from, n, item->getFilename());
             }
         }
     }
@@ -40,6 +40,17 @@ protected:
     virtual void buildCmdFinal(QList<CShellCmd>& cmds){}
 
     QString createTempFile(const QString& ext);
+
+    /**
+       @brief Make all commands from index `from` on a chain that can be run in parallel to other chains
+
+       @param cmds      the list of commands
+       @param from      the index of the first command of the chain
+       @param chain     the chain's ID
+       @param filename  the file the chain processes, used to label the output
+     */
+    static void setChain(QList<CShellCmd>& cmds, qint32 from, qint32 chain, const QString& filename);
+
     qint32 jobId = 0;
     QList<QTemporaryFile*> tmpFiles;
 };
@@ -32,8 +32,12 @@
 #include <wctype.h>
 
 
+#include <condition_variable>
+#include <deque>
 #include <list>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <gdal_priv.h>
@@ -167,12 +171,32 @@ static jnx_hdr_t jnx_hdr;
 static jnx_tile_t tileTable[JNX_MAX_TILES * 5];
 /// tile buffer for 8 bit palette tiles, private to readTile
 static uint8_t tileBuf8Bit[JNX_MAX_TILE_SIZE * JNX_MAX_TILE_SIZE] = {0};
-/// tile buffer for 24 bit raw RGB tiles, private to writeTile
-static uint8_t tileBuf24Bit[JNX_MAX_TILE_SIZE * JNX_MAX_TILE_SIZE * 3] = {0};
-/// tile buffer for 32 bit raw RGBA tiles
-static uint32_t tileBuf32Bit[JNX_MAX_TILE_SIZE * JNX_MAX_TILE_SIZE] = {0};
-/// internal jpeg buffer used by write tile.
-static std::vector<JOCTET> jpgbuf;
+
+/// a tile passed from the reader to the encoders and from the encoders to the writer
+struct tile_job_t
+{
+    /// index into tileTable
+    uint32_t idx = 0;
+    uint32_t xsize = 0;
+    uint32_t ysize = 0;
+    /// raw RGBA data read by readTile
+    std::vector<uint32_t> raw;
+    /// JPEG data created by encodeTile
+    std::vector<JOCTET> jpg;
+    /// set true by the encoder when jpg is complete
+    bool done = false;
+};
+
+/// serialize access to the job queue and the job's done flag
+static std::mutex jobMutex;
+/// signal new jobs in jobsQueued to the encoder threads
+static std::condition_variable jobsAvailable;
+/// signal finished jobs to the writer
+static std::condition_variable jobFinished;
+/// jobs waiting to be encoded
+static std::deque<tile_job_t*> jobsQueued;
+/// set true to terminate the encoder threads
+static bool jobsTerminate = false;
 
 static void prinfFileinfo(const file_t& file)
 {
@@ -244,8 +268,16 @@ bool readTile(uint32_t xoff, uint32_t yoff, uint32_t xsize, uint32_t ysize, file
 
 
 
+/// the JPEG destination manager writing to a std::vector
+struct jpg_destination_t
+{
+    jpeg_destination_mgr mgr;
+    std::vector<JOCTET>* buffer;
+};
+
 static void init_destination(j_compress_ptr cinfo)
 {
+    std::vector<JOCTET>& jpgbuf = *((jpg_destination_t*)cinfo->dest)->buffer;
     jpgbuf.resize(JPG_BLOCK_SIZE);
     cinfo->dest->next_output_byte = &jpgbuf[0];
     cinfo->dest->free_in_buffer = jpgbuf.size();
@@ -253,6 +285,7 @@ static void init_destination(j_compress_ptr cinfo)
 
 static boolean empty_output_buffer(j_compress_ptr cinfo)
 {
+    std::vector<JOCTET>& jpgbuf = *((jpg_destination_t*)cinfo->dest)->buffer;
     size_t oldsize = jpgbuf.size();
     jpgbuf.resize(oldsize + JPG_BLOCK_SIZE);
     cinfo->dest->next_output_byte = &jpgbuf[oldsize];
@@ -262,23 +295,37 @@ static boolean empty_output_buffer(j_compress_ptr cinfo)
 
 static void term_destination(j_compress_ptr cinfo)
 {
+    std::vector<JOCTET>& jpgbuf = *((jpg_destination_t*)cinfo->dest)->buffer;
     jpgbuf.resize(jpgbuf.size() - cinfo->dest->free_in_buffer);
 }
 
 
-static uint32_t writeTile(uint32_t xsize, uint32_t ysize, uint32_t* raw_image, FILE* fid, int quality, int subsampling)
+/**
+   @brief Compress a tile into a JPEG image
+
+   This is thread safe as long as each thread passes it's own buffers.
+
+   @param xsize         the tile's width in pixel
+   @param ysize         the tile's height in pixel
+   @param raw_image     the tile's RGBA data
+   @param jpgbuf        the buffer to receive the JPEG data
+   @param quality       the JPEG quality or -1 for the default
+   @param subsampling   the chroma subsampling or -1 for the default
+ */
+static void encodeTile(uint32_t xsize, uint32_t ysize, const uint32_t* raw_image, std::vector<JOCTET>& jpgbuf, int quality, int subsampling)
 {
-    uint32_t size = 0;
     struct jpeg_compress_struct cinfo;
     struct jpeg_error_mgr jerr;
     JSAMPROW row_pointer[1];
 
-    jpeg_destination_mgr destmgr = {0};
-    destmgr.init_destination = init_destination;
-    destmgr.empty_output_buffer = empty_output_buffer;
-    destmgr.term_destination = term_destination;
+    jpg_destination_t destmgr = {};
+    destmgr.mgr.init_destination = init_destination;
+    destmgr.mgr.empty_output_buffer = empty_output_buffer;
+    destmgr.mgr.term_destination = term_destination;
+    destmgr.buffer = &jpgbuf;
 
     // convert from RGBA to RGB
+    std::vector<uint8_t> tileBuf24Bit(xsize * ysize * 3);
     for(uint32_t r = 0; r < ysize; r++)
     {
         for(uint32_t c = 0; c < xsize; c++)
@@ -293,7 +340,7 @@ static uint32_t writeTile(uint32_t xsize, uint32_t ysize, uint32_t* raw_image, F
     cinfo.err = jpeg_std_error( &jerr );
     jpeg_create_compress(&cinfo);
 
-    cinfo.dest = &destmgr;
+    cinfo.dest = &destmgr.mgr;
     cinfo.image_width = xsize;
     cinfo.image_height = ysize;
     cinfo.input_components = 3;
@@ -355,14 +402,50 @@ static uint32_t writeTile(uint32_t xsize, uint32_t ysize, uint32_t* raw_image, F
     /* similar to read file, clean up after we're done compressing */
     jpeg_finish_compress( &cinfo );
     jpeg_destroy_compress( &cinfo );
+}
+
+/**
+   @brief Write a JPEG encoded tile to the output file
+
+   The leading SOI marker is skipped as the JNX format expects.
 
-    // write data to output file
-    size = jpgbuf.size() - 2;
+   @return The number of bytes written
+ */
+static uint32_t writeTile(const std::vector<JOCTET>& jpgbuf, FILE* fid)
+{
+    uint32_t size = jpgbuf.size() - 2;
     fwrite(&jpgbuf[2], size, 1, fid);
 
     return size;
 }
 
+/// the encoder thread's main loop
+static void encoderThread(int quality, int subsampling)
+{
+    for(;;)
+    {
+        tile_job_t* job;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobsAvailable.wait(lock, []{return jobsTerminate || !jobsQueued.empty();});
+            if(jobsQueued.empty())
+            {
+                return;
+            }
+            job = jobsQueued.front();
+            jobsQueued.pop_front();
+        }
+
+        encodeTile(job->xsize, job->ysize, job->raw.data(), job->jpg, quality, subsampling);
+
+        {
+            std::lock_guard<std::mutex> lock(jobMutex);
+            job->done = true;
+        }
+        jobFinished.notify_all();
+    }
+}
+
 static double distance(const double u1, const double v1, const double u2, const double v2)
 {
     double dU = u2 - u1; // lambda
@@ -523,6 +606,7 @@ int main(int argc, char** argv)
     OGRSpatialReference oSRS;
     int quality = -1;
     int subsampling = -1;
+    int threads = std::thread::hardware_concurrency();
 
     const char* copyright = "Unknown";
     const char* subscname = "BirdsEye";
@@ -538,7 +622,7 @@ int main(int argc, char** argv)
 
     if(argc < 2)
     {
-        fprintf(stderr, "\nusage: qmt_map2jnx -q <1..100> -s <411|422|444> -p <0..> -c \"copyright notice\" -m \"BirdsEye\" -n \"Unknown\" -x file1_scale,file2_scale,...,fileN_scale <file1> <file2> ... <fileN> <outputfile>\n");
+        fprintf(stderr, "\nusage: qmt_map2jnx -q <1..100> -s <411|422|444> -p <0..> -c \"copyright notice\" -m \"BirdsEye\" -n \"Unknown\" -x file1_scale,file2_scale,...,fileN_scale -t <1..> <file1> <file2> ... <fileN> <outputfile>\n");
         fprintf(stderr, "\n");
         fprintf(stderr, "  -q The JPEG quality from 1 to 100. Default is 75 \n");
         fprintf(stderr, "  -s The chroma subsampling. Default is 411  \n");
@@ -548,6 +632,7 @@ int main(int argc, char** argv)
         fprintf(stderr, "  -n The map name. Default is \"Unknown\"  \n");
         fprintf(stderr, "  -z The z order (drawing order). Default is 25\n");
         fprintf(stderr, "  -x Override levels scale. Default: autodetect\n");
+        fprintf(stderr, "  -t The number of threads used to encode tiles. Default is the number of CPU cores\n");
         fprintf(stderr, "\n");
         fprintf(stderr, "\nThe projection of the input files must have the same latitude along");
         fprintf(stderr, "\na pixel row. Mecator and Longitude/Latitude projections match this");
@@ -638,6 +723,12 @@ int main(int argc, char** argv)
                 skip_next_arg = 1;
                 continue;
             }
+            else if (towupper(argv[i][1]) == 'T')
+            {
+                threads = atol(argv[i + 1]);
+                skip_next_arg = 1;
+                continue;
+            }
             else if (towupper(argv[i][1]) == 'X')
             {
                 skip_next_arg = 1;
@@ -929,6 +1020,59 @@ int main(int argc, char** argv)
 
     // --------------------------------------------------------------
     // read tiles from input files and write jpeg coded tiles to output file
+    //
+    // The tiles are read in order by this thread and passed to a pool of encoder
+    // threads. The encoded tiles are written in the same order they have been read.
+    // Thus the file layout does not depend on the number of threads.
+    if(threads < 1)
+    {
+        threads = 1;
+    }
+
+    std::vector<std::thread> encoders;
+    if(threads > 1)
+    {
+        for(int i = 0; i < threads; i++)
+        {
+            encoders.push_back(std::thread(encoderThread, quality, subsampling));
+        }
+    }
+
+    // limit the number of tiles in memory
+    const size_t maxJobsInFlight = 2 * threads;
+    std::deque<tile_job_t*> jobsInFlight;
+    uint32_t tilesWritten = 0;
+
+    // write all encoded tiles at the head of jobsInFlight. Wait for the
+    // head to finish as long as there are more than maxJobs in flight
+    auto writeFinishedTiles = [&](size_t maxJobs)
+    {
+        while(!jobsInFlight.empty())
+        {
+            tile_job_t* job = jobsInFlight.front();
+            {
+                std::unique_lock<std::mutex> lock(jobMutex);
+                if(!job->done)
+                {
+                    if(jobsInFlight.size() <= maxJobs)
+                    {
+                        break;
+                    }
+                    jobFinished.wait(lock, [job]{return job->done;});
+                }
+            }
+
+            jnx_tile_t& tile = tileTable[job->idx];
+            tile.offset = (uint32_t)(ftello(fid) & 0x0FFFFFFFF);
+            tile.size = writeTile(job->jpg, fid);
+
+            jobsInFlight.pop_front();
+            delete job;
+
+            printProgress(++tilesWritten, tilesTotal);
+        }
+    };
+
     printf("\n\nStart conversion:\n");
     for(int l = 0; l < nLevels; l++)
     {
@@ -963,7 +1107,12 @@ int main(int argc, char** argv)
                     }
 
                     // //
-                    if(!readTile(xoff, yoff, xsize, ysize, file, tileBuf32Bit))
+                    tile_job_t* job = new tile_job_t();
+                    job->idx = tileCnt;
+                    job->xsize = xsize;
+                    job->ysize = ysize;
+                    job->raw.resize(xsize * ysize);
+                    if(!readTile(xoff, yoff, xsize, ysize, file, job->raw.data()))
                     {
                         fprintf(stderr, "\nError reading tiles from map file\n");
                         exit(-1);
@@ -1001,10 +1150,23 @@ int main(int argc, char** argv)
 
                     tile.width = xsize;
                     tile.height = ysize;
-                    tile.offset = (uint32_t)(ftello(fid) & 0x0FFFFFFFF);
-                    tile.size = writeTile(xsize, ysize, tileBuf32Bit, fid, quality, subsampling);
 
-                    printProgress(tileCnt, tilesTotal);
+                    jobsInFlight.push_back(job);
+                    if(encoders.empty())
+                    {
+                        encodeTile(job->xsize, job->ysize, job->raw.data(), job->jpg, quality, subsampling);
+                        job->done = true;
+                    }
+                    else
+                    {
+                        {
+                            std::lock_guard<std::mutex> lock(jobMutex);
+                            jobsQueued.push_back(job);
+                        }
+                        jobsAvailable.notify_one();
+                    }
+
+                    writeFinishedTiles(maxJobsInFlight);
                     // //
                     xoff += xsize;
                 }
@@ -1014,6 +1176,18 @@ int main(int argc, char** argv)
         }
     }
 
+    // write all remaining tiles and stop encoders
+    writeFinishedTiles(0);
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        jobsTerminate = true;
+    }
+    jobsAvailable.notify_all();
+    for(std::thread& encoder : encoders)
+    {
+        encoder.join();
+    }
+
     // terminate output file
     fwrite("BirdsEye", 8, 1, fid);
 
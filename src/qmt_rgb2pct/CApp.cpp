@@ -18,12 +18,185 @@
 
 #include "CApp.h"
 
+#include <climits>
+#include <cstring>
 #include <gdal_alg.h>
 #include <gdal_priv.h>
 #include <iostream>
 
 const GDALColorEntry CApp::noColor = {255, 255, 255, 0};
 
+/// the number of pixels sampled for the histogram of the fast algorithm
+#define MAX_SAMPLES (4 * 1024 * 1024)
+/// the number of rows dithered as one block by the fast algorithm
+#define STRIP_HEIGHT 64
+
+/// a box of the RGB555 histogram used by the median cut
+struct box_t
+{
+    qint32 min[3];
+    qint32 max[3];
+    quint64 count;
+};
+
+static inline qint32 histIndex(qint32 r, qint32 g, qint32 b)
+{
+    return (r << 10) | (g << 5) | b;
+}
+
+/// shrink the box to the non empty bins and count the pixels in it
+static void shrinkBox(box_t& box, const QVector<quint64>& hist)
+{
+    qint32 min[3] = {31, 31, 31};
+    qint32 max[3] = {0, 0, 0};
+    box.count = 0;
+
+    for(qint32 r = box.min[0]; r <= box.max[0]; r++)
+    {
+        for(qint32 g = box.min[1]; g <= box.max[1]; g++)
+        {
+            for(qint32 b = box.min[2]; b <= box.max[2]; b++)
+            {
+                const quint64 n = hist[histIndex(r, g, b)];
+                if(n == 0)
+                {
+                    continue;
+                }
+                box.count += n;
+                min[0] = qMin(min[0], r);
+                max[0] = qMax(max[0], r);
+                min[1] = qMin(min[1], g);
+                max[1] = qMax(max[1], g);
+                min[2] = qMin(min[2], b);
+                max[2] = qMax(max[2], b);
+            }
+        }
+    }
+
+    if(box.count)
+    {
+        memcpy(box.min, min, sizeof(min));
+        memcpy(box.max, max, sizeof(max));
+    }
+}
+
+/**
+   @brief Find the closest palette colors for one red slice of the RGB666 lookup table
+ */
+class CColorLookup : public QRunnable
+{
+public:
+    CColorLookup(qint32 r, QVector<quint8>& lut, const QVector<GDALColorEntry>& colors)
+        : r(r), lut(lut), colors(colors)
+    {
+        setAutoDelete(true);
+    }
+
+    void run() override
+    {
+        const qint32 r8 = (r << 2) | 2;
+        for(qint32 g = 0; g < 64; g++)
+        {
+            const qint32 g8 = (g << 2) | 2;
+            for(qint32 b = 0; b < 64; b++)
+            {
+                const qint32 b8 = (b << 2) | 2;
+
+                qint32 best = 0;
+                qint32 dBest = INT_MAX;
+                for(qint32 i = 0; i < colors.size(); i++)
+                {
+                    const GDALColorEntry& c = colors[i];
+                    const qint32 d = (r8 - c.c1) * (r8 - c.c1) + (g8 - c.c2) * (g8 - c.c2) + (b8 - c.c3) * (b8 - c.c3);
+                    if(d < dBest)
+                    {
+                        dBest = d;
+                        best = i;
+                    }
+                }
+                lut[(r << 12) | (g << 6) | b] = best;
+            }
+        }
+    }
+
+private:
+    const qint32 r;
+    QVector<quint8>& lut;
+    const QVector<GDALColorEntry>& colors;
+};
+
+/**
+   @brief Dither a strip of pixels
+
+   Runs in it's own thread. All data is private to the strip but
+   the read only lookup table and color table.
+ */
+class CDitherStrip : public QRunnable
+{
+public:
+    CDitherStrip(QByteArray& src, QByteArray& tar, qint32 xsize, qint32 ysize, qint32 nBands, quint8 nodata, const QVector<quint8>& lut, const QVector<GDALColorEntry>& colors)
+        : src(src), tar(tar), xsize(xsize), ysize(ysize), nBands(nBands), nodata(nodata), lut(lut), colors(colors)
+    {
+        setAutoDelete(true);
+    }
+
+    void run() override
+    {
+        // error of the current and the next row, with one pixel margin on both sides
+        QVector<qint32> err1((xsize + 2) * 3, 0);
+        QVector<qint32> err2((xsize + 2) * 3, 0);
+
+        const quint8* pSrc = (const quint8*)src.constData();
+        quint8* pTar = (quint8*)tar.data();
+
+        for(qint32 y = 0; y < ysize; y++)
+        {
+            err2.fill(0);
+            for(qint32 x = 0; x < xsize; x++)
+            {
+                const quint8* pixel = pSrc + (y * xsize + x) * nBands;
+                if((nBands == 4) && (pixel[3] != 0xFF))
+                {
+                    pTar[y * xsize + x] = nodata;
+                    continue;
+                }
+
+                qint32* e = err1.data() + (x + 1) * 3;
+                const qint32 r = qBound(0, pixel[0] + e[0] / 16, 255);
+                const qint32 g = qBound(0, pixel[1] + e[1] / 16, 255);
+                const qint32 b = qBound(0, pixel[2] + e[2] / 16, 255);
+
+                const quint8 idx = lut[((r >> 2) << 12) | ((g >> 2) << 6) | (b >> 2)];
+                pTar[y * xsize + x] = idx;
+
+                const GDALColorEntry& c = colors[idx];
+                const qint32 d[3] = {r - c.c1, g - c.c2, b - c.c3};
+
+                qint32* e1 = e + 3;
+                qint32* e2 = err2.data() + x * 3;
+                for(int i = 0; i < 3; i++)
+                {
+                    e1[i] += d[i] * 7;
+                    e2[i] += d[i] * 3;
+                    e2[i + 3] += d[i] * 5;
+                    e2[i + 6] += d[i] * 1;
+                }
+            }
+            err1.swap(err2);
+        }
+    }
+
+private:
+    QByteArray& src;
+    QByteArray& tar;
+    const qint32 xsize;
+    const qint32 ysize;
+    const qint32 nBands;
+    const quint8 nodata;
+    const QVector<quint8>& lut;
+    const QVector<GDALColorEntry>& colors;
+};
+
 void printStdoutQString(const QString& str)
 {
     QByteArray array = str.toUtf8();
@@ -40,12 +213,13 @@ void printStderrQString(const QString& str)
 
 
 
-CApp::CApp(qint32 ncolors, const QString& pctFilename, const QString& sctFilename, const QString& srcFilename, const QString& tarFilename)
+CApp::CApp(qint32 ncolors, const QString& pctFilename, const QString& sctFilename, const QString& srcFilename, const QString& tarFilename, algorithm_e algorithm)
     : ncolors(ncolors)
     , pctFilename(pctFilename)
     , sctFilename(sctFilename)
     , srcFilename(srcFilename)
     , tarFilename(tarFilename)
+    , algorithm(algorithm)
 {
     GDALAllRegister();
 }
@@ -73,9 +247,9 @@ qint32 CApp::exec()
             QFile::remove(tarFilename);
         }
 
-        ct = createColorTable(ncolors, pctFilename, dsSrc);
+        ct = createColorTable(ncolors, pctFilename, dsSrc, algorithm);
         saveColorTable(ct, sctFilename);
-        ditherMap(dsSrc, tarFilename, ct);
+        ditherMap(dsSrc, tarFilename, ct, algorithm);
     }
     catch(const QString& msg)
     {
@@ -89,12 +263,19 @@ qint32 CApp::exec()
     return res;
 }
 
-GDALColorTable* CApp::createColorTable(qint32 ncolors, const QString& pctFilename, GDALDataset* dataset)
+GDALColorTable* CApp::createColorTable(qint32 ncolors, const QString& pctFilename, GDALDataset* dataset, algorithm_e algorithm)
 {
     GDALColorTable* ct = nullptr;
     try
     {
-        if(pctFilename.isEmpty())
+        if(pctFilename.isEmpty() && (algorithm == eAlgorithmFast))
+        {
+            ct = (GDALColorTable*)GDALCreateColorTable(GPI_RGB);
+
+            printStdoutQString(tr("Calculate optimal color table from sampled source file"));
+            computeMedianCutFast(ncolors, dataset, ct);
+        }
+        else if(pctFilename.isEmpty())
         {
             ct = (GDALColorTable*)GDALCreateColorTable(GPI_RGB);
 
@@ -177,7 +358,7 @@ void CApp::saveColorTable(GDALColorTable* ct, QString& sctFilename)
     GDALClose(dataset);
 }
 
-void CApp::ditherMap(GDALDataset* dsSrc, const QString& tarFilename, GDALColorTable* ct)
+void CApp::ditherMap(GDALDataset* dsSrc, const QString& tarFilename, GDALColorTable* ct, algorithm_e algorithm)
 {
     if(tarFilename.isEmpty())
     {
@@ -212,6 +393,15 @@ void CApp::ditherMap(GDALDataset* dsSrc, const QString& tarFilename, GDALColorTa
         dataset->SetGeoTransform(adfGeoTransform);
 
         printStdoutQString(tr("Dither source file to target file"));
+        if(algorithm == eAlgorithmFast)
+        {
+            // alpha is applied while dithering
+            ditherMapFast(dsSrc, dataset->GetRasterBand(1), ct);
+            dataset->FlushCache();
+            GDALClose(dataset);
+            return;
+        }
+
         int res = GDALDitherRGB2PCT(dsSrc->GetRasterBand(1),
                                     dsSrc->GetRasterBand(2),
                                     dsSrc->GetRasterBand(3),
@@ -278,3 +468,210 @@ void CApp::ditherMap(GDALDataset* dsSrc, const QString& tarFilename, GDALColorTa
     dataset->FlushCache();
     GDALClose(dataset);
 }
+
+void CApp::computeMedianCutFast(qint32 ncolors, GDALDataset* dataset, GDALColorTable* ct)
+{
+    const qint32 xsize = dataset->GetRasterXSize();
+    const qint32 ysize = dataset->GetRasterYSize();
+    const qint32 nBands = dataset->GetRasterCount();
+
+    // sample every n-th pixel of every n-th row
+    const qint32 step = qMax(1, qCeil(qSqrt(qreal(xsize) * ysize / MAX_SAMPLES)));
+
+    QVector<quint64> hist(32768, 0);
+    QVector<quint64> sum(32768 * 3, 0);
+
+    QByteArray buffer(xsize * nBands, 0);
+    int bandMap[4] = {1, 2, 3, 4};
+    for(qint32 y = 0; y < ysize; y += step)
+    {
+        GDALTermProgress(double(y) / ysize, 0, 0);
+        CPLErr res = dataset->RasterIO(GF_Read, 0, y, xsize, 1, buffer.data(), xsize, 1, GDT_Byte, nBands, bandMap, nBands, nBands * xsize, 1);
+        if(res != CE_None)
+        {
+            throw tr("Failed to read from source file.");
+        }
+
+        const quint8* pixel = (const quint8*)buffer.constData();
+        for(qint32 x = 0; x < xsize; x += step, pixel += step * nBands)
+        {
+            // transparent pixels will become no data
+            if((nBands == 4) && (pixel[3] != 0xFF))
+            {
+                continue;
+            }
+
+            const qint32 idx = histIndex(pixel[0] >> 3, pixel[1] >> 3, pixel[2] >> 3);
+            hist[idx]++;
+            sum[idx * 3] += pixel[0];
+            sum[idx * 3 + 1] += pixel[1];
+            sum[idx * 3 + 2] += pixel[2];
+        }
+    }
+
+    // median cut: split the box with most pixels along its longest axis
+    QList<box_t> boxes;
+    box_t box = {{0, 0, 0}, {31, 31, 31}, 0};
+    shrinkBox(box, hist);
+    if(box.count)
+    {
+        boxes << box;
+    }
+
+    while(boxes.size() < ncolors)
+    {
+        qint32 idxBox = -1;
+        for(qint32 i = 0; i < boxes.size(); i++)
+        {
+            const box_t& b = boxes[i];
+            const bool isSplittable = (b.min[0] < b.max[0]) || (b.min[1] < b.max[1]) || (b.min[2] < b.max[2]);
+            if(isSplittable && ((idxBox < 0) || (b.count > boxes[idxBox].count)))
+            {
+                idxBox = i;
+            }
+        }
+
+        if(idxBox < 0)
+        {
+            break;
+        }
+
+        box_t& b = boxes[idxBox];
+        qint32 axis = 0;
+        for(qint32 i = 1; i < 3; i++)
+        {
+            if((b.max[i] - b.min[i]) > (b.max[axis] - b.min[axis]))
+            {
+                axis = i;
+            }
+        }
+
+        // find the median slice along the axis
+        quint64 acc = 0;
+        qint32 median = b.min[axis];
+        for(qint32 v = b.min[axis]; v < b.max[axis]; v++)
+        {
+            box_t slice = b;
+            slice.min[axis] = slice.max[axis] = v;
+            shrinkBox(slice, hist);
+            acc += slice.count;
+            median = v;
+            if(acc >= (b.count / 2))
+            {
+                break;
+            }
+        }
+
+        box_t b1 = b;
+        box_t b2 = b;
+        b1.max[axis] = median;
+        b2.min[axis] = median + 1;
+        shrinkBox(b1, hist);
+        shrinkBox(b2, hist);
+
+        b = b1;
+        boxes << b2;
+    }
+
+    // the palette entries are the mean colors of the boxes
+    for(qint32 i = 0; i < boxes.size(); i++)
+    {
+        const box_t& b = boxes[i];
+        quint64 s[3] = {0, 0, 0};
+        for(qint32 r = b.min[0]; r <= b.max[0]; r++)
+        {
+            for(qint32 g = b.min[1]; g <= b.max[1]; g++)
+            {
+                for(qint32 bl = b.min[2]; bl <= b.max[2]; bl++)
+                {
+                    const qint32 idx = histIndex(r, g, bl);
+                    s[0] += sum[idx * 3];
+                    s[1] += sum[idx * 3 + 1];
+                    s[2] += sum[idx * 3 + 2];
+                }
+            }
+        }
+
+        GDALColorEntry entry;
+        entry.c1 = qRound(qreal(s[0]) / b.count);
+        entry.c2 = qRound(qreal(s[1]) / b.count);
+        entry.c3 = qRound(qreal(s[2]) / b.count);
+        entry.c4 = 255;
+        ct->SetColorEntry(i, &entry);
+    }
+
+    if(boxes.isEmpty())
+    {
+        // a completely transparent source
+        ct->SetColorEntry(0, &noColor);
+    }
+
+    GDALTermProgress(1.0, 0, 0);
+}
+
+void CApp::ditherMapFast(GDALDataset* dsSrc, GDALRasterBand* band, GDALColorTable* ct)
+{
+    const qint32 xsize = dsSrc->GetRasterXSize();
+    const qint32 ysize = dsSrc->GetRasterYSize();
+    const qint32 nBands = dsSrc->GetRasterCount();
+    const quint8 nodata = band->GetNoDataValue();
+
+    QVector<GDALColorEntry> colors(ct->GetColorEntryCount());
+    for(qint32 i = 0; i < colors.size(); i++)
+    {
+        colors[i] = *ct->GetColorEntry(i);
+    }
+
+    // lookup table of the closest palette color for RGB666 values
+    QVector<quint8> lut(1 << 18);
+    {
+        QThreadPool pool;
+        for(qint32 r = 0; r < 64; r++)
+        {
+            pool.start(new CColorLookup(r, lut, colors));
+        }
+        pool.waitForDone();
+    }
+
+    // read a batch of strips, dither them in parallel and write them in order
+    const qint32 batchSize = qMax(1, QThread::idealThreadCount());
+    QVector<QByteArray> src(batchSize);
+    QVector<QByteArray> tar(batchSize);
+
+    int bandMap[4] = {1, 2, 3, 4};
+    QThreadPool pool;
+    for(qint32 y0 = 0; y0 < ysize; y0 += batchSize * STRIP_HEIGHT)
+    {
+        GDALTermProgress(double(y0) / ysize, 0, 0);
+
+        qint32 nStrips = 0;
+        for(qint32 y = y0; (y < ysize) && (nStrips < batchSize); y += STRIP_HEIGHT, nStrips++)
+        {
+            const qint32 h = qMin(STRIP_HEIGHT, ysize - y);
+            src[nStrips].resize(xsize * h * nBands);
+            tar[nStrips].resize(xsize * h);
+
+            CPLErr res = dsSrc->RasterIO(GF_Read, 0, y, xsize, h, src[nStrips].data(), xsize, h, GDT_Byte, nBands, bandMap, nBands, nBands * xsize, 1);
+            if(res != CE_None)
+            {
+                throw tr("Failed to read from source file.");
+            }
+
+            pool.start(new CDitherStrip(src[nStrips], tar[nStrips], xsize, h, nBands, nodata, lut, colors));
+        }
+        pool.waitForDone();
+
+        for(qint32 i = 0; i < nStrips; i++)
+        {
+            const qint32 y = y0 + i * STRIP_HEIGHT;
+            const qint32 h = qMin(STRIP_HEIGHT, ysize - y);
+            CPLErr res = band->RasterIO(GF_Write, 0, y, xsize, h, tar[i].data(), xsize, h, GDT_Byte, 0, 0);
+            if(res != CE_None)
+            {
+                throw tr("Failed to write to target file.");
+            }
+        }
+    }
+
+    GDALTermProgress(1.0, 0, 0);
+}
@@ -29,21 +29,49 @@ class CApp
 {
     Q_DECLARE_TR_FUNCTIONS(CApp)
 public:
-    CApp(qint32 ncolors, const QString& pctFilename, const QString& sctFilename, const QString& srcFilename, const QString& tarFilename);
+    enum algorithm_e
+    {
+        eAlgorithmGdal      ///< GDAL's median cut and dithering
+        , eAlgorithmFast    ///< sampled histogram median cut and parallel dithering
+    };
+
+    CApp(qint32 ncolors, const QString& pctFilename, const QString& sctFilename, const QString& srcFilename, const QString& tarFilename, algorithm_e algorithm);
     virtual ~CApp() = default;
 
     qint32 exec();
 
 private:
-    static GDALColorTable* createColorTable(qint32 ncolors, const QString& pctFilename, GDALDataset* dataset);
+    static GDALColorTable* createColorTable(qint32 ncolors, const QString& pctFilename, GDALDataset* dataset, algorithm_e algorithm);
     static void saveColorTable(GDALColorTable* ct, QString& sctFilename);
-    static void ditherMap(GDALDataset* dsSrc, const QString& tarFilename, GDALColorTable* ct);
+    static void ditherMap(GDALDataset* dsSrc, const QString& tarFilename, GDALColorTable* ct, algorithm_e algorithm);
+
+    /**
+       @brief Calculate a color table by median cut on a histogram of sampled pixels
+
+       @param ncolors   the maximum number of colors
+       @param dataset   the RGB(A) source
+       @param ct        the color table to fill
+     */
+    static void computeMedianCutFast(qint32 ncolors, GDALDataset* dataset, GDALColorTable* ct);
+
+    /**
+       @brief Dither the source into the target with Floyd-Steinberg error diffusion
+
+       The raster is split into horizontal strips that are dithered in parallel.
+       Pixels that are not fully opaque are set to the target's no data value.
+
+       @param dsSrc     the RGB(A) source
+       @param band      the target band
+       @param ct        the color table of the target
+     */
+    static void ditherMapFast(GDALDataset* dsSrc, GDALRasterBand* band, GDALColorTable* ct);
 
     qint32 ncolors = 0;
     QString pctFilename;
     QString sctFilename;
     QString srcFilename;
     QString tarFilename;
+    algorithm_e algorithm;
 
     static const GDALColorEntry noColor;
 };
@@ -108,6 +108,9 @@ int main(int argc, char** argv)
         {
             {"s", "sct"}, QCoreApplication::translate("main", "Save color table to palette file (*.vrt)"), "filename", ""
         },
+        {
+            {"a", "algorithm"}, QCoreApplication::translate("main", "Algorithm for color table and dithering: 'gdal' or 'fast'. The fast algorithm samples the source for the color table and dithers in parallel. (default: gdal)"), "name", "gdal"
+        },
     });
 
     // Process the actual command line arguments given by the user
@@ -147,7 +150,21 @@ int main(int argc, char** argv)
     QString pctFilename = parser.value("pct");
     QString sctFilename = parser.value("sct");
 
-    CApp theApp(ncolors, pctFilename, sctFilename, srcFilename, tarFilename);
+    CApp::algorithm_e algorithm = CApp::eAlgorithmGdal;
+    const QString& algorithmName = parser.value("algorithm").toLower();
+    if(algorithmName == "fast")
+    {
+        algorithm = CApp::eAlgorithmFast;
+    }
+    else if(algorithmName != "gdal")
+    {
+        printStderrQString("");
+        printStderrQString(QCoreApplication::translate("main", "--algorithm must be 'gdal' or 'fast'"));
+        printStderrQString("");
+        parser.showHelp(-1);
+    }
+
+    CApp theApp(ncolors, pctFilename, sctFilename, srcFilename, tarFilename, algorithm);
     return theApp.exec();
 }
 
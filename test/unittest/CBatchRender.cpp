@@ -0,0 +1,178 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "canvas/CCanvas.h"
+#include "gis/proj_x.h"
+#include "map/CMapDraw.h"
+#include "print/CBatchRender.h"
+
+#include <QtWidgets>
+
+static void writeJobFile(const QString& filename, const QString& content)
+{
+    QFile file(filename);
+    file.open(QIODevice::WriteOnly);
+    file.write(content.toUtf8());
+}
+
+static QString readJobsError(const QString& filename)
+{
+    try
+    {
+        CBatchRender::readJobs(filename);
+    }
+    catch(const QString& msg)
+    {
+        return msg;
+    }
+    return QString();
+}
+
+void test_QMapShack::_readRenderJobs()
+{
+    QTemporaryDir dir;
+    const QString& filename = dir.filePath("jobs.ini");
+
+    writeJobFile(dir.filePath("test.view"), "[map]\n");
+    writeJobFile(filename,
+                 "[b_detail]\n"
+                 "view=test.view\n"
+                 "area=11.30,47.30,11.45,47.22\n"
+                 "zoom=3\n"
+                 "output=out/detail.tif\n"
+                 "[a_overview]\n"
+                 "area=\"10.5, 47.8, 12.0, 46.9\"\n"
+                 "size=2000x1500\n"
+                 "output=overview.png\n"
+                 );
+
+    QList<CBatchRender::job_t> jobs;
+    try
+    {
+        jobs = CBatchRender::readJobs(filename);
+    }
+    catch(const QString& msg)
+    {
+        SUBVERIFY(false, "Failed to read job file: " + msg);
+    }
+
+    VERIFY_EQUAL(2, jobs.size());
+
+    const CBatchRender::job_t& job1 = jobs[0];
+    VERIFY_EQUAL(QString("a_overview"), job1.name);
+    SUBVERIFY(job1.view.isEmpty(), "Job has a view");
+    SUBVERIFY(job1.area == QRectF(QPointF(10.5, 47.8), QPointF(12.0, 46.9)), "Bad area");
+    VERIFY_EQUAL(-1, job1.zoom);
+    SUBVERIFY(job1.size == QSize(2000, 1500), "Bad size");
+    VERIFY_EQUAL(dir.filePath("overview.png"), job1.output);
+
+    const CBatchRender::job_t& job2 = jobs[1];
+    VERIFY_EQUAL(QString("b_detail"), job2.name);
+    VERIFY_EQUAL(dir.filePath("test.view"), job2.view);
+    VERIFY_EQUAL(3, job2.zoom);
+    SUBVERIFY(!job2.size.isValid(), "Size is valid");
+    VERIFY_EQUAL(dir.filePath("out/detail.tif"), job2.output);
+
+    // invalid jobs
+    writeJobFile(filename, "[job]\narea=10,47,11\nzoom=3\noutput=a.png\n");
+    SUBVERIFY(!readJobsError(filename).isEmpty(), "Area with 3 values accepted");
+
+    writeJobFile(filename, "[job]\narea=11,47,10,46\nzoom=3\noutput=a.png\n");
+    SUBVERIFY(!readJobsError(filename).isEmpty(), "Empty area accepted");
+
+    writeJobFile(filename, "[job]\narea=10,47,11,46\noutput=a.png\n");
+    SUBVERIFY(!readJobsError(filename).isEmpty(), "Job without zoom and size accepted");
+
+    writeJobFile(filename, "[job]\narea=10,47,11,46\nsize=100\noutput=a.png\n");
+    SUBVERIFY(!readJobsError(filename).isEmpty(), "Bad size accepted");
+
+    writeJobFile(filename, "[job]\nview=missing.view\narea=10,47,11,46\nzoom=3\noutput=a.png\n");
+    SUBVERIFY(!readJobsError(filename).isEmpty(), "Missing view file accepted");
+
+    writeJobFile(filename, "[job]\narea=10,47,11,46\nzoom=3\n");
+    SUBVERIFY(!readJobsError(filename).isEmpty(), "Job without output accepted");
+
+    SUBVERIFY(!readJobsError(dir.filePath("missing.ini")).isEmpty(), "Missing job file accepted");
+}
+
+void test_QMapShack::_renderJob()
+{
+    createMainWindow();
+
+    QTemporaryDir dir;
+    SUBVERIFY(dir.isValid(), "Failed to create temporary directory");
+
+    const QPointF origin(1224000, 6340000);
+    const qreal pxSize = 100;
+    const QSize sizeMap(256, 256);
+    const QString& filename = TestHelper::createMap(dir.path(), origin, pxSize, sizeMap);
+
+    // the view restores the map from the map paths by its key
+    const QStringList mapPaths = CMapDraw::getMapPaths();
+    CMapDraw::setupMapPath(dir.path());
+    {
+        QSettings view(dir.filePath("test.view"), QSettings::IniFormat);
+        view.setValue("proj", "EPSG:3857");
+
+        CCanvas canvas(nullptr, "view");
+        canvas.loadConfig(view);
+        canvas.setMap(filename);
+        canvas.saveConfig(view);
+    }
+
+    const QPointF pt1 = TestHelper::merc2rad(origin) * RAD_TO_DEG;
+    const QPointF pt2 = TestHelper::merc2rad(origin + QPointF(sizeMap.width(), -sizeMap.height()) * pxSize) * RAD_TO_DEG;
+    const QString& jobs = dir.filePath("jobs.ini");
+    writeJobFile(jobs, QString("[job]\n"
+                               "view=test.view\n"
+                               "area=%1,%2,%3,%4\n"
+                               "size=300x200\n"
+                               "output=out.png\n")
+                 .arg(pt1.x(), 0, 'f', 8).arg(pt1.y(), 0, 'f', 8)
+                 .arg(pt2.x(), 0, 'f', 8).arg(pt2.y(), 0, 'f', 8));
+
+    // GIS files that can't be loaded abort the batch
+    writeJobFile(dir.filePath("test.txt"), "no GIS data\n");
+    const int resMissing = CBatchRender::exec(jobs, {dir.filePath("missing.gpx")});
+    const int resUnsupported = CBatchRender::exec(jobs, {dir.filePath("test.txt")});
+    const bool isRendered = QFileInfo(dir.filePath("out.png")).exists();
+
+    const int res = CBatchRender::exec(jobs, {});
+    CMapDraw::setupMapPath(mapPaths);
+
+    VERIFY_EQUAL(1, resMissing);
+    VERIFY_EQUAL(1, resUnsupported);
+    SUBVERIFY(!isRendered, "Job rendered after load error");
+    VERIFY_EQUAL(0, res);
+
+    QImage img(dir.filePath("out.png"));
+    SUBVERIFY(!img.isNull(), "Failed to read output file");
+    SUBVERIFY(img.size() == QSize(300, 200), "Bad image size");
+
+    // the area's center is the map's center with the color (128, 128, 128)
+    const QRgb center = img.pixel(150, 100);
+    VERIFY_EQUAL(255, qAlpha(center));
+    SUBVERIFY(qAbs(qRed(center) - 128) <= 8 && qAbs(qGreen(center) - 128) <= 8 && qAbs(qBlue(center) - 128) <= 8,
+              QString("Bad color at center: %1").arg(center, 8, 16, QChar('0')));
+
+    // the gradient runs from top left to bottom right
+    SUBVERIFY(qGray(img.pixel(120, 70)) < qGray(center) && qGray(center) < qGray(img.pixel(180, 130)), "No gradient");
+}
@@ -0,0 +1,148 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "canvas/CCanvas.h"
+#include "gis/CGisWorkspace.h"
+#include "gis/prj/IGisProject.h"
+#include "gis/proj_x.h"
+
+#include <QtWidgets>
+
+void test_QMapShack::_printTiled()
+{
+    createMainWindow();
+
+    QTemporaryDir dir;
+    SUBVERIFY(dir.isValid(), "Failed to create temporary directory");
+
+    const QPointF origin(1224000, 6340000);
+    const qreal pxSize = 100;
+    const QSize sizeMap(256, 256);
+    const QString& filename = TestHelper::createMap(dir.path(), origin, pxSize, sizeMap);
+
+    // the grid's labels are placed at the area's border
+    QAction* actionShowGrid = mainWindow->findChild<QAction*>("actionShowGrid");
+    SUBVERIFY(actionShowGrid != nullptr, "No grid action");
+    const bool isGridVisible = actionShowGrid->isChecked();
+    actionShowGrid->setChecked(true);
+
+    QSettings cfg(dir.filePath("view.ini"), QSettings::IniFormat);
+    cfg.setValue("proj", "EPSG:3857");
+
+    CCanvas canvas(nullptr, "print");
+    canvas.resize(400, 300);
+    canvas.loadConfig(cfg);
+    canvas.setMap(filename);
+
+    const QPointF pt1 = TestHelper::merc2rad(origin);
+    const QPointF pt2 = TestHelper::merc2rad(origin + QPointF(sizeMap.width(), -sizeMap.height()) * pxSize);
+    const QRectF area(pt1, pt2);
+    const QSize size(600, 400);
+    canvas.zoomTo(area, size);
+
+    auto print = [&](qint32 tileSize)
+    {
+        QImage img(size, QImage::Format_ARGB32);
+        img.fill(Qt::transparent);
+        canvas.print(size, area.center(), [&img](const QImage& tile, const QPoint& pos)
+        {
+            QPainter p(&img);
+            p.setCompositionMode(QPainter::CompositionMode_Source);
+            p.drawImage(pos, tile);
+        }, true, tileSize);
+        return img;
+    };
+
+    // a waypoint at x = 250 with a long label crossing the border of the tiles at x = 256
+    QPointF pos = area.center();
+    canvas.convertRad2Px(pos);
+    pos += QPointF(250 - size.width() / 2, 120 - size.height() / 2);
+    canvas.convertPx2Rad(pos);
+    pos *= RAD_TO_DEG;
+
+    const QString& filenameGpx = dir.filePath("label.gpx");
+    QFile fileGpx(filenameGpx);
+    fileGpx.open(QIODevice::WriteOnly);
+    fileGpx.write(QString("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                          "<gpx version=\"1.1\" creator=\"test\" xmlns=\"http://www.topografix.com/GPX/1/1\">\n"
+                          "<wpt lat=\"%1\" lon=\"%2\"><name>A waypoint label across the border of two tiles</name></wpt>\n"
+                          "</gpx>\n").arg(pos.y(), 0, 'f', 8).arg(pos.x(), 0, 'f', 8).toUtf8());
+    fileGpx.close();
+
+    const QImage& without = print(128);
+
+    IGisProject* project = nullptr;
+    try
+    {
+        project = CGisWorkspace::self().loadGisProjectQuiet(filenameGpx);
+    }
+    catch(const QString& msg)
+    {
+        actionShowGrid->setChecked(isGridVisible);
+        SUBVERIFY(false, "Failed to load waypoint: " + msg);
+    }
+
+    const QImage& single = print(1024);
+    const QImage& tiled = print(128);
+
+    delete project;
+    actionShowGrid->setChecked(isGridVisible);
+
+    // the map is drawn at all
+    VERIFY_EQUAL(255, qAlpha(single.pixel(size.width() / 2, size.height() / 2)));
+
+    // the label is drawn on both tiles, left and right of the waypoint's icon
+    auto countLabelPixels = [&](int x1, int x2)
+    {
+        qint32 cnt = 0;
+        for(int y = 0; y < 128; y++)
+        {
+            for(int x = x1; x < x2; x++)
+            {
+                if(qGray(without.pixel(x, y)) != qGray(tiled.pixel(x, y)))
+                {
+                    cnt++;
+                }
+            }
+        }
+        return cnt;
+    };
+    SUBVERIFY(countLabelPixels(200, 230) > 0, "No label left of the tile border");
+    SUBVERIFY(countLabelPixels(280, 310) > 0, "No label right of the tile border");
+
+    // allow for rounding when the map is resampled for each tile
+    qint32 cntDiff = 0;
+    for(int y = 0; y < size.height(); y++)
+    {
+        for(int x = 0; x < size.width(); x++)
+        {
+            const QRgb rgb1 = single.pixel(x, y);
+            const QRgb rgb2 = tiled.pixel(x, y);
+            const int diff = qMax(qMax(qAbs(qRed(rgb1) - qRed(rgb2)), qAbs(qGreen(rgb1) - qGreen(rgb2))),
+                                  qMax(qAbs(qBlue(rgb1) - qBlue(rgb2)), qAbs(qAlpha(rgb1) - qAlpha(rgb2))));
+            if(diff > 8)
+            {
+                cntDiff++;
+            }
+        }
+    }
+    VERIFY_EQUAL(0, cntDiff);
+}
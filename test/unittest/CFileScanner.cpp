@@ -0,0 +1,83 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "helpers/CFileScanner.h"
+
+#include <QtCore>
+
+static void writeFile(const QDir& dir, const QString& name, const QByteArray& data)
+{
+    QFile f(dir.absoluteFilePath(name));
+    f.open(QIODevice::WriteOnly);
+    f.write(data);
+    f.close();
+}
+
+void test_QMapShack::_scanMapFiles()
+{
+    QTemporaryDir dir1;
+    QTemporaryDir dir2;
+
+    const int N = 120;
+    for(int n = 0; n < N; n++)
+    {
+        writeFile(dir1.path(), QString("map%1.img").arg(n, 3, 10, QChar('0')), QByteArray(8192, char(n)));
+    }
+    writeFile(dir1.path(), "readme.txt", "not a map");
+    writeFile(dir2.path(), "small.vrt", "<VRTDataset/>");
+
+    const QStringList& filters = QString("*.img|*.vrt").split('|');
+
+    CFileScanner scanner(0x1000, nullptr);
+    qint32 cntSignals = 0;
+    QObject::connect(&scanner, &CFileScanner::sigFilesFound, &scanner, [&cntSignals](){ cntSignals++; });
+
+    scanner.scan({dir1.path(), dir2.path()}, filters);
+    scanner.waitForComplete();
+    QCoreApplication::processEvents();
+
+    SUBVERIFY(scanner.isComplete(), "Scan not complete");
+    SUBVERIFY(cntSignals > 1, "Files not reported in batches");
+
+    const QList<CFileScanner::file_t>& files = scanner.getFiles(0);
+    VERIFY_EQUAL(N + 1, files.size());
+    VERIFY_EQUAL(QDir(dir1.path()).absoluteFilePath("map000.img"), files.first().filename);
+    VERIFY_EQUAL(QDir(dir2.path()).absoluteFilePath("small.vrt"), files.last().filename);
+
+    // the key is the MD5 hash over the first 4k only
+    const QByteArray& hash = QCryptographicHash::hash(QByteArray(0x1000, char(5)), QCryptographicHash::Md5).toHex();
+    VERIFY_EQUAL(QString(hash), files[5].key);
+    VERIFY_EQUAL(files[5].key, CFileScanner::calcKey(files[5].filename, 0x1000));
+
+    // small files are hashed completely
+    const QByteArray& hashSmall = QCryptographicHash::hash("<VRTDataset/>", QCryptographicHash::Md5).toHex();
+    VERIFY_EQUAL(QString(hashSmall), files.last().key);
+
+    // consumers query new files only
+    VERIFY_EQUAL(1, scanner.getFiles(N).size());
+    VERIFY_EQUAL(0, scanner.getFiles(N + 1).size());
+
+    // a new scan drops all previous results
+    scanner.scan({dir2.path()}, filters);
+    scanner.waitForComplete();
+    SUBVERIFY(scanner.isComplete(), "Rescan not complete");
+    VERIFY_EQUAL(1, scanner.getFiles(0).size());
+}
@@ -0,0 +1,88 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "map/garmin/CGarminPickIndex.h"
+
+#include <QtCore>
+
+void test_QMapShack::_findInPickIndex()
+{
+    CGarminPickIndex index(32);
+    const QRectF area(-100, -50, 800, 600);
+
+    // a random set of short polylines, some of them reaching far outside the area
+    quint32 seed = 1;
+    auto random = [&seed](int max)
+    {
+        seed = (seed * 1103515245 + 12345) & 0x7FFFFFFF;
+        return qreal(seed % max);
+    };
+
+    QVector<QPolygonF> lines;
+    for(int i = 0; i < 200; i++)
+    {
+        QPolygonF line;
+        QPointF pt(random(1400) - 400, random(1200) - 350);
+        for(int n = 0; n < 5; n++)
+        {
+            line << pt;
+            pt += QPointF(random(81) - 40, random(81) - 40);
+        }
+        lines << line;
+    }
+
+    index.reset(area);
+    for(int i = 0; i < lines.size(); i++)
+    {
+        index.insertSegments(lines[i], i);
+    }
+
+    // every segment touching the query must be found, in ascending order
+    QVector<quint64> ids;
+    for(int n = 0; n < 500; n++)
+    {
+        const QRectF query(random(1400) - 400, random(1200) - 350, random(60), random(60));
+        index.find(query, ids);
+
+        SUBVERIFY(std::is_sorted(ids.begin(), ids.end()), "Ids are not sorted");
+        SUBVERIFY(std::adjacent_find(ids.begin(), ids.end()) == ids.end(), "Ids are not unique");
+
+        for(int i = 0; i < lines.size(); i++)
+        {
+            for(int s = 1; s < lines[i].size(); s++)
+            {
+                const QRectF bbox = QRectF(lines[i][s - 1], lines[i][s]).normalized();
+                const bool touches = bbox.left() <= query.right() && query.left() <= bbox.right()
+                                     && bbox.top() <= query.bottom() && query.top() <= bbox.bottom();
+                if(touches)
+                {
+                    const quint64 id = CGarminPickIndex::makeId(i, s);
+                    SUBVERIFY(std::binary_search(ids.begin(), ids.end(), id), QString("Segment %1/%2 not found").arg(i).arg(s));
+                }
+            }
+        }
+    }
+
+    // a cleared index finds nothing
+    index.clear();
+    index.find(area, ids);
+    SUBVERIFY(ids.isEmpty(), "Cleared index returned objects");
+}
@@ -23,6 +23,81 @@
 #include "gis/trk/CGisItemTrk.h"
 
 #include <QtCore>
+#include <QtMath>
+
+// the all pairs implementation as used by CGisItemTrk::filterLoopsCut() before
+static QList<QPair<qint32, qint32> > getLoopsCutReference(const CTrackData& trk, qreal minLoopLength)
+{
+    QList<QPair<qint32, qint32> > parts;
+    QVector<CTrackData::trkpt_t> pts;
+
+    for (const CTrackData::trkpt_t& headPt : trk)
+    {
+        if(headPt.isHidden())
+        {
+            continue;
+        }
+
+        pts << headPt;
+
+        if (pts.size() >= 4)
+        {
+            const QLineF headLine = QLineF(headPt.lon, headPt.lat, pts[pts.size() - 2].lon, pts[pts.size() - 2].lat);
+
+            bool firstCycle = true;
+            CTrackData::trkpt_t prevScannedPt;
+            for (const CTrackData::trkpt_t& scannedPt : qAsConst(pts))
+            {
+                if (scannedPt.idxTotal == pts[pts.size() - 2].idxTotal)
+                {
+                    break;
+                }
+
+                if (firstCycle)
+                {
+                    prevScannedPt = scannedPt;
+                    firstCycle = false;
+                    continue;
+                }
+
+                const QLineF scannedLine = QLineF(scannedPt.lon, scannedPt.lat, prevScannedPt.lon, prevScannedPt.lat);
+                QPointF intersectionPoint;
+
+                if ( ( headLine.intersect(scannedLine, &intersectionPoint) == QLineF::BoundedIntersection)
+                     &&
+                     (pts[pts.size() - 2].distance - scannedPt.distance) > minLoopLength)
+                {
+                    parts << qMakePair(pts.first().idxTotal, pts[pts.size() - 2].idxTotal);
+                    pts.remove(0, pts.size() - 2);
+
+                    break;
+                }
+
+                prevScannedPt = scannedPt;
+            }
+        }
+    }
+
+    if(!pts.isEmpty())
+    {
+        parts << qMakePair(pts.first().idxTotal, pts.last().idxTotal);
+    }
+
+    return parts;
+}
+
+static void verifyLoopsCut(const CGisItemTrk& trk)
+{
+    for(qreal minLoopLength : {0.0, 50.0, 500.0, 5000.0})
+    {
+        QList<QPair<qint32, qint32> > parts;
+        trk.filterGetLoopsCut(minLoopLength, parts);
+
+        const QList<QPair<qint32, qint32> >& expected = getLoopsCutReference(trk.getTrackData(), minLoopLength);
+        VERIFY_EQUAL(expected.size(), parts.size());
+        SUBVERIFY(expected == parts, QString("Parts of track `%1` differ for a minimum loop length of %2").arg(trk.getName()).arg(minLoopLength));
+    }
+}
 
 void test_QMapShack::_filterDeleteExtension()
 {
@@ -54,3 +129,44 @@ void test_QMapShack::_filterDeleteExtension()
     }
 }
 
+
+void test_QMapShack::_filterLoopsCut()
+{
+    for(const QString &file : inputFiles)
+    {
+        IGisProject *proj = readProjFile(file);
+
+        for(int i = 0; i < proj->childCount(); i++)
+        {
+            CGisItemTrk *trk = dynamic_cast<CGisItemTrk*>(proj->child(i));
+            if(nullptr != trk)
+            {
+                verifyLoopsCut(*trk);
+            }
+        }
+
+        delete proj;
+    }
+
+    // a noisy track of several laps on different circles, with a few jumps
+    CTrackData data;
+    data.name = "laps";
+    data.segs.resize(1);
+    QVector<CTrackData::trkpt_t>& pts = data.segs[0].pts;
+    const qint32 N = 6000;
+    for(qint32 n = 0; n < N; n++)
+    {
+        const qreal a = n * 2 * M_PI / (n < N / 2 ? 120 : 400);
+        CTrackData::trkpt_t pt;
+        pt.lon = 8.0 + 0.01 * qCos(a) + 0.0005 * qSin(n * 12.9898);
+        pt.lat = 50.0 + 0.01 * qSin(a) + 0.0005 * qSin(n * 78.233);
+        if((n % 997) == 0)
+        {
+            pt.lon += 0.5;
+        }
+        pts << pt;
+    }
+
+    CGisItemTrk trk(data, nullptr);
+    verifyLoopsCut(trk);
+}
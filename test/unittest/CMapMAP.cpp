@@ -0,0 +1,172 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "gis/proj_x.h"
+#include "map/CMapMAP.h"
+
+#include <QtCore>
+
+static void writeVbeU(QByteArray& data, quint64 val)
+{
+    while(val >= 0x80)
+    {
+        data += char((val & 0x7F) | 0x80);
+        val >>= 7;
+    }
+    data += char(val);
+}
+
+static void writeVbeS(QByteArray& data, qint64 val)
+{
+    const bool negative = val < 0;
+    quint64 abs = negative ? -val : val;
+    while(abs >= 0x40)
+    {
+        data += char((abs & 0x7F) | 0x80);
+        abs >>= 7;
+    }
+    data += char(abs | (negative ? 0x40 : 0x00));
+}
+
+static void writeUtf8(QByteArray& data, const QString& str)
+{
+    const QByteArray& utf8 = str.toUtf8();
+    writeVbeU(data, utf8.size());
+    data += utf8;
+}
+
+/// a way with a single coordinate block, the nodes are lat/lon pairs in [µ°]
+static QByteArray createWay(const QList<qint32>& nodes, bool doubleDelta)
+{
+    QByteArray way;
+    QDataStream stream(&way, QIODevice::WriteOnly);
+    stream << quint16(0xFFFF);                  // sub tile bitmap
+    stream << quint8((5 << 4) | 1);             // OSM layer 0, one tag
+
+    writeVbeU(way, 0);                          // tag "highway=primary"
+    way += char(doubleDelta ? 0x04 : 0x00);     // flags
+    writeVbeU(way, 1);                          // number of coordinate blocks
+    writeVbeU(way, nodes.size() / 2);
+    for(qint32 val : nodes)
+    {
+        writeVbeS(way, val);
+    }
+
+    QByteArray data;
+    writeVbeU(data, way.size());
+    return data + way;
+}
+
+static QByteArray createHeader(quint64 offsetSubFile, quint64 sizeSubFile)
+{
+    QByteArray header;
+    QDataStream stream(&header, QIODevice::WriteOnly);
+    stream.writeRawData("mapsforge binary OSM", 20);
+    stream << quint32(0) << quint32(5);         // header size, version
+    stream << quint64(0) << quint64(0);         // file size, timestamp
+    stream << qint32(5000) << qint32(5000) << qint32(10000) << qint32(10000);
+    stream << quint16(256);
+
+    QByteArray tmp;
+    writeUtf8(tmp, "Mercator");
+    tmp += char(0);                             // flags
+    stream.writeRawData(tmp.constData(), tmp.size());
+
+    stream << quint16(0);                       // POI tags
+    stream << quint16(1);                       // way tags
+    tmp.clear();
+    writeUtf8(tmp, "highway=primary");
+    stream.writeRawData(tmp.constData(), tmp.size());
+
+    stream << quint8(1);                        // one sub-file with zoom levels 12..14
+    stream << quint8(14) << quint8(12) << quint8(14);
+    stream << offsetSubFile << sizeSubFile;
+    return header;
+}
+
+static bool comparePolygon(const QPolygonF& line, const QList<qint32>& nodes, qreal lon0, qreal lat0)
+{
+    if(line.size() != nodes.size() / 2)
+    {
+        return false;
+    }
+
+    for(int i = 0; i < line.size(); i++)
+    {
+        const QPointF pt((lon0 + nodes[i * 2 + 1] / 1e6) * DEG_TO_RAD, (lat0 + nodes[i * 2] / 1e6) * DEG_TO_RAD);
+        if((qAbs(pt.x() - line[i].x()) > 1e-12) || (qAbs(pt.y() - line[i].y()) > 1e-12))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void test_QMapShack::_decodeMapsforgeTile()
+{
+    // one tile at zoom level 14 with one way in each row of the zoom table
+    QByteArray tile;
+    for(int z = 12; z <= 14; z++)
+    {
+        writeVbeU(tile, 0);     // POIs
+        writeVbeU(tile, 1);     // ways
+    }
+    writeVbeU(tile, 0);         // offset to first way
+    tile += createWay({1000, 2000, 100, 200, 100, 200}, false);
+    tile += createWay({1000, 2000, 100, 200, 50, -100, 0, 0}, true);
+    tile += createWay({-3000, 3000, -10, 10}, false);
+
+    // the tile index with a single entry is followed by the tile
+    QByteArray subFile = QByteArray::fromHex("0000000005") + tile;
+
+    const int sizeHeader = createHeader(0, 0).size();
+    QTemporaryDir dir;
+    const QString& filename = dir.filePath("test.map");
+    {
+        QFile file(filename);
+        SUBVERIFY(file.open(QIODevice::WriteOnly), "Failed to write map");
+        file.write(createHeader(sizeHeader, subFile.size()) + subFile);
+    }
+
+    CMapMAP map(filename, nullptr);
+    SUBVERIFY(map.activated(), "Failed to open map");
+
+    // the tile's top left corner
+    const qint32 x = 8192;
+    const qint32 y = 8191;
+    const qreal n = M_PI - 2.0 * M_PI * y / qreal(1 << 14);
+    const qreal lat0 = RAD_TO_DEG * qAtan(0.5 * (qExp(n) - qExp(-n)));
+    const qreal lon0 = 0;
+
+    // the zoom table is cumulative
+    for(int z = 12; z <= 14; z++)
+    {
+        CMapMAP::tile_t decoded;
+        map.getTile(0, x, y, z, decoded);
+        VERIFY_EQUAL(z - 11, decoded.ways.size());
+    }
+
+    CMapMAP::tile_t decoded;
+    map.getTile(0, x, y, 14, decoded);
+    SUBVERIFY(comparePolygon(decoded.ways[0].polygons.first(), {1000, 2000, 1100, 2200, 1200, 2400}, lon0, lat0), "Bad single delta way");
+    SUBVERIFY(comparePolygon(decoded.ways[1].polygons.first(), {1000, 2000, 1100, 2200, 1250, 2300, 1400, 2400}, lon0, lat0), "Bad double delta way");
+    SUBVERIFY(comparePolygon(decoded.ways[2].polygons.first(), {-3000, 3000, -3010, 3010}, lon0, lat0), "Bad way with negative offsets");
+}
@@ -0,0 +1,122 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "plot/CPlotEnvelope.h"
+
+#include <QtCore>
+
+struct column_t
+{
+    int first;
+    int last;
+    int min;
+    int max;
+};
+
+static QMap<int, column_t> getColumns(const QPolygonF& line)
+{
+    QMap<int, column_t> columns;
+    for(const QPointF& pt : line)
+    {
+        const int x = pt.x();
+        const int y = pt.y();
+        if(!columns.contains(x))
+        {
+            columns[x] = {y, y, y, y};
+            continue;
+        }
+
+        column_t& column = columns[x];
+        column.last = y;
+        column.min = qMin(column.min, y);
+        column.max = qMax(column.max, y);
+    }
+    return columns;
+}
+
+void test_QMapShack::_reducePlotToEnvelope()
+{
+    // a long noisy series with a few spikes, about 400 points per pixel column
+    const int N = 200000;
+    const int width = 500;
+
+    qsrand(4711);
+    QPolygonF series;
+    for(int i = 0; i < N; i++)
+    {
+        int y = 200 + 100 * qSin(i * 0.0005) + (qrand() % 21) - 10;
+        if((i % 9973) == 0)
+        {
+            y = (i % 2) ? 0 : 400;
+        }
+        series << QPointF((i * width) / N, y);
+    }
+
+    QPolygonF reduced;
+    {
+        CPlotEnvelope envelope(reduced);
+        envelope.append(QPointF(0, 400));
+        for(const QPointF& pt : qAsConst(series))
+        {
+            envelope.add(pt.x(), pt.y());
+        }
+        envelope.append(QPointF(width - 1, 400));
+    }
+
+    // the base points must not be touched
+    SUBVERIFY(reduced.first() == QPointF(0, 400), "First base point lost");
+    SUBVERIFY(reduced.last() == QPointF(width - 1, 400), "Last base point lost");
+    reduced.pop_front();
+    reduced.pop_back();
+
+    SUBVERIFY(reduced.size() <= 4 * width, QString("Too many points left: %1").arg(reduced.size()));
+
+    for(int i = 1; i < reduced.size(); i++)
+    {
+        SUBVERIFY(reduced[i - 1].x() <= reduced[i].x(), "Points out of order");
+    }
+
+    // every column keeps it's extrema and the points connecting it to it's neighbours
+    const QMap<int, column_t>& expected = getColumns(series);
+    const QMap<int, column_t>& actual = getColumns(reduced);
+    VERIFY_EQUAL(expected.size(), actual.size());
+
+    for(int x : expected.keys())
+    {
+        SUBVERIFY(actual.contains(x), QString("Column %1 lost").arg(x));
+        const column_t& exp = expected[x];
+        const column_t& act = actual[x];
+        VERIFY_EQUAL(exp.first, act.first);
+        VERIFY_EQUAL(exp.last, act.last);
+        VERIFY_EQUAL(exp.min, act.min);
+        VERIFY_EQUAL(exp.max, act.max);
+    }
+
+    // a column of a single point stays a single point
+    QPolygonF single;
+    {
+        CPlotEnvelope envelope(single);
+        envelope.add(10, 20);
+        envelope.add(11, 30);
+    }
+    VERIFY_EQUAL(2, single.size());
+}
+
@@ -0,0 +1,105 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include <gdal_priv.h>
+#include <ogr_spatialref.h>
+#include <QtCore>
+
+/// create a RGB GeoTIFF with a pattern that compresses differently from tile to tile
+static void createTestRaster(const QString& filename, int width, int height)
+{
+    GDALDriver* driver = GetGDALDriverManager()->GetDriverByName("GTiff");
+    SUBVERIFY(nullptr != driver, "GDAL has no GTiff driver");
+
+    GDALDataset* dataset = driver->Create(filename.toUtf8(), width, height, 3, GDT_Byte, nullptr);
+    SUBVERIFY(nullptr != dataset, "Failed to create " + filename);
+
+    double adfGeoTransform[6] = {11.0, 0.0001, 0.0, 48.0, 0.0, -0.0001};
+    dataset->SetGeoTransform(adfGeoTransform);
+
+    OGRSpatialReference srs;
+    srs.importFromEPSG(4326);
+    char* wkt = nullptr;
+    srs.exportToWkt(&wkt);
+    dataset->SetProjection(wkt);
+    CPLFree(wkt);
+
+    QVector<quint8> buffer(width * height);
+    for(int b = 1; b <= 3; b++)
+    {
+        for(int y = 0; y < height; y++)
+        {
+            for(int x = 0; x < width; x++)
+            {
+                buffer[y * width + x] = quint8((x * b) ^ (y * (4 - b)) ^ ((x * y) >> 7));
+            }
+        }
+        CPLErr err = dataset->GetRasterBand(b)->RasterIO(GF_Write, 0, 0, width, height, buffer.data(), width, height, GDT_Byte, 0, 0);
+        SUBVERIFY(err != CE_Failure, "Failed to write " + filename);
+    }
+
+    GDALClose(dataset);
+}
+
+/// run qmt_map2jnx and return the created file with the random GUID blanked
+static QByteArray convertToJnx(const QString& app, const QString& input, const QString& output, int threads)
+{
+    QProcess proc;
+    proc.start(app, {"-q", "80", "-s", "411", "-t", QString::number(threads), input, output});
+    SUBVERIFY(proc.waitForFinished(120000), "qmt_map2jnx did not finish");
+    VERIFY_EQUAL(0, proc.exitCode());
+
+    QFile file(output);
+    SUBVERIFY(file.open(QIODevice::ReadOnly), "Failed to open " + output);
+    QByteArray data = file.readAll();
+
+    // the map loader info block holds a random GUID
+    const QRegularExpression re("[0-9A-F]{8}-[0-9A-F]{4}-[0-9A-F]{4}-[0-9A-F]{4}-[0-9A-F]{12}");
+    const QRegularExpressionMatch& match = re.match(QString::fromLatin1(data));
+    SUBVERIFY(match.hasMatch(), "No GUID found in " + output);
+    data.replace(match.capturedStart(), match.capturedLength(), QByteArray(match.capturedLength(), '0'));
+
+    return data;
+}
+
+void test_QMapShack::_convertMapToJnx()
+{
+    const QString& app = QCoreApplication::applicationDirPath() + "/qmt_map2jnx";
+    if(!QFileInfo(app).isExecutable())
+    {
+        QSKIP("qmt_map2jnx has not been built");
+    }
+
+    GDALAllRegister();
+
+    QTemporaryDir dir;
+    SUBVERIFY(dir.isValid(), "Failed to create temporary directory");
+
+    // not a multiple of the tile size to get clipped tiles at the borders
+    const QString& input = dir.filePath("input.tif");
+    createTestRaster(input, 1500, 1300);
+
+    const QByteArray& sequential = convertToJnx(app, input, dir.filePath("sequential.jnx"), 1);
+    const QByteArray& parallel = convertToJnx(app, input, dir.filePath("parallel.jnx"), 4);
+
+    VERIFY_EQUAL(sequential.size(), parallel.size());
+    SUBVERIFY(sequential == parallel, "Parallel encoding changed the JNX file");
+}
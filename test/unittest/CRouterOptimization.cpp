@@ -0,0 +1,239 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "gis/rte/router/CRouterOptimization.h"
+
+#include <QtCore>
+
+using costs_t = CRouterOptimization::costs_t;
+
+static quint32 nextRandom(quint32& seed)
+{
+    seed = (seed * 1103515245 + 12345) & 0x7FFFFFFF;
+    return seed;
+}
+
+/*
+   Points scattered over a 10x10 km square with a random elevation. Going uphill
+   costs extra, thus the costs are not symmetric, like the ones of a router.
+ */
+static costs_t makeCosts(qint32 N, quint32 seed)
+{
+    QVector<QPointF> points;
+    QVector<qreal> elevations;
+    for(int i = 0; i < N; i++)
+    {
+        const qreal x = nextRandom(seed) % 10000;
+        const qreal y = nextRandom(seed) % 10000;
+        points << QPointF(x, y);
+        elevations << nextRandom(seed) % 500;
+    }
+
+    costs_t costs(N, QVector<qreal>(N, 0));
+    for(int i = 0; i < N; i++)
+    {
+        for(int j = 0; j < N; j++)
+        {
+            if(i != j)
+            {
+                const QPointF d = points[j] - points[i];
+                costs[i][j] = qSqrt(d.x() * d.x() + d.y() * d.y()) + 10 * qMax(qreal(0), elevations[j] - elevations[i]);
+            }
+        }
+    }
+    return costs;
+}
+
+// A copy of the former search (insertion and 2-opt restarts) to compare with
+static qreal insertReference(const costs_t& costs, const QVector<qint32>& oldOrder, QVector<qint32>& newOrder)
+{
+    qreal bestGain = 0;
+    int bestBase = -1;
+    int bestItem = -1;
+    for(int base = 0; base < oldOrder.size() - 2; base++)
+    {
+        for(int item = 1; item < oldOrder.size() - 1; item++)
+        {
+            if(base == item || base == item - 1)
+            {
+                continue;
+            }
+
+            const qreal gain = costs[oldOrder[base]][oldOrder[item]]
+                               + costs[oldOrder[item]][oldOrder[base + 1]]
+                               - costs[oldOrder[base]][oldOrder[base + 1]]
+                               + costs[oldOrder[item - 1]][oldOrder[item + 1]]
+                               - costs[oldOrder[item - 1]][oldOrder[item]]
+                               - costs[oldOrder[item]][oldOrder[item + 1]];
+            if(gain < bestGain)
+            {
+                bestGain = gain;
+                bestBase = base;
+                bestItem = item;
+            }
+        }
+    }
+
+    newOrder = oldOrder;
+    if(bestBase >= 0)
+    {
+        newOrder.move(bestItem, bestItem < bestBase ? bestBase : bestBase + 1);
+    }
+    return bestGain;
+}
+
+static void twoOptReference(const costs_t& costs, const QVector<qint32>& oldOrder, QVector<qint32>& newOrder)
+{
+    qreal bestGain = NOINT;
+    int bestBegin = -1;
+    int bestEnd = -1;
+    for(int begin = 1; begin < oldOrder.size() - 2; begin++)
+    {
+        for(int end = begin + 1; end < oldOrder.size() - 1; end++)
+        {
+            qreal oldCosts = costs[oldOrder[begin - 1]][oldOrder[begin]] + costs[oldOrder[end]][oldOrder[end + 1]];
+            qreal newCosts = costs[oldOrder[begin - 1]][oldOrder[end]] + costs[oldOrder[begin]][oldOrder[end + 1]];
+            for(int i = begin; i < end; i++)
+            {
+                oldCosts += costs[oldOrder[i]][oldOrder[i + 1]];
+                newCosts += costs[oldOrder[i + 1]][oldOrder[i]];
+            }
+            if(newCosts - oldCosts < bestGain)
+            {
+                bestGain = newCosts - oldCosts;
+                bestBegin = begin;
+                bestEnd = end;
+            }
+        }
+    }
+
+    newOrder = oldOrder;
+    if(bestBegin >= 0)
+    {
+        std::reverse(newOrder.begin() + bestBegin, newOrder.begin() + bestEnd);
+    }
+}
+
+static QVector<qint32> optimizeReference(const costs_t& costs)
+{
+    const qint32 N = costs.size();
+    QVector<qint32> order;
+    for(int i = 0; i < N; i++)
+    {
+        order << i;
+    }
+
+    QVector<qint32> newOrder;
+    while(insertReference(costs, order, newOrder) < 0)
+    {
+        order = newOrder;
+    }
+
+    QVector<qint32> bestOrder = order;
+    qreal bestCosts = CRouterOptimization::getCosts(costs, order);
+    qreal lastCosts = bestCosts;
+    int restarts = 0;
+    while(restarts < N)
+    {
+        if(insertReference(costs, order, newOrder) < 0)
+        {
+            const qreal newCosts = CRouterOptimization::getCosts(costs, newOrder);
+            if(newCosts < lastCosts)
+            {
+                order = newOrder;
+                lastCosts = newCosts;
+                if(newCosts < bestCosts)
+                {
+                    bestOrder = newOrder;
+                    bestCosts = newCosts;
+                }
+            }
+        }
+        else
+        {
+            restarts++;
+            twoOptReference(costs, order, newOrder);
+            order = newOrder;
+            lastCosts = CRouterOptimization::getCosts(costs, order);
+        }
+    }
+    return bestOrder;
+}
+
+static qreal bruteForce(const costs_t& costs)
+{
+    QVector<qint32> order;
+    for(int i = 0; i < costs.size(); i++)
+    {
+        order << i;
+    }
+
+    qreal bestCosts = CRouterOptimization::getCosts(costs, order);
+    while(std::next_permutation(order.begin() + 1, order.end() - 1))
+    {
+        bestCosts = qMin(bestCosts, CRouterOptimization::getCosts(costs, order));
+    }
+    return bestCosts;
+}
+
+void test_QMapShack::_optimizeRouteOrder()
+{
+    int numBetter = 0;
+    const QList<qint32> sizes = {4, 5, 6, 8, 10, 15, 20, 25, 30};
+    for(qint32 N : sizes)
+    {
+        for(quint32 seed = 1; seed <= 5; seed++)
+        {
+            const costs_t& costs = makeCosts(N, seed * 7 + N);
+            const QVector<qint32>& order = CRouterOptimization::optimizeOrder(costs);
+
+            // a permutation with fixed start and end
+            VERIFY_EQUAL(N, order.size());
+            VERIFY_EQUAL(0, order.first());
+            VERIFY_EQUAL(N - 1, order.last());
+            QVector<qint32> sorted = order;
+            std::sort(sorted.begin(), sorted.end());
+            for(int i = 0; i < N; i++)
+            {
+                VERIFY_EQUAL(i, sorted[i]);
+            }
+
+            const qreal costsNew = CRouterOptimization::getCosts(costs, order);
+            const qreal costsReference = CRouterOptimization::getCosts(costs, optimizeReference(costs));
+            SUBVERIFY(costsNew <= costsReference + 1e-6, QString("Worse order for %1 points, seed %2: %3 > %4").arg(N).arg(seed).arg(costsNew).arg(costsReference));
+            if(costsNew < costsReference - 1e-6)
+            {
+                numBetter++;
+            }
+
+            if(N <= 8)
+            {
+                SUBVERIFY(qAbs(costsNew - bruteForce(costs)) < 1e-6, QString("No optimal order for %1 points, seed %2").arg(N).arg(seed));
+            }
+        }
+    }
+
+    SUBVERIFY(numBetter > 0, "The search never improved the former result");
+
+    // the search is deterministic
+    const costs_t& costs = makeCosts(25, 42);
+    SUBVERIFY(CRouterOptimization::optimizeOrder(costs) == CRouterOptimization::optimizeOrder(costs), "Search is not deterministic");
+}
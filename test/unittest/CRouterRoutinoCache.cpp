@@ -0,0 +1,80 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "gis/rte/router/routino/CRouterRoutinoCache.h"
+
+#include <QtCore>
+
+static CRouterRoutinoCache::key_t makeKey(quint64 database, const QString& profile, qint32 mode, qreal lon1, qreal lon2)
+{
+    CRouterRoutinoCache::key_t key;
+    key.database = database;
+    key.profile = profile;
+    key.mode = mode;
+    key.from = QPointF(lon1, 0.8);
+    key.to = QPointF(lon2, 0.8);
+    return key;
+}
+
+void test_QMapShack::_cacheRoutinoSegments()
+{
+    CRouterRoutinoCache cache(100);
+
+    QPolygonF route;
+    route << QPointF(0.1, 0.8) << QPointF(0.15, 0.8) << QPointF(0.2, 0.8);
+
+    QPolygonF coords;
+    qreal costs = 0;
+
+    // an empty cache misses
+    SUBVERIFY(!cache.find(makeKey(1, "foot", 0, 0.1, 0.2), coords, costs), "Empty cache returned a segment");
+    VERIFY_EQUAL(0u, cache.getHits());
+    VERIFY_EQUAL(1u, cache.getMisses());
+
+    cache.insert(makeKey(1, "foot", 0, 0.1, 0.2), route, 42.0);
+
+    // the same segment hits and returns the route
+    SUBVERIFY(cache.find(makeKey(1, "foot", 0, 0.1, 0.2), coords, costs), "Cached segment not found");
+    VERIFY_EQUAL(1u, cache.getHits());
+    SUBVERIFY(coords == route, "Cached route differs");
+    VERIFY_EQUAL(42.0, costs);
+
+    // every part of the key matters
+    SUBVERIFY(!cache.find(makeKey(2, "foot", 0, 0.1, 0.2), coords, costs), "Database ignored");
+    SUBVERIFY(!cache.find(makeKey(1, "bicycle", 0, 0.1, 0.2), coords, costs), "Profile ignored");
+    SUBVERIFY(!cache.find(makeKey(1, "foot", 1, 0.1, 0.2), coords, costs), "Mode ignored");
+    SUBVERIFY(!cache.find(makeKey(1, "foot", 0, 0.2, 0.1), coords, costs), "Direction ignored");
+    VERIFY_EQUAL(1u, cache.getHits());
+    VERIFY_EQUAL(5u, cache.getMisses());
+
+    // the number of cached points is bounded, the least recently used segments are dropped
+    for(int i = 0; i < 50; i++)
+    {
+        cache.insert(makeKey(1, "foot", 0, i, i + 1), route, i);
+    }
+    SUBVERIFY(cache.count() <= 100 / (route.size() + 1), "Cache exceeds it's limit");
+    SUBVERIFY(cache.find(makeKey(1, "foot", 0, 49, 50), coords, costs), "Last segment has been dropped");
+    SUBVERIFY(!cache.find(makeKey(1, "foot", 0, 0.1, 0.2), coords, costs), "First segment has not been dropped");
+
+    cache.clear();
+    VERIFY_EQUAL(0, cache.count());
+}
+
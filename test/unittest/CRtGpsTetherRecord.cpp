@@ -0,0 +1,133 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "realtime/gpstether/CRtGpsTetherRecord.h"
+
+#include <QtCore>
+
+static qint32 readRecord(const QString& filename, const QDateTime& from = QDateTime(), const QDateTime& to = QDateTime())
+{
+    CRtGpsTetherRecord record(nullptr);
+    if(!record.setFile(filename, from, to))
+    {
+        return -1;
+    }
+    return record.getTrack().size();
+}
+
+void test_QMapShack::_readRecordWindow()
+{
+    QTemporaryDir dir;
+    const QString& filename = dir.filePath("test.rec");
+    const QString& filenameIndex = filename + ".idx";
+    const QDateTime start(QDate(2021, 6, 1), QTime(8, 0), Qt::UTC);
+
+    const int N = 1000;
+    {
+        CRtGpsTetherRecord record(nullptr);
+        SUBVERIFY(record.setFile(filename), "Failed to create record");
+        for(int n = 0; n < N; n++)
+        {
+            SUBVERIFY(record.writeEntry(12.0 + n * 1e-4, 47.0, 500, 5, start.addSecs(n)), "Failed to write entry");
+        }
+        VERIFY_EQUAL(N, record.getTrack().size());
+    }
+
+    // version tag and one entry of offset and time for every 100th entry
+    VERIFY_EQUAL(1 + 10 * 16, QFileInfo(filenameIndex).size());
+
+    VERIFY_EQUAL(N, readRecord(filename));
+    VERIFY_EQUAL(100, readRecord(filename, start.addSecs(250), start.addSecs(349)));
+    VERIFY_EQUAL(50, readRecord(filename, start.addSecs(950)));
+    VERIFY_EQUAL(10, readRecord(filename, QDateTime(), start.addSecs(9)));
+    VERIFY_EQUAL(0, readRecord(filename, start.addSecs(-100), start.addSecs(-1)));
+
+    {
+        CRtGpsTetherRecord record(nullptr);
+        record.setFile(filename, start.addSecs(250), start.addSecs(349));
+        const QVector<CTrackData::trkpt_t>& track = record.getTrack();
+        SUBVERIFY(track.first().time == start.addSecs(250), "Bad start of time window");
+        SUBVERIFY(track.last().time == start.addSecs(349), "Bad end of time window");
+        SUBVERIFY(qAbs(track.first().lon - 12.025) < 1e-9, "Bad position");
+    }
+
+    // the window at the end of an old record is relative to its last entry
+    {
+        CRtGpsTetherRecord record(nullptr);
+        SUBVERIFY(record.setFileLast(filename, 100), "Failed to open record");
+        const QVector<CTrackData::trkpt_t>& track = record.getTrack();
+        VERIFY_EQUAL(101, track.size());
+        SUBVERIFY(track.first().time == start.addSecs(N - 101), "Bad start of time window");
+        SUBVERIFY(track.last().time == start.addSecs(N - 1), "Bad end of time window");
+    }
+
+    // records without index are still readable and get an index
+    QFile::remove(filenameIndex);
+    VERIFY_EQUAL(100, readRecord(filename, start.addSecs(250), start.addSecs(349)));
+    VERIFY_EQUAL(1 + 10 * 16, QFileInfo(filenameIndex).size());
+
+    // append to an existing record
+    {
+        CRtGpsTetherRecord record(nullptr);
+        SUBVERIFY(record.setFile(filename), "Failed to open record");
+        for(int n = N; n < N + 50; n++)
+        {
+            SUBVERIFY(record.writeEntry(12.0 + n * 1e-4, 47.0, 500, 5, start.addSecs(n)), "Failed to write entry");
+        }
+    }
+    VERIFY_EQUAL(N + 50, readRecord(filename));
+    VERIFY_EQUAL(50, readRecord(filename, start.addSecs(N)));
+    VERIFY_EQUAL(1 + 11 * 16, QFileInfo(filenameIndex).size());
+
+    // a broken entry at the end is truncated
+    const qint64 size = QFileInfo(filename).size();
+    {
+        QFile file(filename);
+        file.open(QIODevice::Append);
+        file.write("broken entry");
+    }
+    VERIFY_EQUAL(-1, readRecord(filename));
+    VERIFY_EQUAL(size, QFileInfo(filename).size());
+    VERIFY_EQUAL(N + 50, readRecord(filename));
+
+    // an index not matching the record is rebuilt
+    {
+        QFile file(filenameIndex);
+        file.open(QIODevice::Append);
+        QDataStream stream(&file);
+        stream.setByteOrder(QDataStream::LittleEndian);
+        stream << qint64(size - 3) << start.addSecs(N + 50).toMSecsSinceEpoch();
+    }
+    VERIFY_EQUAL(N + 50, readRecord(filename));
+    VERIFY_EQUAL(size, QFileInfo(filename).size());
+    VERIFY_EQUAL(1 + 11 * 16, QFileInfo(filenameIndex).size());
+
+    // reset
+    {
+        CRtGpsTetherRecord record(nullptr);
+        record.setFile(filename);
+        record.reset();
+        VERIFY_EQUAL(0, record.getTrack().size());
+        SUBVERIFY(record.writeEntry(12.0, 47.0, 500, 5, start), "Failed to write entry");
+    }
+    VERIFY_EQUAL(1, readRecord(filename));
+    VERIFY_EQUAL(1 + 16, QFileInfo(filenameIndex).size());
+}
@@ -0,0 +1,171 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "realtime/gpstether/CRtNmeaParser.h"
+#include "units/IUnit.h"
+
+#include <QtCore>
+#include <QtNetwork>
+
+/**
+   @brief A stand-in for a GPS streaming NMEA sentences via TCP/IP
+ */
+class CLocalNmeaServer : public QTcpServer
+{
+public:
+    CLocalNmeaServer()
+    {
+        connect(this, &QTcpServer::newConnection, this, [this]()
+        {
+            while(hasPendingConnections())
+            {
+                QTcpSocket* socket = nextPendingConnection();
+                connect(socket, &QTcpSocket::disconnected, socket, &QTcpSocket::deleteLater);
+                clients << socket;
+                connections++;
+            }
+        });
+    }
+
+    void send(const QByteArray& data)
+    {
+        for(const QPointer<QTcpSocket>& socket : qAsConst(clients))
+        {
+            if(!socket.isNull())
+            {
+                socket->write(data);
+            }
+        }
+    }
+
+    void dropClients()
+    {
+        for(const QPointer<QTcpSocket>& socket : qAsConst(clients))
+        {
+            if(!socket.isNull())
+            {
+                socket->disconnectFromHost();
+            }
+        }
+        clients.clear();
+    }
+
+    qint32 connections = 0;
+
+private:
+    QList<QPointer<QTcpSocket> > clients;
+};
+
+template<typename T>
+static bool waitFor(T condition)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while(!condition() && timer.elapsed() < 5000)
+    {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+    }
+    return condition();
+}
+
+static QByteArray sentence(const QByteArray& body)
+{
+    quint8 cs = 0;
+    for(char c : body)
+    {
+        cs ^= quint8(c);
+    }
+    return "$" + body + "*" + QByteArray::number(cs, 16).rightJustified(2, '0').toUpper() + "\r\n";
+}
+
+static bool isClose(qreal a, qreal b)
+{
+    return qAbs(a - b) < 1e-6;
+}
+
+void test_QMapShack::_parseNmeaStream()
+{
+    const QByteArray& rmc = sentence("GPRMC,123519.50,A,4807.038,N,01131.000,E,022.4,084.4,230321,003.1,W");
+    const QByteArray& gga = sentence("GPGGA,123519.50,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,");
+    const QByteArray& vtg = sentence("GPVTG,054.7,T,034.4,M,005.5,N,010.2,K");
+
+    // checksum test
+    SUBVERIFY(CRtNmeaParser::verifyLine(rmc.constData(), rmc.size() - 2), "Valid sentence rejected");
+    QByteArray corrupt = rmc;
+    corrupt[10] = '7';
+    SUBVERIFY(!CRtNmeaParser::verifyLine(corrupt.constData(), corrupt.size() - 2), "Corrupt sentence accepted");
+    SUBVERIFY(!CRtNmeaParser::verifyLine("$GPVTG,054.7,T", 14), "Sentence without checksum accepted");
+    SUBVERIFY(!CRtNmeaParser::verifyLine("$GPVTG*G1", 9), "Sentence with bad checksum digits accepted");
+
+    CLocalNmeaServer server;
+    SUBVERIFY(server.listen(QHostAddress::LocalHost), "Failed to start local NMEA server");
+
+    CRtNmeaParser nmea;
+    QTcpSocket socket;
+    QObject::connect(&socket, &QTcpSocket::readyRead, &socket, [&](){nmea.read(socket);});
+    QObject::connect(&socket, &QTcpSocket::disconnected, &socket, [&](){nmea.reset();});
+
+    // connect and receive a fix split into arbitrary chunks
+    socket.connectToHost(QHostAddress::LocalHost, server.serverPort());
+    SUBVERIFY(waitFor([&](){return server.connections == 1;}), "No connection");
+
+    const QByteArray& data = rmc + corrupt + gga + vtg;
+    server.send(data.left(30));
+    // the incomplete line stays in the socket's buffer
+    SUBVERIFY(waitFor([&](){return socket.bytesAvailable() == 30;}), "No data");
+    VERIFY_EQUAL(true, nmea.getPosition() == NOPOINTF);
+    server.send(data.mid(30));
+    SUBVERIFY(waitFor([&](){return nmea.getHeading() != NOFLOAT;}), "No heading");
+
+    const QPointF& pos = nmea.getPosition();
+    SUBVERIFY(isClose(pos.x(), 11 + 31.0 / 60) && isClose(pos.y(), 48 + 7.038 / 60), "Wrong position");
+    SUBVERIFY(isClose(nmea.getElevation(), 545.4), "Wrong elevation");
+    SUBVERIFY(isClose(nmea.getSpeed(), 10.2 / 3.6), "Wrong speed");
+    SUBVERIFY(isClose(nmea.getHeading(), 54.7), "Wrong heading");
+    SUBVERIFY(nmea.getTimestamp() == QDateTime(QDate(2021, 3, 23), QTime(12, 35, 19, 500), Qt::UTC), "Wrong timestamp");
+    VERIFY_EQUAL(quint32(1), nmea.getRejected());
+
+    // drop the connection: all data becomes invalid
+    server.dropClients();
+    SUBVERIFY(waitFor([&](){return socket.state() == QAbstractSocket::UnconnectedState;}), "Still connected");
+    VERIFY_EQUAL(true, nmea.getPosition() == NOPOINTF);
+    VERIFY_EQUAL(true, nmea.getHeading() == NOFLOAT);
+
+    // reconnect and receive the next fix
+    socket.connectToHost(QHostAddress::LocalHost, server.serverPort());
+    SUBVERIFY(waitFor([&](){return server.connections == 2;}), "No reconnection");
+    server.send(sentence("GPRMC,123520.00,A,4807.100,S,01131.500,W,022.4,084.4,230321,003.1,W"));
+    SUBVERIFY(waitFor([&](){return nmea.getPosition() != NOPOINTF;}), "No position after reconnect");
+    SUBVERIFY(isClose(nmea.getPosition().x(), -(11 + 31.5 / 60)) && isClose(nmea.getPosition().y(), -(48 + 7.1 / 60)), "Wrong position after reconnect");
+    SUBVERIFY(nmea.getTimestamp() == QDateTime(QDate(2021, 3, 23), QTime(12, 35, 20), Qt::UTC), "Wrong timestamp after reconnect");
+
+    socket.abort();
+
+    // replay from a file, the last line has no line feed
+    QBuffer log;
+    log.setData(rmc + "garbage\n\n" + gga + vtg.left(vtg.size() - 2));
+    log.open(QIODevice::ReadOnly);
+    CRtNmeaParser replay;
+    VERIFY_EQUAL(5, replay.read(log));
+    VERIFY_EQUAL(quint32(2), replay.getRejected());
+    SUBVERIFY(isClose(replay.getHeading(), 54.7), "Last line not parsed");
+}
+
@@ -0,0 +1,158 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "print/CTiledImageWriter.h"
+#include "print/CTileRenderer.h"
+
+#include <gdal_priv.h>
+#include <QtGui>
+
+/**
+   @brief A small raster map with labels and symbols on top
+
+   Everything is drawn relative to the output's origin. The painter is expected
+   to be translated to the top left corner of the area to draw.
+ */
+static void drawTestMap(QPainter& p, const QImage& raster)
+{
+    p.setRenderHint(QPainter::Antialiasing, true);
+    p.setRenderHint(QPainter::TextAntialiasing, true);
+
+    p.drawImage(0, 0, raster);
+
+    // symbols and labels crossing the tile borders at 64 px
+    p.setPen(QPen(Qt::darkBlue, 5));
+    p.setBrush(Qt::yellow);
+    p.drawEllipse(QPointF(64, 64), 12, 12);
+    p.drawEllipse(QPointF(130, 60), 9, 9);
+    p.drawLine(QPointF(10, 150), QPointF(190, 20));
+
+    p.setPen(Qt::black);
+    p.drawText(QPointF(40, 68), "Label across a tile border");
+    p.drawText(QPointF(100, 130), "Another label");
+}
+
+static QImage createRaster(const QSize& size)
+{
+    QImage img(size, QImage::Format_ARGB32);
+    for(int y = 0; y < size.height(); y++)
+    {
+        for(int x = 0; x < size.width(); x++)
+        {
+            img.setPixel(x, y, qRgba((x * 7) & 0xFF, (y * 5) & 0xFF, ((x + y) * 3) & 0xFF, (x < 20) ? 0 : 255));
+        }
+    }
+    return img;
+}
+
+void test_QMapShack::_renderTiles()
+{
+    const QSize size(200, 150);
+    const QImage& raster = createRaster(size);
+
+    // ----- single pass -----
+    QImage single(size, QImage::Format_ARGB32);
+    single.fill(Qt::transparent);
+    {
+        QPainter p(&single);
+        drawTestMap(p, raster);
+    }
+
+    // ----- tiled -----
+    CTileRenderer renderer(size, 64, 32);
+    VERIFY_EQUAL(12, renderer.getTiles().size());
+    SUBVERIFY(renderer.getTileSize() == QSize(128, 128), "Wrong tile size");
+    VERIFY_EQUAL(8, renderer.getTiles().last().rectCore.width());
+    VERIFY_EQUAL(22, renderer.getTiles().last().rectCore.height());
+
+    const QList<CTileRenderer::tile_t>& tiles = renderer.getTiles();
+    auto render = [&](QPainter& p, qint32 n)
+    {
+        p.translate(-tiles[n].rectTile.topLeft());
+        drawTestMap(p, raster);
+    };
+
+    QImage tiled(size, QImage::Format_ARGB32);
+    tiled.fill(Qt::red);
+    qint32 cntTiles = 0;
+    renderer.render(render, [&](const QImage& img, const QPoint& pos)
+    {
+        QPainter p(&tiled);
+        p.setCompositionMode(QPainter::CompositionMode_Source);
+        p.drawImage(pos, img);
+        cntTiles++;
+    });
+
+    VERIFY_EQUAL(12, cntTiles);
+    SUBVERIFY(single == tiled, "Tiled output differs from single pass output");
+
+    // ----- streamed into files -----
+    QTemporaryDir dir;
+    SUBVERIFY(dir.isValid(), "Failed to create temporary directory");
+
+    const QString& filenamePng = dir.filePath("map.png");
+    {
+        CTiledImageWriter writer(filenamePng, size);
+        renderer.render(render, [&writer](const QImage& img, const QPoint& pos)
+        {
+            writer.write(img, pos);
+        });
+        writer.close();
+    }
+
+    const QImage& png = QImage(filenamePng).convertToFormat(QImage::Format_ARGB32);
+    SUBVERIFY(png.size() == size, "Wrong PNG size");
+    SUBVERIFY(single == png, "PNG output differs from single pass output");
+
+    const QString& filenameTif = dir.filePath("map.tif");
+    {
+        CTiledImageWriter writer(filenameTif, size);
+        writer.setGeoReference("EPSG:3857", QPointF(1000, 2000), QPointF(10, -10));
+        renderer.render(render, [&writer](const QImage& img, const QPoint& pos)
+        {
+            writer.write(img, pos);
+        });
+        writer.close();
+    }
+
+    GDALDataset* dataset = (GDALDataset*)GDALOpen(filenameTif.toUtf8(), GA_ReadOnly);
+    SUBVERIFY(dataset != nullptr, "Failed to open GeoTIFF");
+    VERIFY_EQUAL(size.width(), dataset->GetRasterXSize());
+    VERIFY_EQUAL(size.height(), dataset->GetRasterYSize());
+    VERIFY_EQUAL(4, dataset->GetRasterCount());
+
+    double adfGeoTransform[6] = {0};
+    dataset->GetGeoTransform(adfGeoTransform);
+    VERIFY_EQUAL(1000.0, adfGeoTransform[0]);
+    VERIFY_EQUAL(10.0, adfGeoTransform[1]);
+    VERIFY_EQUAL(2000.0, adfGeoTransform[3]);
+    VERIFY_EQUAL(-10.0, adfGeoTransform[5]);
+
+    // compare a line crossing the tile border at 64 px
+    QVector<quint8> red(size.width());
+    dataset->GetRasterBand(1)->RasterIO(GF_Read, 0, 64, size.width(), 1, red.data(), size.width(), 1, GDT_Byte, 0, 0);
+    GDALClose(dataset);
+
+    for(int x = 0; x < size.width(); x++)
+    {
+        VERIFY_EQUAL(qRed(single.pixel(x, 64)), int(red[x]));
+    }
+}
@@ -0,0 +1,178 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "map/cache/CDiskCache.h"
+#include "map/cache/CTileSeeder.h"
+
+#include <QtCore>
+#include <QtNetwork>
+
+/**
+   @brief A minimal HTTP server answering every GET request with a PNG tile
+
+   Requests to paths containing "fail" are answered with 404.
+ */
+class CLocalTileServer : public QTcpServer
+{
+public:
+    CLocalTileServer()
+    {
+        QImage img(256, 256, QImage::Format_ARGB32);
+        img.fill(Qt::red);
+        QBuffer buffer(&tile);
+        buffer.open(QIODevice::WriteOnly);
+        img.save(&buffer, "PNG");
+
+        connect(this, &QTcpServer::newConnection, this, [this]()
+        {
+            while(hasPendingConnections())
+            {
+                QTcpSocket* socket = nextPendingConnection();
+                connect(socket, &QTcpSocket::readyRead, socket, [this, socket]()
+                {
+                    const QByteArray& request = socket->readAll();
+                    requests++;
+
+                    if(request.contains("fail"))
+                    {
+                        socket->write("HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+                    }
+                    else
+                    {
+                        socket->write("HTTP/1.1 200 OK\r\nContent-Type: image/png\r\nConnection: close\r\n");
+                        socket->write(QString("Content-Length: %1\r\n\r\n").arg(tile.size()).toLatin1());
+                        socket->write(tile);
+                    }
+                    socket->disconnectFromHost();
+                });
+                connect(socket, &QTcpSocket::disconnected, socket, &QTcpSocket::deleteLater);
+            }
+        });
+    }
+
+    QString url(const QString& path) const
+    {
+        return QString("http://127.0.0.1:%1/%2").arg(serverPort()).arg(path);
+    }
+
+    qint32 requests = 0;
+
+private:
+    QByteArray tile;
+};
+
+static void runSeeder(CTileSeeder& seeder, const std::function<void()>& start)
+{
+    QEventLoop loop;
+    QObject::connect(&seeder, &CTileSeeder::sigFinished, &loop, &QEventLoop::quit);
+    QTimer::singleShot(10000, &loop, &QEventLoop::quit);
+    start();
+    if(seeder.isRunning())
+    {
+        loop.exec();
+    }
+}
+
+static void runSeeder(CTileSeeder& seeder, const QSet<QString>& urls)
+{
+    runSeeder(seeder, [&]() { seeder.start(urls); });
+}
+
+void test_QMapShack::_seedTileCache()
+{
+    CLocalTileServer server;
+    SUBVERIFY(server.listen(QHostAddress::LocalHost), "Failed to start local tile server");
+
+    QTemporaryDir dir;
+    CDiskCache cache(dir.path(), 100, 8, nullptr);
+
+    QSet<QString> urls;
+    for(int z = 0; z < 2; z++)
+    {
+        for(int x = 0; x < 3; x++)
+        {
+            for(int y = 0; y < 3; y++)
+            {
+                urls << server.url(QString("%1/%2/%3.png").arg(z).arg(x).arg(y));
+            }
+        }
+    }
+    urls << server.url("fail.png");
+
+    CTileSeeder seeder(&cache, nullptr);
+    seeder.setRateLimit(4, 0);
+    runSeeder(seeder, urls);
+
+    const CTileSeeder::progress_t& progress = seeder.getProgress();
+    VERIFY_EQUAL(false, seeder.isRunning());
+    VERIFY_EQUAL(19, progress.total);
+    VERIFY_EQUAL(0, progress.cached);
+    VERIFY_EQUAL(18, progress.done);
+    VERIFY_EQUAL(1, progress.failed);
+    SUBVERIFY(progress.bytes > 0, "No data received");
+
+    for(const QString& url : urls)
+    {
+        VERIFY_EQUAL(!url.contains("fail"), cache.contains(url));
+    }
+
+    // resume: only the failed tile is requested again
+    const qint32 requests = server.requests;
+    seeder.setRateLimit(2, 50);
+    runSeeder(seeder, urls);
+
+    VERIFY_EQUAL(18, seeder.getProgress().cached);
+    VERIFY_EQUAL(1, seeder.getProgress().failed);
+    VERIFY_EQUAL(requests + 1, server.requests);
+
+    // level by level: the next level is requested once the previous one is sent
+    QTemporaryDir dirChunks;
+    CDiskCache cacheChunks(dirChunks.path(), 100, 8, nullptr);
+    CTileSeeder seederChunks(&cacheChunks, nullptr);
+    seederChunks.setRateLimit(4, 0);
+
+    qint32 z = 0;
+    runSeeder(seederChunks, [&]()
+    {
+        // the estimated number of tiles is too large, as if areas overlap
+        seederChunks.start(30, [&](QSet<QString>& chunk)
+        {
+            if(z == 3)
+            {
+                return false;
+            }
+            for(int x = 0; x < 3; x++)
+            {
+                for(int y = 0; y < 3; y++)
+                {
+                    chunk << server.url(QString("%1/%2/%3.png").arg(z).arg(x).arg(y));
+                }
+            }
+            z++;
+            return true;
+        });
+    });
+
+    VERIFY_EQUAL(3, z);
+    VERIFY_EQUAL(27, seederChunks.getProgress().total);
+    VERIFY_EQUAL(27, seederChunks.getProgress().done);
+    VERIFY_EQUAL(0, seederChunks.getProgress().failed);
+}
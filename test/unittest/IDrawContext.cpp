@@ -0,0 +1,131 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "canvas/CCanvas.h"
+#include "canvas/IDrawContext.h"
+
+#include <QtWidgets>
+
+/**
+   @brief A draw context counting complete and partial redraws
+ */
+class CTestDrawContext : public IDrawContext
+{
+public:
+    CTestDrawContext(CCanvas* canvas)
+        : IDrawContext("test", CCanvas::eRedrawGis, canvas)
+    {
+        setProjection("EPSG:3857");
+    }
+
+    qint32 cntFull = 0;
+    qint32 cntPartial = 0;
+    QList<QRectF> areas;
+
+protected:
+    void drawt(buffer_t& /*currentBuffer*/) override
+    {
+        cntFull++;
+    }
+
+    void drawtPartial(buffer_t& /*currentBuffer*/, const QList<QRectF>& a) override
+    {
+        cntPartial++;
+        areas = a;
+    }
+};
+
+void test_QMapShack::_redrawDirtyAreas()
+{
+    createMainWindow();
+
+    CCanvas canvas(nullptr, "test");
+    canvas.resize(400, 300);
+    CTestDrawContext context(&canvas);
+
+    const QPointF focus = QPointF(12.0, 49.0) * DEG_TO_RAD;
+    QImage img(400, 300, QImage::Format_ARGB32);
+
+    auto redraw = [&](CCanvas::redraw_e flags)
+    {
+        QPainter p(&img);
+        context.draw(p, flags, focus);
+        context.wait();
+    };
+
+    // the thread is started once all areas of the current event are reported
+    auto invalidate = [&](const QList<QRectF>& areas)
+    {
+        for(const QRectF& area : areas)
+        {
+            context.invalidate(area);
+        }
+        SUBVERIFY(context.hasDirtyAreas(), "Areas not collected");
+        QCoreApplication::processEvents();
+        context.wait();
+        SUBVERIFY(!context.hasDirtyAreas(), "Areas not reset by redraw");
+    };
+
+    const QRectF area1(QPointF(12.0, 49.0) * DEG_TO_RAD, QSizeF(0.0001, 0.0001));
+    const QRectF area2(QPointF(12.01, 49.01) * DEG_TO_RAD, QSizeF(0.0001, 0.0001));
+
+    // the first redraw is always a complete one
+    redraw(CCanvas::eRedrawGis);
+    VERIFY_EQUAL(1, context.cntFull);
+    VERIFY_EQUAL(0, context.cntPartial);
+
+    // all areas of an event end up in a single partial redraw
+    invalidate({area1, area2});
+    VERIFY_EQUAL(1, context.cntFull);
+    VERIFY_EQUAL(1, context.cntPartial);
+    VERIFY_EQUAL(2, context.areas.size());
+    SUBVERIFY(context.areas[0] == area1 && context.areas[1] == area2, "Wrong dirty areas");
+
+    // too many areas fall back to a complete redraw
+    QList<QRectF> manyAreas;
+    for(int i = 0; i < 100; i++)
+    {
+        manyAreas << area1.translated(i * 0.0001, 0);
+    }
+    invalidate(manyAreas);
+    VERIFY_EQUAL(2, context.cntFull);
+    VERIFY_EQUAL(1, context.cntPartial);
+
+    // a buffer of another zoom level can't be patched
+    context.zoom(context.zoom() + 1);
+    invalidate({area1});
+    VERIFY_EQUAL(3, context.cntFull);
+    VERIFY_EQUAL(1, context.cntPartial);
+
+    // neither can a buffer of another size
+    context.resize(QSize(300, 200));
+    invalidate({area1});
+    VERIFY_EQUAL(4, context.cntFull);
+    VERIFY_EQUAL(1, context.cntPartial);
+
+    // a redraw requested by the canvas is a complete one
+    invalidate({area2});
+    VERIFY_EQUAL(2, context.cntPartial);
+    context.invalidate(area1);
+    redraw(CCanvas::eRedrawGis);
+    VERIFY_EQUAL(5, context.cntFull);
+    VERIFY_EQUAL(2, context.cntPartial);
+}
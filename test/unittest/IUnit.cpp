@@ -0,0 +1,127 @@
+/**********************************************************************************************
+    Copyright (C) 2021 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "gis/proj_x.h"
+#include "units/IUnit.h"
+
+#include <QtCore>
+
+// the former implementation, resolving the timezone on each call
+static QString datetime2stringReference(const QDateTime& time, const QPointF& pos)
+{
+    IUnit::tz_mode_e mode;
+    QByteArray zone;
+    bool format;
+    IUnit::getTimeZoneSetup(mode, zone, format);
+
+    QTimeZone tz;
+    switch((pos != NOPOINTF) ? mode : IUnit::eTZLocal)
+    {
+    case IUnit::eTZUtc:
+        tz = QTimeZone("UTC");
+        break;
+
+    case IUnit::eTZLocal:
+        tz = QTimeZone(QTimeZone::systemTimeZoneId());
+        break;
+
+    case IUnit::eTZAuto:
+        tz = QTimeZone(IUnit::pos2timezone(pos));
+        break;
+
+    case IUnit::eTZSelected:
+        tz = QTimeZone(zone);
+        break;
+    }
+
+    return time.toTimeZone(tz).toString(Qt::ISODate);
+}
+
+void test_QMapShack::_formatTimestamps()
+{
+    IUnit::tz_mode_e oldMode;
+    QByteArray oldZone;
+    bool oldFormat;
+    IUnit::getTimeZoneSetup(oldMode, oldZone, oldFormat);
+
+    // a track of 20000 points crossing Europe from the Atlantic to the Black Sea
+    const int N = 20000;
+    const QDateTime start(QDate(2020, 3, 28), QTime(12, 0), Qt::UTC);
+    QVector<QDateTime> times;
+    QVector<QPointF> positions;
+    for(int i = 0; i < N; i++)
+    {
+        times << start.addSecs(i * 30);
+        positions << QPointF(-10.0 + 40.0 * i / N, 40.0 + 10.0 * i / N) * DEG_TO_RAD;
+    }
+    // some points without a position
+    positions[10] = NOPOINTF;
+    positions[N - 10] = NOPOINTF;
+
+    const QList<IUnit::tz_mode_e> modes = {IUnit::eTZAuto, IUnit::eTZUtc, IUnit::eTZSelected, IUnit::eTZLocal};
+    for(IUnit::tz_mode_e mode : modes)
+    {
+        IUnit::setTimeZoneSetup(mode, "America/New_York", true);
+
+        QElapsedTimer timer;
+        timer.start();
+        QStringList single;
+        for(int i = 0; i < N; i++)
+        {
+            single << IUnit::datetime2string(times[i], true, positions[i]);
+        }
+        const qint64 timeSingle = timer.restart();
+
+        const QStringList& batch = IUnit::datetime2string(times, true, positions);
+        const qint64 timeBatch = timer.elapsed();
+
+        qDebug() << "timezone mode" << mode << "single:" << timeSingle << "ms" << "batch:" << timeBatch << "ms"
+                 << "speedup:" << qreal(timeSingle) / qMax(timeBatch, qint64(1));
+
+        VERIFY_EQUAL(N, single.size());
+        VERIFY_EQUAL(N, batch.size());
+        for(int i = 0; i < N; i++)
+        {
+            SUBVERIFY(batch[i] == single[i], QString("Batch %1: %2 != %3").arg(i).arg(batch[i]).arg(single[i]));
+        }
+
+        // the cached single call is checked against the uncached implementation for a subset
+        for(int i = 0; i < N; i += 10)
+        {
+            const QString& reference = datetime2stringReference(times[i], positions[i]);
+            SUBVERIFY(single[i] == reference, QString("Single %1: %2 != %3").arg(i).arg(single[i]).arg(reference));
+        }
+    }
+
+    // the track crosses more than one timezone
+    IUnit::setTimeZoneSetup(IUnit::eTZAuto, "UTC", true);
+    SUBVERIFY(IUnit::pos2timezone(positions.first()) != IUnit::pos2timezone(positions.last()), "Track is in a single timezone");
+
+    // no positions at all uses the local timezone
+    const QStringList& local = IUnit::datetime2string(times.mid(0, 10), true);
+    VERIFY_EQUAL(10, local.size());
+    for(int i = 0; i < local.size(); i++)
+    {
+        VERIFY_EQUAL(datetime2stringReference(times[i], NOPOINTF), local[i]);
+    }
+
+    IUnit::setTimeZoneSetup(oldMode, oldZone, oldFormat);
+}
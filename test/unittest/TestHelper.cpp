@@ -23,6 +23,9 @@
 
 #include "TestHelper.h"
 
+#include <gdal_priv.h>
+#include <ogr_spatialref.h>
+
 QString TestHelper::getTempFileName(const QString &ext)
 {
     QTemporaryFile tmp("qtt_XXXXXX." + ext);
@@ -157,3 +160,50 @@ expectedGisProject TestHelper::readExpProj(const QString &fileName)
 
     return proj;
 }
+
+QString TestHelper::createMap(const QString &dir, const QPointF &origin, qreal pxSize, const QSize &size)
+{
+    const QString &filenameTif = QDir(dir).filePath("map.tif");
+    const QString &filenameVrt = QDir(dir).filePath("map.vrt");
+
+    GDALDriver *driverTif = GetGDALDriverManager()->GetDriverByName("GTiff");
+    GDALDataset *dataset = driverTif->Create(filenameTif.toUtf8(), size.width(), size.height(), 3, GDT_Byte, nullptr);
+    SUBVERIFY(dataset != nullptr, "Failed to create GeoTIFF");
+
+    OGRSpatialReference srs;
+    srs.importFromEPSG(3857);
+    char *wkt = nullptr;
+    srs.exportToWkt(&wkt);
+    dataset->SetProjection(wkt);
+    CPLFree(wkt);
+
+    double adfGeoTransform[6] = {origin.x(), pxSize, 0, origin.y(), 0, -pxSize};
+    dataset->SetGeoTransform(adfGeoTransform);
+
+    QVector<quint8> line(size.width());
+    for(int b = 1; b <= 3; b++)
+    {
+        for(int y = 0; y < size.height(); y++)
+        {
+            for(int x = 0; x < size.width(); x++)
+            {
+                line[x] = quint8((x * b + y * (4 - b)) / 4);
+            }
+            dataset->GetRasterBand(b)->RasterIO(GF_Write, 0, y, size.width(), 1, line.data(), size.width(), 1, GDT_Byte, 0, 0);
+        }
+    }
+
+    GDALDriver *driverVrt = GetGDALDriverManager()->GetDriverByName("VRT");
+    GDALDataset *vrt = driverVrt->CreateCopy(filenameVrt.toUtf8(), dataset, FALSE, nullptr, nullptr, nullptr);
+    SUBVERIFY(vrt != nullptr, "Failed to create VRT");
+    GDALClose(vrt);
+    GDALClose(dataset);
+
+    return filenameVrt;
+}
+
+QPointF TestHelper::merc2rad(const QPointF &pt)
+{
+    const qreal R = 6378137.0;
+    return QPointF(pt.x() / R, 2 * qAtan(qExp(pt.y() / R)) - M_PI / 2);
+}
@@ -85,6 +85,23 @@ public:
     static QString getTempFileName(const QString &ext);
 
     static expectedGisProject readExpProj(const QString &file);
+
+    /**
+       @brief Create a georeferenced map with a smooth color gradient
+
+       A VRT is created on top of a GeoTIFF as the canvas does not load GeoTIFFs directly.
+       The color of a pixel at x,y is ((x + 3y) / 4, (2x + 2y) / 4, (3x + y) / 4).
+
+       @param dir       the directory to create the files in
+       @param origin    the top left corner of the map in [m] (EPSG:3857)
+       @param pxSize    the size of a pixel in [m]
+       @param size      the size of the map in [px]
+       @return The filename of the VRT.
+     */
+    static QString createMap(const QString &dir, const QPointF &origin, qreal pxSize, const QSize &size);
+
+    /// convert a point in [m] (EPSG:3857) to [rad]
+    static QPointF merc2rad(const QPointF &pt);
 };
 
 #endif // TESTHELPER_H
@@ -16,12 +16,16 @@
 
 **********************************************************************************************/
 
+#include <QApplication>
 #include <QDebug>
+#include <QDialog>
 #include <QTemporaryFile>
+#include <QTimer>
 
 #include "TestHelper.h"
 #include "test_QMapShack.h"
 
+#include "CMainWindow.h"
 #include "gis/gpx/CGpxProject.h"
 #include "gis/ovl/CGisItemOvlArea.h"
 #include "gis/prj/IGisProject.h"
@@ -34,14 +38,25 @@
 #include "gis/trk/CKnownExtension.h"
 #include "gis/wpt/CGisItemWpt.h"
 #include "helpers/CSettings.h"
+#include "setup/CAppOpts.h"
 #include "setup/IAppSetup.h"
 
 QString testInput;
 
 void test_QMapShack::initTestCase()
 {
+    // never touch the configuration, the workspace or the databases of the user
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(home.isValid());
+    qputenv("HOME", home.path().toLocal8Bit());
+
     IAppSetup* env = IAppSetup::getPlatformInstance();
     env->processArguments();
+
+    CAppOpts* opts = qlOpts;
+    qlOpts = new CAppOpts(opts->debug, opts->logfile, opts->nosplash, QDir(home.path()).filePath("qmapshack.ini"), opts->renderJobs, opts->arguments);
+    delete opts;
+
     env->initLogHandler();
     env->initQMapShack();
 
@@ -61,6 +76,34 @@ void test_QMapShack::initTestCase()
     };
 }
 
+void test_QMapShack::cleanupTestCase()
+{
+    delete mainWindow;
+    mainWindow = nullptr;
+}
+
+void test_QMapShack::createMainWindow()
+{
+    // the canvas and the GIS workspace are attached to the main window
+    if(mainWindow == nullptr)
+    {
+        mainWindow = new CMainWindow();
+
+        // a modal dialog popping up on start would block the test run forever
+        QTimer* timer = new QTimer(mainWindow);
+        connect(timer, &QTimer::timeout, this, []()
+        {
+            QDialog* dlg = qobject_cast<QDialog*>(QApplication::activeModalWidget());
+            if(dlg != nullptr)
+            {
+                qWarning() << "Reject modal dialog" << dlg->windowTitle();
+                dlg->reject();
+            }
+        });
+        timer->start(500);
+    }
+}
+
 void test_QMapShack::verify(expectedGisProject exp, const IGisProject &proj)
 {
     VERIFY_EQUAL(true,        proj.isValid());
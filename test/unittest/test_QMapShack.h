@@ -23,6 +23,7 @@
 
 class IGisProject;
 class CGpxProject;
+class CMainWindow;
 class CQmsProject;
 class CSlfProject;
 
@@ -46,6 +47,13 @@ class test_QMapShack : public QObject
 
     IGisProject* readProjFile(const QString &file, bool valid = true, bool forceVerify = true);
 
+    // settings and the workspace database of the tests, kept apart from the user's
+    QTemporaryDir home;
+
+    // tests using a canvas need the main window
+    CMainWindow* mainWindow = nullptr;
+    void createMainWindow();
+
     // CSlfReader
     void _readValidSLFFile();
     void _readNonExistingSLFFile();
@@ -69,9 +77,57 @@ class test_QMapShack : public QObject
 
     // CGisItemTrk
     void _filterDeleteExtension();
+    void _filterLoopsCut();
+
+    // CTileSeeder
+    void _seedTileCache();
+
+    // qmt_map2jnx
+    void _convertMapToJnx();
+
+    // CRouterRoutinoCache
+    void _cacheRoutinoSegments();
+
+    // CPlotEnvelope
+    void _reducePlotToEnvelope();
+
+    // CRouterOptimization
+    void _optimizeRouteOrder();
+
+    // CGarminPickIndex
+    void _findInPickIndex();
+
+    // IUnit
+    void _formatTimestamps();
+
+    // CRtNmeaParser
+    void _parseNmeaStream();
+
+    // CFileScanner
+    void _scanMapFiles();
+
+    // CTileRenderer
+    void _renderTiles();
+
+    // CBatchRender
+    void _readRenderJobs();
+    void _renderJob();
+
+    // CRtGpsTetherRecord
+    void _readRecordWindow();
+
+    // CMapMAP
+    void _decodeMapsforgeTile();
+
+    // IDrawContext
+    void _redrawDirtyAreas();
+
+    // CCanvas
+    void _printTiled();
 
 private slots:
     void initTestCase();
+    void cleanupTestCase();
 
     void testreadValidSLFFile()         { TCWRAPPER( _readValidSLFFile()         ) }
     void testreadNonExistingSLFFile()   { TCWRAPPER( _readNonExistingSLFFile()   ) }
@@ -82,4 +138,21 @@ private slots:
     void testreadExtGarminTPX1_tp1()    { TCWRAPPER( _readExtGarminTPX1_tp1()    ) }
     void testreadValidFitFiles()        { TCWRAPPER( _readValidFitFiles()        ) }
     void testfilterDeleteExtension()    { TCWRAPPER( _filterDeleteExtension()    ) }
+    void testfilterLoopsCut()           { TCWRAPPER( _filterLoopsCut()           ) }
+    void testseedTileCache()            { TCWRAPPER( _seedTileCache()            ) }
+    void testconvertMapToJnx()          { TCWRAPPER( _convertMapToJnx()          ) }
+    void testcacheRoutinoSegments()     { TCWRAPPER( _cacheRoutinoSegments()     ) }
+    void testreducePlotToEnvelope()     { TCWRAPPER( _reducePlotToEnvelope()     ) }
+    void testoptimizeRouteOrder()       { TCWRAPPER( _optimizeRouteOrder()       ) }
+    void testfindInPickIndex()          { TCWRAPPER( _findInPickIndex()          ) }
+    void testformatTimestamps()         { TCWRAPPER( _formatTimestamps()         ) }
+    void testparseNmeaStream()          { TCWRAPPER( _parseNmeaStream()          ) }
+    void testscanMapFiles()             { TCWRAPPER( _scanMapFiles()             ) }
+    void testrenderTiles()              { TCWRAPPER( _renderTiles()              ) }
+    void testreadRenderJobs()           { TCWRAPPER( _readRenderJobs()           ) }
+    void testrenderJob()                { TCWRAPPER( _renderJob()                ) }
+    void testreadRecordWindow()         { TCWRAPPER( _readRecordWindow()         ) }
+    void testdecodeMapsforgeTile()      { TCWRAPPER( _decodeMapsforgeTile()      ) }
+    void testredrawDirtyAreas()         { TCWRAPPER( _redrawDirtyAreas()         ) }
+    void testprintTiled()               { TCWRAPPER( _printTiled()               ) }
 };